@@ -3594,6 +3594,15 @@ public:
     EXPORT static int32_t getMarketList(const std::string& NOTARY_ID,
                                         const std::string& NYM_ID);
 
+    //! Asks the server for its per-command request counts and latencies.
+    // Only allowed for the override Nym, unless cmd_get_server_stats is on.
+    // The reply payload is the statistics as XML.
+    //
+    // Returns int32_t: the same as getMarketList.
+    //
+    EXPORT static int32_t getServerStats(const std::string& NOTARY_ID,
+                                         const std::string& NYM_ID);
+
     //! Gets all offers for a specific market and their details (up until
     // maximum depth)
     // Returns int32_t:
@@ -42,6 +42,7 @@
 #include <memory>
 #include <string>
 #include <opentxs/core/String.hpp>
+#include <opentxs/core/OTWireFormat.hpp>
 
 // forward declare zsock_t
 typedef struct _zsock_t zsock_t;
@@ -89,12 +90,18 @@ public:
     static void setLinger(int nIn);
     static void setSendTimeout(int nIn);
     static void setRecvTimeout(int nIn);
+
+    // The framing new connections try first. (A connection falls back to
+    // ARMORED by itself if the server doesn't understand BINARY.)
+    static OTWireFormat::Framing getFraming();
+    static void setFraming(OTWireFormat::Framing theFraming);
     
     static bool networkFailure();    // This returns s_bNetworkFailure.
     
 private:
     bool send(const String&);
     bool receive(std::string& reply);
+    bool exchange(const std::string& request, std::string& reply);
 
 private:
     zsock_t* socket_zmq;
@@ -103,10 +110,12 @@ private:
     OTClient* m_pClient;
     
     std::string m_endpoint;
+    OTWireFormat::Framing m_framing;
     
     static int s_linger;
     static int s_send_timeout;
     static int s_recv_timeout;
+    static OTWireFormat::Framing s_framing;
     // -----------------------------
     // Used to signal network failure.
     static bool s_bNetworkFailure;
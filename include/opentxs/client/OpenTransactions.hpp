@@ -1122,6 +1122,8 @@ public:
                                              // threshold price here.
     EXPORT int32_t getMarketList(const Identifier& NOTARY_ID,
                                  const Identifier& NYM_ID) const;
+    EXPORT int32_t getServerStats(const Identifier& NOTARY_ID,
+                                  const Identifier& NYM_ID) const;
     EXPORT int32_t getMarketOffers(const Identifier& NOTARY_ID,
                                    const Identifier& NYM_ID,
                                    const Identifier& MARKET_ID,
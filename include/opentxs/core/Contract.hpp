@@ -43,6 +43,8 @@
 #include "OTStringXML.hpp"
 #include "util/Common.hpp" // TODO: remove this when feasible
 
+#include <vector>
+
 namespace irr
 {
 namespace io
@@ -64,8 +66,12 @@ class OTPasswordData;
 class OTSignature;
 class Tag;
 
+class Contract;
+
 typedef std::list<OTSignature*> listOfSignatures;
 typedef std::map<std::string, Nym*> mapOfNyms;
+typedef std::vector<Contract*> listOfContracts;
+typedef std::vector<const Contract*> listOfConstContracts;
 
 String trim(const String& str);
 
@@ -380,6 +386,15 @@ public:
         OTSignature& theSignature,                // output
         const OTPasswordData* pPWData = nullptr); // optional in/out
 
+    // Signs each contract with theNym's signing key, like calling
+    // SignContract(theNym) on each one, but as one batch on OTCryptoPool.
+    // (So an override of SignContract(const Nym&) is NOT called.) Returns
+    // false if any of them failed; the ones that succeeded keep their new
+    // signature either way.
+    EXPORT static bool SignContracts(const listOfContracts& theContracts,
+                                     const Nym& theNym,
+                                     const OTPasswordData* pPWData = nullptr);
+
     // Calculates a hash of m_strRawFile (the xml portion of the contract plus
     // the signatures)
     // and compares to m_ID (supposedly the same. The ID is calculated by
@@ -435,6 +450,13 @@ public:
         const OTSignature& theSignature,
         const OTPasswordData* pPWData = nullptr) const; // optional in/out
 
+    // True if every contract has a signature that verifies against one of
+    // theNym's signing keys, like calling VerifySignature(theNym) on each
+    // one. All the candidate signatures are checked as one batch.
+    EXPORT static bool VerifySignatures(
+        const listOfConstContracts& theContracts, const Nym& theNym,
+        const OTPasswordData* pPWData = nullptr);
+
     //      bool VerifySignatures();   // This function verifies the signatures
     // on the contract.
     // If true, it proves that certain entities really did sign
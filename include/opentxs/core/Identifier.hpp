@@ -57,9 +57,6 @@ class OTSymmetricKey;
 
 class Identifier : public OTData
 {
-private:
-    bool CalculateDigest(const unsigned char* data, size_t len);
-
 public:
     EXPORT friend std::ostream& operator<<(std::ostream& os, const String& obj);
 
@@ -85,6 +82,7 @@ public:
     EXPORT bool operator<(const Identifier& s2) const;
     EXPORT bool operator<=(const Identifier& s2) const;
     EXPORT bool operator>=(const Identifier& s2) const;
+    EXPORT bool CalculateDigest(const unsigned char* data, size_t len);
     EXPORT bool CalculateDigest(const OTData& dataInput);
     EXPORT bool CalculateDigest(const String& strInput);
 
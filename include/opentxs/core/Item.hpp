@@ -427,6 +427,14 @@ public:
 
 private:
     Item::itemType GetItemTypeFromString(const String& strType);
+
+    // The compact (version 2) half of the two functions above. pInbox and
+    // pOutbox are nullptr for a transaction statement.
+    bool VerifyStatementDigest(const String& strDigest, Nym& THE_NYM,
+                               Ledger* pInbox, Ledger* pOutbox,
+                               OTTransaction& TARGET_TRANSACTION,
+                               int64_t lOutboxTrnsNum,
+                               bool bIsRealTransaction);
 };
 
 } // namespace opentxs
@@ -42,9 +42,11 @@
 #include "String.hpp"
 #include "util/Assert.hpp"
 
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <cstdint>
+#include <mutex>
 
 #if defined(unix) || defined(__unix__) || defined(__unix) ||                   \
     defined(__APPLE__) || defined(linux) || defined(__linux) ||                \
@@ -56,6 +58,23 @@
 #define PREDEF_MODE_DEBUG 1
 #endif
 
+// OT_LOG statements more verbose than this are compiled out entirely.
+// Builds that never log above, say, level 2 can set -DOT_LOG_MAX_LEVEL=2.
+#ifndef OT_LOG_MAX_LEVEL
+#define OT_LOG_MAX_LEVEL 5
+#endif
+
+// OT_LOG(3) << "Processing " << String(theID) << "\n";
+//
+// Unlike writing to otLog3 directly, nothing to the right of OT_LOG is
+// evaluated unless level 3 is being logged, so a suppressed statement costs
+// a single branch. Use it where a message is built inside a loop.
+#define OT_LOG(nVerbosity)                                                     \
+    if (!opentxs::Log::IsEnabled(nVerbosity)) {                                \
+    }                                                                          \
+    else                                                                       \
+        opentxs::Log::Stream(nVerbosity)
+
 namespace opentxs
 {
 
@@ -90,11 +109,21 @@ private:
     int logLevel;
     int next;
     char* pBuffer;
+    std::mutex bufferLock; // crypto pool threads log too
 
 public:
     OTLogStream(int _logLevel);
     ~OTLogStream();
 
+    // Whether anything written to this stream would be logged at the
+    // current log level.
+    bool Enabled() const;
+
+    // While the stream's level is suppressed it is kept in the bad state,
+    // so operator<< returns before formatting anything. Log calls this
+    // whenever the log level changes.
+    void Refresh();
+
     virtual int overflow(int c);
 };
 
@@ -110,12 +139,18 @@ private:
     static const String m_strPathSeparator;
 
     dequeOfStrings logDeque;
+    // The memlog is written from several threads at once: the log writer
+    // thread, OTCryptoPool jobs (when logging synchronously) and the caller,
+    // while the API reads it.
+    std::mutex memlogLock;
 
     String m_strThreadContext;
     String m_strLogFileName;
     String m_strLogFilePath;
 
-    int32_t m_nLogLevel;
+    // Kept outside the logger object so IsEnabled() is a single load, and
+    // works before Init().
+    static std::atomic<int32_t> s_nLogLevel;
 
     bool m_bInitialized;
 
@@ -126,6 +161,12 @@ private:
 
     static bool CheckLogger(Log* pLogger);
 
+    static void RefreshStreams();
+
+    // Hands a finished line to the log writer thread, or writes it here and
+    // now when that thread isn't running.
+    static void Write(const char* szText, bool bMemlog);
+
 public:
     // EXPORT static OTLog& It();
 
@@ -158,12 +199,43 @@ public:
     EXPORT static int32_t LogLevel();
     EXPORT static bool SetLogLevel(const int32_t& nLogLevel);
 
+    // True if a message of this verbosity would be logged. Cheap enough to
+    // test before building the message; see OT_LOG.
+    static bool IsEnabled(int32_t nVerbosity)
+    {
+        if (nVerbosity > OT_LOG_MAX_LEVEL) return false;
+
+        const int32_t nLogLevel = s_nLogLevel.load(std::memory_order_relaxed);
+
+        return (nVerbosity <= nLogLevel) && (-1 != nLogLevel);
+    }
+
+    // The global stream for a verbosity: otOut, otWarn, otInfo, otLog3..5.
+    EXPORT static OTLogStream& Stream(int32_t nVerbosity);
+
     // OTLog Functions:
     //
 
+    // Writes to stderr and the logfile on the calling thread. Output() and
+    // Error() normally go through the log writer thread instead.
     EXPORT static bool LogToFile(const String& strOutput);
 
-    // We keep 1024 logs in memory, to make them available via the API.
+    // While asynchronous logging is on (the default), Output() and Error()
+    // queue each line in a fixed-size ring and return; a background thread
+    // started by Init() writes the lines out in batches. When the ring is
+    // full the line is dropped rather than making the caller wait.
+    EXPORT static bool GetAsync();
+    EXPORT static void SetAsync(bool bAsync);
+
+    // Lines lost to a full ring since startup.
+    EXPORT static uint64_t DroppedMessages();
+
+    // Waits (briefly) until everything queued so far has been written.
+    EXPORT static void Flush();
+
+    // We keep the last 1024 logs in memory, to make them available via the
+    // API. With asynchronous logging a line shows up here once it has been
+    // written out.
     EXPORT static int32_t GetMemlogSize();
     EXPORT static String GetMemlogAtIndex(int32_t nIndex);
     EXPORT static String PeekMemlogFront();
@@ -228,6 +300,11 @@ public:
                                              // above OT_Init.
 };
 
+inline bool OTLogStream::Enabled() const
+{
+    return (logLevel < 0) || Log::IsEnabled(logLevel);
+}
+
 } // namespace opentxs
 
 #endif // OPENTXS_CORE_OTLOG_HPP
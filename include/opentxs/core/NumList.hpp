@@ -39,6 +39,8 @@
 #ifndef OPENTXS_CORE_OTNUMLIST_HPP
 #define OPENTXS_CORE_OTNUMLIST_HPP
 
+#include "OTNumberSet.hpp"
+
 #include <string>
 #include <set>
 #include <cstdint>
@@ -50,7 +52,7 @@ class OTAsymmetricKey;
 class OTPasswordData;
 class String;
 
-// Useful for storing a std::set of longs,
+// Useful for storing a set of longs,
 // serializing to/from comma-separated string,
 // And easily being able to add/remove/verify the
 // individual transaction numbers that are there.
@@ -59,9 +61,15 @@ class String;
 // Also used in OTMessage, for storing lists of acknowledged
 // request numbers.
 //
+// Transaction numbers are issued in runs, so the numbers are kept as ranges,
+// and a run of three or more is serialized as "first-last":
+// "1001-1100,1205". Plain comma-separated lists still parse.
+//
 class NumList
 {
-    std::set<int64_t> m_setData;
+    OTNumberSet m_setData;
+
+    static bool s_bRangeOutput;
 
     // private for security reasons, used internally only by a function that
     // knows the string length already.
@@ -94,6 +102,10 @@ public:
     EXPORT bool Add(const NumList& theNumList); // if false, means the numbers
                                                 // were already there. (At
                                                 // least one of them.)
+    EXPORT bool Add(const OTNumberSet& theNumbers); // if false, means the
+                                                    // numbers were already
+                                                    // there. (At least one of
+                                                    // them.)
     EXPORT bool Add(const std::set<int64_t>& theNumbers); // if false, means the
                                                           // numbers were
                                                           // already there. (At
@@ -134,6 +146,21 @@ public:
     EXPORT bool Output(String& strOutput) const; // returns false if the
                                                  // numlist was empty.
     EXPORT void Release();
+
+    // The numbers, as ranges. (Cheaper than Output for a long run.)
+    const OTNumberSet& GetNumbers() const
+    {
+        return m_setData;
+    }
+
+    // A string that would expand to more numbers than this is rejected.
+    static const int32_t MaxCount = 1000000;
+
+    // Whether Output(String&) writes runs as ranges. Builds from before the
+    // range encoding can't parse those, so this can be turned off while they
+    // are still around.
+    EXPORT static bool GetRangeOutput();
+    EXPORT static void SetRangeOutput(bool bRangeOutput);
 };
 
 } // namespace opentxs
@@ -41,11 +41,14 @@
 
 #include "crypto/OTASCIIArmor.hpp"
 #include "Identifier.hpp"
+#include "OTNumberSet.hpp"
 
 #include <deque>
 #include <map>
 #include <list>
 #include <set>
+#include <string>
+#include <utility>
 
 namespace opentxs
 {
@@ -61,12 +64,14 @@ class OTPasswordData;
 class OTSubcredential;
 class OTTransaction;
 class Tag;
+class XmlWriter;
 
 typedef std::deque<Message*> dequeOfMail;
+typedef std::deque<std::string> dequeOfMailIDs;
+typedef std::set<std::pair<std::string, std::string>> setOfMailRefs;
 typedef std::map<std::string, int64_t> mapOfRequestNums;
 typedef std::map<std::string, int64_t> mapOfHighestNums;
-typedef std::deque<int64_t> dequeOfTransNums;
-typedef std::map<std::string, dequeOfTransNums*> mapOfTransNums;
+typedef std::map<std::string, OTNumberSet> mapOfTransNums;
 typedef std::map<std::string, Identifier> mapOfIdentifiers;
 typedef std::map<std::string, OTCredential*> mapOfCredentials;
 typedef std::list<OTAsymmetricKey*> listOfAsymmetricKeys;
@@ -132,6 +137,19 @@ private:
                                 // yet deleted.)
     dequeOfMail m_dequeOutpayments; // Any outoing payments sent by this Nym.
                                     // (And not yet deleted.) (payments screen.)
+    // Storage IDs of the messages above, index for index. Each message is
+    // written once, to its own file under OTFolders::Mail(), and the signed
+    // nymfile only lists these IDs (the hash of each message.) An empty ID
+    // means the message hasn't been written yet.
+    dequeOfMailIDs m_dequeMailIDs;
+    dequeOfMailIDs m_dequeOutmailIDs;
+    dequeOfMailIDs m_dequeOutpaymentsIDs;
+    // Box and ID of each stored message removed since the last signed save.
+    // The files are erased once the saved nymfile no longer lists them.
+    setOfMailRefs m_setRemovedMail;
+    // Box and ID of each message the signed nymfile lists but whose file is
+    // missing or altered. They stay listed, so saving doesn't lose them.
+    setOfMailRefs m_setUnloadedMail;
     mapOfRequestNums m_mapRequestNum; // Whenever this user makes a request to a
                                       // transaction server
     // he must use the latest request number. Each user has a request
@@ -529,6 +547,24 @@ public:
     EXPORT bool SavePseudonym(); // saves to filename m_strNymfile
 protected: // Use SaveSignedNymfile if you want to save the Nym to local storage.
     EXPORT bool SavePseudonym(const char* szFoldername, const char* szFilename);
+    // bMailByReference lists stored mail by ID instead of inlining it. Only
+    // the signed nymfile does that; other copies of the Nym stay portable.
+    bool SavePseudonym(String& strNym, bool bMailByReference);
+    // bMailByReference accepts those IDs and loads the mail from storage.
+    // Only the signed nymfile may do that: a Nym received from a peer must
+    // not be able to make us read files.
+    bool LoadFromString(const String& strNym, String::Map* pMapCredentials,
+                        String* pstrReason, const OTPassword* pImportPassword,
+                        bool bMailByReference);
+    // Writes any mail that isn't in storage yet.
+    void StoreMail(const String& strNymID);
+    // Erases the files of removed mail that nothing refers to any more.
+    void EraseRemovedMail(const String& strNymID);
+
+private:
+    void ForgetStoredMail(const char* szBox, dequeOfMailIDs& theIDs,
+                          uint32_t uIndex);
+
 public:
     EXPORT bool SavePseudonym(String& strNym);
     EXPORT bool SetIdentifierByPubkey();
@@ -558,6 +594,7 @@ public:
     }
 
     EXPORT void SerializeNymIDSource(Tag& parent) const;
+    EXPORT void SerializeNymIDSource(XmlWriter& writer) const;
     EXPORT const Identifier& GetConstID() const
     {
         return m_nymID;
@@ -881,6 +918,11 @@ public:
     EXPORT bool AddGenericNum(mapOfTransNums& THE_MAP,
                               const String& strNotaryID,
                               int64_t lTransNum); // doesn't save
+    // All of theNumbers, a range at a time. (A peer's "1-999999" is one
+    // insert, not a million.)
+    EXPORT void AddGenericNums(mapOfTransNums& THE_MAP,
+                               const String& strNotaryID,
+                               const OTNumberSet& theNumbers); // doesn't save
 
     EXPORT int32_t GetGenericNumCount(const mapOfTransNums& THE_MAP,
                                       const Identifier& theNotaryID) const;
@@ -83,6 +83,9 @@ public:
     EXPORT bool Randomize(uint32_t size);
     EXPORT void zeroMemory() const;
     EXPORT uint32_t OTfread(uint8_t* data, uint32_t size);
+    // Like OTfread, but returns a pointer to the next size bytes where they
+    // are, instead of copying them out. nullptr if fewer than size are left.
+    EXPORT const void* OTfreadInPlace(uint32_t size);
 
     inline void reset()
     {
@@ -0,0 +1,136 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_OTID_HPP
+#define OPENTXS_CORE_OTID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace opentxs
+{
+
+class Identifier;
+class String;
+
+// A 20 byte Identifier held by value: no heap buffer, no vtable, trivially
+// copyable, and hashable so it can key an unordered_map directly.
+//
+// Use it for in-memory lookups. Convert to an Identifier or to its base62
+// String only where an ID is actually serialized or logged.
+//
+class OTID
+{
+public:
+    static const size_t Size = 20;
+
+    OTID()
+        : bytes_()
+    {
+    }
+
+    // Stays empty if theID isn't exactly Size bytes.
+    EXPORT explicit OTID(const Identifier& theID);
+
+    // Returns false (and leaves *this empty) if theID isn't exactly Size
+    // bytes.
+    EXPORT bool Set(const Identifier& theID);
+
+    EXPORT void GetIdentifier(Identifier& theID) const;
+    EXPORT void GetString(String& strID) const;
+
+    bool empty() const
+    {
+        static const uint8_t s_empty[Size] = {0};
+
+        return 0 == memcmp(bytes_, s_empty, Size);
+    }
+
+    const uint8_t* data() const
+    {
+        return bytes_;
+    }
+
+    // The bytes are a digest, so any of them are as good a hash as all.
+    size_t Hash() const noexcept
+    {
+        size_t lHash = 0;
+        memcpy(&lHash, bytes_, sizeof(lHash));
+
+        return lHash;
+    }
+
+    bool operator==(const OTID& rhs) const
+    {
+        return 0 == memcmp(bytes_, rhs.bytes_, Size);
+    }
+
+    bool operator!=(const OTID& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    // Byte order, not the order of the base62 strings.
+    bool operator<(const OTID& rhs) const
+    {
+        return memcmp(bytes_, rhs.bytes_, Size) < 0;
+    }
+
+private:
+    uint8_t bytes_[Size];
+};
+
+} // namespace opentxs
+
+namespace std
+{
+
+template <>
+struct hash<opentxs::OTID>
+{
+    size_t operator()(const opentxs::OTID& theID) const noexcept
+    {
+        return theID.Hash();
+    }
+};
+
+} // namespace std
+
+#endif // OPENTXS_CORE_OTID_HPP
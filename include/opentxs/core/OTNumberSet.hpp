@@ -0,0 +1,137 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_OTNUMBERSET_HPP
+#define OPENTXS_CORE_OTNUMBERSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace opentxs
+{
+
+// A set of numbers, stored as disjoint, non-adjacent ranges.
+//
+// Transaction numbers are issued in runs, so even a Nym holding thousands of
+// them usually has only a handful of ranges. Contains, Insert and Remove are
+// O(log ranges), Count is O(1), and memory is proportional to the number of
+// gaps rather than the number of values.
+//
+class OTNumberSet
+{
+public:
+    // First number -> last number (inclusive) of each range, in order.
+    typedef std::map<int64_t, int64_t> Ranges;
+
+    EXPORT bool Contains(int64_t lNumber) const;
+
+    // Returns false if lNumber was already there.
+    EXPORT bool Insert(int64_t lNumber);
+
+    // Adds lFirst..lLast (inclusive). Returns how many of those numbers
+    // weren't already there.
+    EXPORT size_t InsertRange(int64_t lFirst, int64_t lLast);
+
+    // Whether any of lFirst..lLast (inclusive) is in the set.
+    EXPORT bool ContainsAny(int64_t lFirst, int64_t lLast) const;
+
+    // Whether all of lFirst..lLast (inclusive) are in the set.
+    EXPORT bool ContainsAll(int64_t lFirst, int64_t lLast) const;
+
+    // Returns false if lNumber wasn't there.
+    EXPORT bool Remove(int64_t lNumber);
+
+    EXPORT void Clear();
+
+    // Removes the lowest numbers until at most lCount are left, in
+    // O(ranges).
+    EXPORT void KeepHighest(size_t lCount);
+
+    // Finds the lIndex'th lowest number, in O(ranges). Returns false if
+    // lIndex >= Count().
+    EXPORT bool At(size_t lIndex, int64_t& lNumber) const;
+
+    size_t Count() const
+    {
+        return count_;
+    }
+
+    bool empty() const
+    {
+        return 0 == count_;
+    }
+
+    // Only valid if !empty().
+    int64_t Lowest() const
+    {
+        return ranges_.begin()->first;
+    }
+
+    // Only valid if !empty().
+    int64_t Highest() const
+    {
+        return ranges_.rbegin()->second;
+    }
+
+    const Ranges& GetRanges() const
+    {
+        return ranges_;
+    }
+
+    // Calls fn(lNumber) for each number, lowest first.
+    template <class F>
+    void ForEach(F fn) const
+    {
+        for (const auto& it : ranges_) {
+            for (int64_t lNumber = it.first;; ++lNumber) {
+                fn(lNumber);
+
+                if (lNumber == it.second) break;
+            }
+        }
+    }
+
+private:
+    Ranges ranges_;
+    size_t count_ = 0;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_OTNUMBERSET_HPP
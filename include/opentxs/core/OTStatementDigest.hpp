@@ -0,0 +1,166 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_OTSTATEMENTDIGEST_HPP
+#define OPENTXS_CORE_OTSTATEMENTDIGEST_HPP
+
+#include "Identifier.hpp"
+#include "NumList.hpp"
+
+#include <cstdint>
+
+namespace opentxs
+{
+
+class Item;
+class Ledger;
+class Nym;
+class OTNumberSet;
+class OTTransaction;
+class String;
+
+// OTStatementDigest is the attachment of a compact (version 2) balance or
+// transaction statement.
+//
+// A full statement attaches a Nym holding every issued number, and a balance
+// statement adds one sub-item per inbox and outbox receipt. A compact one
+// attaches this instead:
+//
+//     - the count and a hash of the issued numbers the statement signs for;
+//     - the delta: which numbers it drops from the Nym's issued list, as it
+//       stood at the last signed receipt;
+//     - for a balance statement, the inbox and outbox counts and a hash of the
+//       report the full statement would have carried.
+//
+// Its size doesn't depend on how many numbers or receipts the Nym has. The
+// server already holds the issued list and the boxes, so it checks the delta
+// against the list and recomputes both hashes from its own state.
+//
+// The client keeps the full statement it compacted as a sidecar next to the
+// receipt, so later receipts can still be checked against the complete list.
+// The digest is what ties the two together.
+//
+// The server accepts both versions. The client only sends compact statements
+// when they're turned on in its config, and sends full ones whenever it can't
+// (a processNymbox has no transaction number and needs the list itself.)
+//
+class OTStatementDigest
+{
+public:
+    // Client side: whether the Generate*Statement functions compact.
+    EXPORT static bool IsEnabled();
+    EXPORT static void SetEnabled(bool bEnabled);
+
+    // Whether strAttachment is a digest rather than a message Nym. (It can
+    // still fail to load.)
+    EXPORT static bool IsDigest(const String& strAttachment);
+
+    // Commits to the issued numbers on theNumbers.
+    EXPORT void SetIssued(const OTNumberSet& theNumbers);
+
+    // Commits to the message Nym attached to a full statement. Returns false
+    // if it won't load.
+    EXPORT bool SetIssued(const Item& theStatement);
+
+    // Commits to the inbox and outbox report on theReport's sub-items. A
+    // server-side report has the real number of a new outbox transfer, so
+    // lOutboxTrnsNum is hashed as the '1' the client used. (Unused when 0.)
+    EXPORT void SetBox(Item& theReport, int64_t lOutboxTrnsNum = 0);
+
+    NumList& GetRemoved()
+    {
+        return m_removed;
+    }
+
+    const NumList& GetRemoved() const
+    {
+        return m_removed;
+    }
+
+    int64_t GetIssuedCount() const
+    {
+        return m_lIssuedCount;
+    }
+
+    // Whether both commit to the same numbers / the same boxes.
+    EXPORT bool SameIssued(const OTStatementDigest& rhs) const;
+    EXPORT bool SameBox(const OTStatementDigest& rhs) const;
+
+    EXPORT void Save(String& strOutput) const;
+    EXPORT bool Load(const String& strInput);
+
+    // Client side. Returns a compact copy of theFull, signed by theNym, and
+    // stores theFull as a pending sidecar under strReceiptID (the account ID
+    // for a balance statement, the Nym ID for a transaction statement.)
+    // theRemoved lists the numbers theFull drops from theNym's issued list.
+    // Returns nullptr if it can't, and the caller sends theFull instead.
+    // CALLER IS RESPONSIBLE TO DELETE.
+    EXPORT static Item* Compact(Item& theFull, const OTTransaction& theOwner,
+                                const NumList& theRemoved, Nym& theNym,
+                                const String& strReceiptID);
+
+    // Client side, when the reply to lTransNum arrives. A success makes its
+    // pending sidecar (if any) the one for strReceiptID, otherwise the
+    // pending sidecar is discarded.
+    EXPORT static void ResolvePending(const Identifier& NOTARY_ID,
+                                      const String& strReceiptID,
+                                      int64_t lTransNum, bool bSuccess);
+
+    // Client side. Loads the sidecar for theCompact, and returns it only if it
+    // is signed by theNym and matches the digest on theCompact.
+    // CALLER IS RESPONSIBLE TO DELETE.
+    EXPORT static Item* LoadExpanded(Item& theCompact,
+                                     const Identifier& NOTARY_ID,
+                                     const String& strReceiptID,
+                                     const Nym& theNym);
+
+private:
+    static bool s_bEnabled;
+
+    int64_t m_lIssuedCount = 0;
+    Identifier m_issuedHash;
+    NumList m_removed;
+    bool m_bHasBox = false;
+    int64_t m_lInboxCount = 0;
+    int64_t m_lOutboxCount = 0;
+    Identifier m_boxHash;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_OTSTATEMENTDIGEST_HPP
@@ -1675,6 +1675,11 @@ public:
                                                             // data_folder
     bool ConfirmFile(const char* szFileName,
                      struct stat* pst = nullptr); // local to data_folder
+
+    // Reads the whole file into theBuffer. lSize is what stat() said its
+    // length was; the file may have grown or shrunk since.
+    EXPORT static bool ReadFile(const std::string& strPath, int64_t lSize,
+                                std::string& theBuffer);
 };
 
 } // namespace OTDB
@@ -0,0 +1,118 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_OTSTORAGECACHE_HPP
+#define OPENTXS_CORE_OTSTORAGECACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+namespace OTDB
+{
+
+// StorageFS keeps the plain-string files it reads here, up to a byte
+// budget, and drops the least recently used ones past it. Entries are
+// keyed by the full path and stamped with the file's size, inode and
+// modification times; one is only served while a stat() of the file still
+// matches, so changes made behind OT's back are picked up. StorageFS also
+// drops the entry for anything it writes or erases.
+//
+// Files in pinned folders (contracts, mints...) are kept regardless of the
+// budget.
+class StorageCache
+{
+public:
+    // What stat() says about a file. Equal versions mean unchanged
+    // contents (down to the filesystem's timestamp resolution.)
+    struct FileVersion
+    {
+        int64_t m_lSize;
+        int64_t m_lModified; // ns
+        int64_t m_lChanged;  // ns
+        uint64_t m_lInode;
+
+        FileVersion();
+        bool operator==(const FileVersion& rhs) const;
+    };
+
+    struct Stats
+    {
+        uint64_t m_lHits;
+        uint64_t m_lMisses;
+        uint64_t m_lStale; // found, but the file had changed
+        uint64_t m_lEvictions;
+        uint64_t m_lEntries;
+        uint64_t m_lBytes;
+        uint64_t m_lPinnedBytes;
+
+        Stats();
+    };
+
+    // On a hit, copies the cached contents into strContents and returns
+    // true. On a miss, theVersion is the file as it is now: pass it to Put()
+    // along with what gets read.
+    EXPORT static bool Get(const std::string& strPath,
+                           std::string& strContents, FileVersion& theVersion);
+    // Caches strContents as the contents of strPath. Ignored if the size
+    // doesn't match theVersion (the file changed while it was read.)
+    EXPORT static void Put(const std::string& strFolder,
+                           const std::string& strPath,
+                           const FileVersion& theVersion,
+                           const std::string& strContents);
+    EXPORT static void Invalidate(const std::string& strPath);
+    EXPORT static void Clear();
+
+    EXPORT static Stats GetStats();
+
+    // The LRU budget in bytes. 0 caches only the pinned folders.
+    EXPORT static int64_t GetMaxBytes();
+    EXPORT static void SetMaxBytes(int64_t lBytes);
+
+    // Comma-separated folder names, as passed to OTDB (e.g. "contracts".)
+    EXPORT static std::string GetPinnedFolders();
+    EXPORT static void SetPinnedFolders(const std::string& strFolders);
+};
+
+} // namespace OTDB
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_OTSTORAGECACHE_HPP
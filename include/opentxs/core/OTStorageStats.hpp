@@ -0,0 +1,99 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_OTSTORAGESTATS_HPP
+#define OPENTXS_CORE_OTSTORAGESTATS_HPP
+
+#include <opentxs/core/util/LatencyHistogram.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace opentxs
+{
+
+namespace OTDB
+{
+
+// Counts what StorageFS does, by top-level folder (nyms, nymbox, inbox,
+// receipts, spent, markets...) and operation: how often, how many bytes,
+// how many failed, how long it took, and how many times it took longer
+// than the slow threshold. Every StorageFS call is recorded, so this shows
+// which kind of data the disk time goes to.
+class StorageStats
+{
+public:
+    enum Operation { READ, WRITE, EXISTS, ERASE, OPERATION_COUNT };
+
+    struct Counters
+    {
+        uint64_t m_lCount;
+        uint64_t m_lErrors;
+        uint64_t m_lBytes;
+        uint64_t m_lSlow;
+        LatencyHistogram m_latency;
+
+        EXPORT Counters();
+    };
+
+    typedef std::array<Counters, OPERATION_COUNT> FolderCounters;
+    typedef std::map<std::string, FolderCounters> Snapshot;
+
+    // Returns true if the operation was slow.
+    EXPORT static bool Record(const std::string& strFolder,
+                              Operation eOperation, bool bSuccess,
+                              uint64_t lBytes, int64_t lMicros);
+
+    // A copy of the counters so far.
+    EXPORT static Snapshot Get();
+
+    EXPORT static const char* Name(Operation eOperation);
+
+    // Operations that take at least this many milliseconds are counted as
+    // slow and logged. 0 turns that off.
+    EXPORT static int64_t GetSlowThreshold();
+    EXPORT static void SetSlowThreshold(int64_t lMilliseconds);
+};
+
+} // namespace OTDB
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_OTSTORAGESTATS_HPP
@@ -342,7 +342,7 @@ same time that it is first being
  */
 
 class Ledger;
-class Tag;
+class XmlWriter;
 
 class OTTransaction : public OTTransactionType
 {
@@ -637,12 +637,12 @@ public:
     // Because all of the actual receipts cannot fit into the single inbox
     // file, you must put their hash, and then store the receipt itself
     // separately...
-    void SaveAbbreviatedNymboxRecord(Tag& parent);
-    void SaveAbbreviatedOutboxRecord(Tag& parent);
-    void SaveAbbreviatedInboxRecord(Tag& parent);
-    void SaveAbbrevPaymentInboxRecord(Tag& parent);
-    void SaveAbbrevRecordBoxRecord(Tag& parent);
-    void SaveAbbrevExpiredBoxRecord(Tag& parent);
+    void SaveAbbreviatedNymboxRecord(XmlWriter& writer);
+    void SaveAbbreviatedOutboxRecord(XmlWriter& writer);
+    void SaveAbbreviatedInboxRecord(XmlWriter& writer);
+    void SaveAbbrevPaymentInboxRecord(XmlWriter& writer);
+    void SaveAbbrevRecordBoxRecord(XmlWriter& writer);
+    void SaveAbbrevExpiredBoxRecord(XmlWriter& writer);
     void ProduceInboxReportItem(Item& theBalanceItem);
     void ProduceOutboxReportItem(Item& theBalanceItem);
 
@@ -0,0 +1,123 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+#ifndef OPENTXS_CORE_OTWIREFORMAT_HPP
+#define OPENTXS_CORE_OTWIREFORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+class String;
+
+// OTWireFormat turns a signed message into the bytes of a ZMQ frame, and back.
+//
+// ARMORED is the original protocol: the message is compressed and base64
+// encoded by OTASCIIArmor, and sent as a text frame.
+//
+// BINARY skips the base64 round trip, since CurveZMQ already gives us an
+// encrypted binary channel. The frame is a five byte header followed by the
+// payload:
+//
+//     0x00, 'o', 't', header version, payload encoding
+//
+// where the payload is the raw signed message (RAW), or the message packed by
+// OTArmorCodec with the preset dictionary (COMPRESSED).
+//
+// An armored frame never starts with a null byte, so each frame identifies
+// its own framing and the server simply answers in kind. Older servers can't
+// parse a binary frame and send an empty reply, which tells the client to
+// fall back to ARMORED. A newer server that fails to process a binary
+// request replies with a bare header instead, so that the client doesn't
+// mistake it for an old one.
+//
+class OTWireFormat
+{
+public:
+    enum Framing {
+        ARMORED = 0,
+        BINARY = 1
+    };
+
+    enum Encoding {
+        RAW = 0,
+        COMPRESSED = 1
+    };
+
+    static const uint8_t HeaderMagic;
+    static const uint8_t HeaderVersion;
+    static const uint32_t HeaderSize;
+
+    // True if the frame has a binary header (possibly with no payload.)
+    EXPORT static bool IsBinary(const void* pFrame, size_t lFrameSize);
+
+    EXPORT static bool Encode(const String& strMessage, Framing theFraming,
+                              std::string& theOutput);
+
+    // Detects the framing from the frame itself. A bare binary header decodes
+    // successfully, to an empty strMessage.
+    EXPORT static bool Decode(const void* pFrame, size_t lFrameSize,
+                              String& strMessage, Framing& theFraming);
+
+    // A binary frame with no payload.
+    EXPORT static void EmptyBinary(std::string& theOutput);
+    // What to send for a request that gets no reply: an empty frame if it
+    // was armored, EmptyBinary() if it was binary. Never an empty frame for
+    // a binary request, which the client would take to mean the server
+    // doesn't support binary framing, and resend the request armored.
+    EXPORT static void FailedReply(Framing theRequestFraming,
+                                   std::string& theOutput);
+
+    // Whether BINARY payloads go through OTArmorCodec. (Payloads under its
+    // stored threshold are sent RAW either way.)
+    EXPORT static bool GetCompress();
+    EXPORT static void SetCompress(bool bCompress);
+
+    EXPORT static const char* FramingToString(Framing theFraming);
+    EXPORT static bool FramingFromString(const std::string& strFraming,
+                                         Framing& theFraming);
+
+private:
+    static bool s_bCompress;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_OTWIREFORMAT_HPP
@@ -0,0 +1,125 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTARMORCODEC_HPP
+#define OPENTXS_CORE_CRYPTO_OTARMORCODEC_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+// OTArmorCodec is the compression layer underneath OTASCIIArmor::SetString
+// and OTASCIIArmor::GetString.
+//
+// Legacy armored strings are a bare zlib stream, and the ZLIB codec still
+// produces exactly that, so its output is readable by every version of OT.
+// The other codecs prefix their payload with a four byte header:
+//
+//     'O', header version, codec, dictionary version
+//
+// A zlib stream can never begin with 'O' (its low nibble must be 8), so
+// Decode() can tell the two forms apart without any other context.
+//
+// Payloads smaller than the stored threshold are not worth compressing. Under
+// the ZLIB codec they are written as a level 0 (stored) zlib stream, which
+// older peers can still read; under the other codecs they get the STORED
+// header instead.
+//
+// The deflate and inflate contexts are reset and reused per thread, instead
+// of paying for deflateInit / inflateInit on every armored string.
+//
+class OTArmorCodec
+{
+public:
+    enum Codec {
+        ZLIB = 0,           // bare zlib stream, no header (legacy format)
+        STORED = 1,         // header, then the uncompressed payload
+        ZLIB_DICTIONARY = 2 // header, then zlib with the OT preset dictionary
+    };
+
+    static const uint8_t HeaderMagic;
+    static const uint8_t HeaderVersion;
+    static const uint8_t DictionaryVersion;
+    static const uint32_t HeaderSize;
+
+    // Compress theInput according to the configured codec.
+    EXPORT static bool Encode(const std::string& theInput,
+                              std::string& theOutput);
+
+    // Compress theInput with an explicitly chosen codec and zlib level.
+    // (Used by Encode, and by anyone who needs to measure the alternatives.)
+    EXPORT static bool Encode(const std::string& theInput,
+                              std::string& theOutput, Codec theCodec,
+                              int32_t nLevel);
+
+    // Decompress theInput, whether it has a header or is a legacy zlib stream.
+    EXPORT static bool Decode(const std::string& theInput,
+                              std::string& theOutput);
+
+    EXPORT static Codec GetCodec();
+    EXPORT static void SetCodec(Codec theCodec);
+
+    // zlib compression level, 0 (none) through 9 (best).
+    EXPORT static int32_t GetCompressionLevel();
+    EXPORT static void SetCompressionLevel(int32_t nLevel);
+
+    // Payloads smaller than this many bytes are stored, not compressed.
+    EXPORT static int64_t GetStoredThreshold();
+    EXPORT static void SetStoredThreshold(int64_t lThreshold);
+
+    // "zlib", "stored" or "zlib_dictionary" (for the config files.)
+    EXPORT static const char* CodecToString(Codec theCodec);
+    EXPORT static bool CodecFromString(const std::string& strCodec,
+                                       Codec& theCodec);
+
+private:
+    static bool Deflate(const std::string& theInput, std::string& theOutput,
+                        int32_t nLevel, bool bUseDictionary);
+    static bool Inflate(const char* pInput, size_t lInputSize,
+                        std::string& theOutput, bool bUseDictionary);
+
+    static Codec s_codec;
+    static int32_t s_nLevel;
+    static int64_t s_lStoredThreshold;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTARMORCODEC_HPP
@@ -41,6 +41,7 @@
 
 #include <opentxs/core/util/Timer.hpp>
 #include <list>
+#include <string>
 
 namespace opentxs
 {
@@ -108,13 +109,26 @@ EXPORT OT_OPENSSL_CALLBACK souped_up_pass_cb;
 
 class OTAsymmetricKey // <========= OT ASYMMETRIC KEY
 {
+    friend class Test_OTAsymmetricKeyResidency; // unit tests
+
 private:
     OTAsymmetricKey(const OTAsymmetricKey&);
     OTAsymmetricKey& operator=(const OTAsymmetricKey&);
 
+public:
+    enum KeyType {
+        RSA = 0,    // OTAsymmetricKey_OpenSSL
+        ED25519 = 1 // OTAsymmetricKey_Ed25519 (signing keys only.)
+    };
+
+    virtual KeyType GetKeyType() const = 0;
+    // True if this build can instantiate keys of that type.
+    EXPORT static bool IsKeyTypeSupported(KeyType eKeyType);
+
 public:                                           // INSTANTIATION
     EXPORT static OTAsymmetricKey* KeyFactory();  // Caller IS responsible to
                                                   // delete!
+    EXPORT static OTAsymmetricKey* KeyFactory(KeyType eKeyType);
     virtual OTAsymmetricKey* ClonePubKey() const; // Caller IS responsible to
                                                   // delete!
 public:                                           // PASSWORD CALLBACK
@@ -131,6 +145,33 @@ protected: // PASSWORD CALLBACK
     static OT_OPENSSL_CALLBACK* s_pwCallback;
     static OTCaller* s_pCaller;
 
+public: // KEY RESIDENCY
+    // What happens to a decrypted private key once OT_KEY_TIMER runs out.
+    // Set from [security] key_residency in the config file.
+    enum KeyResidency {
+        TIMED = 0,    // Released, and decrypted again on next use. (Default.)
+        RESIDENT = 1, // Kept until the key object is destroyed.
+        REFRESH = 2   // Decrypted again on a background thread, while the old
+                      // instance keeps signing. (OpenSSL keys only: Ed25519
+                      // keys treat this as TIMED.)
+    };
+
+    EXPORT static KeyResidency GetKeyResidency();
+    EXPORT static void SetKeyResidency(KeyResidency eResidency);
+    EXPORT static const char* KeyResidencyToString(KeyResidency eResidency);
+    EXPORT static bool KeyResidencyFromString(const std::string& strResidency,
+                                              KeyResidency& eResidency);
+
+    // How many times a private key has been decrypted and instantiated since
+    // startup, and how many of those were background refreshes.
+    EXPORT static int64_t GetKeyInstantiations();
+    EXPORT static int64_t GetKeyRefreshes();
+
+protected:
+    static void CountKeyInstantiation(bool bRefresh = false);
+    // True once OT_KEY_TIMER has run out, unless the key is RESIDENT.
+    bool IsKeyTimerExpired();
+
 protected:                    // PROTECTED MEMBER DATA
     OTASCIIArmor* m_p_ascKey; // base64-encoded, string form of key. (Encrypted
                               // too, for private keys. Should store it in this
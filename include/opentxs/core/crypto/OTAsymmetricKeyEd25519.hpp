@@ -0,0 +1,142 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTASYMMETRICKEYED25519_HPP
+#define OPENTXS_CORE_CRYPTO_OTASYMMETRICKEYED25519_HPP
+
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+
+namespace opentxs
+{
+
+class OTASCIIArmor;
+class OTPassword;
+class OTPasswordData;
+class OTSignature;
+class String;
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+
+// Ed25519 signing keys, implemented with libsodium.
+//
+// The public key is the raw 32 byte Ed25519 key, armored between
+// "ED25519 PUBLIC KEY" bookends. The private key is libsodium's 64 byte
+// secret key, sealed with crypto_secretbox under a key that crypto_pwhash
+// derives from the same passphrase OpenSSL would get for an RSA key: the
+// wallet's master key normally, or the export passphrase when a Nym is being
+// exported or imported.
+//
+// These keys only sign and verify. A credential that uses them for its
+// signing and authentication keys still has an RSA encryption key, since
+// Seal and Open need one.
+//
+class OTAsymmetricKey_Ed25519 : public OTAsymmetricKey
+{
+private:
+    typedef OTAsymmetricKey ot_super;
+    friend class OTAsymmetricKey; // For the factory.
+
+public:
+    virtual KeyType GetKeyType() const
+    {
+        return ED25519;
+    }
+
+    virtual bool LoadPrivateKeyFromCertString(
+        const String& strCert, bool bEscaped = true,
+        const String* pstrReason = nullptr,
+        const OTPassword* pImportPassword = nullptr);
+    virtual bool LoadPublicKeyFromCertString(
+        const String& strCert, bool bEscaped = true,
+        const String* pstrReason = nullptr,
+        const OTPassword* pImportPassword = nullptr);
+    virtual bool SaveCertToString(
+        String& strOutput, const String* pstrReason = nullptr,
+        const OTPassword* pImportPassword = nullptr) const;
+    virtual bool SavePrivateKeyToString(
+        String& strOutput, const String* pstrReason = nullptr,
+        const OTPassword* pImportPassword = nullptr) const;
+    virtual bool LoadPublicKeyFromPGPKey(const OTASCIIArmor& strKey);
+    virtual bool ReEncryptPrivateKey(const OTPassword& theExportPassword,
+                                     bool bImporting) const;
+
+    // Generates a new key and sets it onto both halves of a keypair.
+    static bool MakeNewKeypair(OTAsymmetricKey_Ed25519& thePublicKey,
+                               OTAsymmetricKey_Ed25519& thePrivateKey);
+
+    // The hash type of the contract is not used: Ed25519 always signs the
+    // whole message (hashing it internally with SHA-512.)
+    bool Sign(const String& strContents, OTSignature& theSignature,
+              const OTPasswordData* pPWData = nullptr);
+    bool Verify(const String& strContents,
+                const OTSignature& theSignature) const;
+
+    virtual void Release();
+
+protected:
+    OTAsymmetricKey_Ed25519();
+    virtual void ReleaseKeyLowLevel_Hook() const;
+
+public:
+    virtual ~OTAsymmetricKey_Ed25519();
+
+private:
+    // Decrypts the secret key, unless it is already in memory.
+    const OTPassword* GetSecretKey(const OTPasswordData* pPWData,
+                                   const OTPassword* pImportPassword = nullptr);
+
+    static bool Seal(const OTPassword& theSecretKey,
+                     const OTPassword& thePassphrase, OTASCIIArmor& ascOutput);
+    static bool Unseal(const OTASCIIArmor& ascInput,
+                       const OTPassword& thePassphrase,
+                       OTPassword& theSecretKey);
+
+    // Uses pImportPassword if there is one. Otherwise asks the password
+    // callback, exactly as OpenSSL would for an RSA key.
+    static bool GetPassphrase(const OTPasswordData& thePWData, bool bAskTwice,
+                              const OTPassword* pImportPassword,
+                              OTPassword& thePassphrase);
+
+    mutable OTPassword* m_pSecretKey;
+};
+
+#endif // OT_CRYPTO_SUPPORTED_KEY_ED25519
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTASYMMETRICKEYED25519_HPP
@@ -89,6 +89,11 @@ private:
     typedef OTAsymmetricKey ot_super;
     friend class OTAsymmetricKey; // For the factory.
 public:
+    virtual KeyType GetKeyType() const
+    {
+        return RSA;
+    }
+
     // Load Private Key From Cert String
     //
     // "escaped" means pre-pended with "- " as in:   - -----BEGIN
@@ -41,6 +41,8 @@
 
 #include "OTAsymmetricKeyOpenSSL.hpp"
 
+#include <future>
+
 extern "C" {
 #include <openssl/pem.h>
 #include <openssl/evp.h>
@@ -94,10 +96,18 @@ private:
     EVP_PKEY* m_pKey; // Instantiated form of key. (For private keys especially,
                       // we don't want it instantiated for any longer than
                       // absolutely necessary, when we have to use it.)
+    std::future<EVP_PKEY*> m_refresh; // REFRESH residency: the replacement
+                                      // for m_pKey, being decrypted.
     // PRIVATE METHODS
     EVP_PKEY* InstantiateKey(const OTPasswordData* pPWData = nullptr);
     EVP_PKEY* InstantiatePublicKey(const OTPasswordData* pPWData = nullptr);
     EVP_PKEY* InstantiatePrivateKey(const OTPasswordData* pPWData = nullptr);
+    static EVP_PKEY* ReadPrivateKey(const OTASCIIArmor& ascKey,
+                                    const OTPasswordData* pPWData);
+    // Installs a finished background refresh, or starts one once the timer
+    // has run out.
+    void RefreshKey(const OTPasswordData* pPWData);
+    void CancelRefresh();
     // HIGH LEVEL (internal) METHODS
     //
     EXPORT const EVP_PKEY* GetKey(const OTPasswordData* pPWData = nullptr);
@@ -0,0 +1,96 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTBASE64_HPP
+#define OPENTXS_CORE_CRYPTO_OTBASE64_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opentxs
+{
+
+class OTData;
+
+// Native base64 codec used for all ASCII armoring.
+//
+// Output is byte-for-byte what OpenSSL's BIO_f_base64 produced before it:
+// with bLineBreaks, a newline after every 64 characters and after the last
+// (partial) line; without, no newlines at all. Decoding accepts either layout
+// and skips any whitespace.
+//
+// On x86 the AVX2 or SSSE3 kernels are chosen at runtime, based on what the
+// CPU supports. Everywhere else (and for the leftovers at the end of each
+// line) the portable scalar code is used.
+//
+class OTBase64
+{
+public:
+    // Exact number of characters Encode will write (no null terminator.)
+    EXPORT static size_t EncodedSize(size_t lInputSize, bool bLineBreaks);
+
+    // Upper bound on the number of bytes Decode will write.
+    EXPORT static size_t DecodedSizeMax(size_t lInputSize);
+
+    // pOutput must have room for EncodedSize(lInputSize, bLineBreaks) chars.
+    // Returns the number of characters written.
+    EXPORT static size_t Encode(const uint8_t* pInput, size_t lInputSize,
+                                char* pOutput, bool bLineBreaks);
+
+    // Writes at most lCapacity bytes to pOutput. Fails on characters outside
+    // the base64 alphabet, on truncated input, or if lCapacity is too small.
+    EXPORT static bool Decode(const char* pInput, size_t lInputSize,
+                              uint8_t* pOutput, size_t lCapacity,
+                              size_t& lOutputSize);
+
+    // Decodes straight into theOutput's buffer. (bLineBreaks is only a hint
+    // for sizing that buffer; either layout decodes correctly.)
+    EXPORT static bool Decode(const char* pInput, size_t lInputSize,
+                              OTData& theOutput, bool bLineBreaks = true);
+
+    // "avx2", "ssse3" or "scalar"
+    EXPORT static const char* Implementation();
+
+    // For benchmarks and tests. Returns false if strName is unknown or not
+    // supported by this CPU. Not thread safe: call it before armoring starts.
+    EXPORT static bool SetImplementation(const char* szName);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTBASE64_HPP
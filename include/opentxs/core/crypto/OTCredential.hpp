@@ -163,9 +163,11 @@ private:
     void SetMasterCredID(const String& strID);    // The master credential ID is
                                                   // a hash of the master
                                                   // credential m_MasterKey
-    bool GenerateMasterkey(int32_t nBits = 1024); // CreateMaster is able to
-                                                  // create keys from scratch
-                                                  // (by calling this function.)
+    bool GenerateMasterkey(int32_t nBits = 1024, // CreateMaster is able to
+                                                 // create keys from scratch
+                                                 // (by calling this function.)
+                           OTAsymmetricKey::KeyType eSigningKeyType =
+                               OTAsymmetricKey::RSA);
     bool SignNewMaster(const OTPasswordData* pPWData = nullptr); // SignMaster
                                                                  // is used
     // when creating master
@@ -191,7 +193,9 @@ public:
                                                             // nullptr
                                       const String::Map* pmapPrivate = nullptr,
                                       const String::Map* pmapPublic = nullptr,
-                                      const OTPasswordData* pPWData = nullptr);
+                                      const OTPasswordData* pPWData = nullptr,
+                                      OTAsymmetricKey::KeyType eSigningKeyType =
+                                          OTAsymmetricKey::RSA);
     static OTCredential* LoadMaster(const String& strNymID, // Caller is
                                                             // responsible to
                                                             // delete, in both
@@ -220,7 +224,8 @@ public:
                                                   // from the private.
         const OTPasswordData* pPWData = nullptr, // The master key will sign the
                                                  // subkey.
-        OTSubkey* *ppSubkey = nullptr);          // output
+        OTSubkey* *ppSubkey = nullptr,           // output
+        OTAsymmetricKey::KeyType eSigningKeyType = OTAsymmetricKey::RSA);
     // For non-key credentials, such as for 3rd-party authentication.
     //
     EXPORT bool AddNewSubcredential(
@@ -41,6 +41,7 @@
 
 #include <opentxs/core/OTData.hpp>
 #include <opentxs/core/String.hpp>
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
 #include <opentxs/core/util/Assert.hpp>
 
 #include <mutex>
@@ -62,6 +63,20 @@ class OTSignature;
 
 typedef std::multimap<std::string, OTAsymmetricKey*> mapOfAsymmetricKeys;
 
+// One signature to make (or check) as part of a batch. Nothing is owned:
+// the contents, key and signature must outlive the job's future. When
+// verifying, the signature is only read.
+class OTSignatureJob
+{
+public:
+    const String* m_pContents;
+    const OTAsymmetricKey* m_pKey;
+    OTSignature* m_pSignature;
+    String m_strHashType;
+};
+
+typedef std::vector<OTSignatureJob> listOfSignatureJobs;
+
 class OTCryptoConfig
 {
 private:
@@ -202,10 +217,15 @@ public:
     // IS RESPONSIBLE TO DELETE!
     // Todo: return a smart pointer here.
     //
+    // bUseCache lets the result be kept in (and taken from)
+    // OTDerivedKeyCache. The master key passes false: its derived key must
+    // not outlive the master key's own timeout.
+    //
     virtual OTPassword* DeriveNewKey(const OTPassword& userPassword,
                                      const OTData& dataSalt,
                                      uint32_t uIterations,
-                                     OTData& dataCheckHash) const = 0;
+                                     OTData& dataCheckHash,
+                                     bool bUseCache) const = 0;
 
     // ENCRYPT / DECRYPT
     //
@@ -267,6 +287,23 @@ public:
         const String& strContractToVerify, const String& strSigHashType,
         const std::string& strCertFileContents, const OTSignature& theSignature,
         const OTPasswordData* pPWData = nullptr) const = 0;
+    // BATCHED SIGN / VERIFY
+    //
+    // The same as calling SignContract / VerifySignature once per job, but
+    // the engine may spread the work over OTCryptoPool. Returns one future
+    // per job, in the same order. The keys are instantiated on the calling
+    // thread, so don't use or release them until every future is ready.
+    //
+    // The base class runs each job in turn on the calling thread.
+    //
+    EXPORT virtual listOfCryptoFutures SignContracts(
+        const listOfSignatureJobs& theJobs,
+        const OTPasswordData* pPWData = nullptr);
+
+    EXPORT virtual listOfCryptoFutures VerifySignatures(
+        const listOfSignatureJobs& theJobs,
+        const OTPasswordData* pPWData = nullptr) const;
+
     EXPORT static OTCrypto* It();
 
     EXPORT void Init() const;
@@ -114,7 +114,8 @@ public:
     virtual OTPassword* DeriveNewKey(const OTPassword& userPassword,
                                      const OTData& dataSalt,
                                      uint32_t uIterations,
-                                     OTData& dataCheckHash) const;
+                                     OTData& dataCheckHash,
+                                     bool bUseCache) const;
     // ENCRYPT / DECRYPT
     // Symmetric (secret key) encryption / decryption
     virtual bool Encrypt(
@@ -170,6 +171,14 @@ public:
                                  const std::string& strCertFileContents,
                                  const OTSignature& theSignature,
                                  const OTPasswordData* pPWData = nullptr) const;
+    // Batched versions of the above, spread over OTCryptoPool.
+    virtual listOfCryptoFutures SignContracts(
+        const listOfSignatureJobs& theJobs,
+        const OTPasswordData* pPWData = nullptr);
+
+    virtual listOfCryptoFutures VerifySignatures(
+        const listOfSignatureJobs& theJobs,
+        const OTPasswordData* pPWData = nullptr) const;
     void thread_setup() const;
     void thread_cleanup() const;
 
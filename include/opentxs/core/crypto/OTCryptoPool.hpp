@@ -0,0 +1,91 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTCRYPTOPOOL_HPP
+#define OPENTXS_CORE_CRYPTO_OTCRYPTOPOOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace opentxs
+{
+
+typedef std::vector<std::future<bool>> listOfCryptoFutures;
+
+// OTCryptoPool is a fixed set of worker threads that OTCrypto hands batches
+// of signatures and verifications to, so that a request which has to sign
+// (or verify) several objects can do them all at once and wait once.
+//
+// A job must not submit further jobs and wait on them: with every thread
+// busy waiting, nothing would be left to run them.
+//
+// The threads are started on first use. With the thread count set to 0,
+// every job runs on the submitting thread, as if there were no pool.
+//
+class OTCryptoPool
+{
+public:
+    typedef std::function<bool()> Job;
+
+    // Queues theJob and returns its result.
+    EXPORT static std::future<bool> Submit(Job theJob);
+
+    // A future that already holds bResult, for work done on the spot.
+    EXPORT static std::future<bool> Ready(bool bResult);
+
+    // Waits for every future in the list. True only if all of them
+    // returned true.
+    EXPORT static bool WaitAll(listOfCryptoFutures& theFutures);
+
+    // Negative means one thread per core (the default).
+    EXPORT static int32_t GetThreads();
+    // Finishes any queued jobs before the new count takes effect.
+    EXPORT static void SetThreads(int32_t nThreads);
+
+    // Finishes queued jobs and joins the threads. The next Submit starts
+    // them again.
+    EXPORT static void Shutdown();
+
+    EXPORT static uint64_t JobsRun();
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTCRYPTOPOOL_HPP
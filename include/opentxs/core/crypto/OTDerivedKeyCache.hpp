@@ -0,0 +1,98 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTDERIVEDKEYCACHE_HPP
+#define OPENTXS_CORE_CRYPTO_OTDERIVEDKEYCACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+class OTData;
+class OTPassword;
+
+// OTDerivedKeyCache remembers keys that were derived from a passphrase, so
+// that unlocking the same OTSymmetricKey again (a purse, a wallet extra key,
+// an OTNymOrSymmetricKey) doesn't pay for PBKDF2 again.
+//
+// The crypto engine builds the key: a keyed digest over the salt, the
+// iteration count and the passphrase, where the digest key is random and
+// never leaves the process. The passphrase itself is not stored. Each entry
+// holds the derived key (in an OTPassword, so in locked memory) and its
+// hash check.
+//
+// Entries are wiped by a timer thread once they are older than the timeout,
+// the same way OTCachedKey wipes the master key:
+//   0  : nothing is cached, every unlock runs PBKDF2. (Paranoid.)
+//   300: a derived key lives for five minutes. (The default.)
+//   -1 : derived keys live until shutdown.
+//
+class OTDerivedKeyCache
+{
+public:
+    // Returns true (and counts a hit) if strKey is cached, with copies of
+    // the derived key and its hash check. Otherwise counts a miss.
+    EXPORT static bool Lookup(const std::string& strKey,
+                              OTPassword& theDerivedKey,
+                              OTData& theCheckHash);
+
+    // Remember a successful derivation. Does nothing while the timeout is 0.
+    EXPORT static void Insert(const std::string& strKey,
+                              const OTPassword& theDerivedKey,
+                              const OTData& theCheckHash);
+
+    // Wipes every entry.
+    EXPORT static void Clear();
+
+    // Wipes every entry and stops the timer thread. (OTCrypto::Cleanup)
+    EXPORT static void Shutdown();
+
+    // Changing the timeout wipes the cache.
+    EXPORT static int32_t GetTimeoutSeconds();
+    EXPORT static void SetTimeoutSeconds(int32_t nTimeoutSeconds);
+
+    EXPORT static int64_t Size();
+    EXPORT static uint64_t Hits();
+    EXPORT static uint64_t Misses();
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTDERIVEDKEYCACHE_HPP
@@ -0,0 +1,84 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTHASH160_HPP
+#define OPENTXS_CORE_CRYPTO_OTHASH160_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opentxs
+{
+
+// RIPEMD160(SHA256(x)), the 20 byte digest behind every Identifier.
+//
+// The SHA-256 half is where the time goes, so it has three implementations,
+// chosen at runtime: "shani" uses the x86 SHA extensions, "avx2" hashes up to
+// eight inputs side by side (one per 32 bit lane) when given a batch, and
+// "scalar" is the portable fallback. RIPEMD160 only ever sees one 32 byte
+// block, and is always scalar.
+//
+// Nothing here allocates: digests are written straight into the caller's
+// buffer.
+//
+class OTHash160
+{
+public:
+    static const size_t DigestSize = 20;
+
+    // pOutput must have room for DigestSize bytes.
+    EXPORT static void Digest(const uint8_t* pInput, size_t lSize,
+                              uint8_t* pOutput);
+
+    // Hashes nCount inputs at once. Digest i is written to
+    // pOutput + i * DigestSize.
+    EXPORT static void Digest(const uint8_t* const* ppInputs,
+                              const size_t* pSizes, size_t nCount,
+                              uint8_t* pOutput);
+
+    // "shani", "avx2" or "scalar"
+    EXPORT static const char* Implementation();
+
+    // For benchmarks and tests. Returns false if szName is unknown or not
+    // supported by this CPU. Not thread safe: call it before hashing starts.
+    EXPORT static bool SetImplementation(const char* szName);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTHASH160_HPP
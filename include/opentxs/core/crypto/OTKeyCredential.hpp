@@ -172,7 +172,11 @@ public:
                             // transmissions and stored files.
     OTKeypair m_EncryptKey; // Encryption keys, used for sealing/opening
                             // OTEnvelopes.
-    bool GenerateKeys(int32_t nBits = 1024); // Gotta start somewhere.
+    // eSigningKeyType applies to the signing and authentication keys. The
+    // encryption key is always RSA, since OTEnvelope needs one.
+    bool GenerateKeys(int32_t nBits = 1024, // Gotta start somewhere.
+                      OTAsymmetricKey::KeyType eSigningKeyType =
+                          OTAsymmetricKey::RSA);
     bool ReEncryptKeys(const OTPassword& theExportPassword,
                        bool bImporting); // Used when importing/exporting a Nym
                                          // to/from the wallet.
@@ -39,6 +39,8 @@
 #ifndef OPENTXS_CORE_CRYPTO_OTKEYPAIR_HPP
 #define OPENTXS_CORE_CRYPTO_OTKEYPAIR_HPP
 
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+
 #include <list>
 #include <cstdint>
 
@@ -102,8 +104,18 @@ class OTKeypair
     OTAsymmetricKey* m_pkeyPublic;  // This nym's public key
     OTAsymmetricKey* m_pkeyPrivate; // This nym's private key
 
+    // Replaces pKey with an empty key of eKeyType, unless it already is one.
+    static bool SetKeyType(OTAsymmetricKey*& pKey,
+                           OTAsymmetricKey::KeyType eKeyType);
+    // Same, for the type named by the bookends in strKey.
+    static bool SetKeyType(OTAsymmetricKey*& pKey, const String& strKey);
+
 public:
-    EXPORT bool MakeNewKeypair(int32_t nBits = 1024);
+    // nBits is ignored for Ed25519.
+    EXPORT bool MakeNewKeypair(
+        int32_t nBits = 1024,
+        OTAsymmetricKey::KeyType eKeyType = OTAsymmetricKey::RSA);
+    EXPORT OTAsymmetricKey::KeyType GetKeyType() const;
     EXPORT bool ReEncrypt(const OTPassword& theExportPassword, bool bImporting,
                           String& strOutput); // Used when importing/exporting
                                               // a Nym to/from the wallet.
@@ -0,0 +1,87 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
+#define OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+// OTSignatureCache remembers signatures that have already been verified, so
+// that loading the same account, box receipt or contract again doesn't pay
+// for another RSA verification.
+//
+// The crypto engine builds the key: a digest over the public key, the hash
+// type, the signed content and the signature itself. A hit therefore means
+// that exactly this signature, over exactly these bytes, already verified
+// against exactly this key. Only successful verifications are stored.
+//
+// The cache is a bounded LRU and is safe to use from several threads.
+// Paranoid deployments can switch it off in the config file, in which case
+// every signature is verified from scratch, as before.
+//
+class OTSignatureCache
+{
+public:
+    // Returns true (and counts a hit) if strKey was stored earlier.
+    // Otherwise counts a miss. Always false while the cache is disabled.
+    EXPORT static bool Lookup(const std::string& strKey);
+
+    // Remember a successful verification.
+    EXPORT static void Insert(const std::string& strKey);
+
+    EXPORT static void Clear();
+
+    EXPORT static bool IsEnabled();
+    EXPORT static void SetEnabled(bool bEnabled);
+
+    // Maximum number of entries. Shrinking it evicts the oldest entries.
+    EXPORT static int64_t GetCapacity();
+    EXPORT static void SetCapacity(int64_t lCapacity);
+
+    EXPORT static int64_t Size();
+    EXPORT static uint64_t Hits();
+    EXPORT static uint64_t Misses();
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_CRYPTO_OTSIGNATURECACHE_HPP
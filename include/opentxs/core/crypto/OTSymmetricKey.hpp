@@ -71,6 +71,8 @@ private:
     OTData m_dataEncryptedKey; // Stores only encrypted version of symmetric
                                // key.
     OTData m_dataHashCheck;
+    bool m_bCacheDerivedKey; // Whether derived keys may go in
+                             // OTDerivedKeyCache. (Not serialized.)
 
 public:
     // The highest-level possible interface (used by the API)
@@ -172,6 +174,14 @@ public:
     //
     EXPORT bool GenerateHashCheck(const OTPassword& thePassphrase);
 
+    // True by default. OTCachedKey turns it off for the master key, whose
+    // derived key must not outlive the master key's own timeout.
+    //
+    inline void SetCacheDerivedKey(bool bCache)
+    {
+        m_bCacheDerivedKey = bCache;
+    }
+
     EXPORT OTSymmetricKey();
     EXPORT OTSymmetricKey(const OTPassword& thePassword);
 
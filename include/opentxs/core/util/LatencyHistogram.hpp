@@ -0,0 +1,82 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_LATENCYHISTOGRAM_HPP
+#define OPENTXS_CORE_UTIL_LATENCYHISTOGRAM_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+// Counts latencies into buckets whose widths double: bucket 0 holds those
+// under 2 microseconds, bucket i those under 2^(i+1), and the last one
+// everything slower (over half a minute).
+class LatencyHistogram
+{
+public:
+    static const int32_t Buckets = 26;
+
+    EXPORT LatencyHistogram();
+
+    EXPORT void Add(int64_t lMicros);
+
+    int64_t TotalMicros() const
+    {
+        return m_lTotalMicros;
+    }
+
+    int64_t MaxMicros() const
+    {
+        return m_lMaxMicros;
+    }
+
+    // The bucket counts, comma separated, with trailing empty buckets left
+    // off.
+    EXPORT std::string FormatBuckets() const;
+
+private:
+    uint64_t m_buckets[Buckets];
+    int64_t m_lTotalMicros;
+    int64_t m_lMaxMicros;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_LATENCYHISTOGRAM_HPP
@@ -0,0 +1,163 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_LOGSINK_HPP
+#define OPENTXS_CORE_UTIL_LOGSINK_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace opentxs
+{
+
+// A bounded queue of log lines with any number of producers and the one
+// consumer thread. A producer claims a slot with a single compare-and-swap
+// and never waits; if the ring is full the line is dropped and counted.
+//
+// Each slot's sequence number says whose turn it is: equal to the claim
+// position when free, one past it once filled, and a lap further on once
+// the consumer has taken the line out.
+class LogRing
+{
+public:
+    // lCapacity must be a power of two.
+    EXPORT explicit LogRing(size_t lCapacity);
+
+    // False if the ring is full.
+    EXPORT bool Push(const char* szText, bool bMemlog);
+
+    // Consumer thread only. Swaps the line into strText, so the slot keeps
+    // the old buffer for the next producer to reuse.
+    EXPORT bool Pop(std::string& strText, bool& bMemlog);
+
+    size_t Capacity() const
+    {
+        return m_lCapacity;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> m_lSeq;
+        std::string m_strText;
+        bool m_bMemlog;
+    };
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    const size_t m_lCapacity;
+    std::unique_ptr<Slot[]> m_pSlots;
+    size_t m_lHead;
+    std::atomic<size_t> m_lTail;
+};
+
+// The log writer thread and the ring it drains.
+class LogSink
+{
+public:
+    // Called on the writer thread with each batch of lines.
+    typedef std::function<void(const std::string&)> Writer;
+
+    static const size_t RingSize = 8192;      // lines
+    static const size_t BatchBytes = 65536;   // written out in one go
+    static const int64_t IdleMilliseconds = 10;
+
+    // Without a writer, batches go to stderr and the logfile, and lines
+    // marked for it go to the memlog.
+    EXPORT explicit LogSink(size_t lRingSize = RingSize,
+                            Writer theWriter = Writer());
+    EXPORT ~LogSink();
+
+    // False if the writer thread isn't running and the caller should write
+    // the line itself. A dropped line still returns true.
+    EXPORT bool Push(const char* szText, bool bMemlog);
+
+    EXPORT void Start();
+
+    // Writes out everything queued before returning.
+    EXPORT void Stop();
+
+    // Waits, for at most a second, until everything queued so far has been
+    // written. (Bounded, since this is also called on the way to an abort.)
+    EXPORT void Flush();
+
+    // Lines lost to a full ring since construction.
+    uint64_t Dropped() const
+    {
+        return m_lDropped;
+    }
+
+private:
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    void Run();
+    void Write(std::ofstream& logfile, const std::string& strBatch);
+
+    LogRing m_theRing;
+    Writer m_theWriter;
+    std::atomic<bool> m_bRunning;
+    std::atomic<int32_t> m_nPushing;
+    std::atomic<bool> m_bIdle;
+    std::atomic<uint64_t> m_lQueued;
+    std::atomic<uint64_t> m_lWritten;
+    std::atomic<uint64_t> m_lDropped;
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;
+    std::condition_variable m_cvWritten;
+    std::thread m_theThread;
+    // Until Run() returns. Stop() moves m_theThread out before that, so
+    // Flush() can't go by whether it is joinable.
+    bool m_bWriterRunning;
+    std::thread::id m_writerID;
+    bool m_bStopping;
+    uint64_t m_lDroppedReported; // writer thread only
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_LOGSINK_HPP
@@ -98,6 +98,7 @@ private:
     static String s_strCredential;
     static String s_strCron;
     static String s_strInbox;
+    static String s_strMail;
     static String s_strMarket;
     static String s_strMint;
     static String s_strNym;
@@ -113,6 +114,7 @@ private:
     static String s_strScript;
     static String s_strSmartContracts;
     static String s_strSpent;
+    static String s_strStats;
     static String s_strUserAcct;
 
 public:
@@ -122,6 +124,7 @@ public:
     EXPORT static const String& Credential();
     EXPORT static const String& Cron();
     EXPORT static const String& Inbox();
+    EXPORT static const String& Mail();
     EXPORT static const String& Market();
     EXPORT static const String& Mint();
     EXPORT static const String& Nym();
@@ -137,6 +140,7 @@ public:
     EXPORT static const String& Script();
     EXPORT static const String& SmartContracts();
     EXPORT static const String& Spent();
+    EXPORT static const String& Stats();
     EXPORT static const String& UserAcct();
 };
 
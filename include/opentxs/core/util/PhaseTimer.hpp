@@ -0,0 +1,88 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_PHASETIMER_HPP
+#define OPENTXS_CORE_UTIL_PHASETIMER_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace opentxs
+{
+
+// PhaseTimer splits the wall time a thread spends between Begin() and End()
+// into phases. The code that verifies, signs, loads and saves opens a Scope
+// for its phase; time spent outside any Scope counts as PROCESS. Scopes
+// nest, and each moment is charged to the innermost one, so the phases add
+// up to the total.
+//
+// While no Begin() is active on the thread, a Scope only tests a flag.
+//
+class PhaseTimer
+{
+public:
+    enum Phase { PROCESS, VERIFY, LOAD, SIGN, SAVE, PHASE_COUNT };
+
+    // Nanoseconds per phase.
+    typedef std::array<int64_t, PHASE_COUNT> Durations;
+
+    class Scope
+    {
+    public:
+        EXPORT explicit Scope(Phase ePhase);
+        EXPORT ~Scope();
+
+    private:
+        Phase m_ePrevious;
+        bool m_bActive;
+
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    // Starts timing on the calling thread, discarding anything before.
+    EXPORT static void Begin();
+    // Stops timing on the calling thread and returns the time per phase.
+    EXPORT static Durations End();
+
+    EXPORT static const char* Name(Phase ePhase);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_PHASETIMER_HPP
@@ -0,0 +1,97 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_TRACE_HPP
+#define OPENTXS_CORE_UTIL_TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace opentxs
+{
+
+// Trace records a timeline of nested spans for one request on one thread,
+// and writes it out as Chrome trace-event JSON (load it in chrome://tracing
+// or Perfetto.) Requests are sampled: with a sample rate of N, Begin()
+// traces one request in N, and 0 turns tracing off.
+//
+// A Span on a thread that isn't being traced only tests a flag, so the
+// spans can stay in the load, save, sign and verify paths.
+//
+class Trace
+{
+public:
+    class Span
+    {
+    public:
+        EXPORT explicit Span(const char* szName);
+        EXPORT ~Span();
+
+        // Build arguments only when this is true.
+        bool Active() const
+        {
+            return m_bActive;
+        }
+
+        // Shown with the span in the trace viewer.
+        EXPORT void Arg(const char* szKey, const std::string& strValue);
+
+    private:
+        size_t m_lEvent;
+        bool m_bActive;
+
+        Span(const Span&);
+        Span& operator=(const Span&);
+    };
+
+    // Spans beyond this many in one trace are dropped (and counted.)
+    static const size_t MaxSpans = 20000;
+
+    EXPORT static int32_t GetSampleRate();
+    EXPORT static void SetSampleRate(int32_t nRate);
+
+    // Decides whether to trace the request about to run on this thread.
+    EXPORT static bool Begin();
+    // Stops tracing on this thread. If it was being traced, puts the trace
+    // into strJson and returns true.
+    EXPORT static bool End(std::string& strJson);
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_TRACE_HPP
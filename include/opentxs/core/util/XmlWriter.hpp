@@ -0,0 +1,112 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_XMLWRITER_HPP
+#define OPENTXS_CORE_UTIL_XMLWRITER_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opentxs
+{
+
+// XmlWriter streams elements straight into a caller's string, instead of
+// building a tree of Tags and flattening it afterwards. The output is byte for
+// byte what Tag::output() produces for the same calls:
+//
+//     - attributes are written sorted by name, one per line, and if a name
+//       is added twice the first value wins;
+//     - an element with neither text nor children is written as <name />;
+//     - text and children are followed by "\n</name>\n".
+//
+// That means an element's attributes are held back until its first child or
+// text (or its close), so all of them must be added before either. The storage
+// for them is reused from element to element, so a writer doesn't allocate
+// per element once it has warmed up.
+//
+// A '"' in an attribute value is written as &quot; (Tag wrote it raw, which
+// produced unreadable XML.) Everything else is written exactly as given.
+//
+class XmlWriter
+{
+public:
+    // Output is appended to str_output, which must outlive the writer.
+    explicit XmlWriter(std::string& str_output);
+
+    void open_element(const std::string& str_name);
+    void add_attribute(const std::string& str_name,
+                       const std::string& str_value);
+    void add_attribute(const std::string& str_name, const char* sz_value);
+    // The text content of the open element. (An element has either text or
+    // child elements, never both.)
+    void set_text(const std::string& str_text);
+    void set_text(const char* sz_text);
+    void close_element();
+
+    // An element holding only text: same as Tag::add_tag(name, text).
+    void add_element(const std::string& str_name, const std::string& str_text);
+    void add_element(const std::string& str_name, const char* sz_text);
+
+    // Number of elements still open.
+    size_t depth() const
+    {
+        return open_;
+    }
+
+private:
+    typedef std::pair<std::string, std::string> Attribute;
+
+    XmlWriter(const XmlWriter&) = delete;
+    XmlWriter& operator=(const XmlWriter&) = delete;
+
+    void write_start_tag(const std::string& str_name);
+    void start_content();
+
+    std::string& output_;
+    std::vector<std::string> names_; // of the open elements (and spares)
+    size_t open_;
+    std::vector<Attribute> attributes_;
+    size_t attribute_count_;
+    bool start_tag_pending_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_CORE_UTIL_XMLWRITER_HPP
@@ -63,7 +63,8 @@ public:
 
 private:
     void init(int port, zcert_t* transportKey);
-    bool processMessage(const std::string& messageString, std::string& reply);
+    bool processMessage(const void* requestData, size_t requestSize,
+                        std::string& reply);
     void processSocket();
 
 private:
@@ -87,11 +87,49 @@ struct ServerSettings
         __override_nym_id = id;
     }
 
+    static bool GetBinaryFraming()
+    {
+        return __binary_framing;
+    }
+
+    static void SetBinaryFraming(bool value)
+    {
+        __binary_framing = value;
+    }
+
+    static int32_t GetStatsDumpInterval()
+    {
+        return __stats_dump_interval;
+    }
+
+    static void SetStatsDumpInterval(int32_t value)
+    {
+        __stats_dump_interval = value;
+    }
+
+    static int32_t GetTraceMaxFiles()
+    {
+        return __trace_max_files;
+    }
+
+    static void SetTraceMaxFiles(int32_t value)
+    {
+        __trace_max_files = value;
+    }
+
     static int64_t __min_market_scale;
 
     static int32_t __heartbeat_no_requests;
     static int32_t __heartbeat_ms_between_beats;
 
+    // Whether clients may use the binary wire framing (see OTWireFormat.)
+    static bool __binary_framing;
+
+    // Seconds between writes of the command statistics to disk (0: never.)
+    static int32_t __stats_dump_interval;
+    // How many sampled request traces to keep in stats/traces.
+    static int32_t __trace_max_files;
+
     // The Nym who's allowed to do certain commands even if they are turned off.
     static std::string __override_nym_id;
     // Are usage credits REQUIRED in order to use this server?
@@ -146,6 +184,7 @@ struct ServerSettings
     static bool __transact_cancel_cron_item;
     static bool __transact_smart_contract;
     static bool __cmd_trigger_clause;
+    static bool __cmd_get_server_stats;
 };
 
 } // namespace opentxs
@@ -0,0 +1,87 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_SERVER_SERVERSTATS_HPP
+#define OPENTXS_SERVER_SERVERSTATS_HPP
+
+#include <opentxs/core/util/LatencyHistogram.hpp>
+#include <opentxs/core/util/PhaseTimer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace opentxs
+{
+
+class String;
+
+// Request counts, error counts and latency histograms for each user command,
+// with the latency also broken down by PhaseTimer phase. The server handles
+// one request at a time, so there is no locking.
+class ServerStats
+{
+public:
+    ServerStats();
+
+    void Record(const std::string& command, bool success,
+                const PhaseTimer::Durations& durations);
+
+    // Everything recorded since startup, as XML, followed by the storage
+    // counters (see OTDB::StorageStats.)
+    void Serialize(String& output) const;
+
+private:
+    struct CommandStats
+    {
+        uint64_t count_;
+        uint64_t errors_;
+        LatencyHistogram total_;
+        LatencyHistogram phases_[PhaseTimer::PHASE_COUNT];
+
+        CommandStats();
+    };
+
+    std::map<std::string, CommandStats> commands_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_SERVER_SERVERSTATS_HPP
@@ -40,9 +40,11 @@
 #define OPENTXS_SERVER_TRANSACTOR_HPP
 
 #include <opentxs/core/AccountList.hpp>
+#include <opentxs/core/OTID.hpp>
 #include <string>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <cstdint>
 
 namespace opentxs
@@ -140,8 +142,11 @@ private:
     // to
     // accidentally remove one from the list every time another is added. Thus
     // multimap is employed.
-    typedef std::multimap<std::string, Mint*> MintsMap;
-    typedef std::map<std::string, AssetContract*> ContractsMap;
+    //
+    // Both are looked up on every transaction involving an instrument
+    // definition, so they are hashed on the binary ID.
+    typedef std::unordered_multimap<OTID, Mint*> MintsMap;
+    typedef std::unordered_map<OTID, AssetContract*> ContractsMap;
     typedef std::map<std::string, std::string> BasketsMap;
 
 private:
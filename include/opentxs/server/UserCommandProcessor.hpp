@@ -39,7 +39,13 @@
 #ifndef OPENTXS_SERVER_USERCOMMANDPROCESSOR_HPP
 #define OPENTXS_SERVER_USERCOMMANDPROCESSOR_HPP
 
+#include "ServerStats.hpp"
+
+#include <chrono>
 #include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace opentxs
 {
@@ -52,13 +58,50 @@ class ClientConnection;
 
 class UserCommandProcessor
 {
+    friend class Test_UserCommandProcessor; // unit tests
+
 public:
     UserCommandProcessor(OTServer* server);
 
     bool ProcessUserCommand(Message& msgIn, Message& msgOut,
                             ClientConnection* connection, Nym* nym);
 
+    // Writes the command statistics to the stats folder, if the configured
+    // interval has passed since the last time.
+    void DumpStats();
+
 private:
+    typedef void (UserCommandProcessor::*Handler)(Nym&, Message&, Message&);
+
+    // A command that needs an authenticated Nym. The Nym must be allowed
+    // every permission listed, or with byDepth, the one picked by the
+    // message's depth.
+    struct UserCommand
+    {
+        Handler handler;
+        std::vector<const bool*> permissions;
+        bool byDepth;
+    };
+
+    void AddCommand(const std::string& name, Handler handler,
+                    std::vector<const bool*> permissions, bool byDepth = false);
+
+    bool ProcessCommand(Message& msgIn, Message& msgOut,
+                        ClientConnection* connection, Nym* nym);
+
+    // Checks the sender's permissions for the command, then runs it. False
+    // if the sender isn't allowed; true otherwise, even when the depth picks
+    // no box and nothing runs.
+    bool RunCommand(const UserCommand& command, Nym& nym, Message& msgIn,
+                    Message& msgOut);
+
+    // Commands missing from the table are recorded as "unknown".
+    void RecordStats(const std::string& command, bool success,
+                     const PhaseTimer::Durations& durations);
+
+    // Ends the trace of the current request and writes it to stats/traces.
+    void SaveTrace();
+
     bool SendMessageToNym(const Identifier& notaryID,
                           const Identifier& senderNymID,
                           const Identifier& recipientNymID,
@@ -82,14 +125,15 @@ private:
     void UserCmdRegisterInstrumentDefinition(Nym& nym, Message& msgIn,
                                              Message& msgOut);
     void UserCmdIssueBasket(Nym& nym, Message& msgIn, Message& msgOut);
-    void UserCmdGetBoxReceipt(Message& msgIn, Message& msgOut);
+    void UserCmdGetBoxReceipt(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdDeleteUser(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdDeleteAssetAcct(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdRegisterAccount(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdNotarizeTransaction(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdGetNymbox(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdGetAccountData(Nym& nym, Message& msgIn, Message& msgOut);
-    void UserCmdGetInstrumentDefinition(Message& msgIn, Message& msgOut);
+    void UserCmdGetInstrumentDefinition(Nym& nym, Message& msgIn,
+                                        Message& msgOut);
     void UserCmdGetMint(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdProcessInbox(Nym& nym, Message& msgIn, Message& msgOut);
     void UserCmdProcessNymbox(Nym& nym, Message& msgIn, Message& msgOut);
@@ -113,8 +157,15 @@ private:
     // Get the offers that a specific Nym has placed on a specific market.
     void UserCmdGetNymMarketOffers(Nym& nym, Message& msgIn, Message& msgOut);
 
+    // Request counts and latencies for every command since startup.
+    void UserCmdGetServerStats(Nym& nym, Message& msgIn, Message& msgOut);
+
 private:
     OTServer* server_;
+    std::map<std::string, UserCommand> commands_;
+    ServerStats stats_;
+    std::chrono::steady_clock::time_point lastStatsDump_;
+    int32_t tracesSaved_;
 };
 
 } // namespace opentxs
@@ -15240,6 +15240,25 @@ int32_t OTAPI_Exec::getMarketList(const std::string& NOTARY_ID,
     return OTAPI()->getMarketList(theNotaryID, theNymID);
 }
 
+// Returns int32_t: the same as getMarketList.
+//
+int32_t OTAPI_Exec::getServerStats(const std::string& NOTARY_ID,
+                                   const std::string& NYM_ID) const
+{
+    if (NOTARY_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NOTARY_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (NYM_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NYM_ID passed in!\n";
+        return OT_ERROR;
+    }
+
+    const Identifier theNotaryID(NOTARY_ID), theNymID(NYM_ID);
+
+    return OTAPI()->getServerStats(theNotaryID, theNymID);
+}
+
 // Returns int32_t:
 // -1 means error; no message was sent.
 //  0 means NO error, but also: no message was sent.
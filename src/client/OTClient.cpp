@@ -62,6 +62,7 @@
 #include <opentxs/core/OTData.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/OTServerContract.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/trade/OTOffer.hpp>
@@ -2227,6 +2228,12 @@ void OTClient::ProcessIncomingTransactions(OTServerConnection& theConnection,
                 OTDB::StorePlainString(
                     strFinal.Get(), OTFolders::Receipt().Get(),
                     strNotaryID.Get(), strReceiptFilename.Get());
+
+                // If the statement went out compact, the full one becomes the
+                // one this receipt is checked with.
+                OTStatementDigest::ResolvePending(
+                    NOTARY_ID, strReceiptID, pTransaction->GetTransactionNum(),
+                    pTransaction->GetSuccess());
             }
             else // This should never happen...
             {
@@ -6438,6 +6445,11 @@ bool OTClient::processServerReplyProcessInbox(const Message& theReply,
                         OTDB::StorePlainString(
                             strFinal.Get(), OTFolders::Receipt().Get(),
                             strNotaryID.Get(), strReceiptFilename.Get());
+
+                        OTStatementDigest::ResolvePending(
+                            NOTARY_ID, strReceiptID,
+                            pReplyTransaction->GetTransactionNum(),
+                            pReplyTransaction->GetSuccess());
                     }
                     else // This should never happen...
                     {
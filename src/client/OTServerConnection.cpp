@@ -60,6 +60,7 @@ int  OTServerConnection::s_linger          = CLIENT_SOCKET_LINGER;
 int  OTServerConnection::s_send_timeout    = CLIENT_SEND_TIMEOUT;
 int  OTServerConnection::s_recv_timeout    = CLIENT_RECV_TIMEOUT;
 bool OTServerConnection::s_bNetworkFailure = false;
+OTWireFormat::Framing OTServerConnection::s_framing = OTWireFormat::BINARY;
     
 int OTServerConnection::getLinger()
 {
@@ -90,6 +91,16 @@ void OTServerConnection::setRecvTimeout(int nIn)
 {
     s_recv_timeout = nIn;
 }
+
+OTWireFormat::Framing OTServerConnection::getFraming()
+{
+    return s_framing;
+}
+
+void OTServerConnection::setFraming(OTWireFormat::Framing theFraming)
+{
+    s_framing = theFraming;
+}
  
 // This returns m_bNetworkFailure
 bool OTServerConnection::networkFailure()
@@ -116,6 +127,7 @@ OTServerConnection::OTServerConnection(OTClient* theClient,
     , m_pServerContract(nullptr)
     , m_pClient(theClient)
     , m_endpoint(endpoint)
+    , m_framing(OTServerConnection::getFraming())
 {
     if (!zsys_has_curve()) {
         Log::vError("Error: libzmq has no libsodium support");
@@ -238,50 +250,41 @@ void OTServerConnection::send(OTServerContract* pServerContract, Nym* pNym,
 
 bool OTServerConnection::send(const String& theString)
 {
-    OTASCIIArmor ascEnvelope(theString);
+    std::string request;
 
-    if (!ascEnvelope.Exists()) {
+    if (!OTWireFormat::Encode(theString, m_framing, request)) {
         return false;
     }
-    
+
     s_bNetworkFailure = false;
 
-    int rc = zstr_send(socket_zmq, ascEnvelope.Get());
+    std::string rawServerReply;
 
-    if (rc != 0) {
-        s_bNetworkFailure = true;
-        otErr << __FUNCTION__
-              << ": Failed while trying to send message to server.\n";
-        
-        resetSocket();
-        
+    if (!exchange(request, rawServerReply)) {
         return false;
     }
-//  else
-//      otErr << __FUNCTION__ << ": DEBUGGING!!!! SUCCESSFULLY SENT. \n";
 
-    
-    std::string rawServerReply;
-    bool bSuccessReceiving = receive(rawServerReply);
+    // Servers that predate binary framing (or have it turned off) answer a
+    // binary request with an empty reply, without processing it. So it's
+    // safe to send the same message again, armored, and to stick with that
+    // for the rest of this connection.
+    if ((OTWireFormat::BINARY == m_framing) && rawServerReply.empty()) {
+        otWarn << __FUNCTION__ << ": Server at " << m_endpoint
+               << " doesn't accept binary framing. Using armored messages.\n";
 
-    if (!bSuccessReceiving) {
-        s_bNetworkFailure = true;
-        otErr << __FUNCTION__ << ": Failed trying to receive expected reply "
-                                 "from server.\n";
-        
-        resetSocket();
-        
-        return false;
-    }
-//    else
-//        otErr << __FUNCTION__ << ": DEBUGGING!!!! SUCCESSFULLY RECEIVED. \n";
+        m_framing = OTWireFormat::ARMORED;
 
-    
-    OTASCIIArmor ascServerReply;
-    ascServerReply.Set(rawServerReply.c_str());
+        if (!OTWireFormat::Encode(theString, m_framing, request) ||
+            !exchange(request, rawServerReply)) {
+            return false;
+        }
+    }
 
     String strServerReply;
-    bool bRetrievedReply = ascServerReply.GetString(strServerReply);
+    OTWireFormat::Framing replyFraming = OTWireFormat::ARMORED;
+    bool bRetrievedReply =
+        OTWireFormat::Decode(rawServerReply.data(), rawServerReply.size(),
+                             strServerReply, replyFraming);
 
     // todo: use a unique_ptr  soon as feasible.
     std::shared_ptr<Message> pServerReply(new Message());
@@ -294,6 +297,12 @@ bool OTServerConnection::send(const String& theString)
         // Client takes ownership and will
         m_pClient->processServerReply(pServerReply);
     }
+    else if (OTWireFormat::BINARY == replyFraming) {
+        otErr << __FUNCTION__ << ": Error loading binary server reply ("
+              << rawServerReply.size() << " bytes):\n\n" << strServerReply
+              << "\n\n";
+        return false;
+    }
     else {
         otErr << __FUNCTION__ << ": Error loading server reply from string:\n\n"
               << rawServerReply << "\n\n";
@@ -303,12 +312,47 @@ bool OTServerConnection::send(const String& theString)
     return true;
 }
 
+// Sends one request frame and waits for the reply frame.
+bool OTServerConnection::exchange(const std::string& request,
+                                  std::string& reply)
+{
+    zframe_t* frame = zframe_new(request.data(), request.size());
+    int rc = zframe_send(&frame, socket_zmq, 0);
+
+    if (rc != 0) {
+        zframe_destroy(&frame);
+        s_bNetworkFailure = true;
+        otErr << __FUNCTION__
+              << ": Failed while trying to send message to server.\n";
+        
+        resetSocket();
+        
+        return false;
+    }
+
+    bool bSuccessReceiving = receive(reply);
+
+    if (!bSuccessReceiving) {
+        s_bNetworkFailure = true;
+        otErr << __FUNCTION__ << ": Failed trying to receive expected reply "
+                                 "from server.\n";
+        
+        resetSocket();
+        
+        return false;
+    }
+
+    return true;
+}
+
 bool OTServerConnection::receive(std::string& serverReply)
 {
-    char* msg = zstr_recv(socket_zmq);
-    if (msg == nullptr) return false;
-    serverReply.assign(msg);
-    zstr_free(&msg);
+    // A frame rather than a string: binary replies may contain null bytes.
+    zframe_t* frame = zframe_recv(socket_zmq);
+    if (frame == nullptr) return false;
+    serverReply.assign(reinterpret_cast<const char*>(zframe_data(frame)),
+                       zframe_size(frame));
+    zframe_destroy(&frame);
     return true;
 }
 
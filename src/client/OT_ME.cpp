@@ -2297,6 +2297,8 @@ bool OT_ME::Register_API_With_Script_Chai(const OTScriptChai& theScript) const
                             "OT_API_issueMarketOffer");
         theScript.chai->add(fun(&OTAPI_Wrap::getMarketList),
                             "OT_API_getMarketList");
+        theScript.chai->add(fun(&OTAPI_Wrap::getServerStats),
+                            "OT_API_getServerStats");
         theScript.chai->add(fun(&OTAPI_Wrap::getMarketOffers),
                             "OT_API_getMarketOffers");
         theScript.chai->add(fun(&OTAPI_Wrap::getMarketRecentTrades),
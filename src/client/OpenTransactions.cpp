@@ -62,13 +62,20 @@
 #include <opentxs/core/script/OTSmartContract.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/trade/OTOffer.hpp>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/NumList.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
+#include <opentxs/core/OTWireFormat.hpp>
 #include <opentxs/core/crypto/OTAsymmetricKey.hpp>
 #include <opentxs/core/crypto/OTCachedKey.hpp>
 #include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/crypto/OTNymOrSymmetricKey.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
 #include <opentxs/core/crypto/OTSymmetricKey.hpp>
 #include <opentxs/core/AssetContract.hpp>
 #include <opentxs/core/Cheque.hpp>
@@ -84,6 +91,8 @@
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/OTServerContract.hpp>
 #include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/OTStorageCache.hpp>
+#include <opentxs/core/OTStorageStats.hpp>
 
 #if defined(OT_KEYRING_FLATFILE)
 #include <opentxs/core/crypto/OTKeyring.hpp>
@@ -770,6 +779,53 @@ std::shared_ptr<OTSettings> OT_API::LoadConfigFile()
         Log::SetLogLevel(static_cast<int32_t>(lValue));
     }
 
+    {
+        const char* szComment =
+            "; async_log hands log lines to a background writer thread, so a\n"
+            "; slow terminal or pipe can't hold up the caller. Lines are\n"
+            "; dropped, and counted, if they come faster than it can write.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("logging", "async_log", Log::GetAsync(),
+                                bValue, bIsNewKey, szComment);
+        Log::SetAsync(bValue);
+    }
+
+    {
+        const char* szComment =
+            "; slow_op_ms: storage reads and writes that take at least this\n"
+            "; many milliseconds are logged with their path. 0 turns it off.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("storage", "slow_op_ms",
+                                OTDB::StorageStats::GetSlowThreshold(), lValue,
+                                bIsNewKey, szComment);
+        OTDB::StorageStats::SetSlowThreshold(lValue);
+    }
+
+    {
+        const char* szComment =
+            "; cache_bytes: room for recently read files, so that reading one\n"
+            "; again costs a stat() rather than a read. Files in the folders\n"
+            "; listed in cache_pinned (comma separated, e.g. contracts,mints)\n"
+            "; are kept regardless. 0 caches only the pinned folders.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("storage", "cache_bytes",
+                                OTDB::StorageCache::GetMaxBytes(), lValue,
+                                bIsNewKey, szComment);
+        OTDB::StorageCache::SetMaxBytes(lValue);
+
+        String strValue;
+        p_Config->CheckSet_str("storage", "cache_pinned",
+                               OTDB::StorageCache::GetPinnedFolders().c_str(),
+                               strValue, bIsNewKey);
+        OTDB::StorageCache::SetPinnedFolders(strValue.Get());
+    }
+
     // WALLET
 
     // WALLET FILENAME
@@ -817,8 +873,185 @@ std::shared_ptr<OTSettings> OT_API::LoadConfigFile()
         OTServerConnection::setRecvTimeout(static_cast<int>(lValue));
     }
     
+    // ARMOR
+    {
+        const char* szComment =
+            ";; ARMOR (compression of armored messages, ledgers, receipts...)\n"
+            "; codec is one of: zlib, stored, zlib_dictionary.\n"
+            "; Only zlib can be read by peers older than the armor header,\n"
+            "; so don't change it until your servers have upgraded.\n"
+            "; compression_level is the zlib level, 0 (none) through 9 (best).\n"
+            "; Payloads smaller than stored_threshold bytes are not "
+            "compressed.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str(
+            "armor", "codec",
+            OTArmorCodec::CodecToString(OTArmorCodec::GetCodec()), strValue,
+            bIsNewKey, szComment);
+
+        OTArmorCodec::Codec theCodec = OTArmorCodec::GetCodec();
+        if (OTArmorCodec::CodecFromString(strValue.Get(), theCodec))
+            OTArmorCodec::SetCodec(theCodec);
+        else
+            otErr << __FUNCTION__ << ": Unknown armor codec: " << strValue
+                  << "\n";
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "compression_level",
+                                OTArmorCodec::GetCompressionLevel(), lValue,
+                                bIsNewKey);
+        OTArmorCodec::SetCompressionLevel(static_cast<int32_t>(lValue));
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "stored_threshold",
+                                OTArmorCodec::GetStoredThreshold(), lValue,
+                                bIsNewKey);
+        OTArmorCodec::SetStoredThreshold(lValue);
+    }
+
+    // WIRE
+    {
+        const char* szComment =
+            ";; WIRE (framing of requests sent to the server)\n"
+            "; framing is binary or armored. Binary skips the base64 round "
+            "trip;\n"
+            "; servers that don't support it are detected, and get armored\n"
+            "; messages instead. compress packs binary frames with the armor\n"
+            "; compression settings above.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str(
+            "wire", "framing",
+            OTWireFormat::FramingToString(OTServerConnection::getFraming()),
+            strValue, bIsNewKey, szComment);
+
+        OTWireFormat::Framing theFraming = OTServerConnection::getFraming();
+        if (OTWireFormat::FramingFromString(strValue.Get(), theFraming))
+            OTServerConnection::setFraming(theFraming);
+        else
+            otErr << __FUNCTION__ << ": Unknown wire framing: " << strValue
+                  << "\n";
+    }
+
+    {
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "compress", OTWireFormat::GetCompress(),
+                                bValue, bIsNewKey);
+        OTWireFormat::SetCompress(bValue);
+    }
+
+    {
+        const char* szComment =
+            "; numlist_ranges writes runs of transaction numbers as "
+            "first-last.\n"
+            "; Turn it off while peers older than the range encoding are "
+            "still\n"
+            "; around, since they can't parse it.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "numlist_ranges",
+                                NumList::GetRangeOutput(), bValue, bIsNewKey,
+                                szComment);
+        NumList::SetRangeOutput(bValue);
+    }
+
+    {
+        const char* szComment =
+            "; compact_statements sends balance and transaction statements as\n"
+            "; a hash of the issued numbers and receipts, instead of the full\n"
+            "; lists. Leave it off for servers older than statement version "
+            "2.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "compact_statements",
+                                OTStatementDigest::IsEnabled(), bValue,
+                                bIsNewKey, szComment);
+        OTStatementDigest::SetEnabled(bValue);
+    }
+
     // SECURITY (beginnings of..)
 
+    // Signature Cache
+    {
+        const char* szComment =
+            "; signature_cache remembers signatures that already verified, so\n"
+            "; reloading the same account, receipt or contract doesn't verify\n"
+            "; it again. Set it to false to verify every signature, every\n"
+            "; time.\n"
+            "; signature_cache_size is the maximum number of entries.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("security", "signature_cache",
+                                OTSignatureCache::IsEnabled(), bValue,
+                                bIsNewKey, szComment);
+        OTSignatureCache::SetEnabled(bValue);
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("security", "signature_cache_size",
+                                OTSignatureCache::GetCapacity(), lValue,
+                                bIsNewKey);
+        OTSignatureCache::SetCapacity(lValue);
+    }
+
+    // Crypto Thread Pool
+    {
+        const char* szComment =
+            "; pool_threads is how many threads sign and verify batches of\n"
+            "; signatures (for example every item in a transaction).\n"
+            "; -1 : one per core.\n"
+            "; 0  : no pool, everything is done on the calling thread.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("crypto", "pool_threads",
+                                OTCryptoPool::GetThreads(), lValue, bIsNewKey,
+                                szComment);
+        OTCryptoPool::SetThreads(static_cast<int32_t>(lValue));
+    }
+
+    // Private Key Residency
+    {
+        const char* szComment =
+            "; key_residency controls how long a decrypted private key stays\n"
+            "; in memory. timed (the default) wipes it after a few seconds and\n"
+            "; decrypts it again on next use. resident keeps it until shutdown\n"
+            "; (or until the master key goes away). refresh keeps it ready and\n"
+            "; re-decrypts it on a background thread when the timer runs out.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str(
+            "security", "key_residency",
+            OTAsymmetricKey::KeyResidencyToString(
+                OTAsymmetricKey::GetKeyResidency()),
+            strValue, bIsNewKey, szComment);
+
+        OTAsymmetricKey::KeyResidency theResidency =
+            OTAsymmetricKey::GetKeyResidency();
+        if (OTAsymmetricKey::KeyResidencyFromString(strValue.Get(),
+                                                    theResidency))
+            OTAsymmetricKey::SetKeyResidency(theResidency);
+        else
+            otErr << __FUNCTION__ << ": Unknown key residency: " << strValue
+                  << "\n";
+    }
+
     // Master Key Timeout
     {
         const char* szComment =
@@ -838,6 +1071,24 @@ std::shared_ptr<OTSettings> OT_API::LoadConfigFile()
         OTCachedKey::It()->SetTimeoutSeconds(static_cast<int32_t>(lValue));
     }
 
+    // Derived Key Cache
+    {
+        const char* szComment =
+            "; derived_key_timeout is how long a key derived from a\n"
+            "; passphrase (for a purse or other symmetric key) stays in\n"
+            "; memory, so unlocking the same key again skips the derivation.\n"
+            "; 0   : don't cache derived keys.\n"
+            "; 300 : keep each one for 5 minutes.\n"
+            "; -1  : keep them until shutdown.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("security", "derived_key_timeout",
+                                OTDerivedKeyCache::GetTimeoutSeconds(), lValue,
+                                bIsNewKey, szComment);
+        OTDerivedKeyCache::SetTimeoutSeconds(static_cast<int32_t>(lValue));
+    }
+
     // Use System Keyring
     // NOTE I commented this out because it seems identical to the next piece of code.
     // Maybe this was a copy/paste error?
@@ -12379,6 +12630,43 @@ int32_t OT_API::getMarketList(const Identifier& NOTARY_ID,
     return SendMessage(pServer, pNym, theMessage, lRequestNumber);
 }
 
+/// GET THE SERVER'S COMMAND STATISTICS
+///
+/// Request counts, error counts and latencies for each command the server has
+/// processed since it started. The reply payload is XML.
+///
+int32_t OT_API::getServerStats(const Identifier& NOTARY_ID,
+                               const Identifier& NYM_ID) const
+{
+    Nym* pNym = GetOrLoadPrivateNym(
+        NYM_ID, false, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pNym) return (-1);
+    OTServerContract* pServer =
+        GetServer(NOTARY_ID, __FUNCTION__); // This ASSERTs and logs already.
+    if (nullptr == pServer) return (-1);
+    Message theMessage;
+
+    String strNotaryID(NOTARY_ID);
+    int64_t lRequestNumber = 0;
+    pNym->GetCurrentRequestNum(strNotaryID, lRequestNumber);
+    theMessage.m_strRequestNum.Format("%" PRId64, lRequestNumber);
+    pNym->IncrementRequestNum(*pNym, strNotaryID);
+
+    String strNymID(NYM_ID);
+
+    theMessage.m_strCommand = "getServerStats";
+    theMessage.m_strNymID = strNymID;
+    theMessage.m_strNotaryID = strNotaryID;
+    theMessage.SetAcknowledgments(*pNym); // Must be called AFTER
+                                          // theMessage.m_strNotaryID is already
+                                          // set. (It uses it.)
+
+    theMessage.SignContract(*pNym);
+    theMessage.SaveContract();
+
+    return SendMessage(pServer, pNym, theMessage, lRequestNumber);
+}
+
 /// GET ALL THE OFFERS ON A SPECIFIC MARKET
 ///
 /// A specific Nym is requesting the Server to send a list of the offers on a
@@ -43,6 +43,7 @@
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/Ledger.hpp>
 #include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/OTStorage.hpp>
@@ -395,6 +396,8 @@ bool Account::VerifyOwnerByID(const Identifier& nymId) const
 Account* Account::LoadExistingAccount(const Identifier& accountId,
                                       const Identifier& notaryID)
 {
+    Trace::Span span("Account::LoadExistingAccount");
+
     bool folderAlreadyExist = false;
     bool folderIsNew = false;
 
@@ -47,13 +47,17 @@
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/crypto/OTSignature.hpp>
 #include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/util/PhaseTimer.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/util/Tag.hpp>
 
 #include <cstring>
 #include <irrxml/irrXML.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 using namespace irr;
 using namespace io;
@@ -274,13 +278,30 @@ bool Contract::VerifyContract()
 
 void Contract::CalculateContractID(Identifier& newID) const
 {
-    // may be redundant...
-    std::string str_Trim(m_strRawFile.Get());
-    std::string str_Trim2 = String::trim(str_Trim);
+    // Hashes the same bytes String::trim would leave, without copying the
+    // whole file twice to get them. (Like trim, an all-whitespace file is
+    // hashed as it is.)
+    const char* szWhitespace = " \t\f\v\n\r";
+    const char* szRaw = m_strRawFile.Get();
+    const size_t lSize = strlen(szRaw);
+    size_t lBegin = 0;
+    size_t lEnd = lSize;
+
+    while ((lBegin < lSize) &&
+           (nullptr != strchr(szWhitespace, szRaw[lBegin]))) {
+        ++lBegin;
+    }
 
-    String strTemp(str_Trim2.c_str());
+    if (lBegin < lSize) {
+        while (nullptr != strchr(szWhitespace, szRaw[lEnd - 1])) --lEnd;
+    }
+    else {
+        lBegin = 0;
+    }
 
-    if (!newID.CalculateDigest(strTemp))
+    if (!newID.CalculateDigest(
+            reinterpret_cast<const unsigned char*>(szRaw + lBegin),
+            lEnd - lBegin))
         otErr << __FUNCTION__ << ": Error calculating Contract digest.\n";
 }
 
@@ -512,6 +533,9 @@ bool Contract::SignContract(const OTAsymmetricKey& theKey,
                             const String& strHashType,
                             const OTPasswordData* pPWData)
 {
+    PhaseTimer::Scope phase(PhaseTimer::SIGN);
+    Trace::Span span("Contract::SignContract");
+
     // We assume if there's any important metadata, it will already
     // be on the key, so we just copy it over to the signature.
     //
@@ -540,6 +564,62 @@ bool Contract::SignContract(const OTAsymmetricKey& theKey,
     return true;
 }
 
+// static
+bool Contract::SignContracts(const listOfContracts& theContracts,
+                             const Nym& theNym, const OTPasswordData* pPWData)
+{
+    PhaseTimer::Scope phase(PhaseTimer::SIGN);
+    Trace::Span span("Contract::SignContracts");
+
+    const OTAsymmetricKey& theKey = theNym.GetPrivateSignKey();
+
+    // The jobs point into these, so they're filled in completely before the
+    // first job is made.
+    std::vector<String> vContents;
+    std::vector<std::unique_ptr<OTSignature>> vSignatures;
+    vContents.reserve(theContracts.size());
+
+    for (auto& it : theContracts) {
+        Contract* pContract = it;
+        OT_ASSERT(nullptr != pContract);
+
+        std::unique_ptr<OTSignature> pSig(new OTSignature);
+
+        if (nullptr != theKey.m_pMetadata) {
+            pSig->getMetaData() = *(theKey.m_pMetadata);
+        }
+
+        pContract->UpdateContents();
+        vContents.push_back(trim(pContract->m_xmlUnsigned));
+        vSignatures.push_back(std::move(pSig));
+    }
+
+    listOfSignatureJobs theJobs;
+
+    for (size_t i = 0; i < theContracts.size(); ++i) {
+        theJobs.push_back({&vContents[i], &theKey, vSignatures[i].get(),
+                           theContracts[i]->m_strSigHashType});
+    }
+
+    listOfCryptoFutures theFutures =
+        OTCrypto::It()->SignContracts(theJobs, pPWData);
+    bool bAllSigned = true;
+
+    for (size_t i = 0; i < theFutures.size(); ++i) {
+        if (theFutures[i].get()) {
+            theContracts[i]->m_listSignatures.push_back(
+                vSignatures[i].release());
+        }
+        else {
+            otErr << __FUNCTION__ << ": Failed signing contract " << i
+                  << " of " << theContracts.size() << ".\n";
+            bAllSigned = false;
+        }
+    }
+
+    return bAllSigned;
+}
+
 // Todo: make this private so we can see if anyone is calling it.
 // Might want to ditch it if possible, since the metadata isn't
 // stored in that cert file...
@@ -832,6 +912,9 @@ bool Contract::VerifySignature(const OTAsymmetricKey& theKey,
                                const String& strHashType,
                                const OTPasswordData* pPWData) const
 {
+    PhaseTimer::Scope phase(PhaseTimer::VERIFY);
+    Trace::Span span("Contract::VerifySignature");
+
     // See if this key could possibly have even signed this signature.
     // (The metadata may eliminate it as a possibility.)
     //
@@ -854,6 +937,87 @@ bool Contract::VerifySignature(const OTAsymmetricKey& theKey,
     return true;
 }
 
+// static
+bool Contract::VerifySignatures(const listOfConstContracts& theContracts,
+                                const Nym& theNym,
+                                const OTPasswordData* pPWData)
+{
+    PhaseTimer::Scope phase(PhaseTimer::VERIFY);
+    Trace::Span span("Contract::VerifySignatures");
+
+    OTPasswordData thePWData("OTContract::VerifySignatures");
+    String strNymID;
+    theNym.GetIdentifier(strNymID);
+    char cNymID = '0';
+    uint32_t uIndex = 3;
+    const bool bNymID = strNymID.At(uIndex, cNymID);
+    OTAsymmetricKey* pDefaultKey =
+        const_cast<OTAsymmetricKey*>(&theNym.GetPublicSignKey());
+
+    // The jobs point into vContents, so it mustn't reallocate.
+    std::vector<String> vContents;
+    vContents.reserve(theContracts.size());
+    listOfSignatureJobs theJobs;
+    std::vector<size_t> vOwners; // Which contract each job is for.
+
+    for (size_t i = 0; i < theContracts.size(); ++i) {
+        const Contract* pContract = theContracts[i];
+        OT_ASSERT(nullptr != pContract);
+
+        vContents.push_back(trim(pContract->m_xmlUnsigned));
+
+        // Same candidates as VerifySignature(theNym), in the same order.
+        for (auto& it : pContract->m_listSignatures) {
+            OTSignature* pSig = it;
+            OT_ASSERT(nullptr != pSig);
+
+            if (bNymID && pSig->getMetaData().HasMetadata() &&
+                (pSig->getMetaData().FirstCharNymID() != cNymID))
+                continue;
+
+            listOfAsymmetricKeys listKeys;
+            theNym.GetPublicKeysBySignature(listKeys, *pSig, 'S');
+
+            if (listKeys.end() ==
+                std::find(listKeys.begin(), listKeys.end(), pDefaultKey))
+                listKeys.push_back(pDefaultKey);
+
+            for (auto& itKey : listKeys) {
+                const OTAsymmetricKey* pKey = itKey;
+                OT_ASSERT(nullptr != pKey);
+
+                if ((nullptr != pKey->m_pMetadata) &&
+                    pKey->m_pMetadata->HasMetadata() &&
+                    pSig->getMetaData().HasMetadata() &&
+                    (pSig->getMetaData() != *(pKey->m_pMetadata)))
+                    continue;
+
+                theJobs.push_back({&vContents.back(), pKey, pSig,
+                                   pContract->m_strSigHashType});
+                vOwners.push_back(i);
+            }
+        }
+    }
+
+    listOfCryptoFutures theFutures = OTCrypto::It()->VerifySignatures(
+        theJobs, (nullptr != pPWData) ? pPWData : &thePWData);
+    std::vector<bool> vVerified(theContracts.size(), false);
+
+    for (size_t i = 0; i < theFutures.size(); ++i) {
+        if (theFutures[i].get()) vVerified[vOwners[i]] = true;
+    }
+
+    for (size_t i = 0; i < vVerified.size(); ++i) {
+        if (!vVerified[i]) {
+            otLog4 << __FUNCTION__ << ": Contract " << i << " of "
+                   << vVerified.size() << " failed to verify.\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void Contract::ReleaseSignatures()
 {
 
@@ -1073,6 +1237,8 @@ bool Contract::RewriteContract(String& strOutput) const
 
 bool Contract::SaveContract(const char* szFoldername, const char* szFilename)
 {
+    Trace::Span span("Contract::SaveContract");
+
     OT_ASSERT_MSG(nullptr != szFilename,
                   "Null filename sent to OTContract::SaveContract\n");
     OT_ASSERT_MSG(nullptr != szFoldername,
@@ -1120,6 +1286,8 @@ bool Contract::SaveContract(const char* szFoldername, const char* szFilename)
 // Then it parses that string into the object.
 bool Contract::LoadContract()
 {
+    Trace::Span span("Contract::LoadContract");
+
     Release();
     LoadContractRawFile(); // opens m_strFilename and reads into m_strRawFile
 
@@ -1175,6 +1343,8 @@ bool Contract::LoadContractRawFile()
 
 bool Contract::LoadContract(const char* szFoldername, const char* szFilename)
 {
+    Trace::Span span("Contract::LoadContract");
+
     Release();
 
     m_strFoldername.Set(szFoldername);
@@ -1239,13 +1409,110 @@ bool Contract::LoadContractFromString(const String& theStr)
     return bSuccess;
 }
 
+namespace
+{
+
+// One line of a raw contract, as ParseRawFile walks through it. Offsets are
+// into the raw file; [begin, end) includes the newline.
+struct RawLine
+{
+    const char* text;
+    uint32_t length; // not counting the newline
+    uint32_t begin;
+    uint32_t end;
+    bool last; // no more lines after this one
+};
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> RawSpans;
+
+// Reads the line starting at nPos. Returns false if there isn't one.
+bool read_line(const char* pData, uint32_t nSize, uint32_t nPos,
+               RawLine& theLine)
+{
+    if (nPos >= nSize) return false;
+
+    const char* pStart = pData + nPos;
+    const char* pNewline =
+        static_cast<const char*>(memchr(pStart, '\n', nSize - nPos));
+    const uint32_t nLength =
+        (nullptr == pNewline) ? (nSize - nPos)
+                              : static_cast<uint32_t>(pNewline - pStart);
+
+    theLine.text = pStart;
+    theLine.length = nLength;
+    theLine.begin = nPos;
+    theLine.end = (nullptr == pNewline) ? nSize : (nPos + nLength + 1);
+    theLine.last = (theLine.end >= nSize);
+
+    return true;
+}
+
+bool line_starts_with(const RawLine& theLine, const char* szPrefix)
+{
+    const size_t nPrefix = strlen(szPrefix);
+
+    return (theLine.length >= nPrefix) &&
+           (0 == memcmp(theLine.text, szPrefix, nPrefix));
+}
+
+bool line_contains(const RawLine& theLine, const char* szNeedle)
+{
+    return std::string::npos !=
+           std::string(theLine.text, theLine.length).find(szNeedle);
+}
+
+// Appends a line to the spans, merging it into the previous span when the two
+// are adjacent.
+void add_span(RawSpans& theSpans, const RawLine& theLine)
+{
+    if (!theSpans.empty() && (theSpans.back().second == theLine.begin))
+        theSpans.back().second = theLine.end;
+    else
+        theSpans.push_back(std::make_pair(theLine.begin, theLine.end));
+}
+
+// Copies the spans into strOutput. The usual case is a single span (the lines
+// of a block are contiguous), which costs one allocation and one copy.
+void assemble_spans(const char* pData, const RawSpans& theSpans,
+                    String& strOutput)
+{
+    if (theSpans.empty()) return;
+
+    if (1 == theSpans.size()) {
+        strOutput.MemSet(pData + theSpans.front().first,
+                         theSpans.front().second - theSpans.front().first);
+        return;
+    }
+
+    std::string str_joined;
+    size_t lTotal = 0;
+
+    for (const auto& it : theSpans) lTotal += it.second - it.first;
+
+    str_joined.reserve(lTotal);
+
+    for (const auto& it : theSpans)
+        str_joined.append(pData + it.first, it.second - it.first);
+
+    strOutput.MemSet(str_joined.data(), static_cast<uint32_t>(lTotal));
+}
+
+} // namespace
+
+// Splits m_strRawFile into m_xmlUnsigned, m_strSigHashType and the
+// signatures, in a single pass over the raw buffer. Lines are never copied
+// while scanning; each block is recorded as spans of the raw file and copied
+// out once at the end.
+//
+// The rules are the same as the line reader this replaced, down to the line
+// after each "Hash:", "Version:", "Comment:" and "Meta:" header being
+// skipped unread. The one difference is that lines longer than 2047 bytes are
+// no longer split in two.
+//
 bool Contract::ParseRawFile()
 {
-    char buffer1[2100]; // a bit bigger than 2048, just for safety reasons.
     OTSignature* pSig = nullptr;
 
-    std::string line;
-
     bool bSignatureMode = false;          // "currently in signature mode"
     bool bContentMode = false;            // "currently in content mode"
     bool bHaveEnteredContentMode = false; // "have yet to enter content mode"
@@ -1257,76 +1524,84 @@ bool Contract::ParseRawFile()
         return false;
     }
 
-    // This is redundant (I thought) but the problem hasn't cleared up yet.. so
-    // trying to really nail it now.
-    std::string str_Trim(m_strRawFile.Get());
-    std::string str_Trim2 = String::trim(str_Trim);
-    m_strRawFile.Set(str_Trim2.c_str());
+    // Trim the raw file in place. (It only gets copied if there's actually
+    // whitespace to remove.)
+    {
+        const char* pRaw = m_strRawFile.Get();
+        const uint32_t nRawSize = m_strRawFile.GetLength();
+        const char* szWhitespace = " \t\f\v\n\r";
+        uint32_t nFirst = 0;
+        uint32_t nLast = nRawSize;
+
+        while ((nFirst < nRawSize) && strchr(szWhitespace, pRaw[nFirst]))
+            ++nFirst;
+        while ((nLast > nFirst) && strchr(szWhitespace, pRaw[nLast - 1]))
+            --nLast;
+
+        // (Entirely whitespace is left alone, like String::trim does.)
+        if ((nFirst < nLast) && ((nFirst > 0) || (nLast < nRawSize))) {
+            const std::string str_trimmed(pRaw + nFirst, nLast - nFirst);
+            m_strRawFile.MemSet(str_trimmed.data(),
+                                static_cast<uint32_t>(str_trimmed.size()));
+        }
+    }
 
-    bool bIsEOF = false;
-    m_strRawFile.reset();
+    const char* pData = m_strRawFile.Get();
+    const uint32_t nSize = m_strRawFile.GetLength();
 
-    do {
-        // Just a fresh start at the top of the loop block... probably
-        // unnecessary.
-        memset(buffer1, 0, 2100); // todo remove this in optimization. (might be
-                                  // removed already...)
+    RawSpans contentSpans;
+    RawSpans signatureSpans;
+    RawLine line;
+    RawLine skipped;
+    uint32_t nPos = 0;
+    bool bIsEOF = false;
 
-        // the call returns true if there's more to read, and false if there
-        // isn't.
-        bIsEOF = !(m_strRawFile.sgets(buffer1, 2048));
+    // Skips the line after a header. Fails if the header was the last line,
+    // or if the skipped one is.
+    auto skip_line = [&]() {
+        if (bIsEOF || !read_line(pData, nSize, nPos, skipped) ||
+            skipped.last) {
+            return false;
+        }
+        nPos = skipped.end;
+        return true;
+    };
 
-        line = buffer1;
-        const char* pBuf = line.c_str();
+    while (!bIsEOF && read_line(pData, nSize, nPos, line)) {
+        nPos = line.end;
+        bIsEOF = line.last;
 
-        if (line.length() < 2) {
+        if (line.length < 2) {
             if (bSignatureMode) continue;
         }
 
         // if we're on a dashed line...
-        else if (line.at(0) == '-') {
+        else if ('-' == line.text[0]) {
             if (bSignatureMode) {
                 // we just reached the end of a signature
-                //    otErr << "%s\n", pSig->Get());
+                assemble_spans(pData, signatureSpans, *pSig);
+                signatureSpans.clear();
                 pSig = nullptr;
                 bSignatureMode = false;
                 continue;
             }
 
-            // if I'm NOT in signature mode, and I just hit a dash, that means
-            // there
-            // are only four options:
+            const bool bFourDashes = (line.length > 3) &&
+                                     ('-' == line.text[1]) &&
+                                     ('-' == line.text[2]) &&
+                                     ('-' == line.text[3]);
 
             // a. I have not yet even entered content mode, and just now
             // entering it for the first time.
             if (!bHaveEnteredContentMode) {
-                if ((line.length() > 3) &&
-                    (line.find("BEGIN") != std::string::npos) &&
-                    line.at(1) == '-' && line.at(2) == '-' &&
-                    line.at(3) == '-') {
-                    //                    otErr << "\nProcessing contract...
-                    // \n";
+                if (bFourDashes && line_contains(line, "BEGIN")) {
                     bHaveEnteredContentMode = true;
                     bContentMode = true;
-                    continue;
-                }
-                else {
-                    continue;
                 }
-
+                continue;
             }
-
             // b. I am now entering signature mode!
-            else if (line.length() > 3 &&
-                     line.find("SIGNATURE") != std::string::npos &&
-                     line.at(1) == '-' && line.at(2) == '-' &&
-                     line.at(3) == '-') {
-                // if (bContentMode)
-                //    otLog3 << "Finished reading contract.\n\nReading a
-                // signature at the bottom of the contract...\n");
-                // else
-                //    otLog3 << "Reading another signature...\n");
-
+            else if (bFourDashes && line_contains(line, "SIGNATURE")) {
                 bSignatureMode = true;
                 bContentMode = false;
 
@@ -1341,8 +1616,8 @@ bool Contract::ParseRawFile()
                 continue;
             }
             // c. There is an error in the file!
-            else if (line.length() < 3 || line.at(1) != ' ' ||
-                     line.at(2) != '-') {
+            else if ((line.length < 3) || (' ' != line.text[1]) ||
+                     ('-' != line.text[2])) {
                 otOut
                     << "Error in contract " << m_strFilename
                     << ": a dash at the beginning of the "
@@ -1350,111 +1625,88 @@ bool Contract::ParseRawFile()
                     << m_strRawFile << "\n";
                 return false;
             }
-            // d. It is an escaped dash, and therefore kosher, so I merely
-            // remove the escape and add it.
-            // I've decided not to remove the dashes but to keep them as part of
-            // the signed content.
-            // It's just much easier to deal with that way. The input code will
-            // insert the extra dashes.
-            // pBuf += 2;
+            // d. It is an escaped dash, and therefore kosher. The escape is
+            // kept as part of the signed content.
         }
 
         // Else we're on a normal line, not a dashed line.
-        else {
-            if (bHaveEnteredContentMode) {
-                if (bSignatureMode) {
-                    if (line.length() < 2) {
-                        otLog3 << "Skipping short line...\n";
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after short line.\n";
-                            return false;
-                        }
-
-                        continue;
+        else if (bHaveEnteredContentMode) {
+            if (bSignatureMode) {
+                if (line_starts_with(line, "Version:")) {
+                    otLog3 << "Skipping version section...\n";
+
+                    if (!skip_line()) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Version:\"\n";
+                        return false;
                     }
-                    else if (line.compare(0, 8, "Version:") == 0) {
-                        otLog3 << "Skipping version section...\n";
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Version:\"\n";
-                            return false;
-                        }
 
-                        continue;
+                    continue;
+                }
+                else if (line_starts_with(line, "Comment:")) {
+                    otLog3 << "Skipping comment section...\n";
+
+                    if (!skip_line()) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Comment:\"\n";
+                        return false;
                     }
-                    else if (line.compare(0, 8, "Comment:") == 0) {
-                        otLog3 << "Skipping comment section...\n";
 
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Comment:\"\n";
-                            return false;
-                        }
+                    continue;
+                }
+                else if (line_starts_with(line, "Meta:")) {
+                    otLog3 << "Collecting signature metadata...\n";
+
+                    // "Meta:    knms" (It will always be exactly 13
+                    // characters long.) knms represents the first characters
+                    // of the Key type, NymID, Master Cred ID, and Subcred ID.
+                    // Key type is (A|E|S) and the others are base62.
+                    if (13 != line.length) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename << ": Unexpected length for "
+                                                  "\"Meta:\" comment.\n";
+                        return false;
+                    }
 
-                        continue;
+                    OT_ASSERT(nullptr != pSig);
+                    if (false ==
+                        pSig->getMetaData().SetMetadata(
+                            line.text[9], line.text[10], line.text[11],
+                            line.text[12])) // "knms" from "Meta:    knms"
+                    {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected metadata in the \"Meta:\" "
+                                 "comment.\nLine: "
+                              << std::string(line.text, line.length) << "\n";
+                        return false;
                     }
-                    if (line.compare(0, 5, "Meta:") == 0) {
-                        otLog3 << "Collecting signature metadata...\n";
-
-                        if (line.length() !=
-                            13) // "Meta:    knms" (It will always be exactly 13
-                                // characters int64_t.) knms represents the
-                                // first characters of the Key type, NymID,
-                                // Master Cred ID, and Subcred ID. Key type is
-                                // (A|E|S) and the others are base62.
-                        {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename << ": Unexpected length for "
-                                                      "\"Meta:\" comment.\n";
-                            return false;
-                        }
-
-                        OT_ASSERT(nullptr != pSig);
-                        if (false ==
-                            pSig->getMetaData().SetMetadata(
-                                line.at(9), line.at(10), line.at(11),
-                                line.at(12))) // "knms" from "Meta:    knms"
-                        {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected metadata in the \"Meta:\" "
-                                     "comment.\nLine: " << line << "\n";
-                            return false;
-                        }
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in signature for contract "
-                                  << m_strFilename
-                                  << ": Unexpected EOF after \"Meta:\"\n";
-                            return false;
-                        }
-
-                        continue;
+
+                    if (!skip_line()) {
+                        otOut << "Error in signature for contract "
+                              << m_strFilename
+                              << ": Unexpected EOF after \"Meta:\"\n";
+                        return false;
                     }
+
+                    continue;
                 }
-                if (bContentMode) {
-                    if (line.compare(0, 6, "Hash: ") == 0) {
-                        otLog3 << "Collecting message digest algorithm from "
-                                  "contract header...\n";
-
-                        std::string strTemp = line.substr(6);
-                        m_strSigHashType = strTemp.c_str();
-                        m_strSigHashType.ConvertToUpperCase();
-
-                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048)) {
-                            otOut << "Error in contract " << m_strFilename
-                                  << ": Unexpected EOF after \"Hash:\"\n";
-                            return false;
-                        }
-                        continue;
-                    }
+            }
+            else if (bContentMode && line_starts_with(line, "Hash: ")) {
+                otLog3 << "Collecting message digest algorithm from "
+                          "contract header...\n";
+
+                m_strSigHashType.MemSet(line.text + 6, line.length - 6);
+                m_strSigHashType.ConvertToUpperCase();
+
+                if (!skip_line()) {
+                    otOut << "Error in contract " << m_strFilename
+                          << ": Unexpected EOF after \"Hash:\"\n";
+                    return false;
                 }
+                continue;
             }
         }
 
@@ -1464,13 +1716,11 @@ bool Contract::ParseRawFile()
                           "processing signature, in "
                           "OTContract::ParseRawFile");
 
-            pSig->Concatenate("%s\n", pBuf);
+            add_span(signatureSpans, line);
         }
         else if (bContentMode)
-            m_xmlUnsigned.Concatenate("%s\n", pBuf);
-    } while (!bIsEOF);
-    //    while(!bIsEOF && (!bHaveEnteredContentMode || bContentMode ||
-    // bSignatureMode));
+            add_span(contentSpans, line);
+    }
 
     if (!bHaveEnteredContentMode) {
         otErr << "Error in OTContract::ParseRawFile: Found no BEGIN for signed "
@@ -1483,25 +1733,26 @@ bool Contract::ParseRawFile()
         return false;
     }
     else if (bSignatureMode) {
+        // The last signature block has no closing line, so it was never
+        // assembled. Don't leave it in the list, empty.
+        m_listSignatures.remove(pSig);
+        delete pSig;
+
         otErr << "Error in OTContract::ParseRawFile: EOF while reading "
-                 "signature.\n";
+                 "signature (no closing line).\n";
         return false;
     }
-    else if (!LoadContractXML()) {
+
+    assemble_spans(pData, contentSpans, m_xmlUnsigned);
+
+    if (!LoadContractXML()) {
         otErr << "Error in OTContract::ParseRawFile: unable to load XML "
                  "portion of contract into memory.\n";
         return false;
     }
     // Verification code and loading code are now called separately.
-    //    else if (!VerifyContractID())
-    //    {
-    //        otErr << "Error in OTContract::ParseRawFile: Contract ID does not
-    // match hashed contract file.\n";
-    //        return false;
-    //    }
-    else {
-        return true;
-    }
+
+    return true;
 }
 
 // This function assumes that m_xmlUnsigned is ready to be processed.
@@ -42,9 +42,9 @@
 #include <opentxs/core/Contract.hpp>
 #include <opentxs/core/crypto/OTCachedKey.hpp>
 #include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTHash160.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/crypto/OTSymmetricKey.hpp>
-#include <bitcoin-base58/hash.h>
 #include <cstring>
 #include <iostream>
 
@@ -175,11 +175,14 @@ const String Identifier::DefaultHashAlgorithm("HASH256");
 // so the result is 20 bytes long.
 bool Identifier::CalculateDigest(const unsigned char* data, size_t len)
 {
-    // The Hash160 function comes from the Bitcoin reference client, where
-    // it is implemented as RIPEMD160 ( SHA256 ( x ) ) => 20 byte hash
-    auto hash160 = Hash160(data, data + len);
-    SetSize(20);
-    memcpy(const_cast<void*>(GetPointer()), hash160, 20);
+    uint8_t digest[OTHash160::DigestSize];
+    OTHash160::Digest(data, len, digest);
+
+    // Identifiers are usually recalculated in place, so the buffer is only
+    // reallocated if it isn't the right size already.
+    if (GetSize() != OTHash160::DigestSize) SetSize(OTHash160::DigestSize);
+
+    memcpy(const_cast<void*>(GetPointer()), digest, OTHash160::DigestSize);
     return true;
 }
 
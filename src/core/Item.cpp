@@ -42,9 +42,11 @@
 #include <opentxs/core/Account.hpp>
 #include <opentxs/core/Cheque.hpp>
 #include <opentxs/core/Ledger.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
 #include <opentxs/core/OTStorage.hpp>
 
 #include <irrxml/irrXML.hpp>
@@ -99,6 +101,14 @@ bool Item::VerifyTransactionStatement(Nym& THE_NYM,
         return false;
     }
 
+    String strAttachment;
+    GetAttachment(strAttachment);
+
+    if (OTStatementDigest::IsDigest(strAttachment))
+        return VerifyStatementDigest(strAttachment, THE_NYM, nullptr, nullptr,
+                                     TARGET_TRANSACTION, 0,
+                                     bIsRealTransaction);
+
     //
     // So if the caller was planning to remove a number, or clear a receipt from
     // the inbox, he'll have to do
@@ -271,6 +281,8 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
                                                           // case of transfer,
                                                           // where the user
 { // doesn't know the outbox trans# in advance, so he sends
+    Trace::Span span("Item::VerifyBalanceStatement");
+
     if (GetType() != Item::balanceStatement) // a dummy number (currently '1')
                                              // which we verify against
     { // the actual outbox trans# successfully, only in that special case.
@@ -297,6 +309,16 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
         return false;
     }
 
+    // A compact statement carries hashes instead of the report and the list,
+    // so 2) and 3) below are done against the digest instead.
+    String strAttachment;
+    GetAttachment(strAttachment);
+
+    if (OTStatementDigest::IsDigest(strAttachment))
+        return VerifyStatementDigest(strAttachment, THE_NYM, &THE_INBOX,
+                                     &THE_OUTBOX, TARGET_TRANSACTION,
+                                     lOutboxTrnsNum, true);
+
     // 2) That the inbox transactions and outbox transactions match up to the
     // list of sub-items
     //    on THIS balance item.
@@ -750,27 +772,23 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
 
     String strMessageNym;
 
-    // First, loop through the Nym on my side, and count how many numbers total
-    // he has...
+    // First, count how many numbers total the Nym on my side has...
     //
-    for (auto& it : THE_NYM.GetMapIssuedNum()) {
-        std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
-
-        const Identifier theNotaryID(strNotaryID.c_str());
+    const OTNumberSet* pIssued = nullptr;
+    {
+        const String strNotaryID(GetPurportedNotaryID());
+        auto it = THE_NYM.GetMapIssuedNum().find(strNotaryID.Get());
 
-        if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+        if (THE_NYM.GetMapIssuedNum().end() != it) {
+            pIssued = &it->second;
             nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
-            break; // There's only one, in this loop, that would/could/should
-                   // match. (Therefore, break after finding it.)
+                static_cast<int32_t>(pIssued->Count());
         }
-    } // for
+    }
 
     // Next, loop through theMessageNym, and count his numbers as well...
-    // But ALSO verify that each one exists on THE_NYM, so that each individual
-    // number is checked.
+    // But ALSO verify that each one exists on THE_NYM. (A range at a time,
+    // so this doesn't depend on how many numbers the Nym has.)
     GetAttachment(strMessageNym);
     Nym theMessageNym;
 
@@ -778,74 +796,82 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
         theMessageNym.LoadFromString(strMessageNym)) {
         for (auto& it : theMessageNym.GetMapIssuedNum()) {
             std::string strNotaryID = it.first;
-            dequeOfTransNums* pDeque = it.second;
-            OT_ASSERT(nullptr != pDeque);
+            const OTNumberSet& theNumbers = it.second;
 
             const Identifier theNotaryID(strNotaryID.c_str());
-            const String OTstrNotaryID(theNotaryID);
 
-            if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+            if (!theNumbers.empty() &&
+                (theNotaryID == GetPurportedNotaryID())) {
                 nNumberOfTransactionNumbers2 +=
-                    static_cast<int32_t>(pDeque->size());
-
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    int64_t lTransactionNumber = pDeque->at(i);
-                    if (false ==
-                        THE_NYM.VerifyIssuedNum(OTstrNotaryID,
-                                                lTransactionNumber)) // FAILURE
-                    {
-                        otOut << "OTItem::" << __FUNCTION__
-                              << ": Issued transaction # " << lTransactionNumber
-                              << " from Message Nym not found on this side.\n";
-
-                        // I have to do this whenever I RETURN :-(
-                        switch (TARGET_TRANSACTION.GetType()) {
-                        case OTTransaction::processInbox:
-                        case OTTransaction::withdrawal:
-                        case OTTransaction::deposit:
-                        case OTTransaction::payDividend:
-                        case OTTransaction::cancelCronItem:
-                        case OTTransaction::exchangeBasket:
-                            // Should only actually iterate once, in this case.
-                            for (int32_t j = 0;
-                                 j < theRemovedNym.GetIssuedNumCount(
-                                         GetPurportedNotaryID());
-                                 j++) {
-                                int64_t lTemp = theRemovedNym.GetIssuedNum(
-                                    GetPurportedNotaryID(), j);
-
-                                if (j > 0)
-                                    otErr << "OTItem::" << __FUNCTION__
-                                          << ": THIS SHOULD NOT HAPPEN.\n";
-                                else if (false ==
-                                         THE_NYM.AddIssuedNum(
-                                             NOTARY_ID, lTemp)) // doesn't save.
-                                    otErr << "OTItem::" << __FUNCTION__
-                                          << ": Failed adding issued number "
-                                             "back to THE_NYM.\n";
-                            }
-                            break;
-
-                        case OTTransaction::transfer:
-                        case OTTransaction::marketOffer:
-                        case OTTransaction::paymentPlan:
-                        case OTTransaction::smartContract:
-                            break;
-                        default:
-                            // Error
-                            otErr << "OTItem::" << __FUNCTION__
-                                  << ": wrong target transaction type: "
-                                  << TARGET_TRANSACTION.GetTypeString() << "\n";
-                            break;
+                    static_cast<int32_t>(theNumbers.Count());
+
+                bool bMissing = false;
+                int64_t lFirst = 0, lLast = 0;
+
+                for (const auto& range : theNumbers.GetRanges()) {
+                    if ((nullptr == pIssued) ||
+                        !pIssued->ContainsAll(range.first, range.second)) {
+                        bMissing = true;
+                        lFirst = range.first;
+                        lLast = range.second;
+                        break;
+                    }
+                }
+
+                if (bMissing) // FAILURE
+                {
+                    otOut << "OTItem::" << __FUNCTION__
+                          << ": Issued transaction #s " << lFirst << "-"
+                          << lLast
+                          << " from Message Nym not all found on this side.\n";
+
+                    // I have to do this whenever I RETURN :-(
+                    switch (TARGET_TRANSACTION.GetType()) {
+                    case OTTransaction::processInbox:
+                    case OTTransaction::withdrawal:
+                    case OTTransaction::deposit:
+                    case OTTransaction::payDividend:
+                    case OTTransaction::cancelCronItem:
+                    case OTTransaction::exchangeBasket:
+                        // Should only actually iterate once, in this case.
+                        for (int32_t j = 0;
+                             j < theRemovedNym.GetIssuedNumCount(
+                                     GetPurportedNotaryID());
+                             j++) {
+                            int64_t lTemp = theRemovedNym.GetIssuedNum(
+                                GetPurportedNotaryID(), j);
+
+                            if (j > 0)
+                                otErr << "OTItem::" << __FUNCTION__
+                                      << ": THIS SHOULD NOT HAPPEN.\n";
+                            else if (false ==
+                                     THE_NYM.AddIssuedNum(
+                                         NOTARY_ID, lTemp)) // doesn't save.
+                                otErr << "OTItem::" << __FUNCTION__
+                                      << ": Failed adding issued number "
+                                         "back to THE_NYM.\n";
                         }
-
-                        return false;
+                        break;
+
+                    case OTTransaction::transfer:
+                    case OTTransaction::marketOffer:
+                    case OTTransaction::paymentPlan:
+                    case OTTransaction::smartContract:
+                        break;
+                    default:
+                        // Error
+                        otErr << "OTItem::" << __FUNCTION__
+                              << ": wrong target transaction type: "
+                              << TARGET_TRANSACTION.GetTypeString() << "\n";
+                        break;
                     }
-                }      // for (numbers for a specific server.)
+
+                    return false;
+                }
                 break; // Only one server ID should match, so we can break after
                        // finding it.
             }          // If the server ID matches
-        }              // for (deques of numbers for each server)
+        }              // for (sets of numbers for each server)
     }
 
     // Finally, verify that the counts match...
@@ -956,6 +982,154 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
     return true;
 }
 
+// Server-side, for a compact (version 2) statement.
+//
+// Checks what the full versions above check, but against the server's own
+// state: the issued numbers on THE_NYM, minus whatever a successful
+// transaction would close, must hash to the digest, and the digest's delta
+// must be exactly those closed numbers. For a balance statement, the report
+// the boxes produce must hash to it too. THE_NYM isn't modified, so there's
+// nothing to put back.
+//
+bool Item::VerifyStatementDigest(const String& strDigest, Nym& THE_NYM,
+                                 Ledger* pInbox, Ledger* pOutbox,
+                                 OTTransaction& TARGET_TRANSACTION,
+                                 int64_t lOutboxTrnsNum,
+                                 bool bIsRealTransaction)
+{
+    const bool bBalance = (Item::balanceStatement == GetType());
+    OTStatementDigest theDigest;
+
+    if (!theDigest.Load(strDigest)) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": Unable to load the statement digest.\n";
+        return false;
+    }
+
+    // processNymbox needs the full list (the client harvests from it.)
+    if (!bIsRealTransaction || (bBalance && ((nullptr == pInbox) ||
+                                             (nullptr == pOutbox)))) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": A compact statement needs a transaction.\n";
+        return false;
+    }
+
+    if (GetItemCount() > 0) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": A compact statement can't carry a box report.\n";
+        return false;
+    }
+
+    const String strNotaryID(GetPurportedNotaryID());
+
+    if (!THE_NYM.VerifyIssuedNum(strNotaryID, GetTransactionNum())) {
+        otOut << "OTItem::" << __FUNCTION__ << ": Transaction# ("
+              << GetTransactionNum()
+              << ") doesn't appear on Nym's issued list.\n";
+        return false;
+    }
+
+    OTNumberSet theIssued;
+    {
+        auto it = THE_NYM.GetMapIssuedNum().find(strNotaryID.Get());
+
+        if (THE_NYM.GetMapIssuedNum().end() != it) theIssued = it->second;
+    }
+
+    // The same numbers the full versions remove before comparing.
+    bool bCloses = false;
+
+    switch (TARGET_TRANSACTION.GetType()) {
+    case OTTransaction::processInbox:
+    case OTTransaction::withdrawal:
+    case OTTransaction::deposit:
+    case OTTransaction::payDividend:
+    case OTTransaction::exchangeBasket:
+        bCloses = bBalance;
+        break;
+    case OTTransaction::cancelCronItem:
+        bCloses = true;
+        break;
+    case OTTransaction::transfer:
+    case OTTransaction::marketOffer:
+    case OTTransaction::paymentPlan:
+    case OTTransaction::smartContract:
+        break;
+    default:
+        otErr << "OTItem::" << __FUNCTION__
+              << ": wrong target transaction type: "
+              << TARGET_TRANSACTION.GetTypeString() << "\n";
+        break;
+    }
+
+    NumList theRemoved;
+
+    if (bCloses) {
+        theIssued.Remove(GetTransactionNum());
+        theRemoved.Add(GetTransactionNum());
+    }
+
+    if (!theRemoved.Verify(theDigest.GetRemoved())) {
+        String strExpected, strActual;
+        theRemoved.Output(strExpected);
+        theDigest.GetRemoved().Output(strActual);
+
+        otOut << "OTItem::" << __FUNCTION__ << ": Statement removes ("
+              << strActual << ") but expected (" << strExpected << ").\n";
+        return false;
+    }
+
+    OTStatementDigest theExpected;
+    theExpected.SetIssued(theIssued);
+
+    if (!theExpected.SameIssued(theDigest)) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": Issued numbers don't match. Statement has "
+              << theDigest.GetIssuedCount() << ", expected "
+              << theExpected.GetIssuedCount() << ".\n";
+        return false;
+    }
+
+    if (!bBalance) return true;
+
+    std::unique_ptr<Item> pReport(Item::CreateItemFromTransaction(
+        TARGET_TRANSACTION, Item::balanceStatement));
+
+    // The above has an ASSERT, so this this will never actually happen.
+    if (nullptr == pReport) return false;
+
+    for (auto& it : pInbox->GetTransactionMap()) {
+        OTTransaction* pTransaction = it.second;
+        OT_ASSERT(nullptr != pTransaction);
+
+        pTransaction->ProduceInboxReportItem(*pReport);
+    }
+
+    pOutbox->ProduceOutboxReport(*pReport);
+
+    // As in the full version, a receipt that can't be reported fails it.
+    if (pReport->GetItemCount() !=
+        (pInbox->GetTransactionCount() + pOutbox->GetTransactionCount())) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": Inbox or Outbox holds a receipt a statement can't "
+                 "report.\n";
+        return false;
+    }
+
+    theExpected.SetBox(*pReport, lOutboxTrnsNum);
+
+    if (!theExpected.SameBox(theDigest)) {
+        otOut << "OTItem::" << __FUNCTION__
+              << ": Inbox or Outbox doesn't match the statement. (THE_INBOX "
+                 "count: " << pInbox->GetTransactionCount()
+              << ", THE_OUTBOX count: " << pOutbox->GetTransactionCount()
+              << ")\n";
+        return false;
+    }
+
+    return true;
+}
+
 // You have to allocate the item on the heap and then pass it in as a reference.
 // OTTransaction will take care of it from there and will delete it in
 // destructor.
@@ -2169,19 +2343,21 @@ void Item::UpdateContents() // Before transmission or serialization, this is
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
-    Tag tag("item");
-
-    tag.add_attribute("type", strType.Get());
-    tag.add_attribute("status", strStatus.Get());
-    tag.add_attribute("numberOfOrigin", // GetRaw so it doesn't calculate.
-                      formatLong(GetRawNumberOfOrigin()));
-    tag.add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    tag.add_attribute("notaryID", strNotaryID.Get());
-    tag.add_attribute("nymID", strNymID.Get());
-    tag.add_attribute("fromAccountID", strFromAcctID.Get());
-    tag.add_attribute("toAccountID", strToAcctID.Get());
-    tag.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
-    tag.add_attribute("amount", formatLong(m_lAmount));
+    std::string str_result;
+    XmlWriter writer(str_result);
+
+    writer.open_element("item");
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("status", strStatus.Get());
+    writer.add_attribute("numberOfOrigin", // GetRaw so it doesn't calculate.
+                         formatLong(GetRawNumberOfOrigin()));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("notaryID", strNotaryID.Get());
+    writer.add_attribute("nymID", strNymID.Get());
+    writer.add_attribute("fromAccountID", strFromAcctID.Get());
+    writer.add_attribute("toAccountID", strToAcctID.Get());
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("amount", formatLong(m_lAmount));
 
     // Only used in server reply item:
     // atBalanceStatement. In cases
@@ -2196,8 +2372,8 @@ void Item::UpdateContents() // Before transmission or serialization, this is
     // verifying the outbox against the
     // last signed receipt.
     if (m_lNewOutboxTransNum > 0)
-        tag.add_attribute("outboxNewTransNum",
-                          formatLong(m_lNewOutboxTransNum));
+        writer.add_attribute("outboxNewTransNum",
+                             formatLong(m_lNewOutboxTransNum));
     else {
         // IF this item is "acceptTransaction" then this
         // will serialize the list of transaction numbers
@@ -2209,20 +2385,21 @@ void Item::UpdateContents() // Before transmission or serialization, this is
             String strListOfBlanks;
 
             if (true == m_Numlist.Output(strListOfBlanks))
-                tag.add_attribute("totalListOfNumbers", strListOfBlanks.Get());
+                writer.add_attribute("totalListOfNumbers",
+                                     strListOfBlanks.Get());
         }
     }
 
     if (m_ascNote.GetLength() > 2) {
-        tag.add_tag("note", m_ascNote.Get());
+        writer.add_element("note", m_ascNote.Get());
     }
 
     if (m_ascInReferenceTo.GetLength() > 2) {
-        tag.add_tag("inReferenceTo", m_ascInReferenceTo.Get());
+        writer.add_element("inReferenceTo", m_ascInReferenceTo.Get());
     }
 
     if (m_ascAttachment.GetLength() > 2) {
-        tag.add_tag("attachment", m_ascAttachment.Get());
+        writer.add_element("attachment", m_ascAttachment.Get());
     }
 
     if ((Item::balanceStatement == m_Type) ||
@@ -2241,33 +2418,30 @@ void Item::UpdateContents() // Before transmission or serialization, this is
             String receiptType;
             GetStringFromType(pItem->GetType(), receiptType);
 
-            TagPtr tagReport(new Tag("transactionReport"));
-
-            tagReport->add_attribute("type", receiptType.Exists()
-                                                 ? receiptType.Get()
-                                                 : "error_state");
-            tagReport->add_attribute("adjustment",
-                                     formatLong(pItem->GetAmount()));
-            tagReport->add_attribute("accountID", acctID.Get());
-            tagReport->add_attribute("nymID", nymID.Get());
-            tagReport->add_attribute("notaryID", notaryID.Get());
-            tagReport->add_attribute("numberOfOrigin",
-                                     formatLong(pItem->GetRawNumberOfOrigin()));
-            tagReport->add_attribute("transactionNum",
-                                     formatLong(pItem->GetTransactionNum()));
-            tagReport->add_attribute("closingTransactionNum",
-                                     formatLong(pItem->GetClosingNum()));
-            tagReport->add_attribute("inReferenceTo",
-                                     formatLong(pItem->GetReferenceToNum()));
-
-            tag.add_tag(tagReport);
+            writer.open_element("transactionReport");
+            writer.add_attribute("type", receiptType.Exists()
+                                             ? receiptType.Get()
+                                             : "error_state");
+            writer.add_attribute("adjustment", formatLong(pItem->GetAmount()));
+            writer.add_attribute("accountID", acctID.Get());
+            writer.add_attribute("nymID", nymID.Get());
+            writer.add_attribute("notaryID", notaryID.Get());
+            writer.add_attribute("numberOfOrigin",
+                                 formatLong(pItem->GetRawNumberOfOrigin()));
+            writer.add_attribute("transactionNum",
+                                 formatLong(pItem->GetTransactionNum()));
+            writer.add_attribute("closingTransactionNum",
+                                 formatLong(pItem->GetClosingNum()));
+            writer.add_attribute("inReferenceTo",
+                                 formatLong(pItem->GetReferenceToNum()));
+
+            writer.close_element();
         }
     }
 
-    std::string str_result;
-    tag.output(str_result);
+    writer.close_element();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 } // namespace opentxs
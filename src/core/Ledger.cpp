@@ -43,10 +43,12 @@
 #include <opentxs/core/Cheque.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/Trace.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/transaction/Helpers.hpp>
 
@@ -93,6 +95,8 @@ char const* Ledger::_GetTypeString(ledgerType theType)
 //
 bool Ledger::VerifyAccount(const Nym& theNym)
 {
+    Trace::Span span("Ledger::VerifyAccount");
+
     switch (GetType()) {
     case Ledger::message: // message ledgers do not load Box Receipts. (They
                           // store full version internally already.)
@@ -228,6 +232,8 @@ bool Ledger::DeleteBoxReceipt(const int64_t& lTransactionNum)
 // if psetUnloaded passed in, then use it to return the #s that weren't there.
 bool Ledger::LoadBoxReceipts(std::set<int64_t>* psetUnloaded)
 {
+    Trace::Span span("Ledger::LoadBoxReceipts");
+
     // Grab a copy of all the transaction #s stored inside this ledger.
     //
     std::set<int64_t> the_set;
@@ -445,11 +451,15 @@ bool Ledger::LoadExpiredBoxFromString(const String& strBox)
  */
 bool Ledger::LoadGeneric(Ledger::ledgerType theType, const String* pString)
 {
+    Trace::Span span("Ledger::LoadGeneric");
+
     m_Type = theType;
 
     const char* pszType = GetTypeString();
     const char* pszFolder = nullptr;
 
+    if (span.Active()) span.Arg("type", pszType);
+
     switch (theType) {
     case Ledger::nymbox:
         pszFolder = OTFolders::Nymbox().Get();
@@ -559,11 +569,15 @@ bool Ledger::LoadGeneric(Ledger::ledgerType theType, const String* pString)
 
 bool Ledger::SaveGeneric(Ledger::ledgerType theType)
 {
+    Trace::Span span("Ledger::SaveGeneric");
+
     m_Type = theType;
 
     const char* pszFolder = nullptr;
     const char* pszType = GetTypeString();
 
+    if (span.Active()) span.Arg("type", pszType);
+
     switch (theType) {
     case Ledger::nymbox:
         pszFolder = OTFolders::Nymbox().Get();
@@ -1154,7 +1168,19 @@ int32_t Ledger::GetTransactionIndex(int64_t lTransactionNum)
 // If it is, return a pointer to it, otherwise return nullptr.
 OTTransaction* Ledger::GetTransaction(int64_t lTransactionNum) const
 {
-    // loop through the transactions inside this ledger
+    // The map is keyed by transaction number, so this is almost always found
+    // right away. (Balance statements look up every receipt in the box.)
+    auto it_find = m_mapTransactions.find(lTransactionNum);
+
+    if (m_mapTransactions.end() != it_find) {
+        OT_ASSERT(nullptr != it_find->second);
+
+        if (it_find->second->GetTransactionNum() == lTransactionNum)
+            return it_find->second;
+    }
+
+    // Otherwise, loop through the transactions inside this ledger, in case
+    // one was renumbered after it was added.
 
     for (auto& it : m_mapTransactions) {
         OTTransaction* pTransaction = it.second;
@@ -1477,6 +1503,7 @@ Item* Ledger::GenerateBalanceStatement(int64_t lAdjustment,
     // COPY THE ISSUED TRANSACTION NUMBERS FROM THE NYM to the MESSAGE NYM.
 
     Nym theMessageNym;
+    NumList theRemoved; // The delta, for a compact statement.
 
     theMessageNym.HarvestIssuedNumbers(
         GetPurportedNotaryID(),
@@ -1497,11 +1524,13 @@ Item* Ledger::GenerateBalanceStatement(int64_t lAdjustment,
     case OTTransaction::exchangeBasket:
     case OTTransaction::payDividend:
 
-        theMessageNym.RemoveIssuedNum(
-            theOwner.GetRealNotaryID(),
-            theOwner.GetTransactionNum()); // a transaction number is being
-                                           // used, and REMOVED from my list of
-                                           // responsibility,
+        if (theMessageNym.RemoveIssuedNum(
+                theOwner.GetRealNotaryID(),
+                theOwner.GetTransactionNum())) // a transaction number is
+                                               // being used, and REMOVED
+                                               // from my list of
+                                               // responsibility,
+            theRemoved.Add(theOwner.GetTransactionNum());
         theMessageNym.RemoveTransactionNum(
             theOwner.GetRealNotaryID(),
             theOwner.GetTransactionNum()); // a transaction number is being
@@ -1586,6 +1615,19 @@ Item* Ledger::GenerateBalanceStatement(int64_t lAdjustment,
                                         // a "date signed" variable.
     pBalanceItem->SaveContract();
 
+    // Send a digest instead of the list and the report, if turned on. (If
+    // it can't be made, the full statement goes out as before.)
+    if (OTStatementDigest::IsEnabled()) {
+        const String strAcctID(theAccount.GetPurportedAccountID());
+        Item* pCompact = OTStatementDigest::Compact(
+            *pBalanceItem, theOwner, theRemoved, theNym, strAcctID);
+
+        if (nullptr != pCompact) {
+            delete pBalanceItem;
+            pBalanceItem = pCompact;
+        }
+    }
+
     return pBalanceItem;
 }
 
@@ -1726,14 +1768,16 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
-    Tag tag("accountLedger");
+    std::string str_result;
+    XmlWriter writer(str_result);
 
-    tag.add_attribute("version", m_strVersion.Get());
-    tag.add_attribute("type", strType.Get());
-    tag.add_attribute("numPartialRecords", formatInt(nPartialRecordCount));
-    tag.add_attribute("accountID", strLedgerAcctID.Get());
-    tag.add_attribute("nymID", strNymID.Get());
-    tag.add_attribute("notaryID", strLedgerAcctNotaryID.Get());
+    writer.open_element("accountLedger");
+    writer.add_attribute("version", m_strVersion.Get());
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("numPartialRecords", formatInt(nPartialRecordCount));
+    writer.add_attribute("accountID", strLedgerAcctID.Get());
+    writer.add_attribute("nymID", strNymID.Get());
+    writer.add_attribute("notaryID", strLedgerAcctNotaryID.Get());
 
     // loop through the transactions and print them out here.
     for (auto& it : m_mapTransactions) {
@@ -1751,7 +1795,7 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
             OTASCIIArmor ascTransaction;
             ascTransaction.SetString(strTransaction, true); // linebreaks = true
 
-            tag.add_tag("transaction", ascTransaction.Get());
+            writer.add_element("transaction", ascTransaction.Get());
         }
         else // true == bSavingAbbreviated
         {
@@ -1761,22 +1805,22 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
             switch (GetType()) {
 
             case Ledger::nymbox:
-                pTransaction->SaveAbbreviatedNymboxRecord(tag);
+                pTransaction->SaveAbbreviatedNymboxRecord(writer);
                 break;
             case Ledger::inbox:
-                pTransaction->SaveAbbreviatedInboxRecord(tag);
+                pTransaction->SaveAbbreviatedInboxRecord(writer);
                 break;
             case Ledger::outbox:
-                pTransaction->SaveAbbreviatedOutboxRecord(tag);
+                pTransaction->SaveAbbreviatedOutboxRecord(writer);
                 break;
             case Ledger::paymentInbox:
-                pTransaction->SaveAbbrevPaymentInboxRecord(tag);
+                pTransaction->SaveAbbrevPaymentInboxRecord(writer);
                 break;
             case Ledger::recordBox:
-                pTransaction->SaveAbbrevRecordBoxRecord(tag);
+                pTransaction->SaveAbbrevRecordBoxRecord(writer);
                 break;
             case Ledger::expiredBox:
-                pTransaction->SaveAbbrevExpiredBoxRecord(tag);
+                pTransaction->SaveAbbrevExpiredBoxRecord(writer);
                 break;
 
             default: // todo: possibly change this to an OT_ASSERT. security.
@@ -1791,10 +1835,9 @@ void Ledger::UpdateContents() // Before transmission or serialization, this is
         }
     }
 
-    std::string str_result;
-    tag.output(str_result);
+    writer.close_element();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 // LoadContract will call this function at the right time.
@@ -39,10 +39,12 @@
 #include <opentxs/core/stdafx.hpp>
 
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/util/LogSink.hpp>
 #include <opentxs/core/util/OTPaths.hpp>
 #include <opentxs/core/util/stacktrace.h>
 #include <opentxs/core/Version.hpp>
 
+#include <atomic>
 #include <cstring>
 #include <mutex>
 
@@ -132,7 +134,16 @@ struct sigcontext
 namespace opentxs
 {
 
+namespace
+{
+
+LogSink s_sink;
+std::atomic<bool> s_bAsync(true);
+
+} // namespace
+
 Log* Log::pLogger = nullptr;
+std::atomic<int32_t> Log::s_nLogLevel(0);
 
 const String Log::m_strVersion = OPENTXS_VERSION_STRING;
 const String Log::m_strPathSeparator = "/";
@@ -151,6 +162,7 @@ OTLogStream::OTLogStream(int _logLevel)
     , next(0)
     , pBuffer(new char[1024])
 {
+    Refresh();
 }
 
 OTLogStream::~OTLogStream()
@@ -159,8 +171,18 @@ OTLogStream::~OTLogStream()
     pBuffer = nullptr;
 }
 
+void OTLogStream::Refresh()
+{
+    if (Enabled())
+        clear();
+    else
+        setstate(std::ios_base::badbit);
+}
+
 int OTLogStream::overflow(int c)
 {
+    std::lock_guard<std::mutex> lock(bufferLock);
+
     pBuffer[next++] = c;
     if (c != '\n' && next < 1000) {
         return 0;
@@ -194,7 +216,8 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
         pLogger->logDeque = std::deque<String*>();
         pLogger->m_strThreadContext = strThreadContext;
 
-        pLogger->m_nLogLevel = nLogLevel;
+        s_nLogLevel = nLogLevel;
+        RefreshStreams();
 
         if (!strThreadContext.Exists() ||
             strThreadContext.Compare("")) // global
@@ -244,6 +267,8 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
         delete pLogAssert;
         pLogAssert = nullptr;
 
+        if (s_bAsync) s_sink.Start();
+
         return true;
     }
     else {
@@ -260,14 +285,29 @@ bool Log::IsInitialized()
 // static
 bool Log::Cleanup()
 {
+    s_sink.Stop();
+
     if (nullptr != pLogger) {
         delete pLogger;
         pLogger = nullptr;
+        s_nLogLevel = 0;
+        RefreshStreams();
         return true;
     }
     return false;
 }
 
+// static
+void Log::RefreshStreams()
+{
+    otInfo.Refresh();
+    otOut.Refresh();
+    otWarn.Refresh();
+    otLog3.Refresh();
+    otLog4.Refresh();
+    otLog5.Refresh();
+}
+
 // static
 bool Log::CheckLogger(Log* pLogger)
 {
@@ -317,10 +357,7 @@ const String& Log::GetLogFilePath()
 // static
 int32_t Log::LogLevel()
 {
-    if (nullptr != pLogger)
-        return pLogger->m_nLogLevel;
-    else
-        return 0;
+    return s_nLogLevel.load(std::memory_order_relaxed);
 }
 
 // static
@@ -330,11 +367,71 @@ bool Log::SetLogLevel(const int32_t& nLogLevel)
         OT_FAIL;
     }
     else {
-        pLogger->m_nLogLevel = nLogLevel;
+        s_nLogLevel = nLogLevel;
+        RefreshStreams();
         return true;
     }
 }
 
+// static
+bool Log::GetAsync()
+{
+    return s_bAsync;
+}
+
+// static
+void Log::SetAsync(bool bAsync)
+{
+    s_bAsync = bAsync;
+
+    if (!bAsync)
+        s_sink.Stop();
+    else if (IsInitialized())
+        s_sink.Start();
+}
+
+// static
+uint64_t Log::DroppedMessages()
+{
+    return s_sink.Dropped();
+}
+
+// static
+void Log::Flush()
+{
+    s_sink.Flush();
+}
+
+// static
+void Log::Write(const char* szText, bool bMemlog)
+{
+    if (s_sink.Push(szText, bMemlog)) return;
+
+    // We store the last 1024 logs so programmers can access them via the API.
+    if (bMemlog) Log::PushMemlogFront(szText);
+
+    LogToFile(szText);
+}
+
+// static
+OTLogStream& Log::Stream(int32_t nVerbosity)
+{
+    switch (nVerbosity) {
+    case 0:
+        return otOut;
+    case 1:
+        return otWarn;
+    case 2:
+        return otInfo;
+    case 3:
+        return otLog3;
+    case 4:
+        return otLog4;
+    default:
+        return (nVerbosity < 0) ? otErr : otLog5;
+    }
+}
+
 //  OTLog Functions
 
 // If there's no logfile, then send it to stderr.
@@ -386,7 +483,10 @@ String Log::GetMemlogAtIndex(int32_t nIndex)
 
     uint32_t uIndex = static_cast<uint32_t>(nIndex);
 
+    std::unique_lock<std::mutex> lock(Log::pLogger->memlogLock);
+
     if ((nIndex < 0) || (uIndex >= Log::pLogger->logDeque.size())) {
+        lock.unlock();
         otErr << __FUNCTION__ << ": index out of bounds: " << nIndex << "\n";
         return "";
     }
@@ -411,6 +511,8 @@ int32_t Log::GetMemlogSize()
     // lets check if we are Initialized in this context
     CheckLogger(Log::pLogger);
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
     return static_cast<int32_t>(Log::pLogger->logDeque.size());
 }
 
@@ -419,6 +521,8 @@ String Log::PeekMemlogFront()
     // lets check if we are Initialized in this context
     CheckLogger(Log::pLogger);
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
     if (Log::pLogger->logDeque.size() <= 0) return nullptr;
 
     if (nullptr != Log::pLogger->logDeque.front())
@@ -439,6 +543,8 @@ String Log::PeekMemlogBack()
     // lets check if we are Initialized in this context
     CheckLogger(Log::pLogger);
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
     if (Log::pLogger->logDeque.size() <= 0) return nullptr;
 
     if (nullptr != Log::pLogger->logDeque.back())
@@ -460,6 +566,8 @@ bool Log::PopMemlogFront()
     // lets check if we are Initialized in this context
     CheckLogger(Log::pLogger);
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
     if (Log::pLogger->logDeque.size() <= 0) return false;
 
     String* strLogFront = Log::pLogger->logDeque.front();
@@ -477,6 +585,8 @@ bool Log::PopMemlogBack()
     // lets check if we are Initialized in this context
     CheckLogger(Log::pLogger);
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
     if (Log::pLogger->logDeque.size() <= 0) return false;
 
     String* strLogBack = Log::pLogger->logDeque.back();
@@ -496,13 +606,23 @@ bool Log::PushMemlogFront(const String& strLog)
 
     OT_ASSERT(strLog.Exists());
 
-    Log::pLogger->logDeque.push_front(new String(strLog));
+    String* pEntry = new String(strLog);
+    String* pOldest = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(Log::pLogger->memlogLock);
+
+        Log::pLogger->logDeque.push_front(pEntry);
 
-    if (Log::pLogger->logDeque.size() > LOG_DEQUE_SIZE) {
-        Log::PopMemlogBack(); // We start removing from the back when it
-                              // reaches this size.
+        // We start removing from the back when it reaches this size.
+        if (Log::pLogger->logDeque.size() > LOG_DEQUE_SIZE) {
+            pOldest = Log::pLogger->logDeque.back();
+            Log::pLogger->logDeque.pop_back();
+        }
     }
 
+    delete pOldest;
+
     return true;
 }
 
@@ -524,6 +644,9 @@ bool Log::SleepMilliseconds(int64_t lMilliseconds)
 size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
                       const char* szMessage)
 {
+    // Get what was logged before the assert out ahead of it.
+    Flush();
+
     if (nullptr != szMessage) {
 #ifndef ANDROID // if NOT android
         std::cerr << szMessage << "\n";
@@ -568,6 +691,8 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
 
 void Log::Output(int32_t nVerbosity, const char* szOutput)
 {
+    if (!IsEnabled(nVerbosity) || (nullptr == szOutput)) return;
+
     bool bHaveLogger(false);
     if (nullptr != pLogger)
         if (pLogger->IsInitialized()) bHaveLogger = true;
@@ -575,21 +700,14 @@ void Log::Output(int32_t nVerbosity, const char* szOutput)
     // lets check if we are Initialized in this context
     if (bHaveLogger) CheckLogger(Log::pLogger);
 
-    // If log level is 0, and verbosity of this message is 2, don't bother
-    // logging it.
-    //    if (nVerbosity > OTLog::__CurrentLogLevel || (nullptr == szOutput))
-    if ((nVerbosity > LogLevel()) || (nullptr == szOutput) ||
-        (LogLevel() == (-1)))
-        return;
-
-    // We store the last 1024 logs so programmers can access them via the API.
-    if (bHaveLogger) Log::PushMemlogFront(szOutput);
-
 #ifndef ANDROID // if NOT android
 
-    LogToFile(szOutput);
+    Write(szOutput, bHaveLogger);
 
 #else // if IS Android
+    // We store the last 1024 logs so programmers can access them via the API.
+    if (bHaveLogger) Log::PushMemlogFront(szOutput);
+
     /*
     typedef enum android_LogPriority {
     ANDROID_LOG_UNKNOWN = 0,
@@ -626,6 +744,9 @@ void Log::Output(int32_t nVerbosity, const char* szOutput)
 // the vOutput is to avoid name conflicts.
 void Log::vOutput(int32_t nVerbosity, const char* szOutput, ...)
 {
+    // Decide before formatting: at the default level most calls are dropped.
+    if (!IsEnabled(nVerbosity) || (nullptr == szOutput)) return;
+
     bool bHaveLogger(false);
     if (nullptr != pLogger)
         if (pLogger->IsInitialized()) bHaveLogger = true;
@@ -633,12 +754,6 @@ void Log::vOutput(int32_t nVerbosity, const char* szOutput, ...)
     // lets check if we are Initialized in this context
     if (bHaveLogger) CheckLogger(Log::pLogger);
 
-    // If log level is 0, and verbosity of this message is 2, don't bother
-    // logging it.
-    if (((0 != LogLevel()) && (nVerbosity > LogLevel())) ||
-        (nullptr == szOutput))
-        return;
-
     va_list args;
     va_start(args, szOutput);
 
@@ -698,14 +813,14 @@ void Log::Error(const char* szError)
 
     if ((nullptr == szError)) return;
 
-    // We store the last 1024 logs so programmers can access them via the API.
-    if (bHaveLogger) Log::PushMemlogFront(szError);
-
 #ifndef ANDROID // if NOT android
 
-    LogToFile(szError);
+    Write(szError, bHaveLogger);
 
 #else // if Android
+    // We store the last 1024 logs so programmers can access them via the API.
+    if (bHaveLogger) Log::PushMemlogFront(szError);
+
     __android_log_write(ANDROID_LOG_ERROR, "OT Error", szError);
 #endif
 }
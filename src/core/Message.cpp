@@ -173,27 +173,13 @@ void Message::SetAcknowledgments(Nym& theNym)
 {
     m_AcknowledgedReplies.Release();
 
-    const Identifier theNotaryID(m_strNotaryID);
+    auto it = theNym.GetMapAcknowledgedNum().find(m_strNotaryID.Get());
 
-    for (auto& it : theNym.GetMapAcknowledgedNum()) {
-        std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
-
-        String OTstrNotaryID = strNotaryID.c_str();
-        const Identifier theTempID(OTstrNotaryID);
-
-        if (!(pDeque->empty()) &&
-            (theNotaryID == theTempID)) // only for the matching notaryID.
-        {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                const int64_t lAckRequestNumber = pDeque->at(i);
-
-                m_AcknowledgedReplies.Add(lAckRequestNumber);
-            }
-            break; // We found it! Might as well break out.
-        }
-    } // for
+    if (theNym.GetMapAcknowledgedNum().end() != it) {
+        it->second.ForEach([&](int64_t lAckRequestNumber) {
+            m_AcknowledgedReplies.Add(lAckRequestNumber);
+        });
+    }
 }
 
 // The framework (OTContract) will call this function at the appropriate time.
@@ -3796,4 +3782,97 @@ public:
 RegisterStrategy StrategyGetMarketListResponse::reg(
     "getMarketListResponse", new StrategyGetMarketListResponse());
 
+class StrategyGetServerStats : public OTMessageStrategy
+{
+public:
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+
+        parent.add_tag(pTag);
+    }
+
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+
+        otWarn << "\nCommand: " << m.m_strCommand
+               << "\nNymID:    " << m.m_strNymID
+               << "\nNotaryID: " << m.m_strNotaryID
+               << "\nRequest #: " << m.m_strRequestNum << "\n";
+
+        return 1;
+    }
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetServerStats::reg("getServerStats",
+                                             new StrategyGetServerStats());
+
+class StrategyGetServerStatsResponse : public OTMessageStrategy
+{
+public:
+    virtual int32_t processXml(Message& m, irr::io::IrrXMLReader*& xml)
+    {
+        processXmlSuccess(m, xml);
+
+        m.m_strCommand = xml->getNodeName(); // Command
+        m.m_strRequestNum = xml->getAttributeValue("requestNum");
+        m.m_strNymID = xml->getAttributeValue("nymID");
+        m.m_strNotaryID = xml->getAttributeValue("notaryID");
+
+        const char* pElementExpected =
+            m.m_bSuccess ? "messagePayload" : "inReferenceTo";
+        OTASCIIArmor ascTextExpected;
+
+        if (!Contract::LoadEncodedTextFieldByName(xml, ascTextExpected,
+                                                  pElementExpected)) {
+            otErr << "Error in OTMessage::ProcessXMLNode: "
+                     "Expected " << pElementExpected
+                  << " element with text field, for " << m.m_strCommand
+                  << ".\n";
+            return (-1); // error condition
+        }
+
+        if (m.m_bSuccess)
+            m.m_ascPayload.Set(ascTextExpected);
+        else
+            m.m_ascInReferenceTo.Set(ascTextExpected);
+
+        otWarn << "\nCommand: " << m.m_strCommand << "   "
+               << (m.m_bSuccess ? "SUCCESS" : "FAILED")
+               << "\nNymID:    " << m.m_strNymID
+               << "\n NotaryID: " << m.m_strNotaryID << "\n\n";
+
+        return 1;
+    }
+
+    virtual void writeXml(Message& m, Tag& parent)
+    {
+        TagPtr pTag(new Tag(m.m_strCommand.Get()));
+
+        pTag->add_attribute("success", formatBool(m.m_bSuccess));
+        pTag->add_attribute("requestNum", m.m_strRequestNum.Get());
+        pTag->add_attribute("nymID", m.m_strNymID.Get());
+        pTag->add_attribute("notaryID", m.m_strNotaryID.Get());
+
+        if (m.m_bSuccess)
+            pTag->add_tag("messagePayload", m.m_ascPayload.Get());
+        else
+            pTag->add_tag("inReferenceTo", m.m_ascInReferenceTo.Get());
+
+        parent.add_tag(pTag);
+    }
+
+    static RegisterStrategy reg;
+};
+RegisterStrategy StrategyGetServerStatsResponse::reg(
+    "getServerStatsResponse", new StrategyGetServerStatsResponse());
+
 } // namespace opentxs
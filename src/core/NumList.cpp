@@ -51,6 +51,20 @@
 namespace opentxs
 {
 
+bool NumList::s_bRangeOutput = true;
+
+// static
+bool NumList::GetRangeOutput()
+{
+    return s_bRangeOutput;
+}
+
+// static
+void NumList::SetRangeOutput(bool bRangeOutput)
+{
+    s_bRangeOutput = bRangeOutput;
+}
+
 NumList::NumList(const std::set<int64_t>& theNumbers)
 {
     Add(theNumbers);
@@ -101,8 +115,8 @@ bool NumList::Add(const std::string& strNumbers) // if false, means the
 }
 
 // This function is private, so you can't use it without passing an OTString.
-// (For security reasons.) It takes a comma-separated list of numbers, and adds
-// them to *this.
+// (For security reasons.) It takes a comma-separated list of numbers and
+// "first-last" ranges, and adds them to *this.
 //
 bool NumList::Add(const char* szNumbers) // if false, means the numbers were
                                          // already there. (At least one of
@@ -123,6 +137,8 @@ bool NumList::Add(const char* szNumbers) // if false, means the numbers were
                // set to false when anything else. That way when we go to add
                // the number to the list, and it's "0", we'll know it's a real
                // number we're supposed to add, and not just a default value.
+    bool bInRange = false; // Set after the '-' of "first-last".
+    int64_t lFirst = 0;    // The first number of that range.
 
     for (;;) // We already know it's not null, due to the assert. (So at least
              // one iteration will happen.)
@@ -135,13 +151,33 @@ bool NumList::Add(const char* szNumbers) // if false, means the numbers were
             lNum *= 10; // Move it up a decimal place.
             lNum += nDigit;
         }
+        else if (('-' == *pChar) && bStartedANumber && !bInRange) {
+            bInRange = true;
+            lFirst = lNum;
+            lNum = 0;
+            bStartedANumber = false;
+        }
         // if separator, or end of string, either way, add lNum to *this.
         else if ((',' == *pChar) || ('\0' == *pChar) ||
                  std::isspace(*pChar, loc)) // first sign of a space, and we are
                                             // done with current number. (On to
                                             // the next.)
         {
-            if ((lNum > 0) || (bStartedANumber && (0 == lNum))) {
+            if (bInRange) {
+                if (!bStartedANumber || (lNum < lFirst) ||
+                    (lNum - lFirst >= MaxCount - Count())) {
+                    otErr << "OTNumList::Add: Error: Bad range: " << lFirst
+                          << "-" << lNum << "\n";
+                    bSuccess = false;
+                    break;
+                }
+
+                const uint64_t lSize = static_cast<uint64_t>(lNum - lFirst) + 1;
+
+                if (m_setData.InsertRange(lFirst, lNum) != lSize)
+                    bSuccess = false; // At least one was already there.
+            }
+            else if ((lNum > 0) || (bStartedANumber && (0 == lNum))) {
                 if (!Add(lNum)) // <=========
                 {
                     bSuccess = false; // We still go ahead and try to add them
@@ -153,6 +189,7 @@ bool NumList::Add(const char* szNumbers) // if false, means the numbers were
             lNum = 0; // reset for the next transaction number (in the
                       // comma-separated list.)
             bStartedANumber = false; // reset
+            bInRange = false;
         }
         else {
             otErr << "OTNumList::Add: Error: Unexpected character found in "
@@ -178,60 +215,36 @@ bool NumList::Add(const char* szNumbers) // if false, means the numbers were
 bool NumList::Add(const int64_t& theValue) // if false, means the value was
                                            // already there.
 {
-    auto it = m_setData.find(theValue);
-
-    if (m_setData.end() == it) // it's not already there, so add it.
-    {
-        m_setData.insert(theValue);
-        return true;
-    }
-    return false; // it was already there.
+    return m_setData.Insert(theValue);
 }
 
 bool NumList::Peek(int64_t& lPeek) const
 {
-    auto it = m_setData.begin();
+    if (m_setData.empty()) return false;
 
-    if (m_setData.end() != it) // it's there.
-    {
-        lPeek = *it;
-        return true;
-    }
-    return false;
+    lPeek = m_setData.Lowest();
+
+    return true;
 }
 
 bool NumList::Pop()
 {
-    auto it = m_setData.begin();
+    if (m_setData.empty()) return false;
 
-    if (m_setData.end() != it) // it's there.
-    {
-        m_setData.erase(it);
-        return true;
-    }
-    return false;
+    return m_setData.Remove(m_setData.Lowest());
 }
 
 bool NumList::Remove(const int64_t& theValue) // if false, means the value was
                                               // NOT already there.
 {
-    auto it = m_setData.find(theValue);
-
-    if (m_setData.end() != it) // it's there.
-    {
-        m_setData.erase(it);
-        return true;
-    }
-    return false; // it wasn't there (so how could you remove it then?)
+    return m_setData.Remove(theValue);
 }
 
 bool NumList::Verify(const int64_t& theValue) const // returns true/false
                                                     // (whether value is
                                                     // already there.)
 {
-    auto it = m_setData.find(theValue);
-
-    return (m_setData.end() == it) ? false : true;
+    return m_setData.Contains(theValue);
 }
 
 // True/False, based on whether values are already there.
@@ -255,34 +268,28 @@ bool NumList::Verify(const std::set<int64_t>& theNumbers) const
 ///
 bool NumList::Verify(const NumList& rhs) const
 {
-    // Verify they have the same number of elements.
-    //
-    if (Count() != rhs.Count()) return false;
-
-    // Verify each value on *this is also found on rhs.
+    // The ranges are kept merged, so equal sets have equal ranges.
     //
-    for (auto& it : m_setData) {
-        if (!rhs.Verify(it)) return false;
-    }
-
-    return true;
+    return m_setData.GetRanges() == rhs.m_setData.GetRanges();
 }
 
 /// True/False, based on whether ANY of the numbers in rhs are found in *this.
 ///
 bool NumList::VerifyAny(const NumList& rhs) const
 {
-    return rhs.VerifyAny(m_setData);
+    for (const auto& it : rhs.m_setData.GetRanges()) {
+        if (m_setData.ContainsAny(it.first, it.second)) return true;
+    }
+
+    return false;
 }
 
 /// Verify whether ANY of the numbers on *this are found in setData.
 ///
 bool NumList::VerifyAny(const std::set<int64_t>& setData) const
 {
-    for (const auto& it : m_setData) {
-        auto it_find = setData.find(it);
-
-        if (it_find != setData.end()) // found a match.
+    for (const auto& it : setData) {
+        if (m_setData.Contains(it)) // found a match.
             return true;
     }
 
@@ -293,10 +300,24 @@ bool NumList::Add(const NumList& theNumList) // if false, means the numbers
                                              // were already there. (At
                                              // least one of them.)
 {
-    std::set<int64_t> theOutput;
-    theNumList.Output(theOutput); // returns false if the numlist was empty.
+    return Add(theNumList.m_setData);
+}
 
-    return Add(theOutput);
+bool NumList::Add(const OTNumberSet& theNumbers) // if false, means the
+                                                 // numbers were already
+                                                 // there. (At least one of
+                                                 // them.)
+{
+    bool bSuccess = true;
+
+    for (const auto& it : theNumbers.GetRanges()) {
+        const uint64_t lSize = static_cast<uint64_t>(it.second - it.first) + 1;
+
+        if (m_setData.InsertRange(it.first, it.second) != lSize)
+            bSuccess = false; // At least one was already there.
+    }
+
+    return bSuccess;
 }
 
 bool NumList::Add(const std::set<int64_t>& theNumbers) // if false, means the
@@ -337,27 +358,38 @@ bool NumList::Output(std::set<int64_t>& theOutput) const // returns false if
                                                          // the numlist was
                                                          // empty.
 {
-    theOutput = m_setData;
+    theOutput.clear();
+
+    m_setData.ForEach(
+        [&](int64_t lNumber) { theOutput.insert(theOutput.end(), lNumber); });
 
     return !m_setData.empty();
 }
 
 // Outputs the numlist as a comma-separated string (for serialization, usually.)
+// Runs of three or more numbers are written as "first-last", unless range
+// output is turned off.
 //
 bool NumList::Output(String& strOutput) const // returns false if the
                                               // numlist was empty.
 {
-    int32_t nIterationCount = 0;
+    // Prepend a blank string to the first number (instead of a comma.)
+    const char* szSeparator = "";
+
+    for (const auto& it : m_setData.GetRanges()) {
+        if (s_bRangeOutput && (it.second - it.first >= 2)) {
+            strOutput.Concatenate("%s%" PRId64 "-%" PRId64, szSeparator,
+                                  it.first, it.second);
+            szSeparator = ",";
+            continue;
+        }
 
-    for (auto& it : m_setData) {
-        nIterationCount++;
+        for (int64_t lNumber = it.first;; ++lNumber) {
+            strOutput.Concatenate("%s%" PRId64, szSeparator, lNumber);
+            szSeparator = ",";
 
-        strOutput.Concatenate(
-            "%s%" PRId64,
-            // If first iteration, prepend a blank string (instead of a comma.)
-            // Like this:  "%" PRId64 ""
-            // But for all subsequent iterations, concatenate: ",%" PRId64 ""
-            (1 == nIterationCount) ? "" : ",", it);
+            if (lNumber == it.second) break;
+        }
     }
 
     return !m_setData.empty();
@@ -365,12 +397,12 @@ bool NumList::Output(String& strOutput) const // returns false if the
 
 int32_t NumList::Count() const
 {
-    return static_cast<int32_t>(m_setData.size());
+    return static_cast<int32_t>(m_setData.Count());
 }
 
 void NumList::Release()
 {
-    m_setData.clear();
+    m_setData.Clear();
 }
 
 } // namespace opentxs
@@ -40,6 +40,7 @@
 
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/crypto/OTCredential.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/Ledger.hpp>
 #include <opentxs/core/Log.hpp>
@@ -47,10 +48,13 @@
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
 #include <opentxs/core/crypto/OTSignedFile.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/crypto/OTSubkey.hpp>
 #include <opentxs/core/crypto/OTSymmetricKey.hpp>
 #include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/Trace.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
 
 #include <irrxml/irrXML.hpp>
 
@@ -63,6 +67,120 @@
 namespace opentxs
 {
 
+namespace
+{
+
+// Subfolders of OTFolders::Mail()/<nymID>.
+const char MAILBOX_MAIL[] = "mail";
+const char MAILBOX_OUTMAIL[] = "outmail";
+const char MAILBOX_OUTPAYMENTS[] = "outpayments";
+
+// Writes theMessage to its own file, named by its hash, and sets str_id.
+// Mail doesn't change once it's in a box, so a file that already exists
+// already has the right contents.
+bool store_mail(const String& strNymID, const char* szBox,
+                const Message& theMessage, std::string& str_id)
+{
+    const String strMail(theMessage);
+    Identifier theID;
+
+    if (!strMail.Exists() || !theID.CalculateDigest(strMail)) return false;
+
+    const String strID(theID);
+
+    if (!OTDB::Exists(OTFolders::Mail().Get(), strNymID.Get(), szBox,
+                      strID.Get()) &&
+        !OTDB::StorePlainString(strMail.Get(), OTFolders::Mail().Get(),
+                                strNymID.Get(), szBox, strID.Get())) {
+        otErr << __FUNCTION__ << ": Failed saving " << szBox << " message "
+              << strID << " for Nym " << strNymID << "\n";
+        return false;
+    }
+
+    str_id = strID.Get();
+
+    return true;
+}
+
+void forget_unloaded_mail(setOfMailRefs& unloaded, const char* szBox)
+{
+    for (auto it = unloaded.begin(); it != unloaded.end();) {
+        if (it->first == szBox)
+            it = unloaded.erase(it);
+        else
+            ++it;
+    }
+}
+
+// The nymfile signature covers the ID, and the ID is the hash of the file,
+// so a message that loads here is as trustworthy as the nymfile itself.
+Message* load_mail(const String& strNymID, const char* szBox,
+                   const std::string& str_id)
+{
+    const String strMail(OTDB::QueryPlainString(
+        OTFolders::Mail().Get(), strNymID.Get(), szBox, str_id));
+    Identifier theID;
+
+    if (!strMail.Exists() || !theID.CalculateDigest(strMail) ||
+        (str_id != String(theID).Get())) {
+        otErr << __FUNCTION__ << ": Missing or altered " << szBox
+              << " message " << str_id << " for Nym " << strNymID << "\n";
+        return nullptr;
+    }
+
+    Message* pMessage = new Message;
+
+    if (!pMessage->LoadContractFromString(strMail)) {
+        delete pMessage;
+        return nullptr;
+    }
+
+    return pMessage;
+}
+
+// Inline messages are armored in a szElement element. Stored ones are listed
+// as <szElement>Ref elements with the ID, when bByReference is set, along
+// with the ones in szBox that couldn't be loaded.
+void save_mailbox(XmlWriter& writer, const std::string& str_element,
+                  const char* szBox, const dequeOfMail& theMail,
+                  const dequeOfMailIDs& theIDs, const setOfMailRefs& unloaded,
+                  bool bByReference)
+{
+    if (bByReference) {
+        for (const auto& it : unloaded) {
+            if (it.first != szBox) continue;
+
+            writer.open_element(str_element + "Ref");
+            writer.add_attribute("ID", it.second);
+            writer.close_element();
+        }
+    }
+
+    for (size_t i = 0; i < theMail.size(); ++i) {
+        if (bByReference && !theIDs[i].empty()) {
+            writer.open_element(str_element + "Ref");
+            writer.add_attribute("ID", theIDs[i]);
+            writer.close_element();
+            continue;
+        }
+
+        Message* pMessage = theMail[i];
+        OT_ASSERT(nullptr != pMessage);
+
+        String strMail(*pMessage);
+
+        OTASCIIArmor ascMail;
+
+        if (strMail.Exists()) ascMail.SetString(strMail);
+
+        if (ascMail.Exists()) {
+            writer.add_element(str_element, ascMail.Get());
+        }
+    }
+}
+
+} // namespace
+
 Nym* Nym::LoadPublicNym(const Identifier& NYM_ID, const String* pstrName,
                         const char* szFuncName)
 {
@@ -984,6 +1102,7 @@ void Nym::AddMail(Message& theMessage) // a mail message is a form of
                                        // Nymbox
 {
     m_dequeMail.push_front(&theMessage);
+    m_dequeMailIDs.push_front("");
 }
 
 /// return the number of mail items available for this Nym.
@@ -1019,6 +1138,7 @@ bool Nym::RemoveMailByIndex(int32_t nIndex) // if false, mail
     OT_ASSERT(nullptr != pMessage);
 
     m_dequeMail.erase(m_dequeMail.begin() + nIndex);
+    ForgetStoredMail(MAILBOX_MAIL, m_dequeMailIDs, uIndex);
 
     delete pMessage;
 
@@ -1027,7 +1147,11 @@ bool Nym::RemoveMailByIndex(int32_t nIndex) // if false, mail
 
 void Nym::ClearMail()
 {
-    while (GetMailCount() > 0) RemoveMailByIndex(0);
+    for (auto& it : m_dequeMail) delete it;
+
+    m_dequeMail.clear();
+    m_dequeMailIDs.clear();
+    forget_unloaded_mail(m_setUnloadedMail, MAILBOX_MAIL);
 }
 
 /// Though the parameter is a reference (forcing you to pass a real object),
@@ -1039,6 +1163,7 @@ void Nym::AddOutmail(Message& theMessage) // a mail message is a form
                                           // transported via Nymbox
 {
     m_dequeOutmail.push_front(&theMessage);
+    m_dequeOutmailIDs.push_front("");
 }
 
 /// return the number of mail items available for this Nym.
@@ -1077,6 +1202,7 @@ bool Nym::RemoveOutmailByIndex(int32_t nIndex) // if false,
     OT_ASSERT(nullptr != pMessage);
 
     m_dequeOutmail.erase(m_dequeOutmail.begin() + nIndex);
+    ForgetStoredMail(MAILBOX_OUTMAIL, m_dequeOutmailIDs, uIndex);
 
     delete pMessage;
 
@@ -1085,7 +1211,11 @@ bool Nym::RemoveOutmailByIndex(int32_t nIndex) // if false,
 
 void Nym::ClearOutmail()
 {
-    while (GetOutmailCount() > 0) RemoveOutmailByIndex(0);
+    for (auto& it : m_dequeOutmail) delete it;
+
+    m_dequeOutmail.clear();
+    m_dequeOutmailIDs.clear();
+    forget_unloaded_mail(m_setUnloadedMail, MAILBOX_OUTMAIL);
 }
 
 /// Though the parameter is a reference (forcing you to pass a real object),
@@ -1099,6 +1229,7 @@ void Nym::AddOutpayments(Message& theMessage) // a payments message is
                                               // Nymbox
 {
     m_dequeOutpayments.push_front(&theMessage);
+    m_dequeOutpaymentsIDs.push_front("");
 }
 
 /// return the number of payments items available for this Nym.
@@ -1140,6 +1271,7 @@ bool Nym::RemoveOutpaymentsByIndex(int32_t nIndex, bool bDeleteIt)
     OT_ASSERT(nullptr != pMessage);
 
     m_dequeOutpayments.erase(m_dequeOutpayments.begin() + uIndex);
+    ForgetStoredMail(MAILBOX_OUTPAYMENTS, m_dequeOutpaymentsIDs, uIndex);
 
     if (bDeleteIt) delete pMessage;
 
@@ -1148,7 +1280,67 @@ bool Nym::RemoveOutpaymentsByIndex(int32_t nIndex, bool bDeleteIt)
 
 void Nym::ClearOutpayments()
 {
-    while (GetOutpaymentsCount() > 0) RemoveOutpaymentsByIndex(0);
+    for (auto& it : m_dequeOutpayments) delete it;
+
+    m_dequeOutpayments.clear();
+    m_dequeOutpaymentsIDs.clear();
+    forget_unloaded_mail(m_setUnloadedMail, MAILBOX_OUTPAYMENTS);
+}
+
+void Nym::ForgetStoredMail(const char* szBox, dequeOfMailIDs& theIDs,
+                           uint32_t uIndex)
+{
+    OT_ASSERT(uIndex < theIDs.size());
+
+    if (!theIDs[uIndex].empty())
+        m_setRemovedMail.insert(std::make_pair(szBox, theIDs[uIndex]));
+
+    theIDs.erase(theIDs.begin() + uIndex);
+}
+
+void Nym::StoreMail(const String& strNymID)
+{
+    const std::pair<const dequeOfMail*, dequeOfMailIDs*> boxes[] = {
+        {&m_dequeMail, &m_dequeMailIDs},
+        {&m_dequeOutmail, &m_dequeOutmailIDs},
+        {&m_dequeOutpayments, &m_dequeOutpaymentsIDs}};
+    const char* names[] = {MAILBOX_MAIL, MAILBOX_OUTMAIL, MAILBOX_OUTPAYMENTS};
+
+    for (size_t i = 0; i < 3; ++i) {
+        const dequeOfMail& theMail = *boxes[i].first;
+        dequeOfMailIDs& theIDs = *boxes[i].second;
+
+        for (size_t j = 0; j < theMail.size(); ++j) {
+            if (!theIDs[j].empty()) continue;
+
+            OT_ASSERT(nullptr != theMail[j]);
+
+            // On failure the message is saved inline instead.
+            store_mail(strNymID, names[i], *theMail[j], theIDs[j]);
+        }
+    }
+}
+
+void Nym::EraseRemovedMail(const String& strNymID)
+{
+    for (const auto& it : m_setRemovedMail) {
+        const dequeOfMailIDs& theIDs =
+            (MAILBOX_MAIL == it.first)
+                ? m_dequeMailIDs
+                : ((MAILBOX_OUTMAIL == it.first) ? m_dequeOutmailIDs
+                                                 : m_dequeOutpaymentsIDs);
+
+        // The same message may have been added again since.
+        if ((theIDs.end() !=
+             std::find(theIDs.begin(), theIDs.end(), it.second)) ||
+            (m_setUnloadedMail.end() != m_setUnloadedMail.find(it)))
+            continue;
+
+        OTDB::EraseValueByKey(OTFolders::Mail().Get(), strNymID.Get(),
+                              it.first, it.second);
+    }
+
+    m_setRemovedMail.clear();
 }
 
 // Instead of a "balance statement", some messages require a "transaction
@@ -1193,6 +1385,7 @@ Item* Nym::GenerateTransactionStatement(const OTTransaction& theOwner)
     // COPY THE ISSUED TRANSACTION NUMBERS FROM THE NYM
 
     Nym theMessageNym;
+    NumList theRemoved; // The delta, for a compact statement.
 
     theMessageNym.HarvestIssuedNumbers(
         theOwner.GetPurportedNotaryID(),
@@ -1202,11 +1395,13 @@ Item* Nym::GenerateTransactionStatement(const OTTransaction& theOwner)
     switch (theOwner.GetType()) {
     case OTTransaction::cancelCronItem:
         if (theOwner.GetTransactionNum() > 0) {
-            theMessageNym.RemoveIssuedNum(
-                theOwner.GetRealNotaryID(),
-                theOwner.GetTransactionNum()); // a transaction number is being
-                                               // used, and REMOVED from my list
-                                               // of responsibility,
+            if (theMessageNym.RemoveIssuedNum(
+                    theOwner.GetRealNotaryID(),
+                    theOwner.GetTransactionNum())) // a transaction number is
+                                                   // being used, and REMOVED
+                                                   // from my list of
+                                                   // responsibility,
+                theRemoved.Add(theOwner.GetTransactionNum());
             theMessageNym.RemoveTransactionNum(
                 theOwner.GetRealNotaryID(),
                 theOwner.GetTransactionNum()); // so I want the new signed list
@@ -1245,6 +1440,21 @@ Item* Nym::GenerateTransactionStatement(const OTTransaction& theOwner)
                                        // "date signed" variable.
     pBalanceItem->SaveContract();
 
+    // Send a digest instead of the list, if turned on. Not without a
+    // transaction number, though: processNymbox needs the list itself.
+    if (OTStatementDigest::IsEnabled() &&
+        (OTTransaction::processNymbox != theOwner.GetType()) &&
+        (theOwner.GetTransactionNum() > 0)) {
+        const String strNymID(m_nymID);
+        Item* pCompact = OTStatementDigest::Compact(
+            *pBalanceItem, theOwner, theRemoved, *this, strNymID);
+
+        if (nullptr != pCompact) {
+            delete pBalanceItem;
+            pBalanceItem = pCompact;
+        }
+    }
+
     return pBalanceItem;
 }
 
@@ -1435,9 +1645,7 @@ bool Nym::SetIdentifierByPubkey()
 #define CLEAR_MAP_AND_DEQUE(the_map)                                           \
     for (auto& it : the_map) {                                                 \
         if ((nullptr != pstrNotaryID) && (str_NotaryID != it.first)) continue; \
-        dequeOfTransNums* pDeque = (it.second);                                \
-        OT_ASSERT(nullptr != pDeque);                                          \
-        if (!(pDeque->empty())) pDeque->clear();                               \
+        it.second.Clear();                                                     \
     }
 #endif // CLEAR_MAP_AND_DEQUE
 
@@ -1742,23 +1950,12 @@ bool Nym::UnRegisterAtServer(const String& strNotaryID)
     return bRetVal;
 }
 
-#ifndef WIPE_MAP_AND_DEQUE
-#define WIPE_MAP_AND_DEQUE(the_map)                                            \
-    while (!the_map.empty()) {                                                 \
-        dequeOfTransNums* pDeque = the_map.begin()->second;                    \
-        OT_ASSERT(nullptr != pDeque);                                          \
-        the_map.erase(the_map.begin());                                        \
-        delete pDeque;                                                         \
-        pDeque = nullptr;                                                      \
-    }
-#endif // WIPE_MAP_AND_DEQUE
-
 void Nym::ReleaseTransactionNumbers()
 {
-    WIPE_MAP_AND_DEQUE(m_mapTransNum)
-    WIPE_MAP_AND_DEQUE(m_mapIssuedNum)
-    WIPE_MAP_AND_DEQUE(m_mapTentativeNum)
-    WIPE_MAP_AND_DEQUE(m_mapAcknowledgedNum)
+    m_mapTransNum.clear();
+    m_mapIssuedNum.clear();
+    m_mapTentativeNum.clear();
+    m_mapAcknowledgedNum.clear();
 }
 
 /*
@@ -2057,49 +2254,17 @@ bool Nym::ResyncWithServer(const Ledger& theNymbox, const Nym& theMessageNym)
     return (SaveSignedNymfile(*this) && bSuccess);
 }
 
-/*
-typedef std::deque<int64_t>                            dequeOfTransNums;
-typedef std::map<std::string, dequeOfTransNums *>    mapOfTransNums;
-*/
-
 // Verify whether a certain transaction number appears on a certain list.
 //
 bool Nym::VerifyGenericNum(const mapOfTransNums& THE_MAP,
                            const String& strNotaryID,
                            const int64_t& lTransNum) const
 {
-    std::string strID = strNotaryID.Get();
-
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then return true. Else return false.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        return true;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    // The Pseudonym has a set of transaction numbers for each server.
+    // These sets are mapped by Notary ID.
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    return false;
+    return (THE_MAP.end() != it) && it->second.Contains(lTransNum);
 }
 
 // On the server side: A user has submitted a specific transaction number.
@@ -2124,42 +2289,9 @@ bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, Nym& SIGNER_NYM,
 bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
                            const int64_t& lTransNum)
 {
-    bool bRetVal = false;
-    std::string strID = strNotaryID.Get();
-
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then remove it, and return true. Else return false.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        pDeque->erase(pDeque->begin() + i);
-                        bRetVal = true;
-                        break;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    return bRetVal;
+    return (THE_MAP.end() != it) && it->second.Remove(lTransNum);
 }
 
 // No signer needed for this one, and save is false.
@@ -2167,50 +2299,22 @@ bool Nym::RemoveGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
 bool Nym::AddGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
                         int64_t lTransNum)
 {
-    bool bSuccessFindingNotaryID = false, bSuccess = false;
-    std::string strID = strNotaryID.Get();
+    // If there is not yet a set stored for this specific notaryID, this
+    // creates it. Numbers that are already there are not added twice.
+    THE_MAP[strNotaryID.Get()].Insert(lTransNum);
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then add the transaction
-    // number.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            auto iter = std::find(pDeque->begin(), pDeque->end(), lTransNum);
-
-            if (iter == pDeque->end()) // Only add it if it's not already there.
-                                       // No duplicates!
-                pDeque->push_front(lTransNum);
-
-            bSuccess = true;
-            bSuccessFindingNotaryID = true;
-
-            break;
-        }
-    }
-
-    // Apparently there is not yet a deque stored for this specific notaryID.
-    // Fine. Let's create it then, and then add the transaction num to that new
-    // deque.
-    if (!bSuccessFindingNotaryID) {
-        dequeOfTransNums* pDeque = new dequeOfTransNums;
+    return true;
+}
 
-        OT_ASSERT(nullptr != pDeque);
+void Nym::AddGenericNums(mapOfTransNums& THE_MAP, const String& strNotaryID,
+                         const OTNumberSet& theNumbers)
+{
+    if (theNumbers.empty()) return;
 
-        THE_MAP[strID] = pDeque;
-        pDeque->push_front(lTransNum);
-        bSuccess = true;
-    }
+    OTNumberSet& theSet = THE_MAP[strNotaryID.Get()];
 
-    return bSuccess;
+    for (const auto& it : theNumbers.GetRanges())
+        theSet.InsertRange(it.first, it.second);
 }
 
 // Returns count of transaction numbers available for a given server.
@@ -2218,74 +2322,25 @@ bool Nym::AddGenericNum(mapOfTransNums& THE_MAP, const String& strNotaryID,
 int32_t Nym::GetGenericNumCount(const mapOfTransNums& THE_MAP,
                                 const Identifier& theNotaryID) const
 {
-    int32_t nReturnValue = 0;
-
     const String strNotaryID(theNotaryID);
-    std::string strID = strNotaryID.Get();
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    dequeOfTransNums* pDeque = nullptr;
+    if (THE_MAP.end() == it) return 0;
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then we found the right server.
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            break;
-        }
-    }
-
-    // We found the right server, so let's count the transaction numbers
-    // that this nym has already stored for it.
-    if (nullptr != pDeque) {
-        nReturnValue = static_cast<int32_t>(pDeque->size());
-    }
-
-    return nReturnValue;
+    return static_cast<int32_t>(it->second.Count());
 }
 
-// by index.
+// by index. (Lowest number first.)
 int64_t Nym::GetGenericNum(const mapOfTransNums& THE_MAP,
                            const Identifier& theNotaryID, int32_t nIndex) const
 {
     int64_t lRetVal = 0;
 
     const String strNotaryID(theNotaryID);
-    std::string strID = strNotaryID.Get();
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // maps matches the Notary ID that was passed in, then find the number on
-    // that list, and then return it.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty())) // there are some numbers for that server ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (static_cast<uint32_t>(nIndex) == i) {
-                        lRetVal = pDeque->at(i); // <==== Got the number here.
-                        break;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    if ((THE_MAP.end() != it) && (nIndex >= 0))
+        it->second.At(static_cast<size_t>(nIndex), lRetVal);
 
     return lRetVal;
 }
@@ -2482,36 +2537,19 @@ bool Nym::AddAcknowledgedNum(const String& strNotaryID,
                                                          // save.
 {
     // We're going to call AddGenericNum, but first, let's enforce a cap on the
-    // total
-    // number of ackNums allowed...
+    // total number of ackNums allowed. The oldest (lowest) request numbers go
+    // first.
     //
-    std::string strID = strNotaryID.Get();
+    auto it = m_mapAcknowledgedNum.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then we'll pop the size of the
-    // deque
-    // down to our max size (off the back) before then calling AddGenericNum
-    // which will
-    // push the new request number onto the front.
-    //
-    for (auto& it : m_mapAcknowledgedNum) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            while (pDeque->size() > OT_MAX_ACK_NUMS) {
-                pDeque->pop_back(); // This fixes knotwork's issue where he had
-                                    // thousands of ack nums somehow never
-                                    // getting cleared out. Now we have a MAX
-                                    // and always keep it clean otherwise.
-            }
-            break;
-        }
+    if (m_mapAcknowledgedNum.end() != it) {
+        it->second.KeepHighest(OT_MAX_ACK_NUMS); // This fixes knotwork's
+                                                 // issue where he had
+                                                 // thousands of ack nums
+                                                 // somehow never getting
+                                                 // cleared out. Now we
+                                                 // have a MAX and always
+                                                 // keep it clean otherwise.
     }
 
     return AddGenericNum(m_mapAcknowledgedNum, strNotaryID,
@@ -2637,49 +2675,35 @@ void Nym::HarvestTransactionNumbers(const Identifier& theNotaryID,
                                     Nym& SIGNER_NYM, Nym& theOtherNym,
                                     bool bSave)
 {
-    int64_t lTransactionNumber = 0;
-
     std::set<int64_t> setInput, setOutputGood, setOutputBad;
 
-    for (auto& it : theOtherNym.GetMapIssuedNum()) {
-        std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
-
-        String OTstrNotaryID = strNotaryID.c_str();
-        const Identifier theTempID(OTstrNotaryID);
-
-        if (!(pDeque->empty()) &&
-            (theNotaryID == theTempID)) // only for the matching notaryID.
-        {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-
-                // If number wasn't already on issued list, then add to BOTH
-                // lists.
-                // Otherwise do nothing (it's already on the issued list, and no
-                // longer
-                // valid on the available list--thus shouldn't be re-added there
-                // anyway.)
-                //
-                if ((true == VerifyTentativeNum(
-                                 OTstrNotaryID,
-                                 lTransactionNumber)) && // If I've actually
-                                                         // requested this
-                                                         // number and waiting
-                                                         // on it...
-                    (false ==
-                     VerifyIssuedNum(OTstrNotaryID,
-                                     lTransactionNumber)) // and if it's not
-                                                          // already on my
-                                                          // issued list...
-                    )
-                    setInput.insert(lTransactionNumber);
-            }
-            break; // We found it! Might as well break out.
-        }
-    } // for
+    const String OTstrNotaryID(theNotaryID);
+    auto it = theOtherNym.GetMapIssuedNum().find(OTstrNotaryID.Get());
+
+    if (theOtherNym.GetMapIssuedNum().end() != it) {
+        it->second.ForEach([&](int64_t lTransactionNumber) {
+            // If number wasn't already on issued list, then add to BOTH
+            // lists.
+            // Otherwise do nothing (it's already on the issued list, and no
+            // longer
+            // valid on the available list--thus shouldn't be re-added there
+            // anyway.)
+            //
+            if ((true == VerifyTentativeNum(
+                             OTstrNotaryID,
+                             lTransactionNumber)) && // If I've actually
+                                                     // requested this
+                                                     // number and waiting
+                                                     // on it...
+                (false ==
+                 VerifyIssuedNum(OTstrNotaryID,
+                                 lTransactionNumber)) // and if it's not
+                                                      // already on my
+                                                      // issued list...
+                )
+                setInput.insert(lTransactionNumber);
+        });
+    }
 
     // Looks like we found some numbers to harvest
     // (tentative numbers we had already been waiting for,
@@ -2771,40 +2795,29 @@ void Nym::HarvestIssuedNumbers(const Identifier& theNotaryID, Nym& SIGNER_NYM,
                                Nym& theOtherNym, bool bSave)
 {
     bool bChangedTheNym = false;
-    int64_t lTransactionNumber = 0;
-
-    for (auto& it : theOtherNym.GetMapIssuedNum()) {
-        std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
 
-        String OTstrNotaryID =
-            ((strNotaryID.size()) > 0 ? strNotaryID.c_str() : "");
-        const Identifier theTempID(OTstrNotaryID);
-
-        if (!(pDeque->empty()) && (theNotaryID == theTempID)) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-
-                // If number wasn't already on issued list, then add to BOTH
-                // lists.
-                // Otherwise do nothing (it's already on the issued list, and no
-                // longer
-                // valid on the available list--thus shouldn't be re-added there
-                // anyway.)
-                //
-                if (false ==
-                    VerifyIssuedNum(OTstrNotaryID, lTransactionNumber)) {
-                    AddTransactionNum(
-                        SIGNER_NYM, OTstrNotaryID, lTransactionNumber,
-                        false); // bSave = false (but saved below...)
-                    bChangedTheNym = true;
-                }
-            }
-            break; // We found it! Might as well break out.
+    const String OTstrNotaryID(theNotaryID);
+    auto it = theOtherNym.GetMapIssuedNum().find(OTstrNotaryID.Get());
+
+    // Copied first, in case theOtherNym is this Nym.
+    const OTNumberSet theNumbers =
+        (theOtherNym.GetMapIssuedNum().end() != it) ? it->second
+                                                    : OTNumberSet();
+
+    theNumbers.ForEach([&](int64_t lTransactionNumber) {
+        // If number wasn't already on issued list, then add to BOTH
+        // lists.
+        // Otherwise do nothing (it's already on the issued list, and no
+        // longer
+        // valid on the available list--thus shouldn't be re-added there
+        // anyway.)
+        //
+        if (false == VerifyIssuedNum(OTstrNotaryID, lTransactionNumber)) {
+            AddTransactionNum(SIGNER_NYM, OTstrNotaryID, lTransactionNumber,
+                              false); // bSave = false (but saved below...)
+            bChangedTheNym = true;
         }
-    } // for
+    });
 
     if (bChangedTheNym && bSave) {
         SaveSignedNymfile(SIGNER_NYM);
@@ -2850,32 +2863,19 @@ bool Nym::GetNextTransactionNum(Nym& SIGNER_NYM, const String& strNotaryID,
                                 int64_t& lTransNum, bool bSave)
 {
     bool bRetVal = false;
-    std::string strID = strNotaryID.Get();
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then send out the transaction
-    // number.
+    // The Pseudonym has a set of transaction numbers for each server.
+    // These sets are mapped by Notary ID.
     //
-    for (auto& it : m_mapTransNum) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+    auto it = m_mapTransNum.find(strNotaryID.Get());
 
-            if (!(pDeque->empty())) {
-                lTransNum = pDeque->back();
+    if ((m_mapTransNum.end() != it) && !it->second.empty()) {
+        // The lowest (oldest) number goes out first.
+        lTransNum = it->second.Lowest();
+        it->second.Remove(lTransNum);
 
-                pDeque->pop_back();
-
-                // The call has succeeded
-                bRetVal = true;
-            }
-            break;
-        }
+        // The call has succeeded
+        bRetVal = true;
     }
 
     if (bRetVal && bSave) {
@@ -3642,61 +3642,57 @@ void Nym::DisplayStatistics(String& strOutput)
 
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const OTNumberSet& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
+        if (!theNumbers.empty()) {
             strOutput.Concatenate(
                 "---- Transaction numbers still signed out from server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
+            const char* szFormat = "%" PRId64;
 
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lTransactionNumber);
-            }
+            theNumbers.ForEach([&](int64_t lTransactionNumber) {
+                strOutput.Concatenate(szFormat, lTransactionNumber);
+                szFormat = ", %" PRId64;
+            });
             strOutput.Concatenate("\n");
         }
     } // for
 
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const OTNumberSet& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
+        if (!theNumbers.empty()) {
             strOutput.Concatenate(
                 "---- Transaction numbers still usable on server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lTransactionNumber);
-            }
+            const char* szFormat = "%" PRId64;
+
+            theNumbers.ForEach([&](int64_t lTransactionNumber) {
+                strOutput.Concatenate(szFormat, lTransactionNumber);
+                szFormat = ", %" PRId64;
+            });
             strOutput.Concatenate("\n");
         }
     } // for
 
     for (auto& it : m_mapAcknowledgedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const OTNumberSet& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
+        if (!theNumbers.empty()) {
             strOutput.Concatenate("---- Request numbers for which Nym has "
                                   "already received a reply from server: %s\n",
                                   strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lRequestNumber = pDeque->at(i);
-                strOutput.Concatenate(0 == i ? "%" PRId64 : ", %" PRId64,
-                                      lRequestNumber);
-            }
+            const char* szFormat = "%" PRId64;
+
+            theNumbers.ForEach([&](int64_t lRequestNumber) {
+                strOutput.Concatenate(szFormat, lRequestNumber);
+                szFormat = ", %" PRId64;
+            });
             strOutput.Concatenate("\n");
         }
     } // for
@@ -3913,6 +3909,26 @@ void Nym::SerializeNymIDSource(Tag& parent) const
     }
 }
 
+void Nym::SerializeNymIDSource(XmlWriter& writer) const
+{
+    // We encode these before storing.
+    if (m_strSourceForNymID.Exists()) {
+        const OTASCIIArmor ascSourceForNymID(m_strSourceForNymID);
+
+        writer.open_element("nymIDSource");
+
+        if (m_strAltLocation.Exists()) {
+            OTASCIIArmor ascAltLocation;
+            ascAltLocation.SetString(m_strAltLocation,
+                                     false); // bLineBreaks=true by default.
+
+            writer.add_attribute("altLocation", ascAltLocation.Get());
+        }
+        writer.set_text(ascSourceForNymID.Get());
+        writer.close_element();
+    }
+}
+
 void Nym::SaveCredentialIDsToString(String& strOutput)
 {
     Tag tag("nymData");
@@ -4087,18 +4103,25 @@ void Nym::SaveCredentialsToTag(Tag& parent, String::Map* pmapPubInfo,
 // Save the Pseudonym to a string...
 bool Nym::SavePseudonym(String& strNym)
 {
-    Tag tag("nymData");
+    return SavePseudonym(strNym, false);
+}
 
+bool Nym::SavePseudonym(String& strNym, bool bMailByReference)
+{
     String nymID;
     GetIdentifier(nymID);
 
-    tag.add_attribute("version", m_strVersion.Get());
-    tag.add_attribute("nymID", nymID.Get());
+    std::string str_result;
+    XmlWriter writer(str_result);
+
+    writer.open_element("nymData");
+    writer.add_attribute("version", m_strVersion.Get());
+    writer.add_attribute("nymID", nymID.Get());
 
     if (m_lUsageCredits != 0)
-        tag.add_attribute("usageCredits", formatLong(m_lUsageCredits));
+        writer.add_attribute("usageCredits", formatLong(m_lUsageCredits));
 
-    SerializeNymIDSource(tag);
+    SerializeNymIDSource(writer);
 
     // For now I'm saving the credential list to a separate file.
     // (And then of course, each credential also gets its own file.)
@@ -4114,24 +4137,24 @@ bool Nym::SavePseudonym(String& strNym)
         std::string strNotaryID = it.first;
         int64_t lRequestNum = it.second;
 
-        TagPtr pTag(new Tag("requestNum"));
+        writer.open_element("requestNum");
 
-        pTag->add_attribute("notaryID", strNotaryID);
-        pTag->add_attribute("currentRequestNum", formatLong(lRequestNum));
+        writer.add_attribute("notaryID", strNotaryID);
+        writer.add_attribute("currentRequestNum", formatLong(lRequestNum));
 
-        tag.add_tag(pTag);
+        writer.close_element();
     }
 
     for (auto& it : m_mapHighTransNo) {
         std::string strNotaryID = it.first;
         int64_t lHighestNum = it.second;
 
-        TagPtr pTag(new Tag("highestTransNum"));
+        writer.open_element("highestTransNum");
 
-        pTag->add_attribute("notaryID", strNotaryID);
-        pTag->add_attribute("mostRecent", formatLong(lHighestNum));
+        writer.add_attribute("notaryID", strNotaryID);
+        writer.add_attribute("mostRecent", formatLong(lHighestNum));
 
-        tag.add_tag(pTag);
+        writer.close_element();
     }
 
     // When you delete a Nym, it just marks it.
@@ -4139,92 +4162,75 @@ bool Nym::SavePseudonym(String& strNym)
     // (targeting marked nyms...)
     //
     if (m_bMarkForDeletion) {
-        tag.add_tag("MARKED_FOR_DELETION", "THIS NYM HAS BEEN MARKED "
-                                           "FOR DELETION AT ITS OWN REQUEST");
+        writer.add_element("MARKED_FOR_DELETION",
+                           "THIS NYM HAS BEEN MARKED "
+                           "FOR DELETION AT ITS OWN REQUEST");
     }
 
-    int64_t lTransactionNumber = 0;
-
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const OTNumberSet& theNumbers = it.second;
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!theNumbers.empty() && (strNotaryID.size() > 0)) {
             NumList theList;
+            theList.Add(theNumbers);
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-                theList.Add(lTransactionNumber);
-            }
             String strTemp;
             if ((theList.Count() > 0) && theList.Output(strTemp) &&
                 strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
-                    TagPtr pTag(new Tag("transactionNums", ascTemp.Get()));
-                    pTag->add_attribute("notaryID", strNotaryID);
-                    tag.add_tag(pTag);
+                    writer.open_element("transactionNums");
+                    writer.add_attribute("notaryID", strNotaryID);
+                    writer.set_text(ascTemp.Get());
+                    writer.close_element();
                 }
             }
         }
     } // for
 
-    lTransactionNumber = 0;
-
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const OTNumberSet& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!theNumbers.empty() && (strNotaryID.size() > 0)) {
             NumList theList;
+            theList.Add(theNumbers);
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-                theList.Add(lTransactionNumber);
-            }
             String strTemp;
             if ((theList.Count() > 0) && theList.Output(strTemp) &&
                 strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
-                    TagPtr pTag(new Tag("issuedNums", ascTemp.Get()));
-                    pTag->add_attribute("notaryID", strNotaryID);
-                    tag.add_tag(pTag);
+                    writer.open_element("issuedNums");
+                    writer.add_attribute("notaryID", strNotaryID);
+                    writer.set_text(ascTemp.Get());
+                    writer.close_element();
                 }
             }
         }
     } // for
 
-    lTransactionNumber = 0;
-
     for (auto& it : m_mapTentativeNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const OTNumberSet& theNumbers = it.second;
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!theNumbers.empty() && (strNotaryID.size() > 0)) {
             NumList theList;
+            theList.Add(theNumbers);
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-                theList.Add(lTransactionNumber);
-            }
             String strTemp;
             if ((theList.Count() > 0) && theList.Output(strTemp) &&
                 strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
-                    TagPtr pTag(new Tag("tentativeNums", ascTemp.Get()));
-                    pTag->add_attribute("notaryID", strNotaryID);
-                    tag.add_tag(pTag);
+                    writer.open_element("tentativeNums");
+                    writer.add_attribute("notaryID", strNotaryID);
+                    writer.set_text(ascTemp.Get());
+                    writer.close_element();
                 }
             }
         }
@@ -4239,83 +4245,35 @@ bool Nym::SavePseudonym(String& strNym)
     //
     for (auto& it : m_mapAcknowledgedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const OTNumberSet& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
+        if (!theNumbers.empty() && (strNotaryID.size() > 0)) {
             NumList theList;
+            theList.Add(theNumbers);
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                const int64_t lRequestNumber = pDeque->at(i);
-                theList.Add(lRequestNumber);
-            }
             String strTemp;
             if ((theList.Count() > 0) && theList.Output(strTemp) &&
                 strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
-                    TagPtr pTag(new Tag("ackNums", ascTemp.Get()));
-                    pTag->add_attribute("notaryID", strNotaryID);
-                    tag.add_tag(pTag);
+                    writer.open_element("ackNums");
+                    writer.add_attribute("notaryID", strNotaryID);
+                    writer.set_text(ascTemp.Get());
+                    writer.close_element();
                 }
             }
         }
 
     } // for
 
-    if (!(m_dequeMail.empty())) {
-        for (uint32_t i = 0; i < m_dequeMail.size(); i++) {
-            Message* pMessage = m_dequeMail.at(i);
-            OT_ASSERT(nullptr != pMessage);
-
-            String strMail(*pMessage);
-
-            OTASCIIArmor ascMail;
-
-            if (strMail.Exists()) ascMail.SetString(strMail);
-
-            if (ascMail.Exists()) {
-                tag.add_tag("mailMessage", ascMail.Get());
-            }
-        }
-    }
-
-    if (!(m_dequeOutmail.empty())) {
-        for (uint32_t i = 0; i < m_dequeOutmail.size(); i++) {
-            Message* pMessage = m_dequeOutmail.at(i);
-            OT_ASSERT(nullptr != pMessage);
-
-            String strOutmail(*pMessage);
-
-            OTASCIIArmor ascOutmail;
-
-            if (strOutmail.Exists()) ascOutmail.SetString(strOutmail);
-
-            if (ascOutmail.Exists()) {
-                tag.add_tag("outmailMessage", ascOutmail.Get());
-            }
-        }
-    }
-
-    if (!(m_dequeOutpayments.empty())) {
-        for (uint32_t i = 0; i < m_dequeOutpayments.size(); i++) {
-            Message* pMessage = m_dequeOutpayments.at(i);
-            OT_ASSERT(nullptr != pMessage);
-
-            String strOutpayments(*pMessage);
-
-            OTASCIIArmor ascOutpayments;
-
-            if (strOutpayments.Exists())
-                ascOutpayments.SetString(strOutpayments);
-
-            if (ascOutpayments.Exists()) {
-                tag.add_tag("outpaymentsMessage", ascOutpayments.Get());
-            }
-        }
-    }
+    save_mailbox(writer, "mailMessage", MAILBOX_MAIL, m_dequeMail,
+                 m_dequeMailIDs, m_setUnloadedMail, bMailByReference);
+    save_mailbox(writer, "outmailMessage", MAILBOX_OUTMAIL, m_dequeOutmail,
+                 m_dequeOutmailIDs, m_setUnloadedMail, bMailByReference);
+    save_mailbox(writer, "outpaymentsMessage", MAILBOX_OUTPAYMENTS,
+                 m_dequeOutpayments, m_dequeOutpaymentsIDs, m_setUnloadedMail,
+                 bMailByReference);
 
     // These are used on the server side.
     // (That's why you don't see the server ID saved here.)
@@ -4323,9 +4281,9 @@ bool Nym::SavePseudonym(String& strNym)
     if (!(m_setOpenCronItems.empty())) {
         for (auto& it : m_setOpenCronItems) {
             int64_t lID = it;
-            TagPtr pTag(new Tag("hasOpenCronItem"));
-            pTag->add_attribute("ID", formatLong(lID));
-            tag.add_tag(pTag);
+            writer.open_element("hasOpenCronItem");
+            writer.add_attribute("ID", formatLong(lID));
+            writer.close_element();
         }
     }
 
@@ -4335,9 +4293,9 @@ bool Nym::SavePseudonym(String& strNym)
     if (!(m_setAccounts.empty())) {
         for (auto& it : m_setAccounts) {
             std::string strID(it);
-            TagPtr pTag(new Tag("ownsAssetAcct"));
-            pTag->add_attribute("ID", strID);
-            tag.add_tag(pTag);
+            writer.open_element("ownsAssetAcct");
+            writer.add_attribute("ID", strID);
+            writer.close_element();
         }
     }
 
@@ -4348,10 +4306,10 @@ bool Nym::SavePseudonym(String& strNym)
 
         if ((strNotaryID.size() > 0) && !theID.IsEmpty()) {
             const String strNymboxHash(theID);
-            TagPtr pTag(new Tag("nymboxHashItem"));
-            pTag->add_attribute("notaryID", strNotaryID);
-            pTag->add_attribute("nymboxHash", strNymboxHash.Get());
-            tag.add_tag(pTag);
+            writer.open_element("nymboxHashItem");
+            writer.add_attribute("notaryID", strNotaryID);
+            writer.add_attribute("nymboxHash", strNymboxHash.Get());
+            writer.close_element();
         }
     } // for
 
@@ -4362,19 +4320,19 @@ bool Nym::SavePseudonym(String& strNym)
 
         if ((strNotaryID.size() > 0) && !theID.IsEmpty()) {
             const String strRecentHash(theID);
-            TagPtr pTag(new Tag("recentHashItem"));
-            pTag->add_attribute("notaryID", strNotaryID);
-            pTag->add_attribute("recentHash", strRecentHash.Get());
-            tag.add_tag(pTag);
+            writer.open_element("recentHashItem");
+            writer.add_attribute("notaryID", strNotaryID);
+            writer.add_attribute("recentHash", strRecentHash.Get());
+            writer.close_element();
         }
     } // for
 
     // server-side
     if (!m_NymboxHash.IsEmpty()) {
         const String strNymboxHash(m_NymboxHash);
-        TagPtr pTag(new Tag("nymboxHash"));
-        pTag->add_attribute("value", strNymboxHash.Get());
-        tag.add_tag(pTag);
+        writer.open_element("nymboxHash");
+        writer.add_attribute("value", strNymboxHash.Get());
+        writer.close_element();
     }
 
     // client-side
@@ -4384,10 +4342,10 @@ bool Nym::SavePseudonym(String& strNym)
 
         if ((strAcctID.size() > 0) && !theID.IsEmpty()) {
             const String strHash(theID);
-            TagPtr pTag(new Tag("inboxHashItem"));
-            pTag->add_attribute("accountID", strAcctID);
-            pTag->add_attribute("hashValue", strHash.Get());
-            tag.add_tag(pTag);
+            writer.open_element("inboxHashItem");
+            writer.add_attribute("accountID", strAcctID);
+            writer.add_attribute("hashValue", strHash.Get());
+            writer.close_element();
         }
     } // for
 
@@ -4398,15 +4356,14 @@ bool Nym::SavePseudonym(String& strNym)
 
         if ((strAcctID.size() > 0) && !theID.IsEmpty()) {
             const String strHash(theID);
-            TagPtr pTag(new Tag("outboxHashItem"));
-            pTag->add_attribute("accountID", strAcctID);
-            pTag->add_attribute("hashValue", strHash.Get());
-            tag.add_tag(pTag);
+            writer.open_element("outboxHashItem");
+            writer.add_attribute("accountID", strAcctID);
+            writer.add_attribute("hashValue", strHash.Get());
+            writer.close_element();
         }
     } // for
 
-    std::string str_result;
-    tag.output(str_result);
+    writer.close_element();
 
     strNym.Concatenate("%s", str_result.c_str());
 
@@ -4532,6 +4489,14 @@ bool Nym::LoadFromString(const String& strNym,
                          // credentials have been sent
                          // inside a message.)
                          String* pstrReason, const OTPassword* pImportPassword)
+{
+    return LoadFromString(strNym, pMapCredentials, pstrReason,
+                          pImportPassword, false);
+}
+
+bool Nym::LoadFromString(const String& strNym, String::Map* pMapCredentials,
+                         String* pstrReason, const OTPassword* pImportPassword,
+                         bool bMailByReference)
 {
     bool bSuccess = false;
 
@@ -5026,19 +4991,15 @@ bool Nym::LoadFromString(const String& strNym,
 
                 if (strTemp.Exists()) theNumList.Add(strTemp);
 
-                int64_t lTemp = 0;
-                while (theNumList.Peek(lTemp)) {
-                    theNumList.Pop();
-
-                    otLog3 << "Transaction Number " << lTemp
-                           << " ready-to-use for NotaryID: " << tempNotaryID
-                           << "\n";
-                    AddTransactionNum(tempNotaryID, lTemp); // This version
-                                                            // doesn't save to
-                                                            // disk. (Why save
-                                                            // to disk AS WE'RE
-                                                            // LOADING?)
-                }
+                otLog3 << "Transaction Numbers " << strTemp
+                       << " ready-to-use for NotaryID: " << tempNotaryID
+                       << "\n";
+                AddGenericNums(m_mapTransNum, tempNotaryID,
+                               theNumList.GetNumbers()); // This version
+                                                         // doesn't save to
+                                                         // disk. (Why save
+                                                         // to disk AS WE'RE
+                                                         // LOADING?)
             }
             else if (strNodeName.Compare("issuedNums")) {
                 const String tempNotaryID = xml->getAttributeValue("notaryID");
@@ -5053,17 +5014,14 @@ bool Nym::LoadFromString(const String& strNym,
 
                 if (strTemp.Exists()) theNumList.Add(strTemp);
 
-                int64_t lTemp = 0;
-                while (theNumList.Peek(lTemp)) {
-                    theNumList.Pop();
-
-                    otLog3 << "Currently liable for issued trans# " << lTemp
-                           << " at NotaryID: " << tempNotaryID << "\n";
-                    AddIssuedNum(tempNotaryID, lTemp); // This version doesn't
-                                                       // save to disk. (Why
-                                                       // save to disk AS WE'RE
-                                                       // LOADING?)
-                }
+                otLog3 << "Currently liable for issued trans# " << strTemp
+                       << " at NotaryID: " << tempNotaryID << "\n";
+                AddGenericNums(m_mapIssuedNum, tempNotaryID,
+                               theNumList.GetNumbers()); // This version
+                                                         // doesn't save to
+                                                         // disk. (Why save
+                                                         // to disk AS WE'RE
+                                                         // LOADING?)
             }
             else if (strNodeName.Compare("tentativeNums")) {
                 const String tempNotaryID = xml->getAttributeValue("notaryID");
@@ -5078,19 +5036,15 @@ bool Nym::LoadFromString(const String& strNym,
 
                 if (strTemp.Exists()) theNumList.Add(strTemp);
 
-                int64_t lTemp = 0;
-                while (theNumList.Peek(lTemp)) {
-                    theNumList.Pop();
-
-                    otLog3 << "Tentative: Currently awaiting success notice, "
-                              "for accepting trans# " << lTemp
-                           << " for NotaryID: " << tempNotaryID << "\n";
-                    AddTentativeNum(tempNotaryID, lTemp); // This version
-                                                          // doesn't save to
-                                                          // disk. (Why save to
-                                                          // disk AS WE'RE
-                                                          // LOADING?)
-                }
+                otLog3 << "Tentative: Currently awaiting success notice, "
+                          "for accepting trans# " << strTemp
+                       << " for NotaryID: " << tempNotaryID << "\n";
+                AddGenericNums(m_mapTentativeNum, tempNotaryID,
+                               theNumList.GetNumbers()); // This version
+                                                         // doesn't save to
+                                                         // disk. (Why save
+                                                         // to disk AS WE'RE
+                                                         // LOADING?)
             }
             else if (strNodeName.Compare("ackNums")) {
                 const String tempNotaryID = xml->getAttributeValue("notaryID");
@@ -5120,19 +5074,21 @@ bool Nym::LoadFromString(const String& strNym,
 
                 if (strTemp.Exists()) theNumList.Add(strTemp);
 
-                int64_t lTemp = 0;
-                while (theNumList.Peek(lTemp)) {
-                    theNumList.Pop();
-
-                    otInfo << "Acknowledgment record exists for server reply, "
-                              "for Request Number " << lTemp
-                           << " for NotaryID: " << tempNotaryID << "\n";
-                    AddAcknowledgedNum(tempNotaryID, lTemp); // This version
-                                                             // doesn't save to
-                                                             // disk. (Why save
-                                                             // to disk AS WE'RE
-                                                             // LOADING?)
-                }
+                otInfo << "Acknowledgment record exists for server reply, "
+                          "for Request Numbers " << strTemp
+                       << " for NotaryID: " << tempNotaryID << "\n";
+                AddGenericNums(m_mapAcknowledgedNum, tempNotaryID,
+                               theNumList.GetNumbers()); // This version
+                                                         // doesn't save to
+                                                         // disk. (Why save
+                                                         // to disk AS WE'RE
+                                                         // LOADING?)
+
+                // The same cap AddAcknowledgedNum keeps to.
+                auto it = m_mapAcknowledgedNum.find(tempNotaryID.Get());
+
+                if (m_mapAcknowledgedNum.end() != it)
+                    it->second.KeepHighest(OT_MAX_ACK_NUMS);
             }
 
             // THE BELOW FOUR ARE DEPRECATED, AND ARE REPLACED BY THE ABOVE
@@ -5276,9 +5232,11 @@ bool Nym::LoadFromString(const String& strNym,
                                 OT_ASSERT(nullptr != pMessage);
 
                                 if (pMessage->LoadContractFromString(
-                                        strMessage))
+                                        strMessage)) {
                                     m_dequeMail.push_back(
                                         pMessage); // takes ownership
+                                    m_dequeMailIDs.push_back("");
+                                }
                                 else
                                     delete pMessage;
                             }
@@ -5318,9 +5276,11 @@ bool Nym::LoadFromString(const String& strNym,
                                 OT_ASSERT(nullptr != pMessage);
 
                                 if (pMessage->LoadContractFromString(
-                                        strMessage))
+                                        strMessage)) {
                                     m_dequeOutmail.push_back(
                                         pMessage); // takes ownership
+                                    m_dequeOutmailIDs.push_back("");
+                                }
                                 else
                                     delete pMessage;
                             }
@@ -5360,9 +5320,11 @@ bool Nym::LoadFromString(const String& strNym,
                                 OT_ASSERT(nullptr != pMessage);
 
                                 if (pMessage->LoadContractFromString(
-                                        strMessage))
+                                        strMessage)) {
                                     m_dequeOutpayments.push_back(
                                         pMessage); // takes ownership
+                                    m_dequeOutpaymentsIDs.push_back("");
+                                }
                                 else
                                     delete pMessage;
                             }
@@ -5370,6 +5332,51 @@ bool Nym::LoadFromString(const String& strNym,
                     } // strNodeData
                 }     // EXN_TEXT
             }         // outpayments message
+            else if (strNodeName.Compare("mailMessageRef") ||
+                     strNodeName.Compare("outmailMessageRef") ||
+                     strNodeName.Compare("outpaymentsMessageRef")) {
+                if (!bMailByReference) {
+                    otErr << __FUNCTION__ << ": " << strNodeName
+                          << " is only allowed in a local signed nymfile.\n";
+                    return false;
+                }
+
+                const char* szID = xml->getAttributeValue("ID");
+                const std::string str_id(nullptr == szID ? "" : szID);
+
+                // It becomes part of a path, so it has to be an ID.
+                if (str_id.empty() || !OTCrypto::It()->IsBase62(str_id) ||
+                    (str_id != String(Identifier(str_id.c_str())).Get())) {
+                    otErr << __FUNCTION__ << ": Bad ID in " << strNodeName
+                          << ": " << str_id << "\n";
+                    return false;
+                }
+
+                String strNymID;
+                GetIdentifier(strNymID);
+
+                const bool bMail = strNodeName.Compare("mailMessageRef");
+                const bool bOutmail = strNodeName.Compare("outmailMessageRef");
+                const char* szBox =
+                    bMail ? MAILBOX_MAIL
+                          : (bOutmail ? MAILBOX_OUTMAIL : MAILBOX_OUTPAYMENTS);
+                dequeOfMail& theMail =
+                    bMail ? m_dequeMail
+                          : (bOutmail ? m_dequeOutmail : m_dequeOutpayments);
+                dequeOfMailIDs& theIDs =
+                    bMail ? m_dequeMailIDs
+                          : (bOutmail ? m_dequeOutmailIDs
+                                      : m_dequeOutpaymentsIDs);
+
+                Message* pMessage = load_mail(strNymID, szBox, str_id);
+
+                if (nullptr != pMessage) {
+                    theMail.push_back(pMessage); // takes ownership
+                    theIDs.push_back(str_id);
+                }
+                else
+                    m_setUnloadedMail.insert(std::make_pair(szBox, str_id));
+            }
             else {
                 // unknown element type
                 otErr << "Unknown element type in " << __FUNCTION__ << ": "
@@ -5391,6 +5398,8 @@ bool Nym::LoadFromString(const String& strNym,
 
 bool Nym::LoadSignedNymfile(Nym& SIGNER_NYM)
 {
+    Trace::Span span("Nym::LoadSignedNymfile");
+
     // Get the Nym's ID in string form
     String nymID;
     GetIdentifier(nymID);
@@ -5429,8 +5438,9 @@ bool Nym::LoadSignedNymfile(Nym& SIGNER_NYM)
             << "Loaded and verified signed nymfile. Reading from string...\n";
 
         if (theNymfile.GetFilePayload().GetLength() > 0)
-            return LoadFromString(
-                theNymfile.GetFilePayload()); // <====== Success...
+            return LoadFromString(theNymfile.GetFilePayload(), nullptr,
+                                  nullptr, nullptr,
+                                  true); // <====== Success...
         else {
             const int64_t lLength =
                 static_cast<int64_t>(theNymfile.GetFilePayload().GetLength());
@@ -5445,6 +5455,8 @@ bool Nym::LoadSignedNymfile(Nym& SIGNER_NYM)
 
 bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
 {
+    Trace::Span span("Nym::SaveSignedNymfile");
+
     // Get the Nym's ID in string form
     String strNymID;
     GetIdentifier(strNymID);
@@ -5456,9 +5468,13 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
 
     otInfo << "Saving nym to: " << m_strNymfile << "\n";
 
+    // Mail goes into its own files first, so the nymfile only has to list
+    // it. (Otherwise every counter update would re-sign all of it.)
+    StoreMail(strNymID);
+
     // First we save this nym to a string...
     // Specifically, the file payload string on the OTSignedFile object.
-    SavePseudonym(theNymfile.GetFilePayload());
+    SavePseudonym(theNymfile.GetFilePayload(), true);
 
     // Now the OTSignedFile contains the path, the filename, AND the
     // contents of the Nym itself, saved to a string inside the OTSignedFile
@@ -5467,6 +5483,8 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
     if (theNymfile.SignContract(SIGNER_NYM) && theNymfile.SaveContract()) {
         const bool bSaved = theNymfile.SaveFile();
 
+        if (bSaved) EraseRemovedMail(strNymID);
+
         if (!bSaved) {
             String strSignerNymID;
             SIGNER_NYM.GetIdentifier(strSignerNymID);
@@ -5492,54 +5510,33 @@ bool Nym::SaveSignedNymfile(Nym& SIGNER_NYM)
 /// currently signed for.)
 bool Nym::VerifyIssuedNumbersOnNym(Nym& THE_NYM)
 {
-    int64_t lTransactionNumber = 0; // Used in the loop below.
-
     int32_t nNumberOfTransactionNumbers1 = 0; // *this
     int32_t nNumberOfTransactionNumbers2 = 0; // THE_NYM.
 
-    std::string strNotaryID;
-
     // First, loop through the Nym on my side (*this), and count how many
     // numbers total he has...
     //
     for (auto& it : GetMapIssuedNum()) {
-        dequeOfTransNums* pDeque = (it.second);
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
-            nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
-        }
+        nNumberOfTransactionNumbers1 += static_cast<int32_t>(it.second.Count());
     } // for
 
     // Next, loop through THE_NYM, and count his numbers as well...
-    // But ALSO verify that each one exists on *this, so that each individual
-    // number is checked.
+    // But ALSO verify that each one exists on *this, a range at a time.
     //
     for (auto& it : THE_NYM.GetMapIssuedNum()) {
-        strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
+        nNumberOfTransactionNumbers2 += static_cast<int32_t>(it.second.Count());
 
-        String OTstrNotaryID = strNotaryID.c_str();
+        auto it_mine = GetMapIssuedNum().find(it.first);
 
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        for (const auto& range : it.second.GetRanges()) {
+            if ((GetMapIssuedNum().end() == it_mine) ||
+                !it_mine->second.ContainsAll(range.first, range.second)) {
+                otOut << "OTPseudonym::" << __FUNCTION__
+                      << ": Issued transaction #s " << range.first << "-"
+                      << range.second << " from THE_NYM not all found on "
+                                         "*this.\n";
 
-                //                if ()
-                {
-                    nNumberOfTransactionNumbers2++;
-
-                    if (false ==
-                        VerifyIssuedNum(OTstrNotaryID, lTransactionNumber)) {
-                        otOut << "OTPseudonym::" << __FUNCTION__
-                              << ": Issued transaction # " << lTransactionNumber
-                              << " from THE_NYM not found on *this.\n";
-
-                        return false;
-                    }
-                }
+                return false;
             }
         }
     } // for
@@ -5580,33 +5577,21 @@ bool Nym::VerifyTransactionStatementNumbersOnNym(Nym& THE_NYM) // THE_NYM is
                                                                // from the
                                                                // receipt.
 {
-    int64_t lTransactionNumber = 0; // Used in the loop below.
-
-    std::string strNotaryID;
-
     // First, loop through the Nym on my side (*this), and verify that all those
     // #s appear on the last receipt (THE_NYM)
     //
     for (auto& it : GetMapIssuedNum()) {
-        strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        String OTstrNotaryID = strNotaryID.c_str();
+        auto it_theirs = THE_NYM.GetMapIssuedNum().find(it.first);
 
-        OT_ASSERT(nullptr != pDeque);
+        for (const auto& range : it.second.GetRanges()) {
+            if ((THE_NYM.GetMapIssuedNum().end() == it_theirs) ||
+                !it_theirs->second.ContainsAll(range.first, range.second)) {
+                otOut << "OTPseudonym::" << __FUNCTION__
+                      << ": Issued transaction #s " << range.first << "-"
+                      << range.second << " from *this not all found on "
+                                         "THE_NYM.\n";
 
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-
-                if (false ==
-                    THE_NYM.VerifyIssuedNum(OTstrNotaryID,
-                                            lTransactionNumber)) {
-                    otOut << "OTPseudonym::" << __FUNCTION__
-                          << ": Issued transaction # " << lTransactionNumber
-                          << " from *this not found on THE_NYM.\n";
-                    return false;
-                }
+                return false;
             }
         }
     } // for
@@ -125,6 +125,19 @@ uint32_t OTData::OTfread(uint8_t* data, uint32_t size)
     return sizeToRead;
 }
 
+const void* OTData::OTfreadInPlace(uint32_t size)
+{
+    if (data_ == nullptr || position_ > GetSize() ||
+        size > GetSize() - position_) {
+        return nullptr;
+    }
+
+    const void* data = static_cast<const uint8_t*>(data_) + position_;
+    position_ += size;
+
+    return data;
+}
+
 void OTData::zeroMemory() const
 {
     if (data_ != nullptr) {
@@ -0,0 +1,88 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTID.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/String.hpp>
+
+namespace opentxs
+{
+
+const size_t OTID::Size;
+
+OTID::OTID(const Identifier& theID)
+    : bytes_()
+{
+    Set(theID);
+}
+
+bool OTID::Set(const Identifier& theID)
+{
+    if (Size != theID.GetSize()) {
+        memset(bytes_, 0, Size);
+
+        return false;
+    }
+
+    memcpy(bytes_, theID.GetPointer(), Size);
+
+    return true;
+}
+
+void OTID::GetIdentifier(Identifier& theID) const
+{
+    if (empty())
+        theID.Release();
+    else
+        theID.Assign(bytes_, Size);
+}
+
+void OTID::GetString(String& strID) const
+{
+    Identifier theID;
+    GetIdentifier(theID);
+
+    if (theID.empty())
+        strID.Release();
+    else
+        theID.GetString(strID);
+}
+
+} // namespace opentxs
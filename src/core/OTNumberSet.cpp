@@ -0,0 +1,245 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTNumberSet.hpp>
+
+#include <iterator>
+#include <utility>
+
+namespace opentxs
+{
+
+bool OTNumberSet::Contains(int64_t lNumber) const
+{
+    // The last range starting at or before lNumber.
+    auto it = ranges_.upper_bound(lNumber);
+
+    if (ranges_.begin() == it) return false;
+
+    --it;
+
+    return lNumber <= it->second;
+}
+
+bool OTNumberSet::Insert(int64_t lNumber)
+{
+    auto next = ranges_.upper_bound(lNumber);
+    auto prev = next;
+    bool bJoinPrev = false;
+
+    if (ranges_.begin() != next) {
+        --prev;
+
+        if (lNumber <= prev->second) return false;
+
+        bJoinPrev = (prev->second + 1 == lNumber);
+    }
+
+    const bool bJoinNext =
+        (ranges_.end() != next) && (lNumber + 1 == next->first);
+
+    if (bJoinPrev && bJoinNext) {
+        prev->second = next->second;
+        ranges_.erase(next);
+    }
+    else if (bJoinPrev) {
+        prev->second = lNumber;
+    }
+    else if (bJoinNext) {
+        const int64_t lLast = next->second;
+        ranges_.insert(ranges_.erase(next), std::make_pair(lNumber, lLast));
+    }
+    else {
+        ranges_.insert(next, std::make_pair(lNumber, lNumber));
+    }
+
+    ++count_;
+
+    return true;
+}
+
+size_t OTNumberSet::InsertRange(int64_t lFirst, int64_t lLast)
+{
+    if (lLast < lFirst) return 0;
+
+    // Every existing range that overlaps or touches lFirst..lLast is folded
+    // into one. Nothing is below INT64_MIN, so a range found there overlaps
+    // (and the - 1 would overflow.)
+    auto it = ranges_.upper_bound(lFirst);
+
+    if (ranges_.begin() != it) {
+        auto prev = std::prev(it);
+
+        if ((INT64_MIN == lFirst) || (prev->second >= lFirst - 1)) it = prev;
+    }
+
+    int64_t lNewFirst = lFirst;
+    int64_t lNewLast = lLast;
+    uint64_t lExisting = 0;
+
+    while ((ranges_.end() != it) &&
+           ((INT64_MIN == it->first) || (it->first - 1 <= lLast))) {
+        if (it->first < lNewFirst) lNewFirst = it->first;
+        if (it->second > lNewLast) lNewLast = it->second;
+
+        lExisting += static_cast<uint64_t>(it->second) -
+                     static_cast<uint64_t>(it->first) + 1;
+        it = ranges_.erase(it);
+    }
+
+    ranges_.insert(it, std::make_pair(lNewFirst, lNewLast));
+
+    const uint64_t lSize = static_cast<uint64_t>(lNewLast) -
+                           static_cast<uint64_t>(lNewFirst) + 1;
+    const size_t lAdded = lSize - lExisting;
+    count_ += lAdded;
+
+    return lAdded;
+}
+
+bool OTNumberSet::ContainsAny(int64_t lFirst, int64_t lLast) const
+{
+    if (lLast < lFirst) return false;
+
+    // The last range starting at or before lLast.
+    auto it = ranges_.upper_bound(lLast);
+
+    if (ranges_.begin() == it) return false;
+
+    --it;
+
+    return lFirst <= it->second;
+}
+
+bool OTNumberSet::ContainsAll(int64_t lFirst, int64_t lLast) const
+{
+    if (lLast < lFirst) return true;
+
+    // Ranges are never adjacent, so a run of numbers that are all in the set
+    // is inside a single range.
+    auto it = ranges_.upper_bound(lFirst);
+
+    if (ranges_.begin() == it) return false;
+
+    --it;
+
+    return lLast <= it->second;
+}
+
+bool OTNumberSet::Remove(int64_t lNumber)
+{
+    auto it = ranges_.upper_bound(lNumber);
+
+    if (ranges_.begin() == it) return false;
+
+    --it;
+
+    if (lNumber > it->second) return false;
+
+    const int64_t lFirst = it->first;
+    const int64_t lLast = it->second;
+
+    if (lFirst == lLast) {
+        ranges_.erase(it);
+    }
+    else if (lNumber == lFirst) {
+        ranges_.insert(ranges_.erase(it), std::make_pair(lNumber + 1, lLast));
+    }
+    else if (lNumber == lLast) {
+        it->second = lNumber - 1;
+    }
+    else {
+        it->second = lNumber - 1;
+        ranges_.insert(std::next(it), std::make_pair(lNumber + 1, lLast));
+    }
+
+    --count_;
+
+    return true;
+}
+
+void OTNumberSet::Clear()
+{
+    ranges_.clear();
+    count_ = 0;
+}
+
+void OTNumberSet::KeepHighest(size_t lCount)
+{
+    while (count_ > lCount) {
+        auto it = ranges_.begin();
+        const uint64_t lSize = static_cast<uint64_t>(it->second) -
+                               static_cast<uint64_t>(it->first) + 1;
+        const uint64_t lExtra = count_ - lCount;
+
+        if (lSize <= lExtra) {
+            ranges_.erase(it);
+            count_ -= lSize;
+        }
+        else {
+            const int64_t lFirst = it->first + static_cast<int64_t>(lExtra);
+            const int64_t lLast = it->second;
+            ranges_.insert(ranges_.erase(it), std::make_pair(lFirst, lLast));
+            count_ = lCount;
+        }
+    }
+}
+
+bool OTNumberSet::At(size_t lIndex, int64_t& lNumber) const
+{
+    if (lIndex >= count_) return false;
+
+    for (const auto& it : ranges_) {
+        const uint64_t lSize = static_cast<uint64_t>(it.second) -
+                               static_cast<uint64_t>(it.first) + 1;
+
+        if (lIndex < lSize) {
+            lNumber = it.first + static_cast<int64_t>(lIndex);
+
+            return true;
+        }
+
+        lIndex -= lSize;
+    }
+
+    return false;
+}
+
+} // namespace opentxs
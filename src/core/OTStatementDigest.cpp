@@ -0,0 +1,448 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTStatementDigest.hpp>
+#include <opentxs/core/Item.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/OTStringXML.hpp>
+#include <opentxs/core/OTTransaction.hpp>
+#include <opentxs/core/util/Common.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
+
+#include <irrxml/irrXML.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+namespace
+{
+
+const char* const DIGEST_ELEMENT = "statementDigest";
+const char* const DIGEST_VERSION = "2";
+
+void pending_filename(String& strFilename, const String& strReceiptID,
+                      int64_t lTransNum)
+{
+    strFilename.Format("%s.%" PRId64 ".pending", strReceiptID.Get(),
+                       lTransNum);
+}
+
+void sidecar_filename(String& strFilename, const String& strReceiptID)
+{
+    strFilename.Format("%s.statement", strReceiptID.Get());
+}
+
+} // namespace
+
+bool OTStatementDigest::s_bEnabled = false;
+
+// static
+bool OTStatementDigest::IsEnabled()
+{
+    return s_bEnabled;
+}
+
+// static
+void OTStatementDigest::SetEnabled(bool bEnabled)
+{
+    s_bEnabled = bEnabled;
+}
+
+// static
+bool OTStatementDigest::IsDigest(const String& strAttachment)
+{
+    const size_t nLength = std::strlen(DIGEST_ELEMENT);
+
+    return strAttachment.Exists() && ('<' == strAttachment.Get()[0]) &&
+           (0 == std::strncmp(strAttachment.Get() + 1, DIGEST_ELEMENT,
+                              nLength));
+}
+
+// The hash covers the ranges, so it costs O(ranges) like the set itself.
+void OTStatementDigest::SetIssued(const OTNumberSet& theNumbers)
+{
+    String strNumbers;
+    strNumbers.Format("%" PRId64 ";", static_cast<int64_t>(theNumbers.Count()));
+
+    for (const auto& it : theNumbers.GetRanges())
+        strNumbers.Concatenate("%" PRId64 "-%" PRId64 ",", it.first,
+                               it.second);
+
+    m_lIssuedCount = static_cast<int64_t>(theNumbers.Count());
+    m_issuedHash.CalculateDigest(strNumbers);
+}
+
+bool OTStatementDigest::SetIssued(const Item& theStatement)
+{
+    String strMessageNym;
+    theStatement.GetAttachment(strMessageNym);
+
+    Nym theMessageNym;
+
+    if ((strMessageNym.GetLength() <= 2) ||
+        !theMessageNym.LoadFromString(strMessageNym)) {
+        otErr << "OTStatementDigest::" << __FUNCTION__
+              << ": Unable to load the message Nym.\n";
+        return false;
+    }
+
+    const String strNotaryID(theStatement.GetPurportedNotaryID());
+    auto it = theMessageNym.GetMapIssuedNum().find(strNotaryID.Get());
+
+    if (theMessageNym.GetMapIssuedNum().end() == it)
+        SetIssued(OTNumberSet());
+    else
+        SetIssued(it->second);
+
+    return true;
+}
+
+// One line per receipt, with the same fields VerifyBalanceStatement compares,
+// sorted so the order the boxes were read in doesn't matter.
+void OTStatementDigest::SetBox(Item& theReport, int64_t lOutboxTrnsNum)
+{
+    std::vector<std::string> lines;
+    lines.reserve(theReport.GetItemList().size());
+
+    m_lInboxCount = 0;
+    m_lOutboxCount = 0;
+
+    for (auto& pSubItem : theReport.GetItemList()) {
+        OT_ASSERT(nullptr != pSubItem);
+
+        const bool bOutbox = (Item::transfer == pSubItem->GetType()) &&
+                             (pSubItem->GetAmount() < 0);
+        int64_t lTransNum = pSubItem->GetTransactionNum();
+        int64_t lClosingNum = 0;
+
+        if (bOutbox) {
+            ++m_lOutboxCount;
+
+            if ((lOutboxTrnsNum > 0) && (lTransNum == lOutboxTrnsNum))
+                lTransNum = 1;
+        }
+        else
+            ++m_lInboxCount;
+
+        if ((Item::finalReceipt == pSubItem->GetType()) ||
+            (Item::basketReceipt == pSubItem->GetType()))
+            lClosingNum = pSubItem->GetClosingNum();
+
+        String strLine;
+        strLine.Format("%d %d %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64
+                       " %" PRId64 "\n",
+                       bOutbox ? 1 : 0, static_cast<int>(pSubItem->GetType()),
+                       lTransNum, pSubItem->GetReferenceToNum(),
+                       pSubItem->GetRawNumberOfOrigin(),
+                       pSubItem->GetAmount(), lClosingNum);
+        lines.push_back(strLine.Get());
+    }
+
+    std::sort(lines.begin(), lines.end());
+
+    String strReport;
+    for (const auto& line : lines) strReport.Concatenate("%s", line.c_str());
+
+    m_bHasBox = true;
+    m_boxHash.CalculateDigest(strReport);
+}
+
+bool OTStatementDigest::SameIssued(const OTStatementDigest& rhs) const
+{
+    return (m_lIssuedCount == rhs.m_lIssuedCount) &&
+           (m_issuedHash == rhs.m_issuedHash);
+}
+
+bool OTStatementDigest::SameBox(const OTStatementDigest& rhs) const
+{
+    return (m_bHasBox == rhs.m_bHasBox) &&
+           (m_lInboxCount == rhs.m_lInboxCount) &&
+           (m_lOutboxCount == rhs.m_lOutboxCount) &&
+           (m_boxHash == rhs.m_boxHash);
+}
+
+void OTStatementDigest::Save(String& strOutput) const
+{
+    std::string str_result;
+    XmlWriter writer(str_result);
+
+    const String strIssuedHash(m_issuedHash);
+
+    writer.open_element(DIGEST_ELEMENT);
+    writer.add_attribute("version", DIGEST_VERSION);
+    writer.add_attribute("issuedCount", formatLong(m_lIssuedCount));
+    writer.add_attribute("issuedHash", strIssuedHash.Get());
+
+    String strRemoved;
+    if (m_removed.Output(strRemoved))
+        writer.add_attribute("removed", strRemoved.Get());
+
+    if (m_bHasBox) {
+        const String strBoxHash(m_boxHash);
+
+        writer.add_attribute("inboxCount", formatLong(m_lInboxCount));
+        writer.add_attribute("outboxCount", formatLong(m_lOutboxCount));
+        writer.add_attribute("boxHash", strBoxHash.Get());
+    }
+
+    writer.close_element();
+
+    strOutput.Set(str_result.c_str());
+}
+
+bool OTStatementDigest::Load(const String& strInput)
+{
+    if (!IsDigest(strInput)) return false;
+
+    OTStringXML strXML(strInput);
+    std::unique_ptr<irr::io::IrrXMLReader> xml(
+        irr::io::createIrrXMLReader(strXML));
+    OT_ASSERT(nullptr != xml);
+
+    while (xml->read()) {
+        if ((irr::io::EXN_ELEMENT != xml->getNodeType()) ||
+            (0 != std::strcmp(DIGEST_ELEMENT, xml->getNodeName())))
+            continue;
+
+        const String strVersion = xml->getAttributeValue("version");
+
+        if (!strVersion.Compare(DIGEST_VERSION)) {
+            otOut << "OTStatementDigest::" << __FUNCTION__
+                  << ": Unsupported statement version: " << strVersion
+                  << "\n";
+            return false;
+        }
+
+        const String strIssuedHash = xml->getAttributeValue("issuedHash");
+        const String strRemoved = xml->getAttributeValue("removed");
+        const String strBoxHash = xml->getAttributeValue("boxHash");
+
+        if (!strIssuedHash.Exists()) {
+            otOut << "OTStatementDigest::" << __FUNCTION__
+                  << ": Missing issuedHash.\n";
+            return false;
+        }
+
+        m_lIssuedCount = String::StringToLong(
+            xml->getAttributeValueSafe("issuedCount"));
+        m_issuedHash.SetString(strIssuedHash);
+        m_removed.Release();
+
+        if (strRemoved.Exists() && !m_removed.Add(strRemoved)) {
+            otOut << "OTStatementDigest::" << __FUNCTION__
+                  << ": Bad removed list: " << strRemoved << "\n";
+            return false;
+        }
+
+        m_bHasBox = strBoxHash.Exists();
+
+        if (m_bHasBox) {
+            m_lInboxCount = String::StringToLong(
+                xml->getAttributeValueSafe("inboxCount"));
+            m_lOutboxCount = String::StringToLong(
+                xml->getAttributeValueSafe("outboxCount"));
+            m_boxHash.SetString(strBoxHash);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// static
+Item* OTStatementDigest::Compact(Item& theFull, const OTTransaction& theOwner,
+                                 const NumList& theRemoved, Nym& theNym,
+                                 const String& strReceiptID)
+{
+    OTStatementDigest theDigest;
+
+    if (!theDigest.SetIssued(theFull)) return nullptr;
+
+    if (Item::balanceStatement == theFull.GetType()) theDigest.SetBox(theFull);
+
+    theDigest.m_removed.Add(theRemoved);
+
+    // Keep the full statement first, so there is never a compact one out
+    // there that the client can't expand.
+    String strFull;
+    theFull.SaveContractRaw(strFull);
+
+    const String strNotaryID(theFull.GetPurportedNotaryID());
+    String strFilename;
+    pending_filename(strFilename, strReceiptID, theFull.GetTransactionNum());
+
+    if (!OTDB::StorePlainString(strFull.Get(), OTFolders::Receipt().Get(),
+                                strNotaryID.Get(), strFilename.Get())) {
+        otErr << "OTStatementDigest::" << __FUNCTION__
+              << ": Failed saving the full statement to "
+              << OTFolders::Receipt() << Log::PathSeparator() << strNotaryID
+              << Log::PathSeparator() << strFilename
+              << ". Sending it in full instead.\n";
+        return nullptr;
+    }
+
+    Item* pCompact =
+        Item::CreateItemFromTransaction(theOwner, theFull.GetType());
+
+    // The above has an ASSERT, so this this will never actually happen.
+    if (nullptr == pCompact) return nullptr;
+
+    String strDigest;
+    theDigest.Save(strDigest);
+
+    pCompact->SetAmount(theFull.GetAmount());
+    pCompact->SetAttachment(strDigest);
+    pCompact->SignContract(theNym);
+    pCompact->SaveContract();
+
+    return pCompact;
+}
+
+// static
+void OTStatementDigest::ResolvePending(const Identifier& NOTARY_ID,
+                                       const String& strReceiptID,
+                                       int64_t lTransNum, bool bSuccess)
+{
+    const String strNotaryID(NOTARY_ID);
+    String strPending;
+    pending_filename(strPending, strReceiptID, lTransNum);
+
+    if (!OTDB::Exists(OTFolders::Receipt().Get(), strNotaryID.Get(),
+                      strPending.Get()))
+        return; // The statement was sent in full.
+
+    if (bSuccess) {
+        const std::string strFull(OTDB::QueryPlainString(
+            OTFolders::Receipt().Get(), strNotaryID.Get(), strPending.Get()));
+        String strFilename;
+        sidecar_filename(strFilename, strReceiptID);
+
+        if (strFull.empty() ||
+            !OTDB::StorePlainString(strFull, OTFolders::Receipt().Get(),
+                                    strNotaryID.Get(), strFilename.Get())) {
+            otErr << "OTStatementDigest::" << __FUNCTION__
+                  << ": Failed keeping the full statement for receipt "
+                  << strReceiptID << ". It can't be verified later.\n";
+            return; // Leave the pending one, rather than lose it.
+        }
+    }
+
+    OTDB::EraseValueByKey(OTFolders::Receipt().Get(), strNotaryID.Get(),
+                          strPending.Get());
+}
+
+// static
+Item* OTStatementDigest::LoadExpanded(Item& theCompact,
+                                      const Identifier& NOTARY_ID,
+                                      const String& strReceiptID,
+                                      const Nym& theNym)
+{
+    String strAttachment;
+    theCompact.GetAttachment(strAttachment);
+
+    OTStatementDigest theDigest;
+
+    if (!theDigest.Load(strAttachment)) {
+        otOut << "OTStatementDigest::" << __FUNCTION__
+              << ": Unable to load the statement digest.\n";
+        return nullptr;
+    }
+
+    const String strNotaryID(NOTARY_ID);
+    String strFilename;
+    sidecar_filename(strFilename, strReceiptID);
+
+    if (!OTDB::Exists(OTFolders::Receipt().Get(), strNotaryID.Get(),
+                      strFilename.Get())) {
+        otOut << "OTStatementDigest::" << __FUNCTION__
+              << ": The full statement is missing: " << OTFolders::Receipt()
+              << Log::PathSeparator() << strNotaryID << Log::PathSeparator()
+              << strFilename << "\n";
+        return nullptr;
+    }
+
+    const String strFull(
+        OTDB::QueryPlainString(OTFolders::Receipt().Get(), strNotaryID.Get(),
+                               strFilename.Get()).c_str());
+    std::unique_ptr<Item> pFull(Item::CreateItemFromString(
+        strFull, NOTARY_ID, theCompact.GetTransactionNum()));
+
+    if (nullptr == pFull) {
+        otOut << "OTStatementDigest::" << __FUNCTION__
+              << ": Unable to load the full statement.\n";
+        return nullptr;
+    }
+
+    OTStatementDigest theExpected;
+
+    if ((pFull->GetType() != theCompact.GetType()) ||
+        (pFull->GetTransactionNum() != theCompact.GetTransactionNum()) ||
+        (pFull->GetAmount() != theCompact.GetAmount()) ||
+        !pFull->VerifySignature(theNym) || !theExpected.SetIssued(*pFull)) {
+        otOut << "OTStatementDigest::" << __FUNCTION__
+              << ": The full statement doesn't belong to transaction #"
+              << theCompact.GetTransactionNum() << ".\n";
+        return nullptr;
+    }
+
+    if (Item::balanceStatement == pFull->GetType()) theExpected.SetBox(*pFull);
+
+    if (!theExpected.SameIssued(theDigest) || !theExpected.SameBox(theDigest)) {
+        otOut << "OTStatementDigest::" << __FUNCTION__
+              << ": The full statement doesn't match the signed digest on "
+                 "transaction #" << theCompact.GetTransactionNum() << ".\n";
+        return nullptr;
+    }
+
+    return pFull.release();
+}
+
+} // namespace opentxs
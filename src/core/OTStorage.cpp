@@ -43,11 +43,17 @@
 #include <opentxs/core/util/OTDataFolder.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/util/OTPaths.hpp>
+#include <opentxs/core/util/PhaseTimer.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/OTData.hpp>
 #include <opentxs/core/OTStoragePB.hpp>
+#include <opentxs/core/OTStorageCache.hpp>
+#include <opentxs/core/OTStorageStats.hpp>
 
+#include <chrono>
 #include <sstream>
 #include <fstream>
+#include <iterator>
 #include <typeinfo>
 
 /*
@@ -548,11 +554,98 @@ int64_t FormPathString(std::string& strOutput, std::string strFolder,
                                     threeStr);
 }
 
+namespace
+{
+
+std::string join_path(const std::string& strFolder, const std::string& oneStr,
+                      const std::string& twoStr, const std::string& threeStr)
+{
+    std::string strPath(strFolder);
+
+    for (const std::string* pPart : {&oneStr, &twoStr, &threeStr}) {
+        if (!pPart->empty()) {
+            strPath += "/";
+            strPath += *pPart;
+        }
+    }
+
+    return strPath;
+}
+
+// Labels an OTDB span with the path it stores or queries.
+void trace_path(Trace::Span& span, const std::string& strFolder,
+                const std::string& oneStr, const std::string& twoStr,
+                const std::string& threeStr)
+{
+    if (span.Active())
+        span.Arg("path", join_path(strFolder, oneStr, twoStr, threeStr));
+}
+
+// Times one StorageFS operation, and records it in StorageStats when it
+// goes out of scope. Until Succeeded() is called, it counts as failed.
+class StorageOp
+{
+public:
+    StorageOp(StorageStats::Operation eOperation, const std::string& strFolder,
+              const std::string& oneStr, const std::string& twoStr,
+              const std::string& threeStr)
+        : m_eOperation(eOperation)
+        , m_strFolder(strFolder)
+        , m_oneStr(oneStr)
+        , m_twoStr(twoStr)
+        , m_threeStr(threeStr)
+        , m_bSuccess(false)
+        , m_lBytes(0)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~StorageOp()
+    {
+        const int64_t lMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - m_start).count();
+
+        if (StorageStats::Record(m_strFolder, m_eOperation, m_bSuccess,
+                                 m_lBytes, lMicros)) {
+            otErr << "OTDB: slow " << StorageStats::Name(m_eOperation) << " ("
+                  << lMicros / 1000 << " ms, " << m_lBytes << " bytes): "
+                  << join_path(m_strFolder, m_oneStr, m_twoStr, m_threeStr)
+                  << "\n";
+        }
+    }
+
+    void Succeeded(uint64_t lBytes)
+    {
+        m_bSuccess = true;
+        m_lBytes = lBytes;
+    }
+
+private:
+    StorageStats::Operation m_eOperation;
+    const std::string& m_strFolder;
+    const std::string& m_oneStr;
+    const std::string& m_twoStr;
+    const std::string& m_threeStr;
+    bool m_bSuccess;
+    uint64_t m_lBytes;
+    std::chrono::steady_clock::time_point m_start;
+
+    StorageOp(const StorageOp&);
+    StorageOp& operator=(const StorageOp&);
+};
+
+} // namespace
+
 // Store/Retrieve a string.
 
 bool StoreString(std::string strContents, std::string strFolder,
                  std::string oneStr, std::string twoStr, std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::SAVE);
+    Trace::Span span("OTDB::StoreString");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -580,6 +673,10 @@ bool StoreString(std::string strContents, std::string strFolder,
 std::string QueryString(std::string strFolder, std::string oneStr,
                         std::string twoStr, std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::LOAD);
+    Trace::Span span("OTDB::QueryString");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -608,6 +705,10 @@ bool StorePlainString(std::string strContents, std::string strFolder,
                       std::string oneStr, std::string twoStr,
                       std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::SAVE);
+    Trace::Span span("OTDB::StorePlainString");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -637,6 +738,10 @@ bool StorePlainString(std::string strContents, std::string strFolder,
 std::string QueryPlainString(std::string strFolder, std::string oneStr,
                              std::string twoStr, std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::LOAD);
+    Trace::Span span("OTDB::QueryPlainString");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -668,6 +773,10 @@ std::string QueryPlainString(std::string strFolder, std::string oneStr,
 bool StoreObject(Storable& theContents, std::string strFolder,
                  std::string oneStr, std::string twoStr, std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::SAVE);
+    Trace::Span span("OTDB::StoreObject");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -698,6 +807,10 @@ Storable* QueryObject(StoredObjectType theObjectType, std::string strFolder,
                       std::string oneStr, std::string twoStr,
                       std::string threeStr)
 {
+    PhaseTimer::Scope phase(PhaseTimer::LOAD);
+    Trace::Span span("OTDB::QueryObject");
+    trace_path(span, strFolder, oneStr, twoStr, threeStr);
+
     {
         String ot_strFolder(strFolder), ot_oneStr(oneStr), ot_twoStr(twoStr),
             ot_threeStr(threeStr);
@@ -2442,6 +2555,37 @@ bool StorageFS::ConfirmFile(const char* szFileName, struct stat*)
     return OTPaths::PathExists(strFilePath);
 }
 
+bool StorageFS::ReadFile(const std::string& strPath, int64_t lSize,
+                         std::string& theBuffer)
+{
+    std::ifstream fin(strPath.c_str(), std::ios::in | std::ios::binary);
+
+    if (!fin.is_open()) {
+        otErr << __FUNCTION__ << ": Error opening file: " << strPath << "\n";
+        return false;
+    }
+
+    // Read straight into theBuffer: lSize bytes, or as many as are left if
+    // the file has shrunk, and then whatever it has grown by.
+
+    theBuffer.resize(static_cast<size_t>(lSize));
+    fin.read(&theBuffer[0], lSize);
+    theBuffer.resize(static_cast<size_t>(fin.gcount()));
+
+    if (!fin.eof() && !fin.bad()) {
+        fin.clear();
+        theBuffer.append(std::istreambuf_iterator<char>(fin),
+                         std::istreambuf_iterator<char>());
+    }
+
+    if (fin.bad()) {
+        theBuffer = "";
+        return false;
+    }
+
+    return true;
+}
+
 /*
  - Based on the input, constructs the full path and returns it in strOutput.
  - This function will try to create all the folders leading up to the
@@ -2605,6 +2749,7 @@ bool StorageFS::onStorePackedBuffer(PackedBuffer& theBuffer,
                                     std::string strFolder, std::string oneStr,
                                     std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::WRITE, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
     if (0 > ConstructAndCreatePath(strOutput, strFolder, oneStr, twoStr,
@@ -2629,9 +2774,12 @@ bool StorageFS::onStorePackedBuffer(PackedBuffer& theBuffer,
     ofs.clear();
     bool bSuccess = theBuffer.WriteToOStream(ofs);
     ofs.close();
+    StorageCache::Invalidate(strOutput);
 
     // TODO: Remove the .lock file.
 
+    if (bSuccess) op.Succeeded(theBuffer.GetSize());
+
     return bSuccess;
 }
 
@@ -2639,6 +2787,7 @@ bool StorageFS::onQueryPackedBuffer(PackedBuffer& theBuffer,
                                     std::string strFolder, std::string oneStr,
                                     std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::READ, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
     int64_t lRet =
@@ -2668,6 +2817,8 @@ bool StorageFS::onQueryPackedBuffer(PackedBuffer& theBuffer,
 
     fin.close();
 
+    if (bSuccess) op.Succeeded(static_cast<uint64_t>(lRet));
+
     return bSuccess;
 }
 
@@ -2677,6 +2828,7 @@ bool StorageFS::onStorePlainString(std::string& theBuffer,
                                    std::string strFolder, std::string oneStr,
                                    std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::WRITE, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
     if (0 > ConstructAndCreatePath(strOutput, strFolder, oneStr, twoStr,
@@ -2709,9 +2861,12 @@ bool StorageFS::onStorePlainString(std::string& theBuffer,
     ofs << theBuffer;
     bool bSuccess = ofs.good();
     ofs.close();
+    StorageCache::Invalidate(strOutput);
 
     // TODO: Remove the .lock file.
 
+    if (bSuccess) op.Succeeded(theBuffer.length());
+
     return bSuccess;
 }
 
@@ -2719,6 +2874,7 @@ bool StorageFS::onQueryPlainString(std::string& theBuffer,
                                    std::string strFolder, std::string oneStr,
                                    std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::READ, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
     int64_t lRet =
@@ -2735,33 +2891,22 @@ bool StorageFS::onQueryPlainString(std::string& theBuffer,
         return false;
     }
 
-    // Open the file here
-
-    std::ifstream fin(strOutput.c_str(), std::ios::in | std::ios::binary);
+    StorageCache::FileVersion theVersion;
 
-    if (!fin.is_open()) {
-        otErr << __FUNCTION__ << ": Error opening file: " << strOutput << "\n";
-        return false;
+    if (StorageCache::Get(strOutput, theBuffer, theVersion)) {
+        op.Succeeded(theBuffer.length());
+        return true;
     }
 
-    // Read from the file as a plain string.
-
-    std::stringstream buffer;
-    buffer << fin.rdbuf();
+    if (!ReadFile(strOutput, lRet, theBuffer)) return false;
 
-    bool bSuccess = fin.good();
+    bool bSuccess = (theBuffer.length() > 0);
 
-    if (bSuccess)
-        theBuffer = buffer.str(); // here's the actual output of this function.
-    else {
-        theBuffer = "";
-        return false;
+    if (bSuccess) {
+        StorageCache::Put(strFolder, strOutput, theVersion, theBuffer);
+        op.Succeeded(theBuffer.length());
     }
 
-    bSuccess = (theBuffer.length() > 0);
-
-    fin.close();
-
     return bSuccess;
 }
 
@@ -2770,6 +2915,7 @@ bool StorageFS::onQueryPlainString(std::string& theBuffer,
 bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
                                   std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::ERASE, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
     if (0 > ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr,
@@ -2807,6 +2953,7 @@ bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
     ofs << "(This space intentionally left blank.)\n";
     bool bSuccess = ofs.good() ? true : false;
     ofs.close();
+    StorageCache::Invalidate(strOutput);
     // Note: I bet you think I should be overwriting the file 7 times here with
     // random data, right? Wrong: YOU need to override OTStorage and create your
     // own subclass, where you can override onEraseValueByKey and do that stuff
@@ -2823,6 +2970,8 @@ bool StorageFS::onEraseValueByKey(std::string strFolder, std::string oneStr,
 
     // TODO: Remove the .lock file.
 
+    if (bSuccess) op.Succeeded(0);
+
     return bSuccess;
 }
 
@@ -2845,8 +2994,12 @@ StorageFS::~StorageFS()
 bool StorageFS::Exists(std::string strFolder, std::string oneStr,
                        std::string twoStr, std::string threeStr)
 {
+    StorageOp op(StorageStats::EXISTS, strFolder, oneStr, twoStr, threeStr);
     std::string strOutput;
 
+    // A missing file is an answer, not an error.
+    op.Succeeded(0);
+
     return (0 < ConstructAndConfirmPath(strOutput, strFolder, oneStr, twoStr,
                                         threeStr));
 }
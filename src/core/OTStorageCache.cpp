@@ -0,0 +1,369 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTStorageCache.hpp>
+
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+namespace opentxs
+{
+
+namespace OTDB
+{
+
+namespace
+{
+
+typedef StorageCache::FileVersion FileVersion;
+
+struct CacheEntry
+{
+    std::string m_strPath;
+    std::string m_strContents;
+    FileVersion m_version;
+    bool m_bPinned;
+};
+
+typedef std::list<CacheEntry> EntryList;
+
+struct CacheState
+{
+    std::mutex m_lock;
+    EntryList m_lru; // most recently used first
+    EntryList m_pinned;
+    std::unordered_map<std::string, EntryList::iterator> m_index;
+    std::set<std::string> m_pinnedFolders;
+    std::string m_strPinnedFolders;
+    int64_t m_lMaxBytes;
+    StorageCache::Stats m_stats;
+
+    CacheState()
+        : m_lMaxBytes(32 * 1024 * 1024)
+    {
+    }
+};
+
+// So StorageFS can skip the stat() when there's nothing to cache into.
+std::atomic<bool> s_bEnabled(true);
+
+CacheState& cache_state()
+{
+    static CacheState theState;
+
+    return theState;
+}
+
+bool stat_file(const std::string& strPath, FileVersion& theVersion)
+{
+#ifdef _WIN32
+    struct _stat st_buf;
+
+    if (0 != _stat(strPath.c_str(), &st_buf)) return false;
+
+    theVersion.m_lModified = static_cast<int64_t>(st_buf.st_mtime) * 1000000000;
+    theVersion.m_lChanged = static_cast<int64_t>(st_buf.st_ctime) * 1000000000;
+    theVersion.m_lInode = 0;
+#else
+    struct stat st_buf;
+
+    if (0 != stat(strPath.c_str(), &st_buf)) return false;
+
+#ifdef __APPLE__
+    const struct timespec& modified = st_buf.st_mtimespec;
+    const struct timespec& changed = st_buf.st_ctimespec;
+#else
+    const struct timespec& modified = st_buf.st_mtim;
+    const struct timespec& changed = st_buf.st_ctim;
+#endif
+    theVersion.m_lModified =
+        static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    theVersion.m_lChanged =
+        static_cast<int64_t>(changed.tv_sec) * 1000000000 + changed.tv_nsec;
+    theVersion.m_lInode = st_buf.st_ino;
+#endif
+    theVersion.m_lSize = st_buf.st_size;
+
+    return true;
+}
+
+// Caller holds the lock.
+void remove_entry(CacheState& theState, EntryList::iterator it)
+{
+    const uint64_t lSize = it->m_strContents.size();
+
+    if (it->m_bPinned) {
+        theState.m_stats.m_lPinnedBytes -= lSize;
+        theState.m_index.erase(it->m_strPath);
+        theState.m_pinned.erase(it);
+    }
+    else {
+        theState.m_stats.m_lBytes -= lSize;
+        theState.m_index.erase(it->m_strPath);
+        theState.m_lru.erase(it);
+    }
+}
+
+// Caller holds the lock.
+void evict(CacheState& theState)
+{
+    while (!theState.m_lru.empty() &&
+           (static_cast<int64_t>(theState.m_stats.m_lBytes) >
+            theState.m_lMaxBytes)) {
+        remove_entry(theState, std::prev(theState.m_lru.end()));
+        ++theState.m_stats.m_lEvictions;
+    }
+}
+
+// Caller holds the lock.
+void update_enabled(CacheState& theState)
+{
+    s_bEnabled.store((theState.m_lMaxBytes > 0) ||
+                         !theState.m_pinnedFolders.empty(),
+                     std::memory_order_relaxed);
+}
+
+} // namespace
+
+StorageCache::FileVersion::FileVersion()
+    : m_lSize(-1)
+    , m_lModified(0)
+    , m_lChanged(0)
+    , m_lInode(0)
+{
+}
+
+bool StorageCache::FileVersion::operator==(const FileVersion& rhs) const
+{
+    return (m_lSize == rhs.m_lSize) && (m_lModified == rhs.m_lModified) &&
+           (m_lChanged == rhs.m_lChanged) && (m_lInode == rhs.m_lInode);
+}
+
+StorageCache::Stats::Stats()
+    : m_lHits(0)
+    , m_lMisses(0)
+    , m_lStale(0)
+    , m_lEvictions(0)
+    , m_lEntries(0)
+    , m_lBytes(0)
+    , m_lPinnedBytes(0)
+{
+}
+
+// static
+bool StorageCache::Get(const std::string& strPath, std::string& strContents,
+                       FileVersion& theVersion)
+{
+    theVersion = FileVersion();
+
+    if (!s_bEnabled.load(std::memory_order_relaxed)) return false;
+
+    if (!stat_file(strPath, theVersion)) {
+        theVersion = FileVersion();
+        return false;
+    }
+
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    auto it = theState.m_index.find(strPath);
+
+    if (theState.m_index.end() == it) {
+        ++theState.m_stats.m_lMisses;
+        return false;
+    }
+
+    EntryList::iterator itEntry = it->second;
+
+    if (!(itEntry->m_version == theVersion)) {
+        ++theState.m_stats.m_lStale;
+        remove_entry(theState, itEntry);
+        return false;
+    }
+
+    ++theState.m_stats.m_lHits;
+    strContents = itEntry->m_strContents;
+
+    if (!itEntry->m_bPinned)
+        theState.m_lru.splice(theState.m_lru.begin(), theState.m_lru, itEntry);
+
+    return true;
+}
+
+// static
+void StorageCache::Put(const std::string& strFolder, const std::string& strPath,
+                       const FileVersion& theVersion,
+                       const std::string& strContents)
+{
+    if ((theVersion.m_lSize < 0) ||
+        (static_cast<uint64_t>(theVersion.m_lSize) != strContents.size()))
+        return;
+
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    const bool bPinned = (theState.m_pinnedFolders.end() !=
+                          theState.m_pinnedFolders.find(strFolder));
+
+    // One big file mustn't flush everything else out.
+    if (!bPinned && (static_cast<int64_t>(strContents.size()) >
+                     theState.m_lMaxBytes / 8))
+        return;
+
+    auto it = theState.m_index.find(strPath);
+
+    if (theState.m_index.end() != it) remove_entry(theState, it->second);
+
+    EntryList& theList = bPinned ? theState.m_pinned : theState.m_lru;
+    CacheEntry theEntry = {strPath, strContents, theVersion, bPinned};
+
+    theList.push_front(std::move(theEntry));
+    theState.m_index[strPath] = theList.begin();
+
+    if (bPinned)
+        theState.m_stats.m_lPinnedBytes += strContents.size();
+    else {
+        theState.m_stats.m_lBytes += strContents.size();
+        evict(theState);
+    }
+}
+
+// static
+void StorageCache::Invalidate(const std::string& strPath)
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    auto it = theState.m_index.find(strPath);
+
+    if (theState.m_index.end() != it) remove_entry(theState, it->second);
+}
+
+// static
+void StorageCache::Clear()
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    theState.m_index.clear();
+    theState.m_lru.clear();
+    theState.m_pinned.clear();
+    theState.m_stats.m_lBytes = 0;
+    theState.m_stats.m_lPinnedBytes = 0;
+}
+
+// static
+StorageCache::Stats StorageCache::GetStats()
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    Stats theStats = theState.m_stats;
+    theStats.m_lEntries = theState.m_index.size();
+
+    return theStats;
+}
+
+// static
+int64_t StorageCache::GetMaxBytes()
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    return theState.m_lMaxBytes;
+}
+
+// static
+void StorageCache::SetMaxBytes(int64_t lBytes)
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    theState.m_lMaxBytes = (lBytes < 0) ? 0 : lBytes;
+    evict(theState);
+    update_enabled(theState);
+}
+
+// static
+std::string StorageCache::GetPinnedFolders()
+{
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    return theState.m_strPinnedFolders;
+}
+
+// static
+void StorageCache::SetPinnedFolders(const std::string& strFolders)
+{
+    std::set<std::string> setFolders;
+    std::string strFolder;
+
+    for (size_t i = 0; i <= strFolders.size(); ++i) {
+        const char c = (i < strFolders.size()) ? strFolders[i] : ',';
+
+        if (',' == c) {
+            if (!strFolder.empty()) setFolders.insert(strFolder);
+            strFolder.clear();
+        }
+        else if (' ' != c && '\t' != c) {
+            strFolder += c;
+        }
+    }
+
+    Clear(); // what's cached was filed under the old pins
+
+    CacheState& theState = cache_state();
+    std::lock_guard<std::mutex> lock(theState.m_lock);
+
+    theState.m_pinnedFolders.swap(setFolders);
+    theState.m_strPinnedFolders = strFolders;
+    update_enabled(theState);
+}
+
+} // namespace OTDB
+
+} // namespace opentxs
@@ -0,0 +1,129 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTStorageStats.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace opentxs
+{
+
+namespace OTDB
+{
+
+namespace
+{
+
+std::mutex s_statsLock;
+StorageStats::Snapshot s_stats;
+std::atomic<int64_t> s_lSlowThreshold(250);
+
+} // namespace
+
+StorageStats::Counters::Counters()
+    : m_lCount(0)
+    , m_lErrors(0)
+    , m_lBytes(0)
+    , m_lSlow(0)
+{
+}
+
+// static
+bool StorageStats::Record(const std::string& strFolder, Operation eOperation,
+                          bool bSuccess, uint64_t lBytes, int64_t lMicros)
+{
+    const int64_t lThreshold = s_lSlowThreshold.load(std::memory_order_relaxed);
+    const bool bSlow = (lThreshold > 0) && (lMicros >= lThreshold * 1000);
+
+    std::lock_guard<std::mutex> lock(s_statsLock);
+
+    Counters& theCounters = s_stats[strFolder][eOperation];
+
+    ++theCounters.m_lCount;
+    theCounters.m_lBytes += lBytes;
+    theCounters.m_latency.Add(lMicros);
+
+    if (!bSuccess) ++theCounters.m_lErrors;
+    if (bSlow) ++theCounters.m_lSlow;
+
+    return bSlow;
+}
+
+// static
+StorageStats::Snapshot StorageStats::Get()
+{
+    std::lock_guard<std::mutex> lock(s_statsLock);
+
+    return s_stats;
+}
+
+// static
+const char* StorageStats::Name(Operation eOperation)
+{
+    switch (eOperation) {
+    case READ:
+        return "read";
+    case WRITE:
+        return "write";
+    case EXISTS:
+        return "exists";
+    case ERASE:
+        return "erase";
+    default:
+        return "unknown";
+    }
+}
+
+// static
+int64_t StorageStats::GetSlowThreshold()
+{
+    return s_lSlowThreshold.load(std::memory_order_relaxed);
+}
+
+// static
+void StorageStats::SetSlowThreshold(int64_t lMilliseconds)
+{
+    s_lSlowThreshold.store(lMilliseconds, std::memory_order_relaxed);
+}
+
+} // namespace OTDB
+
+} // namespace opentxs
@@ -43,11 +43,13 @@
 #include <opentxs/core/OTTransaction.hpp>
 #include <opentxs/core/Cheque.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/Ledger.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
 #include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <cstring>
 #include <irrxml/irrXML.hpp>
@@ -1469,6 +1471,7 @@ bool OTTransaction::VerifyBalanceReceipt(
     // using.
 
     Item* pTransactionItem = nullptr;
+    std::unique_ptr<Item> theTransactionItemAngel;
 
     if (tranOut.GetDateSigned() > GetDateSigned()) // it's newer.
     {
@@ -1514,6 +1517,7 @@ bool OTTransaction::VerifyBalanceReceipt(
         pTransactionItem = Item::CreateItemFromString(
             strBalanceItem, GetRealNotaryID(),
             pResponseTransactionItem->GetReferenceToNum());
+        theTransactionItemAngel.reset(pTransactionItem);
 
         if (nullptr == pTransactionItem) {
             otOut << "Unable to load transactionStatement item from string "
@@ -1532,6 +1536,23 @@ bool OTTransaction::VerifyBalanceReceipt(
             return false;
         }
 
+        // A compact statement only has a digest. The full one it stands for
+        // was kept next to the receipt.
+        String strAttachment;
+        pTransactionItem->GetAttachment(strAttachment);
+
+        if (OTStatementDigest::IsDigest(strAttachment)) {
+            pTransactionItem = OTStatementDigest::LoadExpanded(
+                *pTransactionItem, GetRealNotaryID(), strReceiptID, THE_NYM);
+            theTransactionItemAngel.reset(pTransactionItem);
+
+            if (nullptr == pTransactionItem) {
+                otOut << "Unable to expand compact transactionStatement item "
+                         "in OTTransaction::VerifyBalanceReceipt.\n";
+                return false;
+            }
+        }
+
         pItemWithIssuedList = pTransactionItem;
     }
 
@@ -1616,6 +1637,7 @@ bool OTTransaction::VerifyBalanceReceipt(
     pBalanceItem =
         Item::CreateItemFromString(strBalanceItem, GetRealNotaryID(),
                                    pResponseBalanceItem->GetReferenceToNum());
+    std::unique_ptr<Item> theBalanceItemAngel(pBalanceItem);
 
     if (nullptr == pBalanceItem) {
         otOut << "Unable to load balanceStatement item from string (from a "
@@ -1633,6 +1655,26 @@ bool OTTransaction::VerifyBalanceReceipt(
         return false;
     }
 
+    // As above, for a compact balance statement.
+    {
+        String strAttachment;
+        pBalanceItem->GetAttachment(strAttachment);
+
+        if (OTStatementDigest::IsDigest(strAttachment)) {
+            const String strAcctID(GetRealAccountID());
+
+            pBalanceItem = OTStatementDigest::LoadExpanded(
+                *pBalanceItem, GetRealNotaryID(), strAcctID, THE_NYM);
+            theBalanceItemAngel.reset(pBalanceItem);
+
+            if (nullptr == pBalanceItem) {
+                otOut << "Unable to expand compact balanceStatement item in "
+                         "OTTransaction::VerifyBalanceReceipt.\n";
+                return false;
+            }
+        }
+    }
+
     // LOAD MESSAGE NYM (THE LIST OF ISSUED NUMBERS ACCORDING TO THE RECEIPT.)
 
     Nym theMessageNym;
@@ -2840,6 +2882,8 @@ bool OTTransaction::VerifyBalanceReceipt(
 //
 bool OTTransaction::DeleteBoxReceipt(Ledger& theLedger)
 {
+    Trace::Span span("OTTransaction::VerifyBalanceReceipt");
+
     String strFolder1name, strFolder2name, strFolder3name, strFilename;
 
     if (!SetupBoxReceiptFilename(
@@ -3085,6 +3129,8 @@ bool OTTransaction::VerifyItems(Nym& theNym)
     // if pointer not null, and it's a withdrawal, and it's an acknowledgement
     // (not a rejection or error)
     //
+    listOfConstContracts theItems;
+
     for (auto& it : GetItemList()) {
         // loop through the ALL items that make up this transaction and check
         // to see if a response to deposit.
@@ -3095,16 +3141,12 @@ bool OTTransaction::VerifyItems(Nym& theNym)
 
         if (NYM_ID != pItem->GetNymID()) return false;
 
-        if (!pItem->VerifySignature(theNym)) // NO need to call
-                                             // VerifyAccount since
-                                             // VerifyContractID is
-                                             // ALREADY called and now
-                                             // here's
-                                             // VerifySignature().
-            return false;
+        theItems.push_back(pItem);
     }
 
-    return true;
+    // NO need to call VerifyAccount since VerifyContractID is ALREADY called.
+    // The item signatures are all checked together, as one batch.
+    return Contract::VerifySignatures(theItems, theNym);
 }
 
 /*
@@ -4259,22 +4301,25 @@ void OTTransaction::UpdateContents()
     // I release this because I'm about to repopulate it.
     m_xmlUnsigned.Release();
 
-    Tag tag("transaction");
+    std::string str_result;
+    XmlWriter writer(str_result);
 
-    tag.add_attribute("type", strType.Get());
-    tag.add_attribute("dateSigned", getTimestamp());
-    tag.add_attribute("accountID", strAcctID.Get());
-    tag.add_attribute("nymID", strNymID.Get());
-    tag.add_attribute("notaryID", strNotaryID.Get());
-    tag.add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    tag.add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    tag.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.open_element("transaction");
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", getTimestamp());
+    writer.add_attribute("accountID", strAcctID.Get());
+    writer.add_attribute("nymID", strNymID.Get());
+    writer.add_attribute("notaryID", strNotaryID.Get());
+    writer.add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    if (m_bCancelled) tag.add_attribute("cancelled", formatBool(m_bCancelled));
+    if (m_bCancelled)
+        writer.add_attribute("cancelled", formatBool(m_bCancelled));
 
     if (OTTransaction::replyNotice == m_Type) {
-        tag.add_attribute("requestNumber", formatLong(m_lRequestNumber));
-        tag.add_attribute("transSuccess", formatBool(m_bReplyTransSuccess));
+        writer.add_attribute("requestNumber", formatLong(m_lRequestNumber));
+        writer.add_attribute("transSuccess", formatBool(m_bReplyTransSuccess));
     }
 
     // IF this transaction is "blank" or
@@ -4293,7 +4338,7 @@ void OTTransaction::UpdateContents()
         if (m_Numlist.Count() > 0) {
             String strNumbers;
             if (m_Numlist.Output(strNumbers))
-                tag.add_attribute("totalListOfNumbers", strNumbers.Get());
+                writer.add_attribute("totalListOfNumbers", strNumbers.Get());
         }
     }
 
@@ -4302,22 +4347,22 @@ void OTTransaction::UpdateContents()
 
             switch (m_pParent->GetType()) {
             case Ledger::nymbox:
-                SaveAbbreviatedNymboxRecord(tag);
+                SaveAbbreviatedNymboxRecord(writer);
                 break;
             case Ledger::inbox:
-                SaveAbbreviatedInboxRecord(tag);
+                SaveAbbreviatedInboxRecord(writer);
                 break;
             case Ledger::outbox:
-                SaveAbbreviatedOutboxRecord(tag);
+                SaveAbbreviatedOutboxRecord(writer);
                 break;
             case Ledger::paymentInbox:
-                SaveAbbrevPaymentInboxRecord(tag);
+                SaveAbbrevPaymentInboxRecord(writer);
                 break;
             case Ledger::recordBox:
-                SaveAbbrevRecordBoxRecord(tag);
+                SaveAbbrevRecordBoxRecord(writer);
                 break;
             case Ledger::expiredBox:
-                SaveAbbrevExpiredBoxRecord(tag);
+                SaveAbbrevExpiredBoxRecord(writer);
                 break;
             /* --- BREAK --- */
             case Ledger::message:
@@ -4342,21 +4387,20 @@ void OTTransaction::UpdateContents()
     {
         if ((OTTransaction::finalReceipt == m_Type) ||
             (OTTransaction::basketReceipt == m_Type)) {
-            TagPtr tagClosingNo(new Tag("closingTransactionNumber"));
-            tagClosingNo->add_attribute("value",
-                                        formatLong(m_lClosingTransactionNo));
-            tag.add_tag(tagClosingNo);
+            writer.open_element("closingTransactionNumber");
+            writer.add_attribute("value", formatLong(m_lClosingTransactionNo));
+            writer.close_element();
         }
 
         // a transaction contains a list of items, but it is also in reference
         // to some item, from someone else
         // We include a full copy of that item here.
         if (m_ascInReferenceTo.GetLength()) {
-            tag.add_tag("inReferenceTo", m_ascInReferenceTo.Get());
+            writer.add_element("inReferenceTo", m_ascInReferenceTo.Get());
         }
 
         if (m_ascCancellationRequest.GetLength()) {
-            tag.add_tag("cancelRequest", m_ascCancellationRequest.Get());
+            writer.add_element("cancelRequest", m_ascCancellationRequest.Get());
         }
 
         // loop through the items that make up this transaction and print them
@@ -4371,14 +4415,13 @@ void OTTransaction::UpdateContents()
             OTASCIIArmor ascItem;
             ascItem.SetString(strItem, true); // linebreaks = true
 
-            tag.add_tag("item", ascItem.Get());
+            writer.add_element("item", ascItem.Get());
         }
     } // not abbreviated (full details.)
 
-    std::string str_result;
-    tag.output(str_result);
+    writer.close_element();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 /*
@@ -4448,7 +4491,7 @@ paymentInbox, you get one of these in YOUR paymentInbox.
     "instrumentRejection",    // When someone rejects your invoice from his
   paymentInbox, you get one of these in YOUR paymentInbox.
  */
-void OTTransaction::SaveAbbrevPaymentInboxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevPaymentInboxRecord(XmlWriter& writer)
 {
     int64_t lDisplayValue = 0;
 
@@ -4504,21 +4547,21 @@ void OTTransaction::SaveAbbrevPaymentInboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("paymentInboxRecord"));
+    writer.open_element("paymentInboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("displayValue", formatLong(lDisplayValue));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    parent.add_tag(pTag);
+    writer.close_element();
 }
 
-void OTTransaction::SaveAbbrevExpiredBoxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevExpiredBoxRecord(XmlWriter& writer)
 {
     int64_t lDisplayValue = 0;
 
@@ -4586,18 +4629,18 @@ void OTTransaction::SaveAbbrevExpiredBoxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("expiredBoxRecord"));
+    writer.open_element("expiredBoxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("displayValue", formatLong(lDisplayValue));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
-    parent.add_tag(pTag);
+    writer.close_element();
 }
 
 /*
@@ -4641,7 +4684,7 @@ payments inbox or outpayments box.)
  Except it's used for expired payments, instead of completed / canceled
 payments.
  */
-void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
+void OTTransaction::SaveAbbrevRecordBoxRecord(XmlWriter& writer)
 {
     // Have some kind of check in here, whether the AcctID and NymID match.
     // Some recordBoxes DO, and some DON'T (the different kinds store different
@@ -4794,24 +4837,25 @@ void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("recordBoxRecord"));
+    writer.open_element("recordBoxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("adjustment", formatLong(lAdjustment));
+    writer.add_attribute("displayValue", formatLong(lDisplayValue));
+    writer.add_attribute("numberOfOrigin",
+                         formatLong(GetRawNumberOfOrigin()));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        writer.add_attribute("closingNum", formatLong(GetClosingNum()));
 
-    parent.add_tag(pTag);
+    writer.close_element();
 }
 
 // All of the actual receipts cannot fit inside the inbox file,
@@ -4821,7 +4865,7 @@ void OTTransaction::SaveAbbrevRecordBoxRecord(Tag& parent)
 // way, each message cannot be too large to download, such as
 // a giant inbox can be with 400000 receipts inside of it.
 //
-void OTTransaction::SaveAbbreviatedNymboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedNymboxRecord(XmlWriter& writer)
 {
     int64_t lDisplayValue = 0;
     bool bAddRequestNumber = false;
@@ -4919,42 +4963,42 @@ void OTTransaction::SaveAbbreviatedNymboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("nymboxRecord"));
+    writer.open_element("nymboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     // I actually don't think you can put a basket receipt
     // notice in a nymbox, the way you can with a final
     // receipt notice. Probably can remove that line.
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        writer.add_attribute("closingNum", formatLong(GetClosingNum()));
     else {
         if (strListOfBlanks.Exists())
-            pTag->add_attribute("totalListOfNumbers", strListOfBlanks.Get());
+            writer.add_attribute("totalListOfNumbers", strListOfBlanks.Get());
         if (bAddRequestNumber) {
-            pTag->add_attribute("requestNumber", formatLong(m_lRequestNumber));
-            pTag->add_attribute("transSuccess",
-                                formatBool(m_bReplyTransSuccess));
+            writer.add_attribute("requestNumber", formatLong(m_lRequestNumber));
+            writer.add_attribute("transSuccess",
+                                 formatBool(m_bReplyTransSuccess));
         }
         if (lDisplayValue > 0) {
             // IF this transaction is passing through on its
             // way to the paymentInbox, it will have a
             // displayValue.
-            pTag->add_attribute("displayValue", formatLong(lDisplayValue));
+            writer.add_attribute("displayValue", formatLong(lDisplayValue));
         }
     }
 
-    parent.add_tag(pTag);
+    writer.close_element();
 }
 
-void OTTransaction::SaveAbbreviatedOutboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedOutboxRecord(XmlWriter& writer)
 {
     int64_t lAdjustment = 0, lDisplayValue = 0;
 
@@ -5016,23 +5060,24 @@ void OTTransaction::SaveAbbreviatedOutboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("outboxRecord"));
-
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
-
-    parent.add_tag(pTag);
+    writer.open_element("outboxRecord");
+
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("adjustment", formatLong(lAdjustment));
+    writer.add_attribute("displayValue", formatLong(lDisplayValue));
+    writer.add_attribute("numberOfOrigin",
+                         formatLong(GetRawNumberOfOrigin()));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+
+    writer.close_element();
 }
 
-void OTTransaction::SaveAbbreviatedInboxRecord(Tag& parent)
+void OTTransaction::SaveAbbreviatedInboxRecord(XmlWriter& writer)
 {
     // This is the actual amount that your account is changed BY this receipt.
     // Versus the useful amount the user will want to see (lDisplayValue.) For
@@ -5168,24 +5213,25 @@ void OTTransaction::SaveAbbreviatedInboxRecord(Tag& parent)
         idReceiptHash.GetString(strHash);
     }
 
-    TagPtr pTag(new Tag("inboxRecord"));
+    writer.open_element("inboxRecord");
 
-    pTag->add_attribute("type", strType.Get());
-    pTag->add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
-    pTag->add_attribute("receiptHash", strHash.Get());
-    pTag->add_attribute("adjustment", formatLong(lAdjustment));
-    pTag->add_attribute("displayValue", formatLong(lDisplayValue));
-    pTag->add_attribute("numberOfOrigin", formatLong(GetRawNumberOfOrigin()));
-    pTag->add_attribute("transactionNum", formatLong(GetTransactionNum()));
-    pTag->add_attribute("inRefDisplay",
-                        formatLong(GetReferenceNumForDisplay()));
-    pTag->add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
+    writer.add_attribute("type", strType.Get());
+    writer.add_attribute("dateSigned", formatTimestamp(m_DATE_SIGNED));
+    writer.add_attribute("receiptHash", strHash.Get());
+    writer.add_attribute("adjustment", formatLong(lAdjustment));
+    writer.add_attribute("displayValue", formatLong(lDisplayValue));
+    writer.add_attribute("numberOfOrigin",
+                         formatLong(GetRawNumberOfOrigin()));
+    writer.add_attribute("transactionNum", formatLong(GetTransactionNum()));
+    writer.add_attribute("inRefDisplay",
+                         formatLong(GetReferenceNumForDisplay()));
+    writer.add_attribute("inReferenceTo", formatLong(GetReferenceToNum()));
 
     if ((OTTransaction::finalReceipt == m_Type) ||
         (OTTransaction::basketReceipt == m_Type))
-        pTag->add_attribute("closingNum", formatLong(GetClosingNum()));
+        writer.add_attribute("closingNum", formatLong(GetClosingNum()));
 
-    parent.add_tag(pTag);
+    writer.close_element();
 }
 
 // The ONE case where an Item has SUB-ITEMS is in the case of Balance Agreement.
@@ -0,0 +1,237 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/OTWireFormat.hpp>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/String.hpp>
+
+namespace opentxs
+{
+
+const uint8_t OTWireFormat::HeaderMagic = 0x00;
+const uint8_t OTWireFormat::HeaderVersion = 1;
+const uint32_t OTWireFormat::HeaderSize = 5;
+
+bool OTWireFormat::s_bCompress = true;
+
+// static
+bool OTWireFormat::GetCompress()
+{
+    return s_bCompress;
+}
+
+// static
+void OTWireFormat::SetCompress(bool bCompress)
+{
+    s_bCompress = bCompress;
+}
+
+// static
+const char* OTWireFormat::FramingToString(Framing theFraming)
+{
+    switch (theFraming) {
+    case ARMORED:
+        return "armored";
+    case BINARY:
+        return "binary";
+    default:
+        return "error";
+    }
+}
+
+// static
+bool OTWireFormat::FramingFromString(const std::string& strFraming,
+                                     Framing& theFraming)
+{
+    if (strFraming.compare("armored") == 0)
+        theFraming = ARMORED;
+    else if (strFraming.compare("binary") == 0)
+        theFraming = BINARY;
+    else
+        return false;
+
+    return true;
+}
+
+// static
+bool OTWireFormat::IsBinary(const void* pFrame, size_t lFrameSize)
+{
+    if ((nullptr == pFrame) || (lFrameSize < HeaderSize)) return false;
+
+    const uint8_t* pHeader = static_cast<const uint8_t*>(pFrame);
+
+    return (HeaderMagic == pHeader[0]) && ('o' == pHeader[1]) &&
+           ('t' == pHeader[2]);
+}
+
+// static
+void OTWireFormat::EmptyBinary(std::string& theOutput)
+{
+    theOutput.clear();
+    theOutput.push_back(static_cast<char>(HeaderMagic));
+    theOutput.push_back('o');
+    theOutput.push_back('t');
+    theOutput.push_back(static_cast<char>(HeaderVersion));
+    theOutput.push_back(static_cast<char>(RAW));
+}
+
+// static
+void OTWireFormat::FailedReply(Framing theRequestFraming,
+                               std::string& theOutput)
+{
+    if (BINARY == theRequestFraming)
+        EmptyBinary(theOutput);
+    else
+        theOutput.clear();
+}
+
+// static
+bool OTWireFormat::Encode(const String& strMessage, Framing theFraming,
+                          std::string& theOutput)
+{
+    theOutput.clear();
+
+    if (!strMessage.Exists()) return false;
+
+    if (ARMORED == theFraming) {
+        OTASCIIArmor ascMessage(strMessage);
+
+        if (!ascMessage.Exists()) return false;
+
+        theOutput.assign(ascMessage.Get(), ascMessage.GetLength());
+
+        return true;
+    }
+
+    const std::string strPayload(strMessage.Get(), strMessage.GetLength());
+    const bool bCompress =
+        s_bCompress && (static_cast<int64_t>(strPayload.size()) >=
+                        OTArmorCodec::GetStoredThreshold());
+
+    EmptyBinary(theOutput);
+
+    if (!bCompress) {
+        theOutput.append(strPayload);
+
+        return true;
+    }
+
+    // Binary peers are never older than the armor header, so the dictionary
+    // codec is always safe to use here.
+    std::string strCompressed;
+
+    if (!OTArmorCodec::Encode(strPayload, strCompressed,
+                              OTArmorCodec::ZLIB_DICTIONARY,
+                              OTArmorCodec::GetCompressionLevel())) {
+        otErr << "OTWireFormat::" << __FUNCTION__
+              << ": Failed compressing message.\n";
+        theOutput.clear();
+        return false;
+    }
+
+    theOutput[HeaderSize - 1] = static_cast<char>(COMPRESSED);
+    theOutput.append(strCompressed);
+
+    return true;
+}
+
+// static
+bool OTWireFormat::Decode(const void* pFrame, size_t lFrameSize,
+                          String& strMessage, Framing& theFraming)
+{
+    strMessage.Release();
+
+    if ((nullptr == pFrame) || (lFrameSize < 1)) return false;
+
+    const char* pData = static_cast<const char*>(pFrame);
+
+    if (!IsBinary(pFrame, lFrameSize)) {
+        theFraming = ARMORED;
+
+        OTASCIIArmor ascMessage;
+        ascMessage.MemSet(pData, static_cast<uint32_t>(lFrameSize));
+
+        return ascMessage.GetString(strMessage) && strMessage.Exists();
+    }
+
+    theFraming = BINARY;
+
+    const uint8_t nVersion = static_cast<uint8_t>(pData[3]);
+    const uint8_t nEncoding = static_cast<uint8_t>(pData[4]);
+
+    if (HeaderVersion != nVersion) {
+        otErr << "OTWireFormat::" << __FUNCTION__
+              << ": Unsupported header version "
+              << static_cast<int32_t>(nVersion) << ".\n";
+        return false;
+    }
+
+    const char* pPayload = pData + HeaderSize;
+    const size_t lPayloadSize = lFrameSize - HeaderSize;
+
+    if (0 == lPayloadSize) return true;
+
+    switch (nEncoding) {
+    case RAW:
+        strMessage.Set(pPayload, static_cast<uint32_t>(lPayloadSize));
+        return true;
+    case COMPRESSED: {
+        std::string strPayload;
+
+        if (!OTArmorCodec::Decode(std::string(pPayload, lPayloadSize),
+                                  strPayload)) {
+            otErr << "OTWireFormat::" << __FUNCTION__
+                  << ": Failed decompressing message.\n";
+            return false;
+        }
+
+        strMessage.Set(strPayload.data(),
+                       static_cast<uint32_t>(strPayload.size()));
+        return true;
+    }
+    default:
+        otErr << "OTWireFormat::" << __FUNCTION__ << ": Unknown encoding "
+              << static_cast<int32_t>(nEncoding) << ".\n";
+        return false;
+    }
+}
+
+} // namespace opentxs
@@ -617,9 +617,9 @@ void OTCron::ProcessCronItems()
         }
         OTCronItem* pItem = it->second;
         OT_ASSERT(nullptr != pItem);
-        otInfo << "OTCron::" << __FUNCTION__
-               << ": Processing item number: " << pItem->GetTransactionNum()
-               << " \n";
+        OT_LOG(2) << "OTCron::" << __FUNCTION__
+                  << ": Processing item number: "
+                  << pItem->GetTransactionNum() << " \n";
 
         if (pItem->ProcessCron()) {
             it++;
@@ -39,6 +39,8 @@
 #include <opentxs/core/stdafx.hpp>
 
 #include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/crypto/OTBase64.hpp>
 #include <opentxs/core/crypto/OTCrypto.hpp>
 #include <opentxs/core/crypto/OTEnvelope.hpp>
 #include <opentxs/core/Log.hpp>
@@ -46,8 +48,6 @@
 
 #include <sstream>
 #include <fstream>
-#include <cstring>
-#include <zlib.h>
 
 namespace opentxs
 {
@@ -179,93 +179,6 @@ OTASCIIArmor& OTASCIIArmor::operator=(const OTASCIIArmor& strValue)
     return *this;
 }
 
-// Source for these two functions: http://panthema.net/2007/0328-ZLibString.html
-
-/** Compress a STL string using zlib with given compression level and return
- * the binary data. */
-std::string OTASCIIArmor::compress_string(
-    const std::string& str, int32_t compressionlevel = Z_BEST_COMPRESSION) const
-{
-    z_stream zs; // z_stream is zlib's control structure
-    memset(&zs, 0, sizeof(zs));
-
-    if (deflateInit(&zs, compressionlevel) != Z_OK)
-        throw(std::runtime_error("deflateInit failed while compressing."));
-
-    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-    zs.avail_in = static_cast<uInt>(str.size()); // set the z_stream's input
-
-    int32_t ret;
-    char outbuffer[32768];
-    std::string outstring;
-
-    // retrieve the compressed bytes blockwise
-    do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = deflate(&zs, Z_FINISH);
-
-        if (outstring.size() < zs.total_out) {
-            // append the block to the output string
-            outstring.append(outbuffer, zs.total_out - outstring.size());
-        }
-    } while (ret == Z_OK);
-
-    deflateEnd(&zs);
-
-    if (ret != Z_STREAM_END) { // an error occurred that was not EOF
-        std::ostringstream oss;
-        oss << "Exception during zlib compression: (" << ret << ") " << zs.msg;
-        throw(std::runtime_error(oss.str()));
-    }
-
-    return outstring;
-}
-
-/** Decompress an STL string using zlib and return the original data. */
-std::string OTASCIIArmor::decompress_string(const std::string& str) const
-{
-    z_stream zs; // z_stream is zlib's control structure
-    memset(&zs, 0, sizeof(zs));
-
-    if (inflateInit(&zs) != Z_OK)
-        throw(std::runtime_error("inflateInit failed while decompressing."));
-
-    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-    zs.avail_in = static_cast<uInt>(str.size());
-
-    int32_t ret;
-    char outbuffer[32768];
-    std::string outstring;
-
-    // get the decompressed bytes blockwise using repeated calls to inflate
-    do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = inflate(&zs, 0);
-
-        if (outstring.size() < zs.total_out) {
-            outstring.append(outbuffer, zs.total_out - outstring.size());
-        }
-
-    } while (ret == Z_OK);
-
-    inflateEnd(&zs);
-
-    if (ret != Z_STREAM_END) { // an error occurred that was not EOF
-        std::ostringstream oss;
-        oss << "Exception during zlib decompression: (" << ret << ")";
-        if (zs.msg != nullptr) {
-            oss << " " << zs.msg;
-        }
-        throw(std::runtime_error(oss.str()));
-    }
-
-    return outstring;
-}
-
 // Base64-decode
 bool OTASCIIArmor::GetData(OTData& theData,
                            bool bLineBreaks) const // linebreaks=true
@@ -274,16 +187,11 @@ bool OTASCIIArmor::GetData(OTData& theData,
 
     if (GetLength() < 1) return true;
 
-    size_t outSize = 0;
-    uint8_t* pData = OTCrypto::It()->Base64Decode(Get(), &outSize, bLineBreaks);
-
-    if (!pData) {
+    if (!OTBase64::Decode(Get(), GetLength(), theData, bLineBreaks)) {
         otErr << __FUNCTION__ << "Base64Decode fail\n";
         return false;
     }
 
-    theData.Assign(pData, outSize);
-    delete[] pData;
     return true;
 }
 
@@ -318,23 +226,21 @@ bool OTASCIIArmor::GetString(String& strData,
         return true;
     }
 
+    std::string str_decoded(OTBase64::DecodedSizeMax(GetLength()), '\0');
     size_t outSize = 0;
-    uint8_t* pData = OTCrypto::It()->Base64Decode(Get(), &outSize, bLineBreaks);
 
-    if (!pData) {
+    if (!OTBase64::Decode(Get(), GetLength(),
+                          reinterpret_cast<uint8_t*>(&str_decoded[0]),
+                          str_decoded.size(), outSize)) {
         otErr << __FUNCTION__ << "Base64Decode fail\n";
         return false;
     }
 
-    std::string str_decoded(pData, pData + outSize);
-
-    delete[] pData;
+    str_decoded.resize(outSize);
 
     std::string str_uncompressed;
-    try {
-        str_uncompressed = decompress_string(str_decoded);
-    }
-    catch (const std::runtime_error&) {
+
+    if (!OTArmorCodec::Decode(str_decoded, str_uncompressed)) {
         otErr << __FUNCTION__ << "decompress fail\n";
         return false;
     }
@@ -352,10 +258,10 @@ bool OTASCIIArmor::SetString(const String& strData, bool bLineBreaks) //=true
     if (strData.GetLength() < 1) return true;
 
     std::string stdstring = std::string(strData.Get());
-    std::string str_compressed = compress_string(stdstring);
+    std::string str_compressed;
 
-    // "Success"
-    if (str_compressed.size() == 0) {
+    if (!OTArmorCodec::Encode(stdstring, str_compressed) ||
+        (str_compressed.size() == 0)) {
         otErr << "OTASCIIArmor::" << __FUNCTION__ << ": compression fail 0.\n";
         return false;
     }
@@ -0,0 +1,645 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/Log.hpp>
+
+#include <cstring>
+#include <zlib.h>
+
+// Measured with zlib 1.2.13 on a signed notary message (~700 bytes), a smart
+// contract (~9 KB) and an inbox of 200 receipts (~47 KB): level 1 produces
+// output within 3% of level 9 on all three, at roughly a tenth of the cost on
+// the inbox. Reusing the deflate context saves another ~40us per call, which
+// is most of the cost for a typical message. Below ~128 bytes there is nothing
+// left to gain from compressing at all.
+//
+#define OT_ARMOR_DEFAULT_CODEC OTArmorCodec::ZLIB
+#define OT_ARMOR_DEFAULT_LEVEL Z_BEST_SPEED
+#define OT_ARMOR_DEFAULT_STORED_THRESHOLD 128
+
+namespace opentxs
+{
+
+namespace
+{
+
+// The preset dictionary for the ZLIB_DICTIONARY codec. It holds the element
+// names, attribute names and bookends that the OT serializers emit most often,
+// with the most common ones at the end (where zlib finds them cheapest.)
+//
+// NEVER EDIT THIS. Armored data that was compressed with it can only be read
+// back with the identical bytes. If it needs to change, add a new dictionary
+// and bump OTArmorCodec::DictionaryVersion.
+//
+const char OT_ARMOR_DICTIONARY_V1[] =
+    "-----BEGIN OT ARMORED SIGNATURE-----\n"
+    "-----END OT ARMORED SIGNATURE-----\n"
+    "<smartContract\n"
+    " activatorAcctID=\"\"\n"
+    " activatorNymID=\"\"\n"
+    " canceled=\"false\"\n"
+    " cancelerNymID=\"\"\n"
+    "<scriptableContract\n"
+    " numBylaws=\"\n"
+    "<party\n"
+    " authorizingAgent=\"\n"
+    " ownerType=\"nym\"\n"
+    " signedCopyProvided=\"\n"
+    "<agent\n"
+    " doesAgentRepresentHimself=\"true\"\n"
+    " isAgentAnIndividual=\"true\"\n"
+    " acctID=\"\n"
+    " agentName=\"\n"
+    "<bylaw\n"
+    " language=\"chai\"\n"
+    "<variable\n"
+    "<clause\n"
+    "<hook\n"
+    "<callback\n"
+    "<paymentPlan\n"
+    "<agreement\n"
+    " recipientAcctID=\"\n"
+    " recipientNymID=\"\n"
+    " senderAcctID=\"\n"
+    " senderNymID=\"\n"
+    "<offer\n"
+    " isSelling=\"\n"
+    " marketScale=\"\n"
+    " priceLimit=\"\n"
+    " totalAssetsOnOffer=\"\n"
+    " finishedSoFar=\"\n"
+    " minimumIncrement=\"\n"
+    "<trade\n"
+    "<market\n"
+    "<cheque\n"
+    " amount=\"\n"
+    " memo=\"\n"
+    " hasRecipient=\"true\"\n"
+    " hasRemitter=\"false\"\n"
+    "<purse\n"
+    "<token\n"
+    "<mint\n"
+    "<basketContract\n"
+    "<assetAccount\n"
+    " balanceAmount=\"\n"
+    " balanceDate=\"\n"
+    " isMarkedForDeletion=\"false\"\n"
+    "<accountLedger\n"
+    " numPartialRecipts=\"0\"\n"
+    "<nymboxLedger\n"
+    "<inboxRecord\n"
+    "<outboxRecord\n"
+    "<nymboxRecord\n"
+    "<paymentInboxRecord\n"
+    "<recordBoxRecord\n"
+    "<expiredBoxRecord\n"
+    " type=\"transferReceipt\"\n"
+    " type=\"marketReceipt\"\n"
+    " type=\"paymentReceipt\"\n"
+    " type=\"finalReceipt\"\n"
+    " type=\"basketReceipt\"\n"
+    " type=\"chequeReceipt\"\n"
+    " type=\"notice\"\n"
+    " type=\"message\"\n"
+    " type=\"replyNotice\"\n"
+    " type=\"successNotice\"\n"
+    " type=\"blank\"\n"
+    " type=\"balanceStatement\"\n"
+    " type=\"transactionStatement\"\n"
+    " type=\"atBalanceStatement\"\n"
+    " type=\"atTransactionStatement\"\n"
+    "<transaction\n"
+    " cancelled=\"false\"\n"
+    " closingNum=\"\n"
+    " closingTransactionNo=\"\n"
+    " originType=\"not applicable\"\n"
+    " requestNum=\"\n"
+    " totalListOfNumbers=\"\n"
+    "<closingTransactionNumber\n"
+    "<item\n"
+    " fromAccountID=\"\n"
+    " toAccountID=\"\n"
+    " status=\"request\"\n"
+    " status=\"acknowledgement\"\n"
+    " status=\"rejection\"\n"
+    "<attachment>\n"
+    "<inboxReport>\n"
+    "<outboxReport>\n"
+    "<transactionReport>\n"
+    "<note>\n"
+    "<inReferenceTo>\n"
+    "<messagePayload>\n"
+    "<responseLedger>\n"
+    "<processLedger>\n"
+    "<nymIDSource>\n"
+    "<credentialIDs>\n"
+    "<publicCredential\n"
+    "<masterCredential\n"
+    "<keyCredential\n"
+    "<nymData\n"
+    "<nymfile\n"
+    "<nymPublicKey\n"
+    "<publicEncryptionKey\n"
+    "<publicAuthentKey\n"
+    "<publicSignKey\n"
+    "<transactionNums\n"
+    "<issuedNums\n"
+    "<tentativeNums\n"
+    "<ackNums\n"
+    "<ownsAssetAcct\n"
+    "<mailMessage\n"
+    "<outmailMessage\n"
+    "<outpaymentsMessage\n"
+    "<cachedKey>\n"
+    "<stringMap\n"
+    " ackReplies=\"\n"
+    " depth=\"\n"
+    " nymboxHash=\"\n"
+    " inboxHash=\"\n"
+    " outboxHash=\"\n"
+    " success=\"false\"\n"
+    " success=\"true\"\n"
+    " transSuccess=\"true\"\n"
+    " boxType=\"\n"
+    " count=\"\n"
+    " command=\"\n"
+    " hasCredentials=\"true\"\n"
+    " masterID=\"\n"
+    " serverNymID=\"\n"
+    " marketID=\"\n"
+    " currencyTypeID=\"\n"
+    " accountID=\"\n"
+    " adjustment=\"\n"
+    " dateSigned=\"\n"
+    " displayValue=\"\n"
+    " inRefDisplay=\"\n"
+    " inReferenceTo=\"\n"
+    " numberOfOrigin=\"\n"
+    " receiptHash=\"\n"
+    " transactionNum=\"\n"
+    " version=\"2.0\"\n"
+    " validFrom=\"\n"
+    " validTo=\"\n"
+    " instrumentDefinitionID=\"\n"
+    "<notaryMessage\n"
+    " version=\"3.0\"\n"
+    " requestNum=\"\n"
+    " nymID=\"\n"
+    " notaryID=\"\n"
+    "<?xml version=\"1.0\"?>\n"
+    "-----BEGIN SIGNED TRANSACTION-----\n"
+    "-----BEGIN SIGNED LEDGER-----\n"
+    "-----BEGIN SIGNED ACCOUNT-----\n"
+    "-----BEGIN SIGNED NYMFILE-----\n"
+    "-----BEGIN SIGNED MESSAGE-----\n"
+    "Hash: SHA256\n"
+    "\n"
+    "-----END MESSAGE SIGNATURE-----\n"
+    "-----END LEDGER SIGNATURE-----\n"
+    "-----END TRANSACTION SIGNATURE-----\n"
+    "-----BEGIN TRANSACTION SIGNATURE-----\n"
+    "-----BEGIN LEDGER SIGNATURE-----\n"
+    "-----BEGIN MESSAGE SIGNATURE-----\n"
+    "Version: Open Transactions 0.93\n"
+    "Comment: http://github.com/FellowTraveler/Open-Transactions/wiki\n"
+    "Meta:    \n";
+
+class DeflateContext
+{
+public:
+    DeflateContext()
+        : m_bInitialized(false)
+        , m_nLevel(0)
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+    }
+
+    ~DeflateContext()
+    {
+        if (m_bInitialized) deflateEnd(&m_stream);
+    }
+
+    // Returns a context that is ready for a new stream at nLevel, or nullptr.
+    z_stream* Get(int32_t nLevel)
+    {
+        if (m_bInitialized && (nLevel == m_nLevel)) {
+            if (Z_OK == deflateReset(&m_stream)) return &m_stream;
+        }
+
+        if (m_bInitialized) deflateEnd(&m_stream);
+
+        memset(&m_stream, 0, sizeof(m_stream));
+        m_bInitialized = (Z_OK == deflateInit(&m_stream, nLevel));
+        m_nLevel = nLevel;
+
+        return m_bInitialized ? &m_stream : nullptr;
+    }
+
+private:
+    DeflateContext(const DeflateContext&);
+    DeflateContext& operator=(const DeflateContext&);
+
+    z_stream m_stream;
+    bool m_bInitialized;
+    int32_t m_nLevel;
+};
+
+class InflateContext
+{
+public:
+    InflateContext()
+        : m_bInitialized(false)
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+    }
+
+    ~InflateContext()
+    {
+        if (m_bInitialized) inflateEnd(&m_stream);
+    }
+
+    // Returns a context that is ready for a new stream, or nullptr.
+    z_stream* Get()
+    {
+        if (m_bInitialized) {
+            if (Z_OK == inflateReset(&m_stream)) return &m_stream;
+
+            inflateEnd(&m_stream);
+        }
+
+        memset(&m_stream, 0, sizeof(m_stream));
+        m_bInitialized = (Z_OK == inflateInit(&m_stream));
+
+        return m_bInitialized ? &m_stream : nullptr;
+    }
+
+private:
+    InflateContext(const InflateContext&);
+    InflateContext& operator=(const InflateContext&);
+
+    z_stream m_stream;
+    bool m_bInitialized;
+};
+
+// Payloads below the stored threshold are deflated at Z_NO_COMPRESSION, the
+// rest at the configured level. Each gets its own context, so that a mix of
+// the two doesn't re-initialize a context on every call.
+thread_local DeflateContext t_deflateContext;
+thread_local DeflateContext t_storedDeflateContext;
+thread_local InflateContext t_inflateContext;
+
+} // namespace
+
+const uint8_t OTArmorCodec::HeaderMagic = 'O';
+const uint8_t OTArmorCodec::HeaderVersion = 1;
+const uint8_t OTArmorCodec::DictionaryVersion = 1;
+const uint32_t OTArmorCodec::HeaderSize = 4;
+
+OTArmorCodec::Codec OTArmorCodec::s_codec = OT_ARMOR_DEFAULT_CODEC;
+int32_t OTArmorCodec::s_nLevel = OT_ARMOR_DEFAULT_LEVEL;
+int64_t OTArmorCodec::s_lStoredThreshold = OT_ARMOR_DEFAULT_STORED_THRESHOLD;
+
+// static
+OTArmorCodec::Codec OTArmorCodec::GetCodec()
+{
+    return s_codec;
+}
+
+// static
+void OTArmorCodec::SetCodec(Codec theCodec)
+{
+    s_codec = theCodec;
+}
+
+// static
+int32_t OTArmorCodec::GetCompressionLevel()
+{
+    return s_nLevel;
+}
+
+// static
+void OTArmorCodec::SetCompressionLevel(int32_t nLevel)
+{
+    if ((nLevel < Z_NO_COMPRESSION) || (nLevel > Z_BEST_COMPRESSION)) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": Invalid compression level " << nLevel
+              << ", keeping " << s_nLevel << ".\n";
+        return;
+    }
+
+    s_nLevel = nLevel;
+}
+
+// static
+int64_t OTArmorCodec::GetStoredThreshold()
+{
+    return s_lStoredThreshold;
+}
+
+// static
+void OTArmorCodec::SetStoredThreshold(int64_t lThreshold)
+{
+    s_lStoredThreshold = (lThreshold < 0) ? 0 : lThreshold;
+}
+
+// static
+const char* OTArmorCodec::CodecToString(Codec theCodec)
+{
+    switch (theCodec) {
+    case ZLIB:
+        return "zlib";
+    case STORED:
+        return "stored";
+    case ZLIB_DICTIONARY:
+        return "zlib_dictionary";
+    default:
+        return "error";
+    }
+}
+
+// static
+bool OTArmorCodec::CodecFromString(const std::string& strCodec,
+                                   Codec& theCodec)
+{
+    if (strCodec.compare("zlib") == 0)
+        theCodec = ZLIB;
+    else if (strCodec.compare("stored") == 0)
+        theCodec = STORED;
+    else if (strCodec.compare("zlib_dictionary") == 0)
+        theCodec = ZLIB_DICTIONARY;
+    else
+        return false;
+
+    return true;
+}
+
+// static
+bool OTArmorCodec::Encode(const std::string& theInput, std::string& theOutput)
+{
+    const Codec theCodec = s_codec;
+
+    if (static_cast<int64_t>(theInput.size()) < s_lStoredThreshold) {
+        // Older peers can't read the STORED header, so the ZLIB codec keeps
+        // using a zlib stream here, just without compressing it.
+        if (ZLIB == theCodec)
+            return Encode(theInput, theOutput, ZLIB, Z_NO_COMPRESSION);
+
+        return Encode(theInput, theOutput, STORED, Z_NO_COMPRESSION);
+    }
+
+    return Encode(theInput, theOutput, theCodec, s_nLevel);
+}
+
+// static
+bool OTArmorCodec::Encode(const std::string& theInput, std::string& theOutput,
+                          Codec theCodec, int32_t nLevel)
+{
+    theOutput.clear();
+
+    if (ZLIB == theCodec) return Deflate(theInput, theOutput, nLevel, false);
+
+    theOutput.reserve(HeaderSize + theInput.size());
+    theOutput.push_back(static_cast<char>(HeaderMagic));
+    theOutput.push_back(static_cast<char>(HeaderVersion));
+    theOutput.push_back(static_cast<char>(theCodec));
+
+    switch (theCodec) {
+    case STORED:
+        theOutput.push_back(static_cast<char>(0));
+        theOutput.append(theInput);
+        return true;
+    case ZLIB_DICTIONARY:
+        theOutput.push_back(static_cast<char>(DictionaryVersion));
+        return Deflate(theInput, theOutput, nLevel, true);
+    default:
+        break;
+    }
+
+    otErr << "OTArmorCodec::" << __FUNCTION__ << ": Unknown codec "
+          << static_cast<int32_t>(theCodec) << ".\n";
+    theOutput.clear();
+    return false;
+}
+
+// static
+bool OTArmorCodec::Decode(const std::string& theInput, std::string& theOutput)
+{
+    theOutput.clear();
+
+    if (theInput.empty()) {
+        otErr << "OTArmorCodec::" << __FUNCTION__ << ": Empty input.\n";
+        return false;
+    }
+
+    // No header: a legacy zlib stream.
+    if (static_cast<uint8_t>(theInput[0]) != HeaderMagic)
+        return Inflate(theInput.data(), theInput.size(), theOutput, false);
+
+    if (theInput.size() < HeaderSize) {
+        otErr << "OTArmorCodec::" << __FUNCTION__ << ": Truncated header.\n";
+        return false;
+    }
+
+    const uint8_t nVersion = static_cast<uint8_t>(theInput[1]);
+    const uint8_t nCodec = static_cast<uint8_t>(theInput[2]);
+    const uint8_t nDictionary = static_cast<uint8_t>(theInput[3]);
+
+    if (nVersion > HeaderVersion) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": Unsupported header version "
+              << static_cast<int32_t>(nVersion) << ".\n";
+        return false;
+    }
+
+    const char* pPayload = theInput.data() + HeaderSize;
+    const size_t lPayloadSize = theInput.size() - HeaderSize;
+
+    switch (nCodec) {
+    case STORED:
+        theOutput.assign(pPayload, lPayloadSize);
+        return true;
+    case ZLIB:
+        return Inflate(pPayload, lPayloadSize, theOutput, false);
+    case ZLIB_DICTIONARY:
+        if (nDictionary != DictionaryVersion) {
+            otErr << "OTArmorCodec::" << __FUNCTION__
+                  << ": Unknown dictionary version "
+                  << static_cast<int32_t>(nDictionary) << ".\n";
+            return false;
+        }
+        return Inflate(pPayload, lPayloadSize, theOutput, true);
+    default:
+        break;
+    }
+
+    otErr << "OTArmorCodec::" << __FUNCTION__ << ": Unknown codec "
+          << static_cast<int32_t>(nCodec) << ".\n";
+    return false;
+}
+
+// Appends the compressed form of theInput to theOutput.
+//
+// static
+bool OTArmorCodec::Deflate(const std::string& theInput, std::string& theOutput,
+                           int32_t nLevel, bool bUseDictionary)
+{
+    DeflateContext& theContext = (Z_NO_COMPRESSION == nLevel)
+                                     ? t_storedDeflateContext
+                                     : t_deflateContext;
+    z_stream* pStream = theContext.Get(nLevel);
+
+    if (nullptr == pStream) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": deflateInit failed while compressing.\n";
+        return false;
+    }
+
+    if (bUseDictionary &&
+        (Z_OK != deflateSetDictionary(
+                     pStream,
+                     reinterpret_cast<const Bytef*>(OT_ARMOR_DICTIONARY_V1),
+                     sizeof(OT_ARMOR_DICTIONARY_V1) - 1))) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": deflateSetDictionary failed.\n";
+        return false;
+    }
+
+    const size_t lOffset = theOutput.size();
+    size_t lBound = deflateBound(pStream, theInput.size());
+
+    pStream->next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(theInput.data()));
+    pStream->avail_in = static_cast<uInt>(theInput.size());
+
+    int32_t ret = Z_OK;
+
+    // deflateBound is normally enough for a single pass. The loop is only
+    // there in case it isn't.
+    do {
+        theOutput.resize(lOffset + pStream->total_out + lBound);
+
+        pStream->next_out =
+            reinterpret_cast<Bytef*>(&theOutput[lOffset + pStream->total_out]);
+        pStream->avail_out = static_cast<uInt>(lBound);
+
+        ret = deflate(pStream, Z_FINISH);
+        lBound = (lBound < 1024) ? 1024 : lBound;
+    } while ((Z_OK == ret) ||
+             ((Z_BUF_ERROR == ret) && (0 == pStream->avail_out)));
+
+    if (Z_STREAM_END != ret) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": Exception during zlib compression: (" << ret << ") "
+              << ((nullptr != pStream->msg) ? pStream->msg : "") << "\n";
+        theOutput.resize(lOffset);
+        return false;
+    }
+
+    theOutput.resize(lOffset + pStream->total_out);
+
+    return true;
+}
+
+// static
+bool OTArmorCodec::Inflate(const char* pInput, size_t lInputSize,
+                           std::string& theOutput, bool bUseDictionary)
+{
+    z_stream* pStream = t_inflateContext.Get();
+
+    if (nullptr == pStream) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": inflateInit failed while decompressing.\n";
+        return false;
+    }
+
+    pStream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pInput));
+    pStream->avail_in = static_cast<uInt>(lInputSize);
+
+    // Armored XML usually inflates to several times its compressed size.
+    theOutput.resize((lInputSize < 1024) ? 4096 : (lInputSize * 4));
+
+    int32_t ret = Z_OK;
+
+    for (;;) {
+        if (pStream->total_out == theOutput.size())
+            theOutput.resize(theOutput.size() * 2);
+
+        pStream->next_out =
+            reinterpret_cast<Bytef*>(&theOutput[pStream->total_out]);
+        pStream->avail_out =
+            static_cast<uInt>(theOutput.size() - pStream->total_out);
+
+        ret = inflate(pStream, Z_NO_FLUSH);
+
+        if ((Z_NEED_DICT == ret) && bUseDictionary) {
+            ret = inflateSetDictionary(
+                pStream,
+                reinterpret_cast<const Bytef*>(OT_ARMOR_DICTIONARY_V1),
+                sizeof(OT_ARMOR_DICTIONARY_V1) - 1);
+
+            if (Z_OK != ret) break;
+
+            continue;
+        }
+
+        if (Z_OK != ret) {
+            // Z_BUF_ERROR with a full output buffer just means "grow it."
+            if ((Z_BUF_ERROR == ret) && (0 == pStream->avail_out)) continue;
+
+            break;
+        }
+    }
+
+    if (Z_STREAM_END != ret) {
+        otErr << "OTArmorCodec::" << __FUNCTION__
+              << ": Exception during zlib decompression: (" << ret << ")";
+        if (nullptr != pStream->msg) otErr << " " << pStream->msg;
+        otErr << "\n";
+        theOutput.clear();
+        return false;
+    }
+
+    theOutput.resize(pStream->total_out);
+
+    return true;
+}
+
+} // namespace opentxs
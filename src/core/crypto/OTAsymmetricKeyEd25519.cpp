@@ -0,0 +1,509 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTAsymmetricKeyEd25519.hpp>
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/crypto/OTPasswordData.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/OTData.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <sodium.h>
+
+#include <mutex>
+
+// The sealed private key is:
+//
+//   'E' 'D' version | salt | nonce | crypto_secretbox(secret key)
+//
+// Version 1 derives the box key with crypto_pwhash (Argon2id) at the
+// INTERACTIVE limits. A new version byte is needed if those ever change.
+//
+#define OT_ED25519_SEALED_VERSION 1
+#define OT_ED25519_SEALED_HEADER 3
+
+namespace opentxs
+{
+
+namespace
+{
+
+std::once_flag s_sodiumInit;
+
+bool init_sodium()
+{
+    static bool s_bReady = false;
+
+    std::call_once(s_sodiumInit, []() { s_bReady = (sodium_init() >= 0); });
+
+    if (!s_bReady) otErr << __FUNCTION__ << ": sodium_init failed.\n";
+
+    return s_bReady;
+}
+
+bool derive_box_key(const OTPassword& thePassphrase, const uint8_t* pSalt,
+                    uint8_t* pBoxKey)
+{
+    if (0 != crypto_pwhash(pBoxKey, crypto_secretbox_KEYBYTES,
+                           thePassphrase.getPassword(),
+                           thePassphrase.getPasswordSize(), pSalt,
+                           crypto_pwhash_OPSLIMIT_INTERACTIVE,
+                           crypto_pwhash_MEMLIMIT_INTERACTIVE,
+                           crypto_pwhash_ALG_ARGON2ID13)) {
+        otErr << __FUNCTION__ << ": crypto_pwhash failed (out of memory?)\n";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+OTAsymmetricKey_Ed25519::OTAsymmetricKey_Ed25519()
+    : OTAsymmetricKey()
+    , m_pSecretKey(nullptr)
+{
+}
+
+OTAsymmetricKey_Ed25519::~OTAsymmetricKey_Ed25519()
+{
+    // Not through the hook: see ~OTAsymmetricKey_OpenSSL for why.
+    if (nullptr != m_pSecretKey) delete m_pSecretKey;
+    m_pSecretKey = nullptr;
+}
+
+// virtual
+void OTAsymmetricKey_Ed25519::Release()
+{
+    ot_super::Release();
+}
+
+void OTAsymmetricKey_Ed25519::ReleaseKeyLowLevel_Hook() const
+{
+    // OTPassword zeroes its memory on destruction.
+    if (nullptr != m_pSecretKey) delete m_pSecretKey;
+    m_pSecretKey = nullptr;
+}
+
+// static
+bool OTAsymmetricKey_Ed25519::GetPassphrase(const OTPasswordData& thePWData,
+                                            bool bAskTwice,
+                                            const OTPassword* pImportPassword,
+                                            OTPassword& thePassphrase)
+{
+    if (nullptr != pImportPassword) {
+        thePassphrase.setPassword(pImportPassword->getPassword(),
+                                  pImportPassword->getPasswordSize());
+        return true;
+    }
+
+    OT_OPENSSL_CALLBACK* pCallback = OTAsymmetricKey::GetPasswordCallback();
+
+    if (nullptr == pCallback) return false;
+
+    char buf[OT_DEFAULT_BLOCKSIZE];
+    const int32_t nLength =
+        (*pCallback)(buf, OT_DEFAULT_BLOCKSIZE, bAskTwice ? 1 : 0,
+                     const_cast<OTPasswordData*>(&thePWData));
+
+    if (nLength > 0) thePassphrase.setPassword(buf, nLength);
+
+    OTPassword::zeroMemory(buf, OT_DEFAULT_BLOCKSIZE);
+
+    return nLength > 0;
+}
+
+// static
+bool OTAsymmetricKey_Ed25519::Seal(const OTPassword& theSecretKey,
+                                   const OTPassword& thePassphrase,
+                                   OTASCIIArmor& ascOutput)
+{
+    if (!init_sodium()) return false;
+
+    OT_ASSERT(crypto_sign_SECRETKEYBYTES == theSecretKey.getMemorySize());
+
+    const uint32_t nSize = OT_ED25519_SEALED_HEADER + crypto_pwhash_SALTBYTES +
+                           crypto_secretbox_NONCEBYTES +
+                           crypto_secretbox_MACBYTES +
+                           crypto_sign_SECRETKEYBYTES;
+    OTData theData;
+    theData.SetSize(nSize);
+
+    uint8_t* pOutput = static_cast<uint8_t*>(
+        const_cast<void*>(theData.GetPointer()));
+    uint8_t* pSalt = pOutput + OT_ED25519_SEALED_HEADER;
+    uint8_t* pNonce = pSalt + crypto_pwhash_SALTBYTES;
+    uint8_t* pBox = pNonce + crypto_secretbox_NONCEBYTES;
+
+    pOutput[0] = 'E';
+    pOutput[1] = 'D';
+    pOutput[2] = OT_ED25519_SEALED_VERSION;
+    randombytes_buf(pSalt, crypto_pwhash_SALTBYTES);
+    randombytes_buf(pNonce, crypto_secretbox_NONCEBYTES);
+
+    uint8_t boxKey[crypto_secretbox_KEYBYTES];
+
+    if (!derive_box_key(thePassphrase, pSalt, boxKey)) return false;
+
+    crypto_secretbox_easy(pBox, theSecretKey.getMemory_uint8(),
+                          crypto_sign_SECRETKEYBYTES, pNonce, boxKey);
+    OTPassword::zeroMemory(boxKey, crypto_secretbox_KEYBYTES);
+
+    return ascOutput.SetData(theData);
+}
+
+// static
+bool OTAsymmetricKey_Ed25519::Unseal(const OTASCIIArmor& ascInput,
+                                     const OTPassword& thePassphrase,
+                                     OTPassword& theSecretKey)
+{
+    if (!init_sodium()) return false;
+
+    OTData theData;
+
+    if (!ascInput.GetData(theData)) return false;
+
+    const uint32_t nSize = OT_ED25519_SEALED_HEADER + crypto_pwhash_SALTBYTES +
+                           crypto_secretbox_NONCEBYTES +
+                           crypto_secretbox_MACBYTES +
+                           crypto_sign_SECRETKEYBYTES;
+    const uint8_t* pInput = static_cast<const uint8_t*>(theData.GetPointer());
+
+    if ((nSize != theData.GetSize()) || ('E' != pInput[0]) ||
+        ('D' != pInput[1]) || (OT_ED25519_SEALED_VERSION != pInput[2])) {
+        otErr << __FUNCTION__ << ": Not a sealed Ed25519 private key.\n";
+        return false;
+    }
+
+    const uint8_t* pSalt = pInput + OT_ED25519_SEALED_HEADER;
+    const uint8_t* pNonce = pSalt + crypto_pwhash_SALTBYTES;
+    const uint8_t* pBox = pNonce + crypto_secretbox_NONCEBYTES;
+
+    uint8_t boxKey[crypto_secretbox_KEYBYTES];
+
+    if (!derive_box_key(thePassphrase, pSalt, boxKey)) return false;
+
+    uint8_t sk[crypto_sign_SECRETKEYBYTES];
+    const bool bOpened = (0 == crypto_secretbox_open_easy(
+                                   sk, pBox, crypto_secretbox_MACBYTES +
+                                                 crypto_sign_SECRETKEYBYTES,
+                                   pNonce, boxKey));
+    OTPassword::zeroMemory(boxKey, crypto_secretbox_KEYBYTES);
+
+    if (!bOpened) {
+        otErr << __FUNCTION__ << ": Wrong passphrase, or the key is "
+                                 "corrupted.\n";
+        return false;
+    }
+
+    theSecretKey.setMemory(sk, crypto_sign_SECRETKEYBYTES);
+    OTPassword::zeroMemory(sk, crypto_sign_SECRETKEYBYTES);
+
+    return true;
+}
+
+const OTPassword* OTAsymmetricKey_Ed25519::GetSecretKey(
+    const OTPasswordData* pPWData, const OTPassword* pImportPassword)
+{
+    if (!IsPrivate() || (nullptr == m_p_ascKey)) {
+        otErr << __FUNCTION__ << ": Not a private key.\n";
+        return nullptr;
+    }
+
+    if (IsKeyTimerExpired()) ReleaseKeyLowLevel();
+
+    if (nullptr != m_pSecretKey) return m_pSecretKey;
+
+    OTPasswordData thePWData("OTAsymmetricKey_Ed25519::GetSecretKey is "
+                             "unsealing the private key...");
+
+    if (nullptr == pPWData) pPWData = &thePWData;
+
+    OTPassword thePassphrase;
+    OTPassword* pSecretKey = new OTPassword;
+    OT_ASSERT(nullptr != pSecretKey);
+
+    if (!GetPassphrase(*pPWData, false, pImportPassword, thePassphrase) ||
+        !Unseal(*m_p_ascKey, thePassphrase, *pSecretKey)) {
+        delete pSecretKey;
+        return nullptr;
+    }
+
+    m_pSecretKey = pSecretKey;
+    m_timer.start();
+    CountKeyInstantiation();
+
+    return m_pSecretKey;
+}
+
+// static
+bool OTAsymmetricKey_Ed25519::MakeNewKeypair(
+    OTAsymmetricKey_Ed25519& thePublicKey,
+    OTAsymmetricKey_Ed25519& thePrivateKey)
+{
+    if (!init_sodium()) return false;
+
+    uint8_t pk[crypto_sign_PUBLICKEYBYTES];
+    uint8_t sk[crypto_sign_SECRETKEYBYTES];
+
+    crypto_sign_keypair(pk, sk);
+
+    OTPassword* pSecretKey = new OTPassword(static_cast<const void*>(sk),
+                                            crypto_sign_SECRETKEYBYTES);
+    OT_ASSERT(nullptr != pSecretKey);
+    OTPassword::zeroMemory(sk, crypto_sign_SECRETKEYBYTES);
+
+    OTASCIIArmor ascPublic, ascPrivate;
+    OTPassword thePassphrase;
+    OTPasswordData thePWData("Enter the master passphrase. "
+                             "(OTAsymmetricKey_Ed25519::MakeNewKeypair)");
+
+    if (!ascPublic.SetData(OTData(pk, crypto_sign_PUBLICKEYBYTES)) ||
+        !GetPassphrase(thePWData, true, nullptr, thePassphrase) ||
+        !Seal(*pSecretKey, thePassphrase, ascPrivate)) {
+        otErr << __FUNCTION__ << ": Failed sealing the new private key.\n";
+        delete pSecretKey;
+        return false;
+    }
+
+    thePublicKey.SetPublicKey(ascPublic);
+    thePrivateKey.SetPrivateKey(ascPrivate);
+
+    // Keep the key we just generated, so that the first signature doesn't
+    // have to derive the sealing key all over again.
+    thePrivateKey.m_pSecretKey = pSecretKey;
+    thePrivateKey.m_timer.start();
+
+    return true;
+}
+
+bool OTAsymmetricKey_Ed25519::Sign(const String& strContents,
+                                   OTSignature& theSignature,
+                                   const OTPasswordData* pPWData)
+{
+    const OTPassword* pSecretKey = GetSecretKey(pPWData);
+
+    if (nullptr == pSecretKey) {
+        otErr << __FUNCTION__ << ": Unable to load the private key.\n";
+        return false;
+    }
+
+    uint8_t sig[crypto_sign_BYTES];
+
+    if (0 != crypto_sign_detached(
+                 sig, nullptr,
+                 reinterpret_cast<const uint8_t*>(strContents.Get()),
+                 strContents.GetLength(), pSecretKey->getMemory_uint8())) {
+        otErr << __FUNCTION__ << ": crypto_sign_detached failed.\n";
+        return false;
+    }
+
+    return theSignature.SetData(OTData(sig, crypto_sign_BYTES));
+}
+
+bool OTAsymmetricKey_Ed25519::Verify(const String& strContents,
+                                     const OTSignature& theSignature) const
+{
+    if (!init_sodium()) return false;
+
+    if (!IsPublic() || (nullptr == m_p_ascKey)) {
+        otErr << __FUNCTION__ << ": Not a public key.\n";
+        return false;
+    }
+
+    OTData thePublicKey, theSig;
+
+    if (!m_p_ascKey->GetData(thePublicKey) ||
+        (crypto_sign_PUBLICKEYBYTES != thePublicKey.GetSize())) {
+        otErr << __FUNCTION__ << ": Bad public key.\n";
+        return false;
+    }
+
+    if (!theSignature.GetData(theSig) ||
+        (crypto_sign_BYTES != theSig.GetSize())) {
+        otLog4 << __FUNCTION__ << ": Signature is not an Ed25519 signature.\n";
+        return false;
+    }
+
+    return 0 == crypto_sign_verify_detached(
+                    static_cast<const uint8_t*>(theSig.GetPointer()),
+                    reinterpret_cast<const uint8_t*>(strContents.Get()),
+                    strContents.GetLength(),
+                    static_cast<const uint8_t*>(thePublicKey.GetPointer()));
+}
+
+bool OTAsymmetricKey_Ed25519::LoadPrivateKeyFromCertString(
+    const String& strCert, bool bEscaped, const String* pstrReason,
+    const OTPassword* pImportPassword)
+{
+    Release();
+
+    OTASCIIArmor theArmor;
+
+    if (!theArmor.LoadFromString(const_cast<String&>(strCert), bEscaped,
+                                 "-----BEGIN ENCRYPTED ED25519 PRIVATE")) {
+        otErr << __FUNCTION__ << ": Error extracting ASCII-Armored text from "
+                                 "Cert String.\n";
+        return false;
+    }
+
+    SetPrivateKey(theArmor);
+
+    // Unseal it now, as OpenSSL does when it reads an RSA key, so that a
+    // wrong import passphrase is caught here rather than at signing time.
+    OTPasswordData thePWData(
+        (nullptr == pstrReason)
+            ? (nullptr == pImportPassword
+                   ? "Enter the master passphrase. "
+                     "(LoadPrivateKeyFromCertString)"
+                   : "Enter the passphrase for this exported nym.")
+            : pstrReason->Get());
+
+    return nullptr != GetSecretKey(&thePWData, pImportPassword);
+}
+
+bool OTAsymmetricKey_Ed25519::LoadPublicKeyFromCertString(
+    const String& strCert, bool bEscaped, const String*, const OTPassword*)
+{
+    Release();
+
+    OTASCIIArmor theArmor;
+
+    if (!theArmor.LoadFromString(const_cast<String&>(strCert), bEscaped,
+                                 "-----BEGIN ED25519 PUBLIC KEY")) {
+        otErr << __FUNCTION__ << ": Error extracting ASCII-Armored text from "
+                                 "Cert String.\n";
+        return false;
+    }
+
+    return SetPublicKey(theArmor);
+}
+
+// There are no x509 certs for Ed25519 keys: the "cert" is just the
+// bookended public key.
+//
+bool OTAsymmetricKey_Ed25519::SaveCertToString(String& strOutput,
+                                               const String*,
+                                               const OTPassword*) const
+{
+    String strKey;
+
+    if (!GetPublicKey(strKey, false)) return false;
+
+    strOutput = strKey;
+
+    return true;
+}
+
+// The stored key is already sealed to whichever passphrase pImportPassword
+// stands for (the export passphrase, or the wallet's when it's nullptr), so
+// there is nothing to re-encrypt here.
+//
+bool OTAsymmetricKey_Ed25519::SavePrivateKeyToString(String& strOutput,
+                                                     const String*,
+                                                     const OTPassword*) const
+{
+    if (!IsPrivate()) {
+        otErr << __FUNCTION__ << ": Error: !IsPrivate() (This function should "
+                                 "only be called on a private key.)\n";
+        return false;
+    }
+
+    String strKey;
+
+    if (!GetPrivateKey(strKey, false)) return false;
+
+    strOutput = strKey;
+
+    return true;
+}
+
+bool OTAsymmetricKey_Ed25519::LoadPublicKeyFromPGPKey(const OTASCIIArmor&)
+{
+    otErr << __FUNCTION__ << ": PGP keys are not Ed25519 keys.\n";
+    return false;
+}
+
+bool OTAsymmetricKey_Ed25519::ReEncryptPrivateKey(
+    const OTPassword& theExportPassword, bool bImporting) const
+{
+    OT_ASSERT(nullptr != m_p_ascKey);
+    OT_ASSERT(IsPrivate());
+
+    OTPasswordData thePWData(
+        bImporting ? "(Importing) Enter your wallet's master passphrase."
+                   : "(Exporting) Enter your wallet's master passphrase.");
+
+    OTPassword theOldPassphrase, theNewPassphrase, theSecretKey;
+
+    // Importing: sealed to the export passphrase, reseal to the wallet's.
+    // Exporting: the other way around.
+    if (!GetPassphrase(thePWData, false,
+                       bImporting ? &theExportPassword : nullptr,
+                       theOldPassphrase) ||
+        !Unseal(*m_p_ascKey, theOldPassphrase, theSecretKey)) {
+        otErr << __FUNCTION__ << ": Failed unsealing the private key.\n";
+        return false;
+    }
+
+    OTASCIIArmor ascSealed;
+
+    if (!GetPassphrase(thePWData, false,
+                       bImporting ? nullptr : &theExportPassword,
+                       theNewPassphrase) ||
+        !Seal(theSecretKey, theNewPassphrase, ascSealed)) {
+        otErr << __FUNCTION__ << ": Failed resealing the private key.\n";
+        return false;
+    }
+
+    m_p_ascKey->Set(ascSealed);
+    ReleaseKeyLowLevel_Hook();
+
+    return true;
+}
+
+} // namespace opentxs
+
+#endif // OT_CRYPTO_SUPPORTED_KEY_ED25519
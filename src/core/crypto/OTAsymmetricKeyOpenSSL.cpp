@@ -297,6 +297,9 @@ OTAsymmetricKey_OpenSSL::~OTAsymmetricKey_OpenSSL()
     // into OTAsymmetricKey's destructor and
     // make sure the full call path through there doesn't involve any virtual
     // functions.
+
+    delete dp;
+    dp = nullptr;
 }
 
 // virtual
@@ -316,6 +319,9 @@ void OTAsymmetricKey_OpenSSL::Release_AsymmetricKey_OpenSSL()
 
 void OTAsymmetricKey_OpenSSL::ReleaseKeyLowLevel_Hook() const
 {
+    // A refresh in progress would be for the key we're releasing.
+    dp->CancelRefresh();
+
     // Release the instantiated OpenSSL key (unsafe to store in this form.)
     //
     if (nullptr != dp->m_pKey) EVP_PKEY_free(dp->m_pKey);
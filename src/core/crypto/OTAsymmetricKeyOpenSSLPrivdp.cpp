@@ -52,6 +52,9 @@
 
 #include <opentxs/core/util/stacktrace.h>
 
+#include <chrono>
+#include <string>
+
 // BIO_get_mem_data() macro from OpenSSL uses old style cast
 #ifndef _WIN32
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -151,7 +154,13 @@ const EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::GetKey(
         return nullptr;
     }
 
-    if (backlink->m_timer.getElapsedTimeInSec() > OT_KEY_TIMER)
+    if ((nullptr != m_pKey) && backlink->IsPrivate() &&
+        (OTAsymmetricKey::REFRESH == OTAsymmetricKey::GetKeyResidency())) {
+        RefreshKey(pPWData);
+        return m_pKey;
+    }
+
+    if (backlink->IsKeyTimerExpired())
         backlink->ReleaseKeyLowLevel(); // This releases the actual loaded key,
                                         // but not the ascii-armored, encrypted
                                         // version of it.
@@ -552,13 +561,10 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
     return nullptr;
 }
 
+// static
 EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
-    InstantiatePrivateKey(const OTPasswordData* pPWData)
+    ReadPrivateKey(const OTASCIIArmor& ascKey, const OTPasswordData* pPWData)
 {
-    OT_ASSERT(m_pKey == nullptr);
-    OT_ASSERT(backlink->m_p_ascKey != nullptr);
-    OT_ASSERT(backlink->IsPrivate());
-
     EVP_PKEY* pReturnKey = nullptr;
     OTData theData; // after base64-decoding the ascii-armored string, the
                     // (encrypted) binary will be stored here.
@@ -566,9 +572,9 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
     // This line base64 decodes the ascii-armored string into binary object
     // theData...
     //
-    backlink->m_p_ascKey->GetData(theData); // theData now contains binary data,
-                                            // the encrypted private key itself,
-                                            // no longer in text-armoring.
+    ascKey.GetData(theData); // theData now contains binary data, the
+                             // encrypted private key itself, no longer in
+                             // text-armoring.
     //
     // Note, for future optimization: the ASCII-ARMORING could be used for
     // serialization, but the BIO (still encrypted)
@@ -602,33 +608,45 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
         pReturnKey = PEM_read_bio_PrivateKey(
             keyBio, nullptr, OTAsymmetricKey::GetPasswordCallback(),
             const_cast<OTPasswordData*>(pPWData));
+    }
 
-        // Free the BIO and related buffers, filters, etc.
-        backlink->ReleaseKeyLowLevel();
+    return pReturnKey;
+}
 
-        if (nullptr != pReturnKey) {
-            m_pKey = pReturnKey;
-            // TODO (remove theTimer entirely. OTCachedKey replaces already.)
-            // I set this timer because the above required a password. But now
-            // that master key is working,
-            // the above would flow through even WITHOUT the user typing his
-            // passphrase (since master key still
-            // not timed out.) Resulting in THIS timer being reset!  Todo: I
-            // already shortened this timer to 30
-            // seconds, but need to phase it down to 0 and then remove it
-            // entirely! Master key takes over now!
-            //
+EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
+    InstantiatePrivateKey(const OTPasswordData* pPWData)
+{
+    OT_ASSERT(m_pKey == nullptr);
+    OT_ASSERT(backlink->m_p_ascKey != nullptr);
+    OT_ASSERT(backlink->IsPrivate());
 
-            backlink->m_timer.start(); // Note: this isn't the ultimate timer
-                                       // solution. See notes in
-                                       // ReleaseKeyLowLevel.
-            otLog4
-                << __FUNCTION__
-                << ": Success reading private key from ASCII-armored data.\n\n";
-            //          otLog4 << __FUNCTION__ << ": Success reading private key
-            // from ASCII-armored data:\n\n" << m_p_ascKey->Get() << "\n\n";
-            return m_pKey;
-        }
+    EVP_PKEY* pReturnKey = ReadPrivateKey(*backlink->m_p_ascKey, pPWData);
+
+    // Free the BIO and related buffers, filters, etc.
+    backlink->ReleaseKeyLowLevel();
+
+    if (nullptr != pReturnKey) {
+        m_pKey = pReturnKey;
+        // TODO (remove theTimer entirely. OTCachedKey replaces already.)
+        // I set this timer because the above required a password. But now
+        // that master key is working,
+        // the above would flow through even WITHOUT the user typing his
+        // passphrase (since master key still
+        // not timed out.) Resulting in THIS timer being reset!  Todo: I
+        // already shortened this timer to 30
+        // seconds, but need to phase it down to 0 and then remove it
+        // entirely! Master key takes over now!
+        //
+
+        backlink->m_timer.start(); // Note: this isn't the ultimate timer
+                                   // solution. See notes in
+                                   // ReleaseKeyLowLevel.
+        OTAsymmetricKey::CountKeyInstantiation();
+        otLog4 << __FUNCTION__
+               << ": Success reading private key from ASCII-armored data.\n\n";
+        //          otLog4 << __FUNCTION__ << ": Success reading private key
+        // from ASCII-armored data:\n\n" << m_p_ascKey->Get() << "\n\n";
+        return m_pKey;
     }
     otErr << __FUNCTION__
           << ": Failed reading private key from ASCII-armored data.\n\n";
@@ -637,6 +655,55 @@ EVP_PKEY* OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::
     return nullptr;
 }
 
+void OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::RefreshKey(
+    const OTPasswordData* pPWData)
+{
+    if (m_refresh.valid()) {
+        if (std::future_status::ready !=
+            m_refresh.wait_for(std::chrono::seconds(0)))
+            return; // Still decrypting. Keep signing with the old one.
+
+        EVP_PKEY* pNewKey = m_refresh.get();
+
+        if (nullptr == pNewKey) {
+            otErr << __FUNCTION__ << ": Background refresh of private key "
+                                     "failed. Will retry.\n";
+            return;
+        }
+
+        EVP_PKEY_free(m_pKey);
+        m_pKey = pNewKey;
+        backlink->m_timer.start();
+        OTAsymmetricKey::CountKeyInstantiation(true);
+
+        return;
+    }
+
+    if (backlink->m_timer.getElapsedTimeInSec() <= OT_KEY_TIMER) return;
+
+    // The background thread gets its own copies: neither the armor nor
+    // pPWData is guaranteed to outlive this call.
+    const OTASCIIArmor ascKey(*backlink->m_p_ascKey);
+    const std::string strDisplay(
+        nullptr == pPWData ? "OTAsymmetricKey_OpenSSL is refreshing a private "
+                             "key in the background..."
+                           : pPWData->GetDisplayString());
+
+    m_refresh = std::async(std::launch::async, [ascKey, strDisplay]() {
+        const OTPasswordData thePWData(strDisplay);
+        return ReadPrivateKey(ascKey, &thePWData);
+    });
+}
+
+void OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::CancelRefresh()
+{
+    if (!m_refresh.valid()) return;
+
+    EVP_PKEY* pNewKey = m_refresh.get(); // Waits for it to finish.
+
+    if (nullptr != pNewKey) EVP_PKEY_free(pNewKey);
+}
+
 bool OTAsymmetricKey_OpenSSL::OTAsymmetricKey_OpenSSLPrivdp::ArmorPrivateKey(
     EVP_PKEY& theKey, OTASCIIArmor& ascKey, Timer& theTimer,
     const OTPasswordData* pPWData, const OTPassword* pImportPassword)
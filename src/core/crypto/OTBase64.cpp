@@ -0,0 +1,672 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTBase64.hpp>
+#include <opentxs/core/OTData.hpp>
+
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OT_BASE64_X86
+#include <immintrin.h>
+#endif
+
+// The SIMD kernels follow Wojciech Muła and Daniel Lemire, "Faster Base64
+// Encoding and Decoding using AVX2 Instructions" (ACM TOW, 2018.)
+
+namespace opentxs
+{
+
+namespace
+{
+
+const char s_encodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+const uint8_t OT_B64_WHITESPACE = 0xfe;
+const uint8_t OT_B64_PADDING = 0xfd;
+
+// 0..63 for the alphabet, otherwise one of the markers above, or 0xff for
+// anything invalid.
+const uint8_t s_decodeTable[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xfe, 0xfe,
+    0xfe, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff,
+    0xff, 0xfd, 0xff, 0xff, 0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
+    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30,
+    0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff
+};
+
+// Each kernel handles as much of the input as it can in whole blocks, and
+// returns how much it consumed. The caller finishes the rest with the scalar
+// code.
+//
+// An encode kernel encodes at most lCount bytes, in multiples of 3, and may
+// read (but not encode) up to lReadable bytes past pInput.
+typedef size_t (*EncodeKernel)(const uint8_t* pInput, size_t lCount,
+                               size_t lReadable, char* pOutput);
+
+// A decode kernel consumes characters in multiples of 4, stopping at the
+// first block containing anything but the base64 alphabet (whitespace,
+// padding, garbage) or when less than a full store fits in lCapacity.
+typedef size_t (*DecodeKernel)(const char* pInput, size_t lInputSize,
+                               uint8_t* pOutput, size_t lCapacity);
+
+struct Base64Implementation
+{
+    const char* name;
+    EncodeKernel encode;
+    DecodeKernel decode;
+};
+
+size_t encode_scalar(const uint8_t* pInput, size_t lCount, size_t,
+                     char* pOutput)
+{
+    size_t lDone = 0;
+
+    for (; lDone + 3 <= lCount; lDone += 3) {
+        const uint32_t a = pInput[lDone];
+        const uint32_t b = pInput[lDone + 1];
+        const uint32_t c = pInput[lDone + 2];
+        const uint32_t triple = (a << 16) | (b << 8) | c;
+
+        *pOutput++ = s_encodeTable[(triple >> 18) & 0x3f];
+        *pOutput++ = s_encodeTable[(triple >> 12) & 0x3f];
+        *pOutput++ = s_encodeTable[(triple >> 6) & 0x3f];
+        *pOutput++ = s_encodeTable[triple & 0x3f];
+    }
+
+    return lDone;
+}
+
+size_t decode_scalar(const char* pInput, size_t lInputSize, uint8_t* pOutput,
+                     size_t lCapacity)
+{
+    size_t lDone = 0;
+    size_t lWritten = 0;
+
+    for (; (lDone + 4 <= lInputSize) && (lWritten + 3 <= lCapacity);
+         lDone += 4, lWritten += 3) {
+        const uint32_t a = s_decodeTable[static_cast<uint8_t>(pInput[lDone])];
+        const uint32_t b =
+            s_decodeTable[static_cast<uint8_t>(pInput[lDone + 1])];
+        const uint32_t c =
+            s_decodeTable[static_cast<uint8_t>(pInput[lDone + 2])];
+        const uint32_t d =
+            s_decodeTable[static_cast<uint8_t>(pInput[lDone + 3])];
+
+        if ((a | b | c | d) > 63) break;
+
+        const uint32_t quad = (a << 18) | (b << 12) | (c << 6) | d;
+
+        pOutput[lWritten] = static_cast<uint8_t>(quad >> 16);
+        pOutput[lWritten + 1] = static_cast<uint8_t>(quad >> 8);
+        pOutput[lWritten + 2] = static_cast<uint8_t>(quad);
+    }
+
+    return lDone;
+}
+
+#if defined(OT_BASE64_X86)
+
+// 12 input bytes -> 16 characters
+__attribute__((target("ssse3"))) size_t encode_ssse3(const uint8_t* pInput,
+                                                     size_t lCount,
+                                                     size_t lReadable,
+                                                     char* pOutput)
+{
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7,
+                                          10, 9, 11, 10);
+    const __m128i shiftLUT =
+        _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t lDone = 0;
+
+    // Each load reads 16 bytes, of which 12 are encoded.
+    while ((lDone + 12 <= lCount) && (lDone + 16 <= lReadable)) {
+        __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pInput + lDone));
+        in = _mm_shuffle_epi8(in, shuffle);
+
+        // Spread each 3 bytes into 4 bytes of 6 bits each.
+        const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t1, t3);
+
+        // Map 0..63 to the alphabet.
+        __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        result =
+            _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+        result = _mm_add_epi8(_mm_shuffle_epi8(shiftLUT, result), indices);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput + lDone / 3 * 4),
+                         result);
+        lDone += 12;
+    }
+
+    return lDone;
+}
+
+// 16 characters -> 12 output bytes (stored as 16)
+__attribute__((target("ssse3"))) size_t decode_ssse3(const char* pInput,
+                                                     size_t lInputSize,
+                                                     uint8_t* pOutput,
+                                                     size_t lCapacity)
+{
+    const __m128i shiftLUT =
+        _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    // For each low nibble, the set of high nibbles that make a valid char.
+    const __m128i maskLUT = _mm_setr_epi8(
+        static_cast<char>(0xa8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m128i bitposLUT =
+        _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+                      static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                       -1, -1, -1, -1);
+    size_t lDone = 0;
+    size_t lWritten = 0;
+
+    while ((lDone + 16 <= lInputSize) && (lWritten + 16 <= lCapacity)) {
+        const __m128i in =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInput + lDone));
+        const __m128i hi =
+            _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+        const __m128i lo = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+
+        const __m128i valid = _mm_and_si128(_mm_shuffle_epi8(maskLUT, lo),
+                                            _mm_shuffle_epi8(bitposLUT, hi));
+        if (0 != _mm_movemask_epi8(
+                     _mm_cmpeq_epi8(valid, _mm_setzero_si128())))
+            break;
+
+        // '/' is the only character whose shift its high nibble can't
+        // determine.
+        const __m128i isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+        const __m128i shift = _mm_or_si128(
+            _mm_andnot_si128(isSlash, _mm_shuffle_epi8(shiftLUT, hi)),
+            _mm_and_si128(isSlash, _mm_set1_epi8(16)));
+        const __m128i values = _mm_add_epi8(in, shift);
+
+        // Pack 4 x 6 bits into 3 bytes.
+        const __m128i merged =
+            _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i packed =
+            _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput + lWritten),
+                         _mm_shuffle_epi8(packed, pack));
+        lDone += 16;
+        lWritten += 12;
+    }
+
+    return lDone;
+}
+
+// 24 input bytes -> 32 characters
+__attribute__((target("avx2"))) size_t encode_avx2(const uint8_t* pInput,
+                                                   size_t lCount,
+                                                   size_t lReadable,
+                                                   char* pOutput)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5,
+        4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shiftLUT = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t lDone = 0;
+
+    // Each lane loads 16 bytes, of which 12 are encoded.
+    while ((lDone + 24 <= lCount) && (lDone + 28 <= lReadable)) {
+        const __m128i lo =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInput + lDone));
+        const __m128i hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pInput + lDone + 12));
+        __m256i in =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 =
+            _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 =
+            _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(
+            result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result =
+            _mm256_add_epi8(_mm256_shuffle_epi8(shiftLUT, result), indices);
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(pOutput + lDone / 3 * 4), result);
+        lDone += 24;
+    }
+
+    return lDone;
+}
+
+// 32 characters -> 24 output bytes (stored as 32)
+__attribute__((target("avx2"))) size_t decode_avx2(const char* pInput,
+                                                   size_t lInputSize,
+                                                   uint8_t* pOutput,
+                                                   size_t lCapacity)
+{
+    const __m256i shiftLUT = _mm256_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 4,
+        -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i maskLUT = _mm256_setr_epi8(
+        static_cast<char>(0xa8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54,
+        static_cast<char>(0xa8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m256i bitposLUT = _mm256_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0,
+        0, 0, 0, 0, 0, 0, 0, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+        static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5,
+        4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    size_t lDone = 0;
+    size_t lWritten = 0;
+
+    while ((lDone + 32 <= lInputSize) && (lWritten + 32 <= lCapacity)) {
+        const __m256i in = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(pInput + lDone));
+        const __m256i hi =
+            _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+        const __m256i lo = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+
+        const __m256i valid =
+            _mm256_and_si256(_mm256_shuffle_epi8(maskLUT, lo),
+                             _mm256_shuffle_epi8(bitposLUT, hi));
+        if (0 != _mm256_movemask_epi8(
+                     _mm256_cmpeq_epi8(valid, _mm256_setzero_si256())))
+            break;
+
+        const __m256i isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2f));
+        const __m256i shift = _mm256_or_si256(
+            _mm256_andnot_si256(isSlash, _mm256_shuffle_epi8(shiftLUT, hi)),
+            _mm256_and_si256(isSlash, _mm256_set1_epi8(16)));
+        const __m256i values = _mm256_add_epi8(in, shift);
+
+        const __m256i merged =
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i packed =
+            _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(pOutput + lWritten),
+            _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(packed, pack),
+                                        compact));
+        lDone += 32;
+        lWritten += 24;
+    }
+
+    return lDone;
+}
+
+#endif // OT_BASE64_X86
+
+const Base64Implementation s_scalar = {"scalar", encode_scalar, decode_scalar};
+#if defined(OT_BASE64_X86)
+const Base64Implementation s_ssse3 = {"ssse3", encode_ssse3, decode_ssse3};
+const Base64Implementation s_avx2 = {"avx2", encode_avx2, decode_avx2};
+#endif
+
+const Base64Implementation* best_implementation()
+{
+#if defined(OT_BASE64_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) return &s_avx2;
+    if (__builtin_cpu_supports("ssse3")) return &s_ssse3;
+#endif
+
+    return &s_scalar;
+}
+
+const Base64Implementation*& active_implementation()
+{
+    static const Base64Implementation* pImplementation = best_implementation();
+
+    return pImplementation;
+}
+
+// Encodes lCount bytes, with padding, and returns the number of characters.
+size_t encode_run(const uint8_t* pInput, size_t lCount, size_t lReadable,
+                  char* pOutput)
+{
+    size_t lDone =
+        active_implementation()->encode(pInput, lCount, lReadable, pOutput);
+    lDone += encode_scalar(pInput + lDone, lCount - lDone, lReadable - lDone,
+                           pOutput + lDone / 3 * 4);
+
+    char* pOut = pOutput + lDone / 3 * 4;
+
+    switch (lCount - lDone) {
+    case 1: {
+        const uint32_t a = pInput[lDone];
+        *pOut++ = s_encodeTable[a >> 2];
+        *pOut++ = s_encodeTable[(a & 0x03) << 4];
+        *pOut++ = '=';
+        *pOut++ = '=';
+    } break;
+    case 2: {
+        const uint32_t a = pInput[lDone];
+        const uint32_t b = pInput[lDone + 1];
+        *pOut++ = s_encodeTable[a >> 2];
+        *pOut++ = s_encodeTable[((a & 0x03) << 4) | (b >> 4)];
+        *pOut++ = s_encodeTable[(b & 0x0f) << 2];
+        *pOut++ = '=';
+    } break;
+    default:
+        break;
+    }
+
+    return static_cast<size_t>(pOut - pOutput);
+}
+
+// The decoded size of input laid out exactly the way Encode writes it.
+// Returns false if that can't be the case.
+bool canonical_decoded_size(const char* pInput, size_t lInputSize,
+                            bool bLineBreaks, size_t& lDecodedSize)
+{
+    size_t lEnd = lInputSize;
+
+    while ((lEnd > 0) &&
+           (OT_B64_WHITESPACE ==
+            s_decodeTable[static_cast<uint8_t>(pInput[lEnd - 1])]))
+        --lEnd;
+
+    const size_t lNewlines = bLineBreaks ? (lEnd / 65) : 0;
+
+    for (int32_t i = 0; (i < 2) && (lEnd > 0) && ('=' == pInput[lEnd - 1]);
+         ++i)
+        --lEnd;
+
+    if (lEnd < lNewlines) return false;
+
+    const size_t lChars = lEnd - lNewlines;
+
+    if (1 == lChars % 4) return false;
+
+    lDecodedSize = (lChars / 4) * 3 + ((lChars % 4) ? ((lChars % 4) - 1) : 0);
+
+    return true;
+}
+
+// The decoded size of input with any amount of whitespace anywhere.
+bool exact_decoded_size(const char* pInput, size_t lInputSize,
+                        size_t& lDecodedSize)
+{
+    size_t lChars = 0;
+
+    for (size_t i = 0; i < lInputSize; ++i) {
+        const uint8_t value = s_decodeTable[static_cast<uint8_t>(pInput[i])];
+
+        if (value < 64)
+            ++lChars;
+        else if (OT_B64_PADDING == value)
+            break;
+    }
+
+    if (1 == lChars % 4) return false;
+
+    lDecodedSize = (lChars / 4) * 3 + ((lChars % 4) ? ((lChars % 4) - 1) : 0);
+
+    return true;
+}
+
+} // namespace
+
+// static
+size_t OTBase64::EncodedSize(size_t lInputSize, bool bLineBreaks)
+{
+    const size_t lChars = ((lInputSize + 2) / 3) * 4;
+
+    return bLineBreaks ? (lChars + (lChars + 63) / 64) : lChars;
+}
+
+// static
+size_t OTBase64::DecodedSizeMax(size_t lInputSize)
+{
+    return ((lInputSize + 3) / 4) * 3;
+}
+
+// static
+size_t OTBase64::Encode(const uint8_t* pInput, size_t lInputSize,
+                        char* pOutput, bool bLineBreaks)
+{
+    if (!bLineBreaks)
+        return encode_run(pInput, lInputSize, lInputSize, pOutput);
+
+    // 48 bytes make one line of 64 characters.
+    char* pOut = pOutput;
+
+    for (size_t lPos = 0; lPos < lInputSize; lPos += 48) {
+        const size_t lLine =
+            (lInputSize - lPos < 48) ? (lInputSize - lPos) : 48;
+
+        pOut += encode_run(pInput + lPos, lLine, lInputSize - lPos, pOut);
+        *pOut++ = '\n';
+    }
+
+    return static_cast<size_t>(pOut - pOutput);
+}
+
+// static
+bool OTBase64::Decode(const char* pInput, size_t lInputSize, uint8_t* pOutput,
+                      size_t lCapacity, size_t& lOutputSize)
+{
+    const DecodeKernel kernel = active_implementation()->decode;
+    uint32_t quad = 0;
+    int32_t nFill = 0;
+    size_t lPos = 0;
+    size_t lWritten = 0;
+
+    lOutputSize = 0;
+
+    while (lPos < lInputSize) {
+        // At a quad boundary, let the kernel take whole blocks.
+        if (0 == nFill) {
+            const size_t lDone = kernel(pInput + lPos, lInputSize - lPos,
+                                        pOutput + lWritten,
+                                        lCapacity - lWritten);
+            lPos += lDone;
+            lWritten += lDone / 4 * 3;
+
+            if (lPos >= lInputSize) break;
+        }
+
+        const uint8_t value =
+            s_decodeTable[static_cast<uint8_t>(pInput[lPos++])];
+
+        if (value < 64) {
+            quad = (quad << 6) | value;
+
+            if (4 == ++nFill) {
+                if (lWritten + 3 > lCapacity) return false;
+
+                pOutput[lWritten++] = static_cast<uint8_t>(quad >> 16);
+                pOutput[lWritten++] = static_cast<uint8_t>(quad >> 8);
+                pOutput[lWritten++] = static_cast<uint8_t>(quad);
+                quad = 0;
+                nFill = 0;
+            }
+        }
+        else if (OT_B64_WHITESPACE == value)
+            continue;
+        else if (OT_B64_PADDING == value)
+            break;
+        else
+            return false;
+    }
+
+    switch (nFill) {
+    case 0:
+        break;
+    case 2:
+        if (lWritten + 1 > lCapacity) return false;
+        pOutput[lWritten++] = static_cast<uint8_t>(quad >> 4);
+        break;
+    case 3:
+        if (lWritten + 2 > lCapacity) return false;
+        pOutput[lWritten++] = static_cast<uint8_t>(quad >> 10);
+        pOutput[lWritten++] = static_cast<uint8_t>(quad >> 2);
+        break;
+    default:
+        return false; // a single leftover character can't be decoded
+    }
+
+    lOutputSize = lWritten;
+
+    return true;
+}
+
+// static
+bool OTBase64::Decode(const char* pInput, size_t lInputSize, OTData& theOutput,
+                      bool bLineBreaks)
+{
+    theOutput.Release();
+
+    size_t lSize = 0;
+    size_t lWritten = 0;
+
+    // The input is almost always our own output, in which case its decoded
+    // size is known without looking at it, and we decode in a single pass.
+    // Otherwise count first, then decode.
+    for (int32_t nPass = 0; nPass < 2; ++nPass) {
+        const bool bSized =
+            (0 == nPass)
+                ? canonical_decoded_size(pInput, lInputSize, bLineBreaks, lSize)
+                : exact_decoded_size(pInput, lInputSize, lSize);
+
+        if (!bSized) continue;
+        // Nothing but whitespace and padding (or garbage.)
+        if (0 == lSize) return Decode(pInput, lInputSize, nullptr, 0, lWritten);
+        if (lSize > std::numeric_limits<uint32_t>::max()) return false;
+
+        theOutput.SetSize(static_cast<uint32_t>(lSize));
+
+        if (Decode(pInput, lInputSize,
+                   static_cast<uint8_t*>(
+                       const_cast<void*>(theOutput.GetPointer())),
+                   lSize, lWritten) &&
+            (lWritten == lSize))
+            return true;
+
+        theOutput.Release();
+    }
+
+    return false;
+}
+
+// static
+const char* OTBase64::Implementation()
+{
+    return active_implementation()->name;
+}
+
+// static
+bool OTBase64::SetImplementation(const char* szName)
+{
+    if (nullptr == szName) return false;
+
+    const Base64Implementation* pChoice = nullptr;
+
+    if (0 == strcmp(szName, s_scalar.name)) pChoice = &s_scalar;
+#if defined(OT_BASE64_X86)
+    __builtin_cpu_init();
+
+    if ((0 == strcmp(szName, s_ssse3.name)) && __builtin_cpu_supports("ssse3"))
+        pChoice = &s_ssse3;
+    if ((0 == strcmp(szName, s_avx2.name)) && __builtin_cpu_supports("avx2"))
+        pChoice = &s_avx2;
+#endif
+
+    if (nullptr == pChoice) return false;
+
+    active_implementation() = pChoice;
+
+    return true;
+}
+
+} // namespace opentxs
@@ -419,6 +419,7 @@ void OTCachedKey::SetCachedKey(const OTASCIIArmor& ascCachedKey)
 
     m_pSymmetricKey = new OTSymmetricKey;
     OT_ASSERT(nullptr != m_pSymmetricKey);
+    m_pSymmetricKey->SetCacheDerivedKey(false);
 
     // const bool bSerialized =
     m_pSymmetricKey->SerializeFrom(ascCachedKey);
@@ -623,6 +624,7 @@ bool OTCachedKey::GetMasterPassword(std::shared_ptr<OTCachedKey>& mySharedPtr,
     if (nullptr == m_pSymmetricKey) {
         m_pSymmetricKey = new OTSymmetricKey;
         OT_ASSERT(nullptr != m_pSymmetricKey);
+        m_pSymmetricKey->SetCacheDerivedKey(false);
     }
 
     if (!m_pSymmetricKey->IsGenerated()) // doesn't already exist.
@@ -652,14 +652,12 @@ bool OTCredential::SignNewSubcredential(OTSubcredential& theSubCred,
     return true;
 }
 
-bool OTCredential::GenerateMasterkey(int32_t nBits) // CreateMaster is
-                                                    // able to create
-                                                    // keys from
-                                                    // scratch (by
-                                                    // calling this
-                                                    // function.)
+bool OTCredential::GenerateMasterkey(
+    int32_t nBits, // CreateMaster is able to create keys from scratch (by
+                   // calling this function.)
+    OTAsymmetricKey::KeyType eSigningKeyType)
 {
-    return m_Masterkey.GenerateKeys(nBits);
+    return m_Masterkey.GenerateKeys(nBits, eSigningKeyType);
 }
 
 bool OTCredential::Load_MasterFromString(const String& strInput,
@@ -935,7 +933,8 @@ bool OTCredential::AddNewSubkey(
     const String::Map* pmapPrivate, // Public keys are derived from
                                     // the private.
     const OTPasswordData* pPWData,  // The master key will sign the subkey.
-    OTSubkey** ppSubkey)            // output
+    OTSubkey** ppSubkey,            // output
+    OTAsymmetricKey::KeyType eSigningKeyType)
 {
     OTSubkey* pSub = new OTSubkey(*this);
     OT_ASSERT(nullptr != pSub);
@@ -959,7 +958,7 @@ bool OTCredential::AddNewSubkey(
             *pmapPrivate); // so let's set them onto the sub key.
     else
         // No keys were provided, so let's generate them ourselves...
-        bContentsReady = pSub->GenerateKeys(nBits);
+        bContentsReady = pSub->GenerateKeys(nBits, eSigningKeyType);
 
     if (!bContentsReady) {
         otErr << "In " << __FILE__ << ", line " << __LINE__
@@ -1097,7 +1096,7 @@ OTCredential* OTCredential::CreateMaster(
                                     // already be derived from
                                     // private. But not all
                                     // credentials are keys...
-    const OTPasswordData* pPWData)
+    const OTPasswordData* pPWData, OTAsymmetricKey::KeyType eSigningKeyType)
 {
     OTCredential* pCredential = new OTCredential;
     OT_ASSERT(nullptr != pCredential);
@@ -1139,7 +1138,8 @@ OTCredential* OTCredential::CreateMaster(
             *pmapPrivate); // So let's set them onto the master key.
     else
         // No keys were provided, so let's generate them ourselves...
-        bContentsReady = pCredential->GenerateMasterkey(nBits);
+        bContentsReady =
+            pCredential->GenerateMasterkey(nBits, eSigningKeyType);
 
     if (!bContentsReady) {
         otErr << "In " << __FILE__ << ", line " << __LINE__
@@ -48,6 +48,7 @@
 
 #include <iostream>
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
 #include <opentxs/core/util/OTPaths.hpp>
@@ -297,6 +298,38 @@ bool OTCrypto::GetPasswordFromConsole(OTPassword& theOutput, bool bRepeat) const
     return false;
 }
 
+// virtual
+listOfCryptoFutures OTCrypto::SignContracts(const listOfSignatureJobs& theJobs,
+                                            const OTPasswordData* pPWData)
+{
+    listOfCryptoFutures theFutures;
+
+    for (auto& it : theJobs) {
+        const bool bSigned =
+            SignContract(*it.m_pContents, *it.m_pKey, *it.m_pSignature,
+                         it.m_strHashType, pPWData);
+        theFutures.push_back(OTCryptoPool::Ready(bSigned));
+    }
+
+    return theFutures;
+}
+
+// virtual
+listOfCryptoFutures OTCrypto::VerifySignatures(
+    const listOfSignatureJobs& theJobs, const OTPasswordData* pPWData) const
+{
+    listOfCryptoFutures theFutures;
+
+    for (auto& it : theJobs) {
+        const bool bVerified =
+            VerifySignature(*it.m_pContents, *it.m_pKey, *it.m_pSignature,
+                            it.m_strHashType, pPWData);
+        theFutures.push_back(OTCryptoPool::Ready(bVerified));
+    }
+
+    return theFutures;
+}
+
 // static
 OTCrypto* OTCrypto::It()
 {
@@ -353,6 +386,8 @@ void OTCrypto::Cleanup() const
         // Any crypto-related cleanup code NOT specific to OpenSSL (which is
         // handled in OTCrypto_OpenSSL, a subclass) would go here.
         //
+        OTCryptoPool::Shutdown(); // Before the engine tears down its locks.
+        OTDerivedKeyCache::Shutdown();
 
         Cleanup_Override();
     }
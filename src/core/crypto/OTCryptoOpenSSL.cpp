@@ -46,19 +46,25 @@
 
 #include <opentxs/core/stdafx.hpp>
 
-#include <bitcoin-base58/hash.h> // for Hash()
 #include <opentxs/core/crypto/BitcoinCrypto.hpp>
 #include <opentxs/core/crypto/OTCryptoOpenSSL.hpp>
+#include <opentxs/core/crypto/OTBase64.hpp>
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+#include <opentxs/core/crypto/OTAsymmetricKeyEd25519.hpp>
+#endif
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/crypto/OTPassword.hpp>
 #include <opentxs/core/crypto/OTPasswordData.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
 #include <opentxs/core/OTStorage.hpp>
 #include <opentxs/core/util/stacktrace.h>
 
 #include <bitcoin-base58/base58.h>
 
+#include <map>
 #include <thread>
 
 extern "C" {
@@ -136,6 +142,38 @@ public:
                          const OTPasswordData* pPWData = nullptr) const;
 
     static const EVP_MD* GetOpenSSLDigestByName(const String& theName);
+
+    static bool SealInitParallel(EVP_CIPHER_CTX* ctx, const EVP_CIPHER* type,
+                                 uint8_t** ek, int32_t* ekl, uint8_t* iv,
+                                 EVP_PKEY** pubk, int32_t npubk);
+
+    // PBKDF2, without consulting OTDerivedKeyCache. Fills theDerivedKey and
+    // returns false if dataCheckHash was supplied and doesn't match.
+    static bool DeriveKey(const OTPassword& userPassword,
+                          const OTData& dataSalt, uint32_t uIterations,
+                          OTData& dataCheckHash, OTPassword& theDerivedKey);
+
+    // Keyed digest of (salt, iterations, passphrase) for OTDerivedKeyCache.
+    static bool GetDerivedKeyCacheKey(const OTPassword& userPassword,
+                                      const OTData& dataSalt,
+                                      uint32_t uIterations,
+                                      std::string& strKey);
+
+private:
+    // The actual verification, without consulting OTSignatureCache.
+    bool VerifySignatureNoCache(const String& strContractToVerify,
+                                const EVP_PKEY* pkey,
+                                const OTSignature& theSignature,
+                                const String& strHashType,
+                                const OTPasswordData* pPWData) const;
+
+    // Digest of (public key, hash type, contents, signature) for
+    // OTSignatureCache.
+    static bool GetSignatureCacheKey(const String& strContractToVerify,
+                                     const EVP_PKEY* pkey,
+                                     const OTSignature& theSignature,
+                                     const String& strHashType,
+                                     std::string& strKey);
 };
 
 #else // Apparently NO crypto engine is defined!
@@ -165,6 +203,117 @@ extern "C" {
 #include <openssl/opensslv.h>
 }
 
+namespace
+{
+
+// What each thread keeps between signatures, so that signing and verifying
+// don't create a digest context, a key context and scratch buffers every
+// time: one digest context, the EVP_PKEY_CTX for the key it used last, and
+// buffers for the raw RSA operations of the default hash.
+//
+// The EVP_PKEY_CTX holds a reference to its key, so while it is cached that
+// key can't be freed and its address can't be reused by another one.
+//
+class SignatureContext
+{
+public:
+    SignatureContext()
+        : m_pDigest(EVP_MD_CTX_create())
+        , m_pKeyContext(nullptr)
+        , m_pKey(nullptr)
+    {
+    }
+
+    ~SignatureContext()
+    {
+        ReleaseKey();
+
+        if (nullptr != m_pDigest) EVP_MD_CTX_destroy(m_pDigest);
+    }
+
+    // Hashes lSize bytes at pInput with md. pOutput must hold
+    // EVP_MAX_MD_SIZE bytes.
+    bool Digest(const EVP_MD* md, const void* pInput, size_t lSize,
+                uint8_t* pOutput, uint32_t* pOutputSize)
+    {
+        return (nullptr != m_pDigest) &&
+               (1 == EVP_DigestInit_ex(m_pDigest, md, nullptr)) &&
+               (1 == EVP_DigestUpdate(m_pDigest, pInput, lSize)) &&
+               (1 == EVP_DigestFinal_ex(m_pDigest, pOutput, pOutputSize));
+    }
+
+    // A key context for pkey, ready to sign (or verify) a digest made
+    // with md.
+    EVP_PKEY_CTX* KeyContext(EVP_PKEY* pkey, const EVP_MD* md, bool bSign)
+    {
+        if (pkey != m_pKey) {
+            ReleaseKey();
+            m_pKeyContext = EVP_PKEY_CTX_new(pkey, nullptr);
+            m_pKey = (nullptr != m_pKeyContext) ? pkey : nullptr;
+        }
+
+        if (nullptr == m_pKeyContext) return nullptr;
+
+        const int32_t nInit = bSign ? EVP_PKEY_sign_init(m_pKeyContext)
+                                    : EVP_PKEY_verify_init(m_pKeyContext);
+
+        if ((nInit <= 0) ||
+            (EVP_PKEY_CTX_set_signature_md(m_pKeyContext, md) <= 0)) {
+            return nullptr;
+        }
+
+        return m_pKeyContext;
+    }
+
+    // Drops the cached key context (and with it, the reference to the key.)
+    void ReleaseKey()
+    {
+        if (nullptr != m_pKeyContext) EVP_PKEY_CTX_free(m_pKeyContext);
+
+        m_pKeyContext = nullptr;
+        m_pKey = nullptr;
+    }
+
+    // Zeroed scratch space of lSize bytes. Only grows.
+    uint8_t* Scratch(std::vector<uint8_t>& vBuffer, size_t lSize)
+    {
+        if (vBuffer.size() < lSize) vBuffer.resize(lSize);
+
+        OTPassword::zeroMemory(&vBuffer.at(0),
+                               static_cast<uint32_t>(vBuffer.size()));
+
+        return &vBuffer.at(0);
+    }
+
+    std::vector<uint8_t> m_vEM;
+    std::vector<uint8_t> m_vSignature;
+
+private:
+    SignatureContext(const SignatureContext&);
+    SignatureContext& operator=(const SignatureContext&);
+
+    EVP_MD_CTX* m_pDigest;
+    EVP_PKEY_CTX* m_pKeyContext;
+    EVP_PKEY* m_pKey;
+};
+
+thread_local SignatureContext t_signatureContext;
+
+// The default hash: SHA-256, twice. pOutput must hold SHA256_DIGEST_LENGTH
+// bytes.
+bool default_hash(const String& strInput, uint8_t* pOutput)
+{
+    uint8_t vFirst[EVP_MAX_MD_SIZE];
+    uint32_t uSize = 0;
+
+    return t_signatureContext.Digest(EVP_sha256(), strInput.Get(),
+                                     strInput.GetLength(), vFirst, &uSize) &&
+           t_signatureContext.Digest(EVP_sha256(), vFirst, uSize, pOutput,
+                                     &uSize);
+}
+
+} // namespace
+
 OTCrypto_OpenSSL::OTCrypto_OpenSSL()
     : OTCrypto()
     , dp(nullptr)
@@ -397,82 +546,42 @@ void ot_openssl_locking_callback(int32_t mode, int32_t type, const char*,
 char* OTCrypto_OpenSSL::Base64Encode(const uint8_t* input, int32_t in_len,
                                      bool bLineBreaks) const
 {
-    char* buf = nullptr;
-    BUF_MEM* bptr = nullptr;
-
     OT_ASSERT_MSG(in_len >= 0,
                   "OT_base64_encode: Abort: in_len is a negative number!");
 
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (!b64) return buf;
-
-    if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-    OpenSSL_BIO bmem = BIO_new(BIO_s_mem());
-
-    if (bmem) {
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
+    const size_t lInputSize = static_cast<size_t>(in_len);
+    char* buf = new char[OTBase64::EncodedSize(lInputSize, bLineBreaks) + 1];
+    OT_ASSERT(nullptr != buf);
 
-        if (BIO_write(b64join, input, in_len) == in_len) {
-            (void)BIO_flush(b64join);
-#ifndef _WIN32
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-#endif
-            BIO_get_mem_ptr(b64join, &bptr);
-#ifndef _WIN32
-#pragma GCC diagnostic pop
-#endif
-            //    otLog5 << "DEBUG base64_encode size: %" PRId64 ",  in_len:
-            // %" PRId64 "\n", bptr->length+1, in_len);
-            buf = new char[bptr->length + 1];
-            OT_ASSERT(nullptr != buf);
-            memcpy(buf, bptr->data, bptr->length); // Safe.
-            buf[bptr->length] = '\0';              // Forcing null terminator.
-        }
-    }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_encode.\n");
-    }
+    const size_t lWritten =
+        OTBase64::Encode(input, lInputSize, buf, bLineBreaks);
+    buf[lWritten] = '\0'; // Forcing null terminator.
 
     return buf;
 }
 
 // Caller responsible to delete.
+//
+// Both layouts decode the same way, so bLineBreaks doesn't matter here.
+// Returns nullptr (and sets *out_len to 0) if the input isn't valid base64.
 uint8_t* OTCrypto_OpenSSL::Base64Decode(const char* input, size_t* out_len,
-                                        bool bLineBreaks) const
+                                        bool) const
 {
-
     OT_ASSERT(nullptr != input);
+    OT_ASSERT(nullptr != out_len);
 
-    int32_t in_len =
-        static_cast<int32_t>(strlen(input)); // todo security (strlen)
-    int32_t out_max_len = (in_len * 6 + 7) / 8;
-    uint8_t* buf = new uint8_t[out_max_len];
-    OT_ASSERT(nullptr != buf);
-    memset(buf, 0, out_max_len); // todo security
-
-    OpenSSL_BIO b64 = BIO_new(BIO_f_base64());
-
-    if (b64) {
-        if (!bLineBreaks) BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    *out_len = 0;
 
-        OpenSSL_BIO bmem = BIO_new_mem_buf(const_cast<char*>(input), in_len);
-        OT_ASSERT(nullptr != bmem);
-
-        OpenSSL_BIO b64join = BIO_push(b64, bmem);
-        b64.release();
-        bmem.release();
-        OT_ASSERT(nullptr != b64join);
-
-        *out_len = BIO_read(b64join, buf, out_max_len);
+    const size_t in_len = strlen(input); // todo security (strlen)
+    const size_t out_max_len = OTBase64::DecodedSizeMax(in_len);
+    uint8_t* buf = new uint8_t[out_max_len + 1];
+    OT_ASSERT(nullptr != buf);
 
-    }
-    else {
-        OT_FAIL_MSG("Failed creating new Bio in base64_decode.\n");
+    if (!OTBase64::Decode(input, in_len, buf, out_max_len, *out_len)) {
+        otErr << __FUNCTION__ << ": Invalid base64 input.\n";
+        delete[] buf;
+        *out_len = 0;
+        return nullptr;
     }
 
     return buf;
@@ -550,18 +659,59 @@ bool OTCrypto_OpenSSL::RandomizeMemory(uint8_t* szDestination,
 OTPassword* OTCrypto_OpenSSL::DeriveNewKey(const OTPassword& userPassword,
                                            const OTData& dataSalt,
                                            uint32_t uIterations,
-                                           OTData& dataCheckHash) const
+                                           OTData& dataCheckHash,
+                                           bool bUseCache) const
 {
     //  OT_ASSERT(userPassword.isPassword());
     OT_ASSERT(!dataSalt.IsEmpty());
 
+    std::string strCacheKey;
+    const bool bCacheable =
+        bUseCache && (0 != OTDerivedKeyCache::GetTimeoutSeconds()) &&
+        OTCrypto_OpenSSLdp::GetDerivedKeyCacheKey(userPassword, dataSalt,
+                                                  uIterations, strCacheKey);
+
+    if (bCacheable) {
+        std::unique_ptr<OTPassword> pCachedKey(new OTPassword);
+        OTData tmpHashCheck;
+
+        if (OTDerivedKeyCache::Lookup(strCacheKey, *pCachedKey,
+                                      tmpHashCheck)) {
+            // Same outcome as deriving it again: the same key and hash check,
+            // and failure if the caller's hash check is a different one.
+            const bool bMatches =
+                dataCheckHash.IsEmpty() || (dataCheckHash == tmpHashCheck);
+            dataCheckHash = tmpHashCheck;
+
+            return bMatches ? pCachedKey.release() : nullptr;
+        }
+    }
+
     otInfo << __FUNCTION__
            << ": Using a text passphrase, salt, and iteration count, "
               "to make a derived key...\n";
 
-    OTPassword* pDerivedKey(InstantiateBinarySecret()); // already asserts.
+    std::unique_ptr<OTPassword> pDerivedKey(
+        InstantiateBinarySecret()); // already asserts.
 
-    //  pDerivedKey MUST be returned or cleaned-up, below this point.
+    if (!OTCrypto_OpenSSLdp::DeriveKey(userPassword, dataSalt, uIterations,
+                                       dataCheckHash, *pDerivedKey)) {
+        return nullptr; // failure (but we will return the dataCheckHash we
+                        // got anyway)
+    }
+
+    if (bCacheable) {
+        OTDerivedKeyCache::Insert(strCacheKey, *pDerivedKey, dataCheckHash);
+    }
+
+    return pDerivedKey.release();
+}
+
+// static
+bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::DeriveKey(
+    const OTPassword& userPassword, const OTData& dataSalt,
+    uint32_t uIterations, OTData& dataCheckHash, OTPassword& theDerivedKey)
+{
     //
     // Key derivation in OpenSSL.
     //
@@ -581,9 +731,9 @@ OTPassword* OTCrypto_OpenSSL::DeriveNewKey(const OTPassword& userPassword,
         static_cast<const int32_t>(dataSalt.GetSize()),     // Salt Length
         static_cast<const int32_t>(uIterations), // Number Of Iterations
         static_cast<const int32_t>(
-            pDerivedKey->getMemorySize()), // Output Length
+            theDerivedKey.getMemorySize()), // Output Length
         static_cast<uint8_t*>(
-            pDerivedKey->getMemoryWritable()) // Output Key (not const!)
+            theDerivedKey.getMemoryWritable()) // Output Key (not const!)
         );
 
     // For The HashCheck
@@ -597,9 +747,9 @@ OTPassword* OTCrypto_OpenSSL::DeriveNewKey(const OTPassword& userPassword,
     // If there isn't one, we return the
 
     PKCS5_PBKDF2_HMAC_SHA1(
-        reinterpret_cast<const char*>(pDerivedKey->getMemory()), // Derived Key
+        reinterpret_cast<const char*>(theDerivedKey.getMemory()), // Derived Key
         static_cast<const int32_t>(
-            pDerivedKey->getMemorySize()),                  // Password Length
+            theDerivedKey.getMemorySize()),                  // Password Length
         static_cast<const uint8_t*>(dataSalt.GetPointer()), // Salt Data
         static_cast<const int32_t>(dataSalt.GetSize()),     // Salt Length
         static_cast<const int32_t>(uIterations), // Number Of Iterations
@@ -618,9 +768,7 @@ OTPassword* OTCrypto_OpenSSL::DeriveNewKey(const OTPassword& userPassword,
         if (!strDataCheck.Compare(strTestCheck)) {
             dataCheckHash.reset();
             dataCheckHash = tmpHashCheck;
-            return nullptr; // failure (but we will return the dataCheckHash we
-                            // got
-                            // anyway)
+            return false;
         }
     }
     else {
@@ -628,7 +776,50 @@ OTPassword* OTCrypto_OpenSSL::DeriveNewKey(const OTPassword& userPassword,
         dataCheckHash = tmpHashCheck;
     }
 
-    return pDerivedKey;
+    return true;
+}
+
+// static
+bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::GetDerivedKeyCacheKey(
+    const OTPassword& userPassword, const OTData& dataSalt,
+    uint32_t uIterations, std::string& strKey)
+{
+    // Random per process, so that a cache key is not a plain hash of the
+    // passphrase.
+    static const std::vector<uint8_t> vSecret = []() {
+        std::vector<uint8_t> vOutput(SHA256_DIGEST_LENGTH);
+        const int32_t nSize = static_cast<int32_t>(vOutput.size());
+        if (1 != RAND_bytes(&vOutput.at(0), nSize)) vOutput.clear();
+        return vOutput;
+    }();
+
+    if (vSecret.empty()) return false;
+
+    const bool bIsPassword = userPassword.isPassword();
+    const uint8_t* pPassword = bIsPassword ? userPassword.getPassword_uint8()
+                                           : userPassword.getMemory_uint8();
+    const uint32_t uPasswordSize = bIsPassword ? userPassword.getPasswordSize()
+                                               : userPassword.getMemorySize();
+
+    // As with the signature cache, every variable length field is prefixed
+    // with its size.
+    const uint32_t sizes[] = {static_cast<uint32_t>(vSecret.size()),
+                              uIterations, dataSalt.GetSize(), uPasswordSize};
+
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, sizes, sizeof(sizes));
+    SHA256_Update(&ctx, &vSecret.at(0), vSecret.size());
+    SHA256_Update(&ctx, dataSalt.GetPointer(), dataSalt.GetSize());
+    SHA256_Update(&ctx, pPassword, uPasswordSize);
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &ctx);
+    OPENSSL_cleanse(&ctx, sizeof(ctx));
+
+    strKey.assign(reinterpret_cast<const char*>(digest), sizeof(digest));
+
+    return true;
 }
 
 /*
@@ -788,6 +979,11 @@ bool OTCrypto_OpenSSL::GetPasswordFromConsoleLowLevel(
 
 void OTCrypto_OpenSSL::thread_setup() const
 {
+#if OPENSSL_VERSION_NUMBER - 0 >= 0x10100000L
+    // Since 1.1.0, OpenSSL does its own locking and ignores these callbacks
+    // (they are no-op macros.) Don't allocate locks nobody will take.
+    return;
+#else
     OTCrypto_OpenSSL::s_arrayMutex = new std::mutex[CRYPTO_num_locks()];
 
 // NOTE: OpenSSL supposedly has some default implementation for the thread_id,
@@ -812,13 +1008,16 @@ void OTCrypto_OpenSSL::thread_setup() const
     // of OpenSSL. (Unlike thread_id function above.)
     //
     CRYPTO_set_locking_callback(ot_openssl_locking_callback);
+#endif
 }
 
 // done
 
 void OTCrypto_OpenSSL::thread_cleanup() const
 {
+#if OPENSSL_VERSION_NUMBER - 0 < 0x10100000L
     CRYPTO_set_locking_callback(nullptr);
+#endif
 
     if (nullptr != OTCrypto_OpenSSL::s_arrayMutex) {
         delete[] OTCrypto_OpenSSL::s_arrayMutex;
@@ -1468,6 +1667,49 @@ bool OTCrypto_OpenSSL::Decrypt(
 
 // Seal up as envelope (Asymmetric, using public key and then AES key.)
 
+// Does what EVP_SealInit does: generate a session key and IV, set ctx up to
+// encrypt with them, and wrap the session key to each of the npubk public
+// keys. Except that the wrapping, which is the expensive part, is done for
+// all the recipients in parallel on OTCryptoPool instead of one by one.
+// Open can't tell the difference.
+//
+// static
+bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SealInitParallel(
+    EVP_CIPHER_CTX* ctx, const EVP_CIPHER* type, uint8_t** ek, int32_t* ekl,
+    uint8_t* iv, EVP_PKEY** pubk, int32_t npubk)
+{
+    uint8_t key[EVP_MAX_KEY_LENGTH];
+
+    if (!EVP_EncryptInit_ex(ctx, type, nullptr, nullptr, nullptr)) return false;
+
+    if (EVP_CIPHER_CTX_rand_key(ctx, key) <= 0) return false;
+
+    const int32_t nIVLength = EVP_CIPHER_CTX_iv_length(ctx);
+    const int32_t nKeyLength = EVP_CIPHER_CTX_key_length(ctx);
+    bool bWrapped = ((0 == nIVLength) || (RAND_bytes(iv, nIVLength) > 0)) &&
+                    EVP_EncryptInit_ex(ctx, nullptr, nullptr, key, iv);
+
+    if (bWrapped) {
+        const uint8_t* pKey = key; // Outlives the jobs: we wait for them.
+        listOfCryptoFutures theFutures;
+
+        for (int32_t i = 0; i < npubk; ++i) {
+            theFutures.push_back(
+                OTCryptoPool::Submit([i, ek, ekl, pubk, pKey, nKeyLength]() {
+                    ekl[i] = EVP_PKEY_encrypt_old(ek[i], pKey, nKeyLength,
+                                                  pubk[i]);
+                    return ekl[i] > 0;
+                }));
+        }
+
+        bWrapped = OTCryptoPool::WaitAll(theFutures);
+    }
+
+    OPENSSL_cleanse(key, sizeof(key));
+
+    return bWrapped;
+}
+
 bool OTCrypto_OpenSSL::Seal(mapOfAsymmetricKeys& RecipPubKeys,
                             const String& theInput, OTData& dataOutput) const
 {
@@ -1763,19 +2005,19 @@ bool OTCrypto_OpenSSL::Seal(mapOfAsymmetricKeys& RecipPubKeys,
     //    int32_t           *  eklen        = nullptr;  // This will just be an
     // array of integers.
 
-    if (!EVP_SealInit(
-            &ctx, cipher_type, ek,
-            eklen, // array of buffers for output of encrypted copies of the
-                   // symmetric "session key". (Plus array of ints, to receive
-                   // the size of each key.)
-            iv,    // A buffer where the generated IV is written. Must contain
-                   // room for the corresponding cipher's IV, as determined by
-                   // (for example) EVP_CIPHER_iv_length(type).
-            array_pubkey,
-            static_cast<int32_t>(RecipPubKeys.size()))) // array of public keys
-                                                        // we are addressing
-                                                        // this envelope to.
-    {
+    // With several recipients, the session key is wrapped for all of them
+    // at once on OTCryptoPool. The result is the same as EVP_SealInit's.
+    //
+    if (RecipPubKeys.size() > 1) {
+        if (!OTCrypto_OpenSSLdp::SealInitParallel(
+                &ctx, cipher_type, ek, eklen, iv, array_pubkey,
+                static_cast<int32_t>(RecipPubKeys.size()))) {
+            otErr << szFunc << ": SealInitParallel: failed.\n";
+            return false;
+        }
+    }
+    else if (!EVP_SealInit(&ctx, cipher_type, ek, eklen, iv, array_pubkey,
+                           static_cast<int32_t>(RecipPubKeys.size()))) {
         otErr << szFunc << ": EVP_SealInit: failed.\n";
         return false;
     }
@@ -2222,6 +2464,11 @@ bool OTCrypto_OpenSSL::Open(OTData& dataInput, const Nym& theRecipient,
         // then read its NymID,
         //      read its network-order key content size (convert to host), and
         // then read its key content.
+        //
+        // The NymID and the key are looked at where they sit in dataInput,
+        // rather than copied out: only the recipient's own key is ever
+        // copied, so an envelope addressed to many Nyms costs no more to
+        // open than one addressed to a single Nym.
 
         uint32_t nymid_len_n = 0;
         uint32_t nReadNymIDSize = 0;
@@ -2238,66 +2485,34 @@ bool OTCrypto_OpenSSL::Open(OTData& dataInput, const Nym& theRecipient,
 
         // convert that array size from network to HOST endian.
         //
-        uint32_t nymid_len = ntohl(nymid_len_n);
+        const uint32_t nymid_len = ntohl(nymid_len_n);
 
         otLog5 << __FUNCTION__
                << ": NymID length: " << static_cast<int64_t>(nymid_len) << "\n";
 
-        //      nRunningTotal += nymid_len; // Nope!
-
-        uint8_t* nymid =
-            static_cast<uint8_t*>(malloc(sizeof(uint8_t) * nymid_len));
-        OT_ASSERT(nullptr != nymid);
-        nymid[0] = '\0'; // null terminator.
+        // This length includes the null terminator (it was written that way.)
+        const char* nymid = static_cast<const char*>(
+            (0 == nymid_len) ? nullptr : dataInput.OTfreadInPlace(nymid_len));
 
-        uint32_t nReadNymID = 0;
-
-        if (0 == (nReadNymID = dataInput.OTfread(
-                      nymid,
-                      static_cast<uint32_t>(sizeof(uint8_t) *
-                                            nymid_len)))) // this length
-                                                          // includes the null
-                                                          // terminator (it was
-                                                          // written that way.)
-        {
+        if (nullptr == nymid) {
             otErr << szFunc
                   << ": Error reading NymID for an encrypted symmetric key.\n";
-            free(nymid);
-            nymid = nullptr;
             return false;
         }
-        nRunningTotal += nReadNymID;
-        OT_ASSERT(nReadNymID ==
-                  static_cast<uint32_t>(sizeof(uint8_t) * nymid_len));
-        //      OT_ASSERT(nymid_len == nReadNymID);
-
-        nymid[nymid_len - 1] = '\0'; // for null terminator. If string is 10
-                                     // bytes int64_t, it's from 0-9, and the
-                                     // null terminator is at index 9.
-        const String loopStrNymID(reinterpret_cast<char*>(nymid));
-        free(nymid);
-        nymid = nullptr;
-
-        otLog5 << __FUNCTION__ << ": (LOOP) Current NymID: " << loopStrNymID
-               << "    Strlen:  "
-               << static_cast<int64_t>(loopStrNymID.GetLength()) << "\n";
-
-        // loopStrNymID ... if this matches strNymID then it's the one we're
-        // looking for.
-        // But we have to load it all either way, just to iterate through them,
-        // so might
-        // as well load it all first, then check. If it matches, we use it and
-        // break.
-        // Otherwise we keep iterating until we find it.
-        //
+        nRunningTotal += nymid_len;
+
+        // If string is 10 bytes long, it's from 0-9, and the null terminator
+        // is at index 9. Don't trust the terminator to be there, though.
+        const std::string loopNymID(nymid, strnlen(nymid, nymid_len - 1));
+
+        otLog5 << __FUNCTION__ << ": (LOOP) Current NymID: " << loopNymID
+               << "    Strlen:  " << static_cast<int64_t>(loopNymID.size())
+               << "\n";
+
         // Read its network-order key content size (convert to host-order), and
-        // then
-        // read its key content.
-        uint8_t* ek = nullptr;
-        uint32_t eklen = 0;
+        // then its key content.
         uint32_t eklen_n = 0;
         uint32_t nReadLength = 0;
-        uint32_t nReadKey = 0;
 
         // First we read the encrypted key size.
         //
@@ -2312,84 +2527,46 @@ bool OTCrypto_OpenSSL::Open(OTData& dataInput, const Nym& theRecipient,
 
         // convert that key size from network to host endian.
         //
-        eklen = ntohl(eklen_n);
-        //      eklen  = EVP_PKEY_size(private_key);  // We read this size from
-        // file now...
+        const uint32_t eklen = ntohl(eklen_n);
 
         otLog5 << __FUNCTION__
                << ": EK length:  " << static_cast<int64_t>(eklen) << "   \n";
 
-        //      nRunningTotal += eklen;  // Nope!
-
-        ek = static_cast<uint8_t*>(
-            malloc(static_cast<int32_t>(eklen) *
-                   sizeof(uint8_t))); // I assume this is for the AES key
-        OT_ASSERT(nullptr != ek);
-        memset(static_cast<void*>(ek), 0, static_cast<int32_t>(eklen));
-
-        // Next we read the encrypted key itself...
+        // Next, the encrypted key itself...
         //
-        if (0 == (nReadKey = dataInput.OTfread(ek, eklen))) {
+        const void* ek =
+            (0 == eklen) ? nullptr : dataInput.OTfreadInPlace(eklen);
+
+        if (nullptr == ek) {
             otErr << szFunc << ": Error reading encrypted key.\n";
-            free(ek);
-            ek = nullptr;
             return false;
         }
-        nRunningTotal += nReadKey;
-
-        otLog5 << __FUNCTION__
-               << ":    EK First byte: " << static_cast<int32_t>(ek[0])
-               << "     EK Last byte: " << static_cast<int32_t>(ek[eklen - 1])
-               << "\n";
-
-        OT_ASSERT(nReadKey == eklen);
+        nRunningTotal += eklen;
 
         // If we "found the key already" that means we already found the right
-        // key on
-        // a previous iteration, so therefore we're *definitely* just going to
-        // throw
-        // THIS one away. We just continue on to the next iteration and keep
-        // counting
-        // the bytes.
+        // key on a previous iteration, so therefore we're *definitely* just
+        // going to skip THIS one. We just continue on to the next iteration
+        // and keep counting the bytes.
         //
-        if (!bFoundKeyAlready) {
-            // We have NOT found the right key yet, so let's see if this is the
-            // one we're looking for.
-
-            const bool bNymIDMatches =
-                strNymID.Compare(loopStrNymID); // FOUND IT! <==========
-
-            if ((ii == (array_size - 1)) || // If we're on the LAST INDEX in the
-                                            // array (often the only index), OR
-                                            // if the
-                bNymIDMatches) // NymID is a guaranteed match, then we'll try to
-                               // decrypt using this session key.
-            { // (Of course also we know that we haven't found the Key yet, or
-                // we wouldn't even be here.)
-                // NOTE: What if we're on the last index, but the NymID DOES
-                // exist, and it DEFINITELY doesn't match?
-                // In other words, if loopStrNymID EXISTS, and it DEFINITELY
-                // doesn't match (bNymIDMatches is false) then we
-                // DEFINITELY want to skip it. But if bNymIDMatches is false
-                // simply because loopStrNymID is EMPTY, then we
-                // can't rule that key out, in that case.
-                //
-                if (!(loopStrNymID.Exists() &&
-                      !bNymIDMatches)) // Skip if ID was definitely found and
-                                       // definitely doesn't match.
-                {
-                    bFoundKeyAlready = true;
-
-                    theRawEncryptedKey.Assign(static_cast<void*>(ek), eklen);
-                    //                  theRawEncryptedKey.Assign(const_cast<const
-                    // void *>(static_cast<void *>(ek)), eklen);
-                }
-            }
-        }
+        if (bFoundKeyAlready) continue;
 
-        free(ek);
-        ek = nullptr;
+        const bool bNymIDMatches =
+            (0 == loopNymID.compare(strNymID.Get())); // FOUND IT! <==========
 
+        // If we're on the LAST INDEX in the array (often the only index), OR
+        // if the NymID is a guaranteed match, then we'll try to decrypt using
+        // this session key.
+        //
+        // NOTE: What if we're on the last index, but the NymID DOES exist,
+        // and it DEFINITELY doesn't match? Then we DEFINITELY want to skip
+        // it. But if bNymIDMatches is false simply because loopNymID is
+        // EMPTY, then we can't rule that key out, in that case.
+        //
+        if (bNymIDMatches ||
+            ((ii == (array_size - 1)) && loopNymID.empty())) {
+            bFoundKeyAlready = true;
+            theRawEncryptedKey.Assign(ek, eklen);
+        }
     } // for
 
     if (!bFoundKeyAlready) // Todo: AND if list of POTENTIAL matches is
@@ -2579,20 +2756,22 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContractDefaultHash(
     const char* szFunc = "OTCrypto_OpenSSL::SignContractDefaultHash";
 
     // 32 bytes, double sha256
+    uint8_t vDigest[SHA256_DIGEST_LENGTH];
+
+    if (!default_hash(strContractUnsigned, vDigest)) {
+        otErr << szFunc << ": Failed hashing the contents.\n";
+        return false;
+    }
+
     // This stores the message digest, pre-encrypted, but with the padding
     // added.
-    unsigned char* vDigest =
-        Hash(strContractUnsigned.Get(),
-             strContractUnsigned.Get() + strContractUnsigned.GetLength());
+    uint8_t* vEM = t_signatureContext.Scratch(
+        t_signatureContext.m_vEM, OTCryptoConfig::PublicKeysizeMax());
 
     // This stores the final signature, when the EM value has been signed by RSA
     // private key.
-    std::vector<uint8_t> vEM(OTCryptoConfig::PublicKeysizeMax());
-    std::vector<uint8_t> vpSignature(OTCryptoConfig::PublicKeysizeMax());
-
-    OTPassword::zeroMemory(&vEM.at(0), OTCryptoConfig::PublicKeysizeMax());
-    OTPassword::zeroMemory(&vpSignature.at(0),
-                           OTCryptoConfig::PublicKeysizeMax());
+    uint8_t* vpSignature = t_signatureContext.Scratch(
+        t_signatureContext.m_vSignature, OTCryptoConfig::PublicKeysizeMax());
 
     // Here, we convert the EVP_PKEY that was passed in, to an RSA key for
     // signing.
@@ -2645,7 +2824,7 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContractDefaultHash(
     //      in    OUT      IN        in        in
     const EVP_MD* md_sha256 = EVP_sha256();
     int32_t status =
-        RSA_padding_add_PKCS1_PSS(pRsaKey, &vEM.at(0), vDigest, md_sha256,
+        RSA_padding_add_PKCS1_PSS(pRsaKey, vEM, vDigest, md_sha256,
                                   -2); // maximum salt length
 
     // Above, pDigest is the input, but its length is not needed, since it is
@@ -2696,10 +2875,10 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContractDefaultHash(
     // RSA_size(rsa)).
     //
     status = RSA_private_encrypt(
-        RSA_size(pRsaKey),  // input
-        &vEM.at(0),         // padded message digest (input)
-        &vpSignature.at(0), // encrypted padded message digest (output)
-        pRsaKey,            // private key (input )
+        RSA_size(pRsaKey), // input
+        vEM,               // padded message digest (input)
+        vpSignature,       // encrypted padded message digest (output)
+        pRsaKey,           // private key (input )
         RSA_NO_PADDING); // why not RSA_PKCS1_PADDING ? (Custom padding above in
                          // PSS mode with two hashes.)
 
@@ -2712,7 +2891,7 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContractDefaultHash(
     }
     // status contains size
 
-    OTData binSignature(&vpSignature.at(0), status); // RSA_private_encrypt
+    OTData binSignature(vpSignature, status); // RSA_private_encrypt
                                                      // actually returns the
                                                      // right size.
     //    OTData binSignature(pSignature, 128);    // stop hardcoding this block
@@ -2738,19 +2917,17 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifyContractDefaultHash(
     const char* szFunc = "OTCrypto_OpenSSL::VerifyContractDefaultHash";
 
     // 32 bytes, double sha256
-    unsigned char* vDigest =
-        Hash(strContractToVerify.Get(),
-             strContractToVerify.Get() + strContractToVerify.GetLength());
+    uint8_t vDigest[SHA256_DIGEST_LENGTH];
 
-    std::vector<uint8_t> vDecrypted(
-        OTCryptoConfig::PublicKeysizeMax()); // Contains the decrypted
-                                             // signature.
+    if (!default_hash(strContractToVerify, vDigest)) {
+        otErr << szFunc << ": Failed hashing the contents.\n";
+        return false;
+    }
 
-    OTPassword::zeroMemory(&vDecrypted.at(0),
-                           OTCryptoConfig::PublicKeysizeMax());
+    // Contains the decrypted signature.
+    uint8_t* vDecrypted = t_signatureContext.Scratch(
+        t_signatureContext.m_vEM, OTCryptoConfig::PublicKeysizeMax());
 
-    // Here, we convert the EVP_PKEY that was passed in, to an RSA key for
-    // signing.
     RSA* pRsaKey = EVP_PKEY_get1_RSA(const_cast<EVP_PKEY*>(pkey));
 
     if (!pRsaKey) {
@@ -2807,7 +2984,7 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifyContractDefaultHash(
         nSignatureSize, // length of signature, aka RSA_size(rsa)
         static_cast<const uint8_t*>(
             binSignature.GetPointer()), // location of signature
-        &vDecrypted.at(0), // Output--must be large enough to hold the md (which
+        vDecrypted,        // Output--must be large enough to hold the md (which
                            // is smaller than RSA_size(rsa) - 11)
         pRsaKey,           // signer's public key
         RSA_NO_PADDING);
@@ -2853,7 +3030,7 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifyContractDefaultHash(
 
     const EVP_MD* md_sha256 = EVP_sha256();
     status =
-        RSA_verify_PKCS1_PSS(pRsaKey, vDigest, md_sha256, &vDecrypted.at(0),
+        RSA_verify_PKCS1_PSS(pRsaKey, vDigest, md_sha256, vDecrypted,
                              -2); // salt length recovered from signature
 
     if (!status) {
@@ -3284,28 +3461,6 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContract(
 
     const char* szFunc = "OTCrypto_OpenSSL::SignContract";
 
-    class _OTCont_SignCont1
-    {
-    private:
-        const char* m_szFunc;
-        EVP_MD_CTX& m_ctx;
-
-    public:
-        _OTCont_SignCont1(const char* param_szFunc, EVP_MD_CTX& param_ctx)
-            : m_szFunc(param_szFunc)
-            , m_ctx(param_ctx)
-        {
-            OT_ASSERT(nullptr != m_szFunc);
-
-            EVP_MD_CTX_init(&m_ctx);
-        }
-        ~_OTCont_SignCont1()
-        {
-            if (0 == EVP_MD_CTX_cleanup(&m_ctx))
-                otErr << m_szFunc << ": Failure in cleanup. (It returned 0.)\n";
-        }
-    };
-
     const bool bUsesDefaultHashAlgorithm =
         strHashType.Compare(Identifier::DefaultHashAlgorithm);
     EVP_MD* md = nullptr;
@@ -3332,33 +3487,32 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContract(
         return false;
     }
 
-    // RE: EVP_SignInit() or EVP_MD_CTX_init()...
-    //
-    // Since only a copy of the digest context is ever finalized the
-    // context MUST be cleaned up after use by calling EVP_MD_CTX_cleanup()
-    // or a memory leak will occur.
-    //
-    EVP_MD_CTX md_ctx;
-
-    _OTCont_SignCont1 theInstance(szFunc, md_ctx);
-
-    // Do the signature
-    // Note: I just changed this to the _ex version (in case I'm debugging later
-    // and find a problem here.)
+    // This is what EVP_SignInit / EVP_SignUpdate / EVP_SignFinal do, but
+    // with the contexts this thread already has (SignatureContext.)
     //
-    EVP_SignInit_ex(&md_ctx, md, nullptr);
-
-    EVP_SignUpdate(&md_ctx, strContractUnsigned.Get(),
-                   strContractUnsigned.GetLength());
+    uint8_t vDigest[EVP_MAX_MD_SIZE];
+    uint32_t uDigestSize = 0;
+    EVP_PKEY_CTX* pKeyContext = nullptr;
 
     uint8_t sig_buf[4096]; // Safe since we pass the size when we use it.
+    size_t sig_len = sizeof(sig_buf);
+
+    const bool bSigned =
+        t_signatureContext.Digest(md, strContractUnsigned.Get(),
+                                  strContractUnsigned.GetLength(), vDigest,
+                                  &uDigestSize) &&
+        (nullptr != (pKeyContext = t_signatureContext.KeyContext(
+                         const_cast<EVP_PKEY*>(pkey), md, true))) &&
+        (1 == EVP_PKEY_sign(pKeyContext, sig_buf, &sig_len, vDigest,
+                            uDigestSize));
 
-    int32_t sig_len = sizeof(sig_buf);
-    int32_t err =
-        EVP_SignFinal(&md_ctx, sig_buf, reinterpret_cast<uint32_t*>(&sig_len),
-                      const_cast<EVP_PKEY*>(pkey));
+    // Unless keys are resident anyway, don't let the cached context keep the
+    // private key alive after its timer has run out.
+    if (OTAsymmetricKey::RESIDENT != OTAsymmetricKey::GetKeyResidency()) {
+        t_signatureContext.ReleaseKey();
+    }
 
-    if (err != 1) {
+    if (!bSigned) {
         otErr << szFunc << ": Error signing xml contents.\n";
         return false;
     }
@@ -3368,7 +3522,7 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::SignContract(
         // We put the signature data into the signature object that
         // was passed in for that purpose.
         OTData tempData;
-        tempData.Assign(sig_buf, sig_len);
+        tempData.Assign(sig_buf, static_cast<uint32_t>(sig_len));
         theSignature.SetData(tempData);
 
         return true;
@@ -3383,6 +3537,14 @@ bool OTCrypto_OpenSSL::SignContract(const String& strContractUnsigned,
 {
 
     OTAsymmetricKey& theTempKey = const_cast<OTAsymmetricKey&>(theKey);
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+    // Ed25519 has its own hash, so strHashType doesn't apply.
+    if (OTAsymmetricKey::ED25519 == theKey.GetKeyType())
+        return dynamic_cast<OTAsymmetricKey_Ed25519&>(theTempKey)
+            .Sign(strContractUnsigned, theSignature, pPWData);
+#endif
+
     OTAsymmetricKey_OpenSSL* pTempOpenSSLKey =
         dynamic_cast<OTAsymmetricKey_OpenSSL*>(&theTempKey);
     OT_ASSERT(nullptr != pTempOpenSSLKey);
@@ -3407,6 +3569,12 @@ bool OTCrypto_OpenSSL::VerifySignature(const String& strContractToVerify,
                                        const String& strHashType,
                                        const OTPasswordData* pPWData) const
 {
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+    if (OTAsymmetricKey::ED25519 == theKey.GetKeyType())
+        return dynamic_cast<const OTAsymmetricKey_Ed25519&>(theKey)
+            .Verify(strContractToVerify, theSignature);
+#endif
+
     OTAsymmetricKey& theTempKey = const_cast<OTAsymmetricKey&>(theKey);
     OTAsymmetricKey_OpenSSL* pTempOpenSSLKey =
         dynamic_cast<OTAsymmetricKey_OpenSSL*>(&theTempKey);
@@ -3426,6 +3594,108 @@ bool OTCrypto_OpenSSL::VerifySignature(const String& strContractToVerify,
     return true;
 }
 
+namespace
+{
+
+typedef std::map<const OTAsymmetricKey*, const EVP_PKEY*> mapOfInstantiatedKeys;
+
+} // namespace
+
+// Each distinct key is instantiated once, here on the calling thread, before
+// any job is queued: GetKey may release or swap the EVP_PKEY, and it must not
+// do that to a key a worker is using.
+//
+listOfCryptoFutures OTCrypto_OpenSSL::SignContracts(
+    const listOfSignatureJobs& theJobs, const OTPasswordData* pPWData)
+{
+    listOfCryptoFutures theFutures;
+    mapOfInstantiatedKeys mapKeys;
+    const OTCrypto_OpenSSLdp* pdp = dp;
+
+    for (auto& it : theJobs) {
+        OTAsymmetricKey& theTempKey = const_cast<OTAsymmetricKey&>(*it.m_pKey);
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+        // The Ed25519 secret key isn't safe to share between threads, and
+        // signing with it is too cheap to be worth handing off anyway.
+        if (OTAsymmetricKey::ED25519 == theTempKey.GetKeyType()) {
+            theFutures.push_back(OTCryptoPool::Ready(
+                SignContract(*it.m_pContents, theTempKey, *it.m_pSignature,
+                             it.m_strHashType, pPWData)));
+            continue;
+        }
+#endif
+
+        const EVP_PKEY*& pkey = mapKeys[it.m_pKey];
+
+        if (nullptr == pkey) {
+            OTAsymmetricKey_OpenSSL* pTempOpenSSLKey =
+                dynamic_cast<OTAsymmetricKey_OpenSSL*>(&theTempKey);
+            OT_ASSERT(nullptr != pTempOpenSSLKey);
+
+            pkey = pTempOpenSSLKey->dp->GetKey(pPWData);
+            OT_ASSERT(nullptr != pkey);
+        }
+
+        const OTSignatureJob theJob(it);
+        const EVP_PKEY* pJobKey = pkey;
+
+        theFutures.push_back(OTCryptoPool::Submit([pdp, theJob, pJobKey]() {
+            return pdp->SignContract(*theJob.m_pContents, pJobKey,
+                                     *theJob.m_pSignature,
+                                     theJob.m_strHashType);
+        }));
+    }
+
+    return theFutures;
+}
+
+listOfCryptoFutures OTCrypto_OpenSSL::VerifySignatures(
+    const listOfSignatureJobs& theJobs, const OTPasswordData* pPWData) const
+{
+    listOfCryptoFutures theFutures;
+    mapOfInstantiatedKeys mapKeys;
+    const OTCrypto_OpenSSLdp* pdp = dp;
+
+    for (auto& it : theJobs) {
+        const OTSignatureJob theJob(it);
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+        if (OTAsymmetricKey::ED25519 == it.m_pKey->GetKeyType()) {
+            theFutures.push_back(OTCryptoPool::Submit([theJob]() {
+                return dynamic_cast<const OTAsymmetricKey_Ed25519&>(
+                           *theJob.m_pKey)
+                    .Verify(*theJob.m_pContents, *theJob.m_pSignature);
+            }));
+            continue;
+        }
+#endif
+
+        const EVP_PKEY*& pkey = mapKeys[it.m_pKey];
+
+        if (nullptr == pkey) {
+            OTAsymmetricKey& theTempKey =
+                const_cast<OTAsymmetricKey&>(*it.m_pKey);
+            OTAsymmetricKey_OpenSSL* pTempOpenSSLKey =
+                dynamic_cast<OTAsymmetricKey_OpenSSL*>(&theTempKey);
+            OT_ASSERT(nullptr != pTempOpenSSLKey);
+
+            pkey = pTempOpenSSLKey->dp->GetKey(pPWData);
+            OT_ASSERT(nullptr != pkey);
+        }
+
+        const EVP_PKEY* pJobKey = pkey;
+
+        theFutures.push_back(OTCryptoPool::Submit([pdp, theJob, pJobKey]() {
+            return pdp->VerifySignature(*theJob.m_pContents, pJobKey,
+                                        *theJob.m_pSignature,
+                                        theJob.m_strHashType);
+        }));
+    }
+
+    return theFutures;
+}
+
 // All the other various versions eventually call this one, where the actual
 // work is done.
 bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifySignature(
@@ -3439,6 +3709,67 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifySignature(
     OT_ASSERT_MSG(nullptr != pkey,
                   "Null pkey in OTCrypto_OpenSSL::VerifySignature.\n");
 
+    std::string strCacheKey;
+    const bool bUseCache =
+        OTSignatureCache::IsEnabled() &&
+        GetSignatureCacheKey(strContractToVerify, pkey, theSignature,
+                             strHashType, strCacheKey);
+
+    if (bUseCache && OTSignatureCache::Lookup(strCacheKey)) return true;
+
+    const bool bVerified = VerifySignatureNoCache(
+        strContractToVerify, pkey, theSignature, strHashType, pPWData);
+
+    if (bUseCache && bVerified) OTSignatureCache::Insert(strCacheKey);
+
+    return bVerified;
+}
+
+// static
+bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::GetSignatureCacheKey(
+    const String& strContractToVerify, const EVP_PKEY* pkey,
+    const OTSignature& theSignature, const String& strHashType,
+    std::string& strKey)
+{
+    EVP_PKEY* pPublicKey = const_cast<EVP_PKEY*>(pkey);
+    const int32_t nKeySize = i2d_PUBKEY(pPublicKey, nullptr);
+
+    if (nKeySize <= 0) return false;
+
+    std::vector<uint8_t> vKey(static_cast<size_t>(nKeySize));
+    uint8_t* pKeyOut = &vKey.at(0);
+
+    if (i2d_PUBKEY(pPublicKey, &pKeyOut) != nKeySize) return false;
+
+    // Every variable length field is prefixed with its size, so that no two
+    // different tuples can be fed to the digest as the same byte string.
+    const uint32_t sizes[] = {static_cast<uint32_t>(nKeySize),
+                              strHashType.GetLength(),
+                              strContractToVerify.GetLength(),
+                              theSignature.GetLength()};
+
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, sizes, sizeof(sizes));
+    SHA256_Update(&ctx, &vKey.at(0), vKey.size());
+    SHA256_Update(&ctx, strHashType.Get(), strHashType.GetLength());
+    SHA256_Update(&ctx, strContractToVerify.Get(),
+                  strContractToVerify.GetLength());
+    SHA256_Update(&ctx, theSignature.Get(), theSignature.GetLength());
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &ctx);
+
+    strKey.assign(reinterpret_cast<const char*>(digest), sizeof(digest));
+
+    return true;
+}
+
+bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifySignatureNoCache(
+    const String& strContractToVerify, const EVP_PKEY* pkey,
+    const OTSignature& theSignature, const String& strHashType,
+    const OTPasswordData* pPWData) const
+{
     const char* szFunc = "OTCrypto_OpenSSL::VerifySignature";
 
     const bool bUsesDefaultHashAlgorithm =
@@ -3472,34 +3803,23 @@ bool OTCrypto_OpenSSL::OTCrypto_OpenSSLdp::VerifySignature(
         return false;
     }
 
-    EVP_MD_CTX ctx;
-    EVP_MD_CTX_init(&ctx);
-
-    EVP_VerifyInit(&ctx, md);
-
-    // Here I'm adding the actual XML portion of the contract (the portion that
-    // gets signed.)
-    // Basically we are repeating similarly to the signing process in order to
-    // verify.
-
-    EVP_VerifyUpdate(&ctx, strContractToVerify.Get(),
-                     strContractToVerify.GetLength());
-
-    // Now we pass in the Signature
-    // EVP_VerifyFinal() returns 1 for a correct signature,
-    // 0 for failure and -1 if some other error occurred.
+    // This is what EVP_VerifyInit / EVP_VerifyUpdate / EVP_VerifyFinal do,
+    // but with the contexts this thread already has (SignatureContext.)
     //
-    int32_t nErr = EVP_VerifyFinal(
-        &ctx, static_cast<const uint8_t*>(binSignature.GetPointer()),
-        binSignature.GetSize(), const_cast<EVP_PKEY*>(pkey));
-
-    EVP_MD_CTX_cleanup(&ctx);
+    uint8_t vDigest[EVP_MAX_MD_SIZE];
+    uint32_t uDigestSize = 0;
+    EVP_PKEY_CTX* pKeyContext = nullptr;
 
     // the moment of true. 1 means the signature verified.
-    if (1 == nErr)
-        return true;
-    else
-        return false;
+    return t_signatureContext.Digest(md, strContractToVerify.Get(),
+                                     strContractToVerify.GetLength(), vDigest,
+                                     &uDigestSize) &&
+           (nullptr != (pKeyContext = t_signatureContext.KeyContext(
+                            const_cast<EVP_PKEY*>(pkey), md, false))) &&
+           (1 == EVP_PKEY_verify(
+                     pKeyContext,
+                     static_cast<const uint8_t*>(binSignature.GetPointer()),
+                     binSignature.GetSize(), vDigest, uDigestSize));
 }
 
 // Sign the Contract using a private key from a file.
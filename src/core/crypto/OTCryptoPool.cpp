@@ -0,0 +1,218 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace opentxs
+{
+
+namespace
+{
+
+class Pool
+{
+public:
+    std::mutex m_mutex;
+    std::condition_variable m_cvJobs;
+    std::deque<std::packaged_task<bool()>> m_dequeJobs;
+    std::vector<std::thread> m_vThreads;
+    bool m_bStopping;
+    int32_t m_nThreads;
+
+    Pool()
+        : m_bStopping(false)
+        , m_nThreads(-1)
+    {
+    }
+
+    ~Pool()
+    {
+        Stop();
+    }
+
+    // Caller must hold m_mutex.
+    size_t ThreadsWanted() const
+    {
+        if (m_nThreads >= 0) return static_cast<size_t>(m_nThreads);
+
+        const uint32_t nCores = std::thread::hardware_concurrency();
+
+        return (0 == nCores) ? 1 : nCores;
+    }
+
+    // Caller must hold m_mutex.
+    void Start()
+    {
+        const size_t nWanted = ThreadsWanted();
+
+        while (m_vThreads.size() < nWanted) {
+            m_vThreads.push_back(std::thread(&Pool::Run, this));
+        }
+    }
+
+    void Stop()
+    {
+        std::vector<std::thread> vThreads;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStopping = true;
+            vThreads.swap(m_vThreads);
+        }
+
+        m_cvJobs.notify_all();
+
+        for (auto& it : vThreads) it.join();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStopping = false;
+    }
+
+    void Run()
+    {
+        for (;;) {
+            std::packaged_task<bool()> theTask;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cvJobs.wait(lock, [this]() {
+                    return m_bStopping || !m_dequeJobs.empty();
+                });
+
+                // Queued jobs still run when stopping, so nobody is left
+                // waiting on a future that will never be ready.
+                if (m_dequeJobs.empty()) return;
+
+                theTask = std::move(m_dequeJobs.front());
+                m_dequeJobs.pop_front();
+            }
+
+            theTask();
+        }
+    }
+};
+
+Pool s_pool;
+std::atomic<uint64_t> s_lJobsRun(0);
+
+} // namespace
+
+// static
+std::future<bool> OTCryptoPool::Submit(Job theJob)
+{
+    ++s_lJobsRun;
+
+    std::packaged_task<bool()> theTask(std::move(theJob));
+    std::future<bool> theFuture = theTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(s_pool.m_mutex);
+
+        if (0 < s_pool.ThreadsWanted()) {
+            s_pool.Start();
+            s_pool.m_dequeJobs.push_back(std::move(theTask));
+        }
+    }
+
+    if (theTask.valid())
+        theTask(); // No threads configured: run it here.
+    else
+        s_pool.m_cvJobs.notify_one();
+
+    return theFuture;
+}
+
+// static
+std::future<bool> OTCryptoPool::Ready(bool bResult)
+{
+    std::promise<bool> thePromise;
+    thePromise.set_value(bResult);
+
+    return thePromise.get_future();
+}
+
+// static
+bool OTCryptoPool::WaitAll(listOfCryptoFutures& theFutures)
+{
+    bool bAllTrue = true;
+
+    for (auto& it : theFutures) {
+        if (!it.get()) bAllTrue = false;
+    }
+
+    return bAllTrue;
+}
+
+// static
+int32_t OTCryptoPool::GetThreads()
+{
+    std::lock_guard<std::mutex> lock(s_pool.m_mutex);
+
+    return s_pool.m_nThreads;
+}
+
+// static
+void OTCryptoPool::SetThreads(int32_t nThreads)
+{
+    s_pool.Stop();
+
+    std::lock_guard<std::mutex> lock(s_pool.m_mutex);
+    s_pool.m_nThreads = nThreads;
+}
+
+// static
+void OTCryptoPool::Shutdown()
+{
+    s_pool.Stop();
+}
+
+// static
+uint64_t OTCryptoPool::JobsRun()
+{
+    return s_lJobsRun;
+}
+
+} // namespace opentxs
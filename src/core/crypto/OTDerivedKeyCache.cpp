@@ -0,0 +1,276 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/OTData.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Same default as the master key.
+#define OT_DERIVED_KEY_CACHE_DEFAULT_TIMEOUT 300
+
+// Only a handful of passphrase-protected keys are in use at any one time;
+// this just keeps a misbehaving caller from growing the cache without bound.
+#define OT_DERIVED_KEY_CACHE_MAX_ENTRIES 256
+
+namespace opentxs
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct Entry
+{
+    std::unique_ptr<OTPassword> pDerivedKey;
+    OTData theCheckHash;
+    Clock::time_point theExpiry;
+};
+
+typedef std::list<std::string> listOfKeys;
+typedef std::unordered_map<std::string, Entry> mapOfEntries;
+
+class Cache
+{
+public:
+    std::mutex m_mutex;
+    std::condition_variable m_cvWake;
+    listOfKeys m_listOldest; // in order of insertion, oldest at the front
+    mapOfEntries m_mapEntries;
+    int32_t m_nTimeoutSeconds;
+    std::thread m_threadTimeout;
+    uint64_t m_lGeneration; // bumped by Stop, to retire the timer thread
+
+    Cache()
+        : m_nTimeoutSeconds(OT_DERIVED_KEY_CACHE_DEFAULT_TIMEOUT)
+        , m_lGeneration(0)
+    {
+    }
+
+    ~Cache()
+    {
+        Stop();
+    }
+
+    // Caller must hold m_mutex. The OTPassword destructor zeroes the key.
+    void EraseOldest()
+    {
+        m_mapEntries.erase(m_listOldest.front());
+        m_listOldest.pop_front();
+    }
+
+    // Caller must hold m_mutex.
+    void Wipe()
+    {
+        m_mapEntries.clear();
+        m_listOldest.clear();
+    }
+
+    // Caller must hold m_mutex.
+    void Start()
+    {
+        if (!m_threadTimeout.joinable()) {
+            m_threadTimeout = std::thread(&Cache::Run, this, m_lGeneration);
+        }
+    }
+
+    void Stop()
+    {
+        std::thread theThread;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_lGeneration;
+            Wipe();
+            theThread.swap(m_threadTimeout);
+        }
+
+        m_cvWake.notify_all();
+
+        if (theThread.joinable()) theThread.join();
+    }
+
+    // The timer thread. Every entry gets the same timeout, so the oldest
+    // entry is always the next one to expire.
+    void Run(uint64_t lGeneration)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (lGeneration == m_lGeneration) {
+            if (m_listOldest.empty() || (-1 == m_nTimeoutSeconds)) {
+                m_cvWake.wait(lock);
+                continue;
+            }
+
+            const Clock::time_point theExpiry =
+                m_mapEntries.find(m_listOldest.front())->second.theExpiry;
+
+            if (Clock::now() >= theExpiry) {
+                EraseOldest();
+                continue;
+            }
+
+            m_cvWake.wait_until(lock, theExpiry);
+        }
+    }
+};
+
+Cache s_cache;
+
+std::atomic<uint64_t> s_lHits(0);
+std::atomic<uint64_t> s_lMisses(0);
+
+} // namespace
+
+bool OTDerivedKeyCache::Lookup(const std::string& strKey,
+                               OTPassword& theDerivedKey, OTData& theCheckHash)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+        auto it = s_cache.m_mapEntries.find(strKey);
+
+        // The timer thread may not have woken up yet.
+        if ((s_cache.m_mapEntries.end() != it) &&
+            ((-1 == s_cache.m_nTimeoutSeconds) ||
+             (Clock::now() < it->second.theExpiry))) {
+            const OTPassword& theCached = *it->second.pDerivedKey;
+            theDerivedKey.setMemory(theCached.getMemory(),
+                                    theCached.getMemorySize());
+            theCheckHash = it->second.theCheckHash;
+            ++s_lHits;
+
+            return true;
+        }
+    }
+
+    ++s_lMisses;
+
+    return false;
+}
+
+void OTDerivedKeyCache::Insert(const std::string& strKey,
+                               const OTPassword& theDerivedKey,
+                               const OTData& theCheckHash)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+        if ((0 == s_cache.m_nTimeoutSeconds) ||
+            (s_cache.m_mapEntries.count(strKey) > 0)) {
+            return;
+        }
+
+        while (s_cache.m_listOldest.size() >=
+               OT_DERIVED_KEY_CACHE_MAX_ENTRIES) {
+            s_cache.EraseOldest();
+        }
+
+        Entry& theEntry = s_cache.m_mapEntries[strKey];
+        theEntry.pDerivedKey.reset(new OTPassword);
+        theEntry.pDerivedKey->setMemory(theDerivedKey.getMemory(),
+                                        theDerivedKey.getMemorySize());
+        theEntry.theCheckHash = theCheckHash;
+        s_cache.m_listOldest.push_back(strKey);
+
+        if (-1 == s_cache.m_nTimeoutSeconds) return;
+
+        theEntry.theExpiry =
+            Clock::now() + std::chrono::seconds(s_cache.m_nTimeoutSeconds);
+        s_cache.Start();
+    }
+
+    s_cache.m_cvWake.notify_all();
+}
+
+void OTDerivedKeyCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+    s_cache.Wipe();
+}
+
+void OTDerivedKeyCache::Shutdown()
+{
+    s_cache.Stop();
+}
+
+int32_t OTDerivedKeyCache::GetTimeoutSeconds()
+{
+    std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+    return s_cache.m_nTimeoutSeconds;
+}
+
+void OTDerivedKeyCache::SetTimeoutSeconds(int32_t nTimeoutSeconds)
+{
+    std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+    s_cache.m_nTimeoutSeconds = (nTimeoutSeconds < -1) ? 0 : nTimeoutSeconds;
+    s_cache.Wipe();
+}
+
+int64_t OTDerivedKeyCache::Size()
+{
+    std::lock_guard<std::mutex> lock(s_cache.m_mutex);
+
+    return static_cast<int64_t>(s_cache.m_listOldest.size());
+}
+
+uint64_t OTDerivedKeyCache::Hits()
+{
+    return s_lHits;
+}
+
+uint64_t OTDerivedKeyCache::Misses()
+{
+    return s_lMisses;
+}
+
+} // namespace opentxs
@@ -0,0 +1,638 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTHash160.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OT_HASH160_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace opentxs
+{
+
+namespace
+{
+
+const uint32_t s_sha256Init[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                  0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                  0x1f83d9ab, 0x5be0cd19};
+
+const uint32_t s_sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// RIPEMD160 message word order, rotation amounts and constants, for the left
+// and the right line.
+const uint8_t s_ripemdR[80] = {
+    0, 1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+    7, 4,  13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,
+    3, 10, 14, 4,  9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12,
+    1, 9,  11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,
+    4, 0,  5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+const uint8_t s_ripemdRR[80] = {
+    5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12,
+    6,  11, 3,  7, 0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,
+    15, 5,  1,  3, 7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13,
+    8,  6,  4,  1, 3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14,
+    12, 15, 10, 4, 1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11};
+const uint8_t s_ripemdS[80] = {
+    11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,
+    7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12,
+    11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,
+    11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12,
+    9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+const uint8_t s_ripemdSS[80] = {
+    8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,
+    9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11,
+    9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,
+    15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,
+    8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+const uint32_t s_ripemdK[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc,
+                               0xa953fd4e};
+const uint32_t s_ripemdKK[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3,
+                                0x7a6d76e9, 0x00000000};
+
+const size_t OT_SHA256_SIZE = 32;
+
+// The most inputs a batch kernel hashes at once.
+const size_t OT_HASH160_LANES = 8;
+
+inline uint32_t load_be32(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) |
+           (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void store_be32(uint8_t* p, uint32_t x)
+{
+    p[0] = static_cast<uint8_t>(x >> 24);
+    p[1] = static_cast<uint8_t>(x >> 16);
+    p[2] = static_cast<uint8_t>(x >> 8);
+    p[3] = static_cast<uint8_t>(x);
+}
+
+inline uint32_t load_le32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void store_le32(uint8_t* p, uint32_t x)
+{
+    p[0] = static_cast<uint8_t>(x);
+    p[1] = static_cast<uint8_t>(x >> 8);
+    p[2] = static_cast<uint8_t>(x >> 16);
+    p[3] = static_cast<uint8_t>(x >> 24);
+}
+
+inline uint32_t rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t rotl(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// Compresses nBlocks consecutive 64 byte blocks into state.
+typedef void (*BlockKernel)(uint32_t* state, const uint8_t* pBlocks,
+                            size_t nBlocks);
+
+// Writes the SHA-256 of at most OT_HASH160_LANES inputs to
+// pOutput + i * OT_SHA256_SIZE.
+typedef void (*BatchKernel)(const uint8_t* const* ppInputs,
+                            const size_t* pSizes, size_t nCount,
+                            uint8_t* pOutput);
+
+struct Hash160Implementation
+{
+    const char* name;
+    BlockKernel blocks;
+    BatchKernel batch; // nullptr: hash batches one input at a time
+};
+
+void blocks_scalar(uint32_t* state, const uint8_t* pBlocks, size_t nBlocks)
+{
+    uint32_t w[64];
+
+    for (size_t n = 0; n < nBlocks; ++n, pBlocks += 64) {
+        for (int t = 0; t < 16; ++t) w[t] = load_be32(pBlocks + 4 * t);
+
+        for (int t = 16; t < 64; ++t) {
+            const uint32_t s0 =
+                rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            const uint32_t s1 =
+                rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+                 e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 64; ++t) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) +
+                                ((e & f) ^ (~e & g)) + s_sha256K[t] + w[t];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) +
+                                ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+// Copies the trailing partial block of the input into pTail (128 bytes) and
+// pads it. Returns the number of padded blocks: 1, or 2 if the length did not
+// fit.
+size_t pad_tail(const uint8_t* pInput, size_t lSize, uint8_t* pTail)
+{
+    const size_t lRest = lSize % 64;
+    const size_t nBlocks = (lRest < 56) ? 1 : 2;
+
+    if (lRest > 0) memcpy(pTail, pInput + lSize - lRest, lRest);
+
+    pTail[lRest] = 0x80;
+    memset(pTail + lRest + 1, 0, nBlocks * 64 - lRest - 1 - 8);
+
+    const uint64_t lBits = lSize * 8ULL;
+    store_be32(pTail + nBlocks * 64 - 8, static_cast<uint32_t>(lBits >> 32));
+    store_be32(pTail + nBlocks * 64 - 4, static_cast<uint32_t>(lBits));
+
+    return nBlocks;
+}
+
+void sha256(BlockKernel blocks, const uint8_t* pInput, size_t lSize,
+            uint8_t* pOutput)
+{
+    uint32_t state[8];
+    memcpy(state, s_sha256Init, sizeof(state));
+
+    uint8_t tail[128];
+    blocks(state, pInput, lSize / 64);
+    blocks(state, tail, pad_tail(pInput, lSize, tail));
+
+    for (int i = 0; i < 8; ++i) store_be32(pOutput + 4 * i, state[i]);
+}
+
+template <int F>
+inline uint32_t ripemd_f(uint32_t x, uint32_t y, uint32_t z)
+{
+    return (0 == F) ? (x ^ y ^ z)
+                    : (1 == F) ? ((x & y) | (~x & z))
+                               : (2 == F) ? ((x | ~y) ^ z)
+                                          : (3 == F) ? ((x & z) | (y & ~z))
+                                                     : (x ^ (y | ~z));
+}
+
+// Sixteen steps of both lines. The right line uses the functions in reverse
+// order.
+template <int G>
+inline void ripemd_group(const uint32_t* x, uint32_t* left, uint32_t* right)
+{
+    uint32_t a = left[0], b = left[1], c = left[2], d = left[3], e = left[4];
+    uint32_t aa = right[0], bb = right[1], cc = right[2], dd = right[3],
+             ee = right[4];
+
+    for (int j = 16 * G; j < 16 * (G + 1); ++j) {
+        uint32_t t = rotl(a + ripemd_f<G>(b, c, d) + x[s_ripemdR[j]] +
+                              s_ripemdK[G],
+                          s_ripemdS[j]) +
+                     e;
+        a = e;
+        e = d;
+        d = rotl(c, 10);
+        c = b;
+        b = t;
+
+        t = rotl(aa + ripemd_f<4 - G>(bb, cc, dd) + x[s_ripemdRR[j]] +
+                     s_ripemdKK[G],
+                 s_ripemdSS[j]) +
+            ee;
+        aa = ee;
+        ee = dd;
+        dd = rotl(cc, 10);
+        cc = bb;
+        bb = t;
+    }
+
+    left[0] = a;
+    left[1] = b;
+    left[2] = c;
+    left[3] = d;
+    left[4] = e;
+    right[0] = aa;
+    right[1] = bb;
+    right[2] = cc;
+    right[3] = dd;
+    right[4] = ee;
+}
+
+// RIPEMD160 of a SHA-256 digest: a single, always identically padded block.
+void ripemd160_of_sha256(const uint8_t* pInput, uint8_t* pOutput)
+{
+    uint32_t x[16];
+
+    for (int i = 0; i < 8; ++i) x[i] = load_le32(pInput + 4 * i);
+
+    x[8] = 0x80;
+    for (int i = 9; i < 14; ++i) x[i] = 0;
+    x[14] = OT_SHA256_SIZE * 8;
+    x[15] = 0;
+
+    const uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+                           0xc3d2e1f0};
+    uint32_t left[5], right[5];
+    memcpy(left, h, sizeof(left));
+    memcpy(right, h, sizeof(right));
+
+    ripemd_group<0>(x, left, right);
+    ripemd_group<1>(x, left, right);
+    ripemd_group<2>(x, left, right);
+    ripemd_group<3>(x, left, right);
+    ripemd_group<4>(x, left, right);
+
+    store_le32(pOutput, h[1] + left[2] + right[3]);
+    store_le32(pOutput + 4, h[2] + left[3] + right[4]);
+    store_le32(pOutput + 8, h[3] + left[4] + right[0]);
+    store_le32(pOutput + 12, h[4] + left[0] + right[1]);
+    store_le32(pOutput + 16, h[0] + left[1] + right[2]);
+}
+
+#if defined(OT_HASH160_X86)
+
+// The SHA extensions keep the state as ABEF and CDGH, and do two rounds per
+// sha256rnds2. The message schedule for four words at a time is
+// msg2(msg1(W[-16], W[-12]) + W[-7..-4], W[-4]).
+__attribute__((target("sha,sse4.1"))) void blocks_shani(
+    uint32_t* state, const uint8_t* pBlocks, size_t nBlocks)
+{
+    const __m128i mask =
+        _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<__m128i*>(state));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<__m128i*>(state + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xb1); // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1b); // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0); // CDGH
+
+    for (size_t n = 0; n < nBlocks; ++n, pBlocks += 64) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+        __m128i w[4];
+
+        for (int i = 0; i < 16; ++i) {
+            __m128i& cur = w[i & 3];
+
+            if (i < 4) {
+                cur = _mm_shuffle_epi8(
+                    _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(pBlocks + 16 * i)),
+                    mask);
+            }
+            else {
+                const __m128i& prev = w[(i - 1) & 3];
+                cur = _mm_sha256msg2_epu32(
+                    _mm_add_epi32(
+                        _mm_sha256msg1_epu32(cur, w[(i - 3) & 3]),
+                        _mm_alignr_epi8(prev, w[(i - 2) & 3], 4)),
+                    prev);
+            }
+
+            __m128i msg = _mm_add_epi32(
+                cur, _mm_loadu_si128(
+                         reinterpret_cast<const __m128i*>(s_sha256K + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b); // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1); // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0); // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8); // HGFE
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+template <int n>
+__attribute__((target("avx2"))) inline __m256i rotr8(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                           _mm256_slli_epi32(x, 32 - n));
+}
+
+// One block for each of eight independent hashes, one per lane.
+__attribute__((target("avx2"))) void compress_avx2(__m256i* state,
+                                                   __m256i* w)
+{
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3],
+            e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(
+                _mm256_xor_si256(rotr8<7>(w15), rotr8<18>(w15)),
+                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(
+                _mm256_xor_si256(rotr8<17>(w2), rotr8<19>(w2)),
+                _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(
+                _mm256_add_epi32(w[t & 15], s0),
+                _mm256_add_epi32(w[(t - 7) & 15], s1));
+        }
+
+        const __m256i sigma1 = _mm256_xor_si256(
+            _mm256_xor_si256(rotr8<6>(e), rotr8<11>(e)), rotr8<25>(e));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f),
+                                            _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(h, sigma1), ch),
+            _mm256_add_epi32(
+                _mm256_set1_epi32(static_cast<int>(s_sha256K[t])),
+                w[t & 15]));
+        const __m256i sigma0 = _mm256_xor_si256(
+            _mm256_xor_si256(rotr8<2>(a), rotr8<13>(a)), rotr8<22>(a));
+        const __m256i maj = _mm256_or_si256(
+            _mm256_and_si256(a, b),
+            _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, _mm256_add_epi32(sigma0, maj));
+    }
+
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+    state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g);
+    state[7] = _mm256_add_epi32(state[7], h);
+}
+
+// Lanes run in lockstep, one block per round, until the longest input is
+// done. A lane whose input has run out hashes zeros; its digest was already
+// taken after its own last block.
+__attribute__((target("avx2"))) void batch_avx2(const uint8_t* const* ppInputs,
+                                                const size_t* pSizes,
+                                                size_t nCount,
+                                                uint8_t* pOutput)
+{
+    static const uint8_t s_zeros[64] = {0};
+
+    uint8_t tail[OT_HASH160_LANES][128];
+    size_t nFull[OT_HASH160_LANES] = {0};
+    size_t nTotal[OT_HASH160_LANES] = {0};
+    size_t nMax = 0;
+
+    for (size_t lane = 0; lane < nCount; ++lane) {
+        nFull[lane] = pSizes[lane] / 64;
+        nTotal[lane] =
+            nFull[lane] + pad_tail(ppInputs[lane], pSizes[lane], tail[lane]);
+        nMax = std::max(nMax, nTotal[lane]);
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi32(static_cast<int>(s_sha256Init[i]));
+    }
+
+    for (size_t n = 0; n < nMax; ++n) {
+        const uint8_t* p[OT_HASH160_LANES];
+
+        for (size_t lane = 0; lane < OT_HASH160_LANES; ++lane) {
+            if (n < nFull[lane])
+                p[lane] = ppInputs[lane] + 64 * n;
+            else if (n < nTotal[lane])
+                p[lane] = tail[lane] + 64 * (n - nFull[lane]);
+            else
+                p[lane] = s_zeros;
+        }
+
+        __m256i w[16];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = _mm256_set_epi32(
+                static_cast<int>(load_be32(p[7] + 4 * t)),
+                static_cast<int>(load_be32(p[6] + 4 * t)),
+                static_cast<int>(load_be32(p[5] + 4 * t)),
+                static_cast<int>(load_be32(p[4] + 4 * t)),
+                static_cast<int>(load_be32(p[3] + 4 * t)),
+                static_cast<int>(load_be32(p[2] + 4 * t)),
+                static_cast<int>(load_be32(p[1] + 4 * t)),
+                static_cast<int>(load_be32(p[0] + 4 * t)));
+        }
+
+        compress_avx2(state, w);
+
+        bool bFinished = false;
+        for (size_t lane = 0; lane < nCount; ++lane) {
+            if (nTotal[lane] == n + 1) bFinished = true;
+        }
+
+        if (!bFinished) continue;
+
+        uint32_t words[8][OT_HASH160_LANES];
+        for (int i = 0; i < 8; ++i) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(words[i]),
+                                state[i]);
+        }
+
+        for (size_t lane = 0; lane < nCount; ++lane) {
+            if (nTotal[lane] != n + 1) continue;
+
+            for (int i = 0; i < 8; ++i) {
+                store_be32(pOutput + lane * OT_SHA256_SIZE + 4 * i,
+                           words[i][lane]);
+            }
+        }
+    }
+}
+
+bool cpu_supports_sha()
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+
+    __builtin_cpu_init();
+
+    return (0 != (ebx & (1u << 29))) && __builtin_cpu_supports("sse4.1");
+}
+
+#endif // OT_HASH160_X86
+
+const Hash160Implementation s_scalar = {"scalar", blocks_scalar, nullptr};
+#if defined(OT_HASH160_X86)
+const Hash160Implementation s_avx2 = {"avx2", blocks_scalar, batch_avx2};
+const Hash160Implementation s_shani = {"shani", blocks_shani, nullptr};
+#endif
+
+const Hash160Implementation* best_implementation()
+{
+#if defined(OT_HASH160_X86)
+    __builtin_cpu_init();
+
+    if (cpu_supports_sha()) return &s_shani;
+    if (__builtin_cpu_supports("avx2")) return &s_avx2;
+#endif
+
+    return &s_scalar;
+}
+
+const Hash160Implementation*& active_implementation()
+{
+    static const Hash160Implementation* pImplementation =
+        best_implementation();
+
+    return pImplementation;
+}
+
+} // namespace
+
+// static
+void OTHash160::Digest(const uint8_t* pInput, size_t lSize, uint8_t* pOutput)
+{
+    uint8_t sha[OT_SHA256_SIZE];
+    sha256(active_implementation()->blocks, pInput, lSize, sha);
+    ripemd160_of_sha256(sha, pOutput);
+}
+
+// static
+void OTHash160::Digest(const uint8_t* const* ppInputs, const size_t* pSizes,
+                       size_t nCount, uint8_t* pOutput)
+{
+    const Hash160Implementation* pImplementation = active_implementation();
+
+    if (nullptr == pImplementation->batch) {
+        for (size_t i = 0; i < nCount; ++i) {
+            Digest(ppInputs[i], pSizes[i], pOutput + i * DigestSize);
+        }
+
+        return;
+    }
+
+    uint8_t sha[OT_HASH160_LANES * OT_SHA256_SIZE];
+
+    for (size_t first = 0; first < nCount; first += OT_HASH160_LANES) {
+        const size_t nLanes = std::min(OT_HASH160_LANES, nCount - first);
+        pImplementation->batch(ppInputs + first, pSizes + first, nLanes, sha);
+
+        for (size_t lane = 0; lane < nLanes; ++lane) {
+            ripemd160_of_sha256(sha + lane * OT_SHA256_SIZE,
+                                pOutput + (first + lane) * DigestSize);
+        }
+    }
+}
+
+// static
+const char* OTHash160::Implementation()
+{
+    return active_implementation()->name;
+}
+
+// static
+bool OTHash160::SetImplementation(const char* szName)
+{
+    if (nullptr == szName) return false;
+
+    const Hash160Implementation* pChoice = nullptr;
+
+    if (0 == strcmp(szName, s_scalar.name)) pChoice = &s_scalar;
+#if defined(OT_HASH160_X86)
+    __builtin_cpu_init();
+
+    if ((0 == strcmp(szName, s_avx2.name)) && __builtin_cpu_supports("avx2"))
+        pChoice = &s_avx2;
+    if ((0 == strcmp(szName, s_shani.name)) && cpu_supports_sha())
+        pChoice = &s_shani;
+#endif
+
+    if (nullptr == pChoice) return false;
+
+    active_implementation() = pChoice;
+
+    return true;
+}
+
+} // namespace opentxs
@@ -216,11 +216,18 @@ void OTKeyCredential::Release_Subkey()
     // Release any dynamically allocated members here. (Normally.)
 }
 
-bool OTKeyCredential::GenerateKeys(int32_t nBits) // Gotta start
-                                                  // somewhere.
+bool OTKeyCredential::GenerateKeys(
+    int32_t nBits, // Gotta start somewhere.
+    OTAsymmetricKey::KeyType eSigningKeyType)
 {
-    const bool bSign = m_SigningKey.MakeNewKeypair(nBits);
-    const bool bAuth = m_AuthentKey.MakeNewKeypair(nBits);
+    if (!OTAsymmetricKey::IsKeyTypeSupported(eSigningKeyType)) {
+        otErr << __FUNCTION__ << ": This build doesn't support key type "
+              << eSigningKeyType << ".\n";
+        return false;
+    }
+
+    const bool bSign = m_SigningKey.MakeNewKeypair(nBits, eSigningKeyType);
+    const bool bAuth = m_AuthentKey.MakeNewKeypair(nBits, eSigningKeyType);
     const bool bEncr = m_EncryptKey.MakeNewKeypair(nBits);
 
     OT_ASSERT(bSign && bAuth && bEncr);
@@ -62,6 +62,10 @@
 #include <opentxs/core/crypto/OTSignature.hpp>
 #include <opentxs/core/OTStorage.hpp>
 
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+#include <opentxs/core/crypto/OTAsymmetricKeyEd25519.hpp>
+#endif
+
 // DONE: Add OTKeypair member for m_pMetadata.
 // Add method to set the Metadata. Or instead of a member,
 // just have the method set the public and private keys.
@@ -103,6 +107,42 @@ OTKeypair::~OTKeypair()
     m_pkeyPrivate = nullptr;
 }
 
+// static
+bool OTKeypair::SetKeyType(OTAsymmetricKey*& pKey,
+                           OTAsymmetricKey::KeyType eKeyType)
+{
+    OT_ASSERT(nullptr != pKey);
+
+    if (eKeyType == pKey->GetKeyType()) return true;
+
+    OTAsymmetricKey* pNewKey = OTAsymmetricKey::KeyFactory(eKeyType);
+
+    if (nullptr == pNewKey) return false;
+
+    *(pNewKey->m_pMetadata) = *(pKey->m_pMetadata);
+    delete pKey;
+    pKey = pNewKey;
+
+    return true;
+}
+
+// static
+bool OTKeypair::SetKeyType(OTAsymmetricKey*& pKey, const String& strKey)
+{
+    // Ed25519 bookends are "ED25519 PUBLIC KEY" and "ENCRYPTED ED25519 PRIVATE
+    // KEY". Anything else is OpenSSL's.
+    return SetKeyType(pKey, strKey.Contains("ED25519 ")
+                                ? OTAsymmetricKey::ED25519
+                                : OTAsymmetricKey::RSA);
+}
+
+OTAsymmetricKey::KeyType OTKeypair::GetKeyType() const
+{
+    OT_ASSERT(nullptr != m_pkeyPublic);
+
+    return m_pkeyPublic->GetKeyType();
+}
+
 void OTKeypair::SetMetadata(const OTSignatureMetadata& theMetadata)
 {
     OT_ASSERT(nullptr != m_pkeyPublic);
@@ -305,6 +345,8 @@ bool OTKeypair::LoadPrivateKeyFromCertString(const String& strCert,
 {
     OT_ASSERT(nullptr != m_pkeyPrivate);
 
+    if (!SetKeyType(m_pkeyPrivate, strCert)) return false;
+
     return m_pkeyPrivate->LoadPrivateKeyFromCertString(
         strCert, bEscaped, pstrReason, pImportPassword);
 }
@@ -317,6 +359,8 @@ bool OTKeypair::LoadPublicKeyFromCertString(
 {
     OT_ASSERT(nullptr != m_pkeyPublic);
 
+    if (!SetKeyType(m_pkeyPublic, strCert)) return false;
+
     return m_pkeyPublic->LoadPublicKeyFromCertString(
         strCert, bEscaped, pstrReason, pImportPassword);
 }
@@ -332,11 +376,26 @@ bool OTKeypair::LoadPublicKeyFromCertFile(
                                                    pstrReason, pImportPassword);
 }
 
-bool OTKeypair::MakeNewKeypair(int32_t nBits/*=1024*/)
+bool OTKeypair::MakeNewKeypair(int32_t nBits,
+                               OTAsymmetricKey::KeyType eKeyType)
 {
     OT_ASSERT(nullptr != m_pkeyPrivate);
     OT_ASSERT(nullptr != m_pkeyPublic);
 
+    if (!SetKeyType(m_pkeyPublic, eKeyType) ||
+        !SetKeyType(m_pkeyPrivate, eKeyType)) {
+        otErr << "OTKeypair::MakeNewKeypair"
+              << ": Unsupported key type: " << eKeyType << "\n";
+        return false;
+    }
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+    if (OTAsymmetricKey::ED25519 == eKeyType)
+        return OTAsymmetricKey_Ed25519::MakeNewKeypair(
+            *dynamic_cast<OTAsymmetricKey_Ed25519*>(m_pkeyPublic),
+            *dynamic_cast<OTAsymmetricKey_Ed25519*>(m_pkeyPrivate));
+#endif
+
     OTLowLevelKeyData lowLevelData;
     
 //    lowLevelData.bits = nBits;
@@ -456,7 +515,8 @@ bool OTKeypair::SetPublicKey(const String& strKey, bool bEscaped)
     else // the below function SetPublicKey (in the return call) expects the
         // bookends to still be there, and it will handle removing them. (Unlike
         // PGP code above.)
-        return m_pkeyPublic->SetPublicKey(strKey, bEscaped);
+        return SetKeyType(m_pkeyPublic, strKey) &&
+               m_pkeyPublic->SetPublicKey(strKey, bEscaped);
 }
 
 // PRIVATE KEY
@@ -523,7 +583,8 @@ bool OTKeypair::SetPrivateKey(const String& strKey, bool bEscaped)
         // bookends to still be there, and it will handle removing them. (Unlike
         // PGP code above.)
         //
-        return m_pkeyPrivate->SetPrivateKey(strKey, bEscaped);
+        return SetKeyType(m_pkeyPrivate, strKey) &&
+               m_pkeyPrivate->SetPrivateKey(strKey, bEscaped);
 }
 
 bool OTKeypair::SetPrivateKey(const OTASCIIArmor& strKey) // Decodes a private
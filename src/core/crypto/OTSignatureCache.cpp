@@ -0,0 +1,176 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Each entry is a 32 byte key plus list and hash node overhead, so the
+// default costs around 1 MB and covers the working set of a busy notary.
+//
+#define OT_SIGNATURE_CACHE_DEFAULT_CAPACITY 8192
+
+namespace opentxs
+{
+
+namespace
+{
+
+typedef std::list<std::string> listOfKeys;
+typedef std::unordered_map<std::string, listOfKeys::iterator> mapOfEntries;
+
+std::mutex s_mutex;
+listOfKeys s_listRecent; // most recently used at the front
+mapOfEntries s_mapEntries;
+int64_t s_lCapacity = OT_SIGNATURE_CACHE_DEFAULT_CAPACITY;
+
+std::atomic<bool> s_bEnabled(true);
+std::atomic<uint64_t> s_lHits(0);
+std::atomic<uint64_t> s_lMisses(0);
+
+// Caller must hold s_mutex.
+void trim(int64_t lCapacity)
+{
+    while (static_cast<int64_t>(s_listRecent.size()) > lCapacity) {
+        s_mapEntries.erase(s_listRecent.back());
+        s_listRecent.pop_back();
+    }
+}
+
+} // namespace
+
+bool OTSignatureCache::Lookup(const std::string& strKey)
+{
+    if (!s_bEnabled) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        auto it = s_mapEntries.find(strKey);
+
+        if (s_mapEntries.end() != it) {
+            s_listRecent.splice(s_listRecent.begin(), s_listRecent, it->second);
+            ++s_lHits;
+
+            return true;
+        }
+    }
+
+    ++s_lMisses;
+
+    return false;
+}
+
+void OTSignatureCache::Insert(const std::string& strKey)
+{
+    if (!s_bEnabled) return;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (s_lCapacity < 1) return;
+
+    auto it = s_mapEntries.find(strKey);
+
+    if (s_mapEntries.end() != it) {
+        s_listRecent.splice(s_listRecent.begin(), s_listRecent, it->second);
+        return;
+    }
+
+    s_listRecent.push_front(strKey);
+    s_mapEntries[strKey] = s_listRecent.begin();
+    trim(s_lCapacity);
+}
+
+void OTSignatureCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    s_mapEntries.clear();
+    s_listRecent.clear();
+}
+
+bool OTSignatureCache::IsEnabled()
+{
+    return s_bEnabled;
+}
+
+void OTSignatureCache::SetEnabled(bool bEnabled)
+{
+    s_bEnabled = bEnabled;
+
+    if (!bEnabled) Clear();
+}
+
+int64_t OTSignatureCache::GetCapacity()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    return s_lCapacity;
+}
+
+void OTSignatureCache::SetCapacity(int64_t lCapacity)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    s_lCapacity = (lCapacity > 0) ? lCapacity : 0;
+    trim(s_lCapacity);
+}
+
+int64_t OTSignatureCache::Size()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    return static_cast<int64_t>(s_listRecent.size());
+}
+
+uint64_t OTSignatureCache::Hits()
+{
+    return s_lHits;
+}
+
+uint64_t OTSignatureCache::Misses()
+{
+    return s_lMisses;
+}
+
+} // namespace opentxs
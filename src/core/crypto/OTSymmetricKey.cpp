@@ -382,8 +382,10 @@ OTPassword* OTSymmetricKey::CalculateDerivedKeyFromPassphrase(
         }
     }
 
-    pDerivedKey = OTCrypto::It()->DeriveNewKey(
-        thePassphrase, m_dataSalt, m_uIterationCount, tmpDataHashCheck);
+    pDerivedKey = OTCrypto::It()->DeriveNewKey(thePassphrase, m_dataSalt,
+                                               m_uIterationCount,
+                                               tmpDataHashCheck,
+                                               m_bCacheDerivedKey);
 
     return pDerivedKey; // can be null
 }
@@ -400,7 +402,8 @@ OTPassword* OTSymmetricKey::CalculateNewDerivedKeyFromPassphrase(
         m_dataHashCheck.zeroMemory();
 
         pDerivedKey = OTCrypto::It()->DeriveNewKey(
-            thePassphrase, m_dataSalt, m_uIterationCount, m_dataHashCheck);
+            thePassphrase, m_dataSalt, m_uIterationCount, m_dataHashCheck,
+            m_bCacheDerivedKey);
     }
     else {
         otErr << __FUNCTION__
@@ -1127,6 +1130,7 @@ OTSymmetricKey::OTSymmetricKey()
     , m_nKeySize(OTCryptoConfig::SymmetricKeySize() * 8)
     , // 128 (in bits)
     m_uIterationCount(OTCryptoConfig::IterationCount())
+    , m_bCacheDerivedKey(true)
 {
 }
 
@@ -1136,6 +1140,7 @@ OTSymmetricKey::OTSymmetricKey(const OTPassword& thePassword)
     , m_nKeySize(OTCryptoConfig::SymmetricKeySize() * 8)
     , // 128 (in bits)
     m_uIterationCount(OTCryptoConfig::IterationCount())
+    , m_bCacheDerivedKey(true)
 {
     //  const bool bGenerated =
     GenerateKey(thePassword);
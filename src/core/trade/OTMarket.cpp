@@ -43,7 +43,7 @@
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/Account.hpp>
 #include <opentxs/core/Ledger.hpp>
-#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Nym.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
@@ -150,15 +150,18 @@ void OTMarket::UpdateContents()
         INSTRUMENT_DEFINITION_ID(m_INSTRUMENT_DEFINITION_ID),
         CURRENCY_TYPE_ID(m_CURRENCY_TYPE_ID);
 
-    Tag tag("market");
-
-    tag.add_attribute("version", m_strVersion.Get());
-    tag.add_attribute("notaryID", NOTARY_ID.Get());
-    tag.add_attribute("instrumentDefinitionID", INSTRUMENT_DEFINITION_ID.Get());
-    tag.add_attribute("currencyTypeID", CURRENCY_TYPE_ID.Get());
-    tag.add_attribute("marketScale", formatLong(m_lScale));
-    tag.add_attribute("lastSaleDate", m_strLastSaleDate);
-    tag.add_attribute("lastSalePrice", formatLong(m_lLastSalePrice));
+    std::string str_result;
+    XmlWriter writer(str_result);
+
+    writer.open_element("market");
+    writer.add_attribute("version", m_strVersion.Get());
+    writer.add_attribute("notaryID", NOTARY_ID.Get());
+    writer.add_attribute("instrumentDefinitionID",
+                         INSTRUMENT_DEFINITION_ID.Get());
+    writer.add_attribute("currencyTypeID", CURRENCY_TYPE_ID.Get());
+    writer.add_attribute("marketScale", formatLong(m_lScale));
+    writer.add_attribute("lastSaleDate", m_strLastSaleDate);
+    writer.add_attribute("lastSalePrice", formatLong(m_lLastSalePrice));
 
     // Save the offers for sale.
     for (auto& it : m_mapAsks) {
@@ -169,10 +172,11 @@ void OTMarket::UpdateContents()
             *pOffer); // Extract the offer contract into string form.
         OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
 
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
-        tagOffer->add_attribute(
+        writer.open_element("offer");
+        writer.add_attribute(
             "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
-        tag.add_tag(tagOffer);
+        writer.set_text(ascOffer.Get());
+        writer.close_element();
     }
 
     // Save the bids.
@@ -184,16 +188,16 @@ void OTMarket::UpdateContents()
             *pOffer); // Extract the offer contract into string form.
         OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
 
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
-        tagOffer->add_attribute(
+        writer.open_element("offer");
+        writer.add_attribute(
             "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
-        tag.add_tag(tagOffer);
+        writer.set_text(ascOffer.Get());
+        writer.close_element();
     }
 
-    std::string str_result;
-    tag.output(str_result);
+    writer.close_element();
 
-    m_xmlUnsigned.Concatenate("%s", str_result.c_str());
+    m_xmlUnsigned.Set(str_result.c_str());
 }
 
 int64_t OTMarket::GetTotalAvailableAssets()
@@ -2370,7 +2374,7 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
     //
     if ((0 == lRelevantPrice) && // Market order has 0 price.
         theOffer.IsMarketOrder()) {
-        otInfo << "OTMarket::" << __FUNCTION__ << ": Removing market order that has 0 price: "
+        OT_LOG(2) << "OTMarket::" << __FUNCTION__ << ": Removing market order that has 0 price: "
             << formatLong(theTrade.GetOpeningNum()) << "\n";
         return false;
     }
@@ -2486,7 +2490,7 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
                 (theOffer.GetMinimumIncrement() >
                  theOffer.GetAmountAvailable())) {
                     
-                    otInfo << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
+                    OT_LOG(2) << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
                         << formatLong(theTrade.GetOpeningNum()) << ". IsFlaggedForRemoval: "
                         << formatBool(theTrade.IsFlaggedForRemoval())
                         << ". Minimum increment is larger than Amount available: "
@@ -2571,7 +2575,7 @@ bool OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer)
                 (theOffer.GetMinimumIncrement() >
                  theOffer.GetAmountAvailable())) {
                     
-                    otInfo << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
+                    OT_LOG(2) << "OTMarket::" << __FUNCTION__ << ": Removing market order: "
                         << formatLong(theTrade.GetOpeningNum()) << ". IsFlaggedForRemoval: "
                         << formatBool(theTrade.IsFlaggedForRemoval())
                         << ". Minimum increment is larger than Amount available: "
@@ -0,0 +1,85 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/LatencyHistogram.hpp>
+
+#include <opentxs/core/util/Common.hpp>
+
+namespace opentxs
+{
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets()
+    , m_lTotalMicros(0)
+    , m_lMaxMicros(0)
+{
+}
+
+void LatencyHistogram::Add(int64_t lMicros)
+{
+    int32_t nBucket = 0;
+
+    while ((nBucket < Buckets - 1) && ((lMicros >> (nBucket + 1)) > 0)) {
+        ++nBucket;
+    }
+
+    ++m_buckets[nBucket];
+    m_lTotalMicros += lMicros;
+
+    if (lMicros > m_lMaxMicros) m_lMaxMicros = lMicros;
+}
+
+std::string LatencyHistogram::FormatBuckets() const
+{
+    int32_t nCount = Buckets;
+
+    while ((nCount > 0) && (0 == m_buckets[nCount - 1])) --nCount;
+
+    std::string strOutput;
+
+    for (int32_t i = 0; i < nCount; ++i) {
+        if (i > 0) strOutput += ",";
+        strOutput += formatUlong(m_buckets[i]);
+    }
+
+    return strOutput;
+}
+
+} // namespace opentxs
@@ -0,0 +1,274 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/LogSink.hpp>
+#include <opentxs/core/Log.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace opentxs
+{
+
+const size_t LogSink::RingSize;
+const size_t LogSink::BatchBytes;
+const int64_t LogSink::IdleMilliseconds;
+
+LogRing::LogRing(size_t lCapacity)
+    : m_lCapacity(lCapacity)
+    , m_pSlots(new Slot[lCapacity])
+    , m_lHead(0)
+    , m_lTail(0)
+{
+    OT_ASSERT((0 < lCapacity) && (0 == (lCapacity & (lCapacity - 1))));
+
+    for (size_t i = 0; i < m_lCapacity; ++i) m_pSlots[i].m_lSeq = i;
+}
+
+bool LogRing::Push(const char* szText, bool bMemlog)
+{
+    size_t lPos = m_lTail.load(std::memory_order_relaxed);
+    Slot* pSlot = nullptr;
+
+    for (;;) {
+        pSlot = &m_pSlots[lPos & (m_lCapacity - 1)];
+        const size_t lSeq = pSlot->m_lSeq.load(std::memory_order_acquire);
+        const auto lDiff = static_cast<std::ptrdiff_t>(lSeq - lPos);
+
+        if (0 == lDiff) {
+            if (m_lTail.compare_exchange_weak(lPos, lPos + 1,
+                                              std::memory_order_relaxed))
+                break;
+        }
+        else if (lDiff < 0) {
+            return false; // full
+        }
+        else {
+            lPos = m_lTail.load(std::memory_order_relaxed);
+        }
+    }
+
+    pSlot->m_strText.assign(szText);
+    pSlot->m_bMemlog = bMemlog;
+    pSlot->m_lSeq.store(lPos + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool LogRing::Pop(std::string& strText, bool& bMemlog)
+{
+    Slot& theSlot = m_pSlots[m_lHead & (m_lCapacity - 1)];
+
+    if (theSlot.m_lSeq.load(std::memory_order_acquire) != m_lHead + 1)
+        return false;
+
+    strText.swap(theSlot.m_strText);
+    bMemlog = theSlot.m_bMemlog;
+    theSlot.m_lSeq.store(m_lHead + m_lCapacity, std::memory_order_release);
+    ++m_lHead;
+
+    return true;
+}
+
+LogSink::LogSink(size_t lRingSize, Writer theWriter)
+    : m_theRing(lRingSize)
+    , m_theWriter(theWriter)
+    , m_bRunning(false)
+    , m_nPushing(0)
+    , m_bIdle(false)
+    , m_lQueued(0)
+    , m_lWritten(0)
+    , m_lDropped(0)
+    , m_bWriterRunning(false)
+    , m_bStopping(false)
+    , m_lDroppedReported(0)
+{
+}
+
+LogSink::~LogSink()
+{
+    Stop();
+}
+
+bool LogSink::Push(const char* szText, bool bMemlog)
+{
+    ++m_nPushing;
+
+    if (!m_bRunning) {
+        --m_nPushing;
+        return false;
+    }
+
+    if (m_theRing.Push(szText, bMemlog))
+        ++m_lQueued;
+    else
+        ++m_lDropped;
+
+    --m_nPushing;
+
+    // Without taking the mutex a wakeup can be missed; the writer
+    // doesn't sleep longer than IdleMilliseconds anyway.
+    if (m_bIdle) m_cvWork.notify_one();
+
+    return true;
+}
+
+void LogSink::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Still draining after a Stop() on another thread.
+    if (m_theThread.joinable() || m_bWriterRunning) return;
+
+    m_bStopping = false;
+    m_bWriterRunning = true;
+    m_theThread = std::thread(&LogSink::Run, this);
+    m_writerID = m_theThread.get_id();
+    m_bRunning = true;
+}
+
+void LogSink::Stop()
+{
+    std::thread theThread;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_theThread.joinable()) return;
+
+        m_bRunning = false;
+        theThread.swap(m_theThread);
+    }
+
+    // Let pushes that got in before m_bRunning went false finish.
+    while (0 < m_nPushing) std::this_thread::yield();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStopping = true;
+    }
+
+    m_cvWork.notify_one();
+    theThread.join();
+}
+
+void LogSink::Flush()
+{
+    const uint64_t lTarget = m_lQueued;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cvWritten.wait_for(lock, std::chrono::seconds(1), [&]() {
+        return !m_bWriterRunning || (m_lWritten >= lTarget) ||
+               (std::this_thread::get_id() == m_writerID);
+    });
+}
+
+void LogSink::Write(std::ofstream& logfile, const std::string& strBatch)
+{
+    if (m_theWriter) {
+        m_theWriter(strBatch);
+        return;
+    }
+
+    std::cerr.write(strBatch.data(), strBatch.size());
+    std::cerr.flush();
+
+    if (logfile.is_open()) {
+        logfile.write(strBatch.data(), strBatch.size());
+        logfile.flush();
+    }
+}
+
+void LogSink::Run()
+{
+    std::ofstream logfile;
+    std::string strBatch;
+    std::string strLine;
+    bool bMemlog = false;
+
+    if (!m_theWriter && Log::IsInitialized() &&
+        Log::GetLogFilePath().Exists())
+        logfile.open(Log::LogFilePath(), std::ios::app);
+
+    for (;;) {
+        uint64_t lLines = 0;
+        strBatch.clear();
+
+        while ((strBatch.size() < BatchBytes) &&
+               m_theRing.Pop(strLine, bMemlog)) {
+            if (bMemlog && !m_theWriter && Log::IsInitialized())
+                Log::PushMemlogFront(strLine.c_str());
+
+            strBatch += strLine;
+            ++lLines;
+        }
+
+        const uint64_t lDropped = m_lDropped;
+
+        if (lDropped != m_lDroppedReported) {
+            strBatch += std::to_string(lDropped - m_lDroppedReported) +
+                        " log messages dropped: log ring full\n";
+            m_lDroppedReported = lDropped;
+        }
+
+        if (!strBatch.empty()) Write(logfile, strBatch);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (0 < lLines) {
+            m_lWritten += lLines;
+            m_cvWritten.notify_all();
+            continue;
+        }
+
+        if (m_bStopping) {
+            m_bWriterRunning = false;
+            m_cvWritten.notify_all();
+            return;
+        }
+
+        m_bIdle = true;
+        m_cvWork.wait_for(lock, std::chrono::milliseconds(IdleMilliseconds));
+        m_bIdle = false;
+    }
+}
+
+} // namespace opentxs
@@ -66,6 +66,7 @@
 #define DEFAULT_CREDENTIAL "credentials"
 #define DEFAULT_CRON "cron"
 #define DEFAULT_INBOX "inbox"
+#define DEFAULT_MAIL "mail"
 #define DEFAULT_MARKET "markets"
 #define DEFAULT_MINT "mints"
 #define DEFAULT_NYM "nyms"
@@ -81,6 +82,7 @@
 #define DEFAULT_SCRIPT "scripts"
 #define DEFAULT_SMARTCONTRACTS "smartcontracts"
 #define DEFAULT_SPENT "spent"
+#define DEFAULT_STATS "stats"
 #define DEFAULT_USERACCT "useraccounts"
 
 #define KEY_ACCOUNT "account"
@@ -89,6 +91,7 @@
 #define KEY_CREDENTIAL "credential"
 #define KEY_CRON "cron"
 #define KEY_INBOX "inbox"
+#define KEY_MAIL "mail"
 #define KEY_MARKET "market"
 #define KEY_MINT "mint"
 #define KEY_NYM "nym"
@@ -104,6 +107,7 @@
 #define KEY_SCRIPT "script"
 #define KEY_SMARTCONTRACTS "smartcontracts"
 #define KEY_SPENT "spent"
+#define KEY_STATS "stats"
 #define KEY_USERACCT "useracct"
 
 namespace opentxs
@@ -115,6 +119,7 @@ String OTFolders::s_strContract("");
 String OTFolders::s_strCredential("");
 String OTFolders::s_strCron("");
 String OTFolders::s_strInbox("");
+String OTFolders::s_strMail("");
 String OTFolders::s_strMarket("");
 String OTFolders::s_strMint("");
 String OTFolders::s_strNym("");
@@ -130,6 +135,7 @@ String OTFolders::s_strExpiredBox("");
 String OTFolders::s_strScript("");
 String OTFolders::s_strSmartContracts("");
 String OTFolders::s_strSpent("");
+String OTFolders::s_strStats("");
 String OTFolders::s_strUserAcct("");
 
 bool OTFolders::GetSetAll()
@@ -154,6 +160,8 @@ bool OTFolders::GetSetAll()
         return false;
     if (!GetSetFolderName(config, KEY_INBOX, DEFAULT_INBOX, s_strInbox))
         return false;
+    if (!GetSetFolderName(config, KEY_MAIL, DEFAULT_MAIL, s_strMail))
+        return false;
     if (!GetSetFolderName(config, KEY_MARKET, DEFAULT_MARKET, s_strMarket))
         return false;
     if (!GetSetFolderName(config, KEY_MINT, DEFAULT_MINT, s_strMint))
@@ -187,6 +195,8 @@ bool OTFolders::GetSetAll()
         return false;
     if (!GetSetFolderName(config, KEY_SPENT, DEFAULT_SPENT, s_strSpent))
         return false;
+    if (!GetSetFolderName(config, KEY_STATS, DEFAULT_STATS, s_strStats))
+        return false;
     if (!GetSetFolderName(config, KEY_USERACCT, DEFAULT_USERACCT,
                           s_strUserAcct))
         return false;
@@ -222,6 +232,10 @@ const String& OTFolders::Inbox()
 {
     return GetFolder(s_strInbox);
 }
+const String& OTFolders::Mail()
+{
+    return GetFolder(s_strMail);
+}
 const String& OTFolders::Market()
 {
     return GetFolder(s_strMarket);
@@ -282,6 +296,10 @@ const String& OTFolders::Spent()
 {
     return GetFolder(s_strSpent);
 }
+const String& OTFolders::Stats()
+{
+    return GetFolder(s_strStats);
+}
 const String& OTFolders::UserAcct()
 {
     return GetFolder(s_strUserAcct);
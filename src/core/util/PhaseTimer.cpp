@@ -0,0 +1,136 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/PhaseTimer.hpp>
+
+#include <chrono>
+
+namespace opentxs
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct ThreadPhases
+{
+    bool m_bActive;
+    PhaseTimer::Phase m_eCurrent;
+    Clock::time_point m_since;
+    PhaseTimer::Durations m_durations;
+};
+
+thread_local ThreadPhases t_phases = {false, PhaseTimer::PROCESS,
+                                      Clock::time_point(), {{}}};
+
+// Charges the time since the last switch to the current phase.
+void charge(ThreadPhases& thePhases)
+{
+    const Clock::time_point now = Clock::now();
+
+    thePhases.m_durations[thePhases.m_eCurrent] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now -
+                                                             thePhases.m_since)
+            .count();
+    thePhases.m_since = now;
+}
+
+} // namespace
+
+PhaseTimer::Scope::Scope(Phase ePhase)
+    : m_ePrevious(PROCESS)
+    , m_bActive(t_phases.m_bActive)
+{
+    if (!m_bActive) return;
+
+    charge(t_phases);
+    m_ePrevious = t_phases.m_eCurrent;
+    t_phases.m_eCurrent = ePhase;
+}
+
+PhaseTimer::Scope::~Scope()
+{
+    // Begin() or End() may have run in between.
+    if (!m_bActive || !t_phases.m_bActive) return;
+
+    charge(t_phases);
+    t_phases.m_eCurrent = m_ePrevious;
+}
+
+// static
+void PhaseTimer::Begin()
+{
+    t_phases.m_bActive = true;
+    t_phases.m_eCurrent = PROCESS;
+    t_phases.m_since = Clock::now();
+    t_phases.m_durations.fill(0);
+}
+
+// static
+PhaseTimer::Durations PhaseTimer::End()
+{
+    if (t_phases.m_bActive) charge(t_phases);
+
+    t_phases.m_bActive = false;
+
+    return t_phases.m_durations;
+}
+
+// static
+const char* PhaseTimer::Name(Phase ePhase)
+{
+    switch (ePhase) {
+    case PROCESS:
+        return "process";
+    case VERIFY:
+        return "verify";
+    case LOAD:
+        return "load";
+    case SIGN:
+        return "sign";
+    case SAVE:
+        return "save";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace opentxs
@@ -0,0 +1,268 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/Trace.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace opentxs
+{
+
+namespace
+{
+
+struct TraceEvent
+{
+    const char* m_szName;
+    int64_t m_lStart;    // ns
+    int64_t m_lDuration; // ns, -1 while the span is open
+    std::vector<std::pair<const char*, std::string>> m_args;
+};
+
+struct ThreadTrace
+{
+    std::vector<TraceEvent> m_events;
+    int64_t m_lDropped;
+    int32_t m_nThread;
+
+    ThreadTrace()
+        : m_lDropped(0)
+        , m_nThread(0)
+    {
+    }
+};
+
+std::atomic<int32_t> s_nSampleRate(0);
+std::atomic<uint64_t> s_lRequests(0);
+std::atomic<int32_t> s_nNextThread(1);
+
+// Tested by every Span, so kept apart from the (non-trivial) trace itself.
+thread_local bool t_bTracing = false;
+thread_local ThreadTrace t_trace;
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void append_json_string(std::string& strJson, const char* szValue)
+{
+    strJson += '"';
+
+    for (const char* p = szValue; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+
+        if ('"' == c || '\\' == c) {
+            strJson += '\\';
+            strJson += static_cast<char>(c);
+        }
+        else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            strJson += buf;
+        }
+        else {
+            strJson += static_cast<char>(c);
+        }
+    }
+
+    strJson += '"';
+}
+
+// Trace-event timestamps are microseconds; keep the nanoseconds as decimals.
+void append_micros(std::string& strJson, int64_t lNanos)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%" PRId64 ".%03d", lNanos / 1000,
+             static_cast<int>(lNanos % 1000));
+    strJson += buf;
+}
+
+void append_event(std::string& strJson, const TraceEvent& theEvent,
+                  int32_t nThread)
+{
+    strJson += "{\"name\":";
+    append_json_string(strJson, theEvent.m_szName);
+    strJson += ",\"cat\":\"opentxs\",\"ph\":\"X\",\"ts\":";
+    append_micros(strJson, theEvent.m_lStart);
+    strJson += ",\"dur\":";
+    append_micros(strJson, theEvent.m_lDuration);
+    strJson += ",\"pid\":1,\"tid\":";
+    strJson += std::to_string(nThread);
+
+    if (!theEvent.m_args.empty()) {
+        strJson += ",\"args\":{";
+
+        for (size_t i = 0; i < theEvent.m_args.size(); ++i) {
+            if (i > 0) strJson += ',';
+            append_json_string(strJson, theEvent.m_args[i].first);
+            strJson += ':';
+            append_json_string(strJson, theEvent.m_args[i].second.c_str());
+        }
+
+        strJson += '}';
+    }
+
+    strJson += '}';
+}
+
+} // namespace
+
+Trace::Span::Span(const char* szName)
+    : m_lEvent(0)
+    , m_bActive(t_bTracing)
+{
+    if (!m_bActive) return;
+
+    ThreadTrace& theTrace = t_trace;
+
+    if (theTrace.m_events.size() >= MaxSpans) {
+        ++theTrace.m_lDropped;
+        m_bActive = false;
+        return;
+    }
+
+    m_lEvent = theTrace.m_events.size();
+    theTrace.m_events.push_back(TraceEvent());
+
+    TraceEvent& theEvent = theTrace.m_events.back();
+    theEvent.m_szName = szName;
+    theEvent.m_lDuration = -1;
+    theEvent.m_lStart = now_ns();
+}
+
+Trace::Span::~Span()
+{
+    // End() may have run in between; it closes whatever is still open.
+    if (!m_bActive || !t_bTracing) return;
+
+    ThreadTrace& theTrace = t_trace;
+
+    if (m_lEvent >= theTrace.m_events.size()) return;
+
+    TraceEvent& theEvent = theTrace.m_events[m_lEvent];
+    theEvent.m_lDuration = now_ns() - theEvent.m_lStart;
+}
+
+void Trace::Span::Arg(const char* szKey, const std::string& strValue)
+{
+    if (!m_bActive || !t_bTracing) return;
+
+    ThreadTrace& theTrace = t_trace;
+
+    if (m_lEvent >= theTrace.m_events.size()) return;
+
+    theTrace.m_events[m_lEvent].m_args.emplace_back(szKey, strValue);
+}
+
+// static
+int32_t Trace::GetSampleRate()
+{
+    return s_nSampleRate.load(std::memory_order_relaxed);
+}
+
+// static
+void Trace::SetSampleRate(int32_t nRate)
+{
+    s_nSampleRate.store(nRate < 0 ? 0 : nRate, std::memory_order_relaxed);
+}
+
+// static
+bool Trace::Begin()
+{
+    const int32_t nRate = s_nSampleRate.load(std::memory_order_relaxed);
+
+    if (nRate <= 0) return false;
+
+    if (0 != (s_lRequests.fetch_add(1, std::memory_order_relaxed) %
+              static_cast<uint64_t>(nRate)))
+        return false;
+
+    ThreadTrace& theTrace = t_trace;
+    theTrace.m_events.clear();
+    theTrace.m_lDropped = 0;
+
+    if (0 == theTrace.m_nThread)
+        theTrace.m_nThread = s_nNextThread.fetch_add(1);
+
+    t_bTracing = true;
+
+    return true;
+}
+
+// static
+bool Trace::End(std::string& strJson)
+{
+    if (!t_bTracing) return false;
+
+    t_bTracing = false;
+
+    ThreadTrace& theTrace = t_trace;
+    const int64_t lNow = now_ns();
+
+    strJson = "{\"traceEvents\":[";
+
+    for (size_t i = 0; i < theTrace.m_events.size(); ++i) {
+        TraceEvent& theEvent = theTrace.m_events[i];
+
+        if (theEvent.m_lDuration < 0)
+            theEvent.m_lDuration = lNow - theEvent.m_lStart;
+
+        if (i > 0) strJson += ",\n";
+        append_event(strJson, theEvent, theTrace.m_nThread);
+    }
+
+    strJson += "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":";
+    strJson += std::to_string(theTrace.m_lDropped);
+    strJson += "}}\n";
+
+    theTrace.m_events.clear();
+
+    return true;
+}
+
+} // namespace opentxs
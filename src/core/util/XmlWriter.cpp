@@ -0,0 +1,204 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/core/stdafx.hpp>
+
+#include <opentxs/core/util/XmlWriter.hpp>
+#include <opentxs/core/util/Assert.hpp>
+
+#include <cstring>
+
+namespace opentxs
+{
+
+XmlWriter::XmlWriter(std::string& str_output)
+    : output_(str_output)
+    , open_(0)
+    , attribute_count_(0)
+    , start_tag_pending_(false)
+{
+}
+
+void XmlWriter::open_element(const std::string& str_name)
+{
+    start_content();
+
+    if (names_.size() == open_) names_.push_back(std::string());
+
+    names_[open_++].assign(str_name);
+
+    attribute_count_ = 0;
+    start_tag_pending_ = true;
+}
+
+void XmlWriter::add_attribute(const std::string& str_name,
+                              const std::string& str_value)
+{
+    OT_ASSERT_MSG(start_tag_pending_, "XmlWriter: attribute added after the "
+                                      "element's text or first child.");
+
+    // Insertion sort by name, keeping the first value for a repeated name
+    // (the order and semantics of Tag's std::map.) Elements have a handful
+    // of attributes, so this beats anything cleverer.
+    size_t nPos = attribute_count_;
+
+    while ((nPos > 0) && (str_name < attributes_[nPos - 1].first)) --nPos;
+
+    if ((nPos > 0) && (str_name == attributes_[nPos - 1].first)) return;
+
+    if (attributes_.size() == attribute_count_)
+        attributes_.push_back(Attribute());
+
+    // Reuse the last free slot, then rotate it into place.
+    Attribute& slot = attributes_[attribute_count_];
+    slot.first.assign(str_name);
+    slot.second.assign(str_value);
+
+    for (size_t i = attribute_count_; i > nPos; --i)
+        attributes_[i].swap(attributes_[i - 1]);
+
+    ++attribute_count_;
+}
+
+void XmlWriter::add_attribute(const std::string& str_name,
+                              const char* sz_value)
+{
+    add_attribute(str_name, std::string(sz_value));
+}
+
+void XmlWriter::set_text(const std::string& str_text)
+{
+    if (str_text.empty()) return;
+
+    OT_ASSERT_MSG(0 < open_, "XmlWriter: text outside of any element.");
+    OT_ASSERT_MSG(start_tag_pending_, "XmlWriter: element already has text "
+                                      "or children.");
+
+    start_content();
+    output_ += str_text;
+}
+
+void XmlWriter::set_text(const char* sz_text)
+{
+    if ((nullptr == sz_text) || ('\0' == sz_text[0])) return;
+
+    OT_ASSERT_MSG(0 < open_, "XmlWriter: text outside of any element.");
+    OT_ASSERT_MSG(start_tag_pending_, "XmlWriter: element already has text "
+                                      "or children.");
+
+    start_content();
+    output_ += sz_text;
+}
+
+void XmlWriter::close_element()
+{
+    OT_ASSERT_MSG(0 < open_, "XmlWriter: no element to close.");
+
+    const std::string& str_name = names_[--open_];
+
+    if (start_tag_pending_) {
+        write_start_tag(str_name);
+        output_ += " />\n";
+    }
+    else {
+        output_ += "\n</";
+        output_ += str_name;
+        output_ += ">\n";
+    }
+
+    // The parent, if any, now has content.
+    start_tag_pending_ = false;
+}
+
+void XmlWriter::add_element(const std::string& str_name,
+                            const std::string& str_text)
+{
+    open_element(str_name);
+    set_text(str_text);
+    close_element();
+}
+
+void XmlWriter::add_element(const std::string& str_name, const char* sz_text)
+{
+    open_element(str_name);
+    set_text(sz_text);
+    close_element();
+}
+
+// Writes "<name" and the pending attributes.
+void XmlWriter::write_start_tag(const std::string& str_name)
+{
+    output_ += '<';
+    output_ += str_name;
+
+    for (size_t i = 0; i < attribute_count_; ++i) {
+        const Attribute& attribute = attributes_[i];
+
+        output_ += "\n ";
+        output_ += attribute.first;
+        output_ += "=\"";
+
+        if (std::string::npos == attribute.second.find('"')) {
+            output_ += attribute.second;
+        }
+        else {
+            for (char c : attribute.second) {
+                if ('"' == c)
+                    output_ += "&quot;";
+                else
+                    output_ += c;
+            }
+        }
+
+        output_ += '"';
+    }
+
+    attribute_count_ = 0;
+    start_tag_pending_ = false;
+}
+
+// Called before anything is written inside the innermost open element.
+void XmlWriter::start_content()
+{
+    if (!start_tag_pending_) return;
+
+    write_start_tag(names_[open_ - 1]);
+    output_ += ">\n";
+}
+
+} // namespace opentxs
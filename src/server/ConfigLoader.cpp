@@ -40,11 +40,21 @@
 #include <opentxs/server/ServerSettings.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/util/OTDataFolder.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/OTSettings.hpp>
 #include <opentxs/core/cron/OTCron.hpp>
 #include <opentxs/core/Log.hpp>
+#include <opentxs/core/NumList.hpp>
+#include <opentxs/core/OTStorageCache.hpp>
+#include <opentxs/core/OTStorageStats.hpp>
+#include <opentxs/core/OTWireFormat.hpp>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
 #include <opentxs/core/crypto/OTCachedKey.hpp>
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
 #include <opentxs/core/crypto/OTKeyring.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
 #include <cstdint>
 
 #define SERVER_WALLET_FILENAME "notaryServer.xml"
@@ -99,6 +109,19 @@ bool ConfigLoader::load(String& walletFilename)
         Log::SetLogLevel(static_cast<int32_t>(lValue));
     }
 
+    {
+        const char* szComment =
+            "; async_log hands log lines to a background writer thread, so a\n"
+            "; slow terminal or pipe can't hold up the caller. Lines are\n"
+            "; dropped, and counted, if they come faster than it can write.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("logging", "async_log", Log::GetAsync(),
+                                bValue, bIsNewKey, szComment);
+        Log::SetAsync(bValue);
+    }
+
     // WALLET
 
     // WALLET FILENAME
@@ -244,8 +267,239 @@ bool ConfigLoader::load(String& walletFilename)
         ServerSettings::SetMinMarketScale(lValue);
     }
 
+    // ARMOR
+    {
+        const char* szComment =
+            ";; ARMOR (compression of armored messages, ledgers, receipts...)\n"
+            "; codec is one of: zlib, stored, zlib_dictionary.\n"
+            "; Only zlib can be read by peers older than the armor header,\n"
+            "; so don't change it until your clients have upgraded.\n"
+            "; compression_level is the zlib level, 0 (none) through 9 (best).\n"
+            "; Payloads smaller than stored_threshold bytes are not "
+            "compressed.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str(
+            "armor", "codec",
+            OTArmorCodec::CodecToString(OTArmorCodec::GetCodec()), strValue,
+            bIsNewKey, szComment);
+
+        OTArmorCodec::Codec theCodec = OTArmorCodec::GetCodec();
+        if (OTArmorCodec::CodecFromString(strValue.Get(), theCodec))
+            OTArmorCodec::SetCodec(theCodec);
+        else
+            Log::vError("%s: Unknown armor codec: %s\n", szFunc,
+                        strValue.Get());
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "compression_level",
+                                OTArmorCodec::GetCompressionLevel(), lValue,
+                                bIsNewKey);
+        OTArmorCodec::SetCompressionLevel(static_cast<int32_t>(lValue));
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("armor", "stored_threshold",
+                                OTArmorCodec::GetStoredThreshold(), lValue,
+                                bIsNewKey);
+        OTArmorCodec::SetStoredThreshold(lValue);
+    }
+
+    // WIRE
+    {
+        const char* szComment =
+            ";; WIRE (framing of client requests and server replies)\n"
+            "; binary_framing lets clients skip the base64 round trip and "
+            "send\n"
+            "; signed messages as raw ZMQ frames. Armored requests are always\n"
+            "; accepted. compress packs binary frames with the armor "
+            "compression\n"
+            "; settings above.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "binary_framing",
+                                ServerSettings::GetBinaryFraming(), bValue,
+                                bIsNewKey, szComment);
+        ServerSettings::SetBinaryFraming(bValue);
+    }
+
+    {
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "compress", OTWireFormat::GetCompress(),
+                                bValue, bIsNewKey);
+        OTWireFormat::SetCompress(bValue);
+    }
+
+    {
+        const char* szComment =
+            "; numlist_ranges writes runs of transaction numbers as "
+            "first-last.\n"
+            "; Turn it off while peers older than the range encoding are "
+            "still\n"
+            "; around, since they can't parse it.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("wire", "numlist_ranges",
+                                NumList::GetRangeOutput(), bValue, bIsNewKey,
+                                szComment);
+        NumList::SetRangeOutput(bValue);
+    }
+
+    // STATS
+    {
+        const char* szComment =
+            ";; STATS (per-command request counts and latencies)\n"
+            "; dump_interval is the number of seconds between writes of\n"
+            "; stats/serverStats.xml. 0 turns the file off; the override Nym\n"
+            "; can still ask for the numbers with getServerStats.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("stats", "dump_interval",
+                                ServerSettings::GetStatsDumpInterval(), lValue,
+                                bIsNewKey, szComment);
+        ServerSettings::SetStatsDumpInterval(static_cast<int32_t>(lValue));
+    }
+
+    {
+        const char* szComment =
+            "; slow_op_ms: storage reads and writes that take at least this\n"
+            "; many milliseconds are logged with their path. 0 turns it off.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("storage", "slow_op_ms",
+                                OTDB::StorageStats::GetSlowThreshold(), lValue,
+                                bIsNewKey, szComment);
+        OTDB::StorageStats::SetSlowThreshold(lValue);
+    }
+
+    {
+        const char* szComment =
+            "; cache_bytes: room for recently read files, so that reading one\n"
+            "; again costs a stat() rather than a read. Files in the folders\n"
+            "; listed in cache_pinned (comma separated, e.g. contracts,mints)\n"
+            "; are kept regardless. 0 caches only the pinned folders.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("storage", "cache_bytes",
+                                OTDB::StorageCache::GetMaxBytes(), lValue,
+                                bIsNewKey, szComment);
+        OTDB::StorageCache::SetMaxBytes(lValue);
+
+        String strValue;
+        p_Config->CheckSet_str("storage", "cache_pinned",
+                               OTDB::StorageCache::GetPinnedFolders().c_str(),
+                               strValue, bIsNewKey);
+        OTDB::StorageCache::SetPinnedFolders(strValue.Get());
+    }
+
+    // TRACE
+    {
+        const char* szComment =
+            ";; TRACE (timelines of sampled requests, as Chrome trace JSON)\n"
+            "; sample_rate traces one request in every sample_rate. 0 turns\n"
+            "; tracing off. The traces go to stats/traces, where only the\n"
+            "; newest max_files are kept.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("trace", "sample_rate",
+                                Trace::GetSampleRate(), lValue, bIsNewKey,
+                                szComment);
+        Trace::SetSampleRate(static_cast<int32_t>(lValue));
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("trace", "max_files",
+                                ServerSettings::GetTraceMaxFiles(), lValue,
+                                bIsNewKey);
+        ServerSettings::SetTraceMaxFiles(static_cast<int32_t>(lValue));
+    }
+
     // SECURITY (beginnings of..)
 
+    // Signature Cache
+    {
+        const char* szComment =
+            "; signature_cache remembers signatures that already verified, so\n"
+            "; reloading the same account, receipt or contract doesn't verify\n"
+            "; it again. Set it to false to verify every signature, every\n"
+            "; time.\n"
+            "; signature_cache_size is the maximum number of entries.\n";
+
+        bool bIsNewKey;
+        bool bValue;
+        p_Config->CheckSet_bool("security", "signature_cache",
+                                OTSignatureCache::IsEnabled(), bValue,
+                                bIsNewKey, szComment);
+        OTSignatureCache::SetEnabled(bValue);
+    }
+
+    {
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("security", "signature_cache_size",
+                                OTSignatureCache::GetCapacity(), lValue,
+                                bIsNewKey);
+        OTSignatureCache::SetCapacity(lValue);
+    }
+
+    // Crypto Thread Pool
+    {
+        const char* szComment =
+            "; pool_threads is how many threads sign and verify batches of\n"
+            "; signatures (for example every item in a transaction).\n"
+            "; -1 : one per core.\n"
+            "; 0  : no pool, everything is done on the calling thread.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("crypto", "pool_threads",
+                                OTCryptoPool::GetThreads(), lValue, bIsNewKey,
+                                szComment);
+        OTCryptoPool::SetThreads(static_cast<int32_t>(lValue));
+    }
+
+    // Private Key Residency
+    {
+        const char* szComment =
+            "; key_residency controls how long a decrypted private key stays\n"
+            "; in memory. timed (the default) wipes it after a few seconds and\n"
+            "; decrypts it again on next use. resident keeps it until shutdown\n"
+            "; (or until the master key goes away). refresh keeps it ready and\n"
+            "; re-decrypts it on a background thread when the timer runs out.\n";
+
+        bool bIsNewKey;
+        String strValue;
+        p_Config->CheckSet_str(
+            "security", "key_residency",
+            OTAsymmetricKey::KeyResidencyToString(
+                OTAsymmetricKey::GetKeyResidency()),
+            strValue, bIsNewKey, szComment);
+
+        OTAsymmetricKey::KeyResidency theResidency =
+            OTAsymmetricKey::GetKeyResidency();
+        if (OTAsymmetricKey::KeyResidencyFromString(strValue.Get(),
+                                                    theResidency))
+            OTAsymmetricKey::SetKeyResidency(theResidency);
+        else
+            Log::vError("%s: Unknown key residency: %s\n", szFunc,
+                        strValue.Get());
+    }
+
     // Master Key Timeout
     {
         const char* szComment =
@@ -265,6 +519,24 @@ bool ConfigLoader::load(String& walletFilename)
         OTCachedKey::It()->SetTimeoutSeconds(static_cast<int32_t>(lValue));
     }
 
+    // Derived Key Cache
+    {
+        const char* szComment =
+            "; derived_key_timeout is how long a key derived from a\n"
+            "; passphrase (for a purse or other symmetric key) stays in\n"
+            "; memory, so unlocking the same key again skips the derivation.\n"
+            "; 0   : don't cache derived keys.\n"
+            "; 300 : keep each one for 5 minutes.\n"
+            "; -1  : keep them until shutdown.\n";
+
+        bool bIsNewKey;
+        int64_t lValue;
+        p_Config->CheckSet_long("security", "derived_key_timeout",
+                                OTDerivedKeyCache::GetTimeoutSeconds(), lValue,
+                                bIsNewKey, szComment);
+        OTDerivedKeyCache::SetTimeoutSeconds(static_cast<int32_t>(lValue));
+    }
+
     // Use System Keyring
     {
         bool bIsNewKey;
@@ -377,6 +649,8 @@ bool ConfigLoader::load(String& walletFilename)
                              ServerSettings::__transact_smart_contract);
     p_Config->SetOption_bool("permissions", "cmd_trigger_clause",
                              ServerSettings::__cmd_trigger_clause);
+    p_Config->SetOption_bool("permissions", "cmd_get_server_stats",
+                             ServerSettings::__cmd_get_server_stats);
 
     // Done Loading... Lets save any changes...
     if (!p_Config->Save()) {
@@ -51,6 +51,7 @@
 #include <opentxs/core/util/OTFolders.hpp>
 #include <opentxs/core/util/Tag.hpp>
 #include <irrxml/irrXML.hpp>
+#include <map>
 #include <string>
 #include <memory>
 
@@ -88,7 +89,13 @@ bool MainFile::SaveMainFileToString(String& strMainFile)
                 __FUNCTION__);
     }
 
-    for (auto& it : server_->transactor_.contractsMap_) {
+    // The contracts map is unordered. Sort by ID so the notary file comes
+    // out the same every time.
+    std::map<OTID, Contract*> mapContracts(
+        server_->transactor_.contractsMap_.begin(),
+        server_->transactor_.contractsMap_.end());
+
+    for (auto& it : mapContracts) {
         Contract* pContract = it.second;
         OT_ASSERT_MSG(nullptr != pContract,
                       "nullptr contract pointer in MainFile::SaveMainFile.\n");
@@ -504,9 +511,10 @@ bool MainFile::LoadMainFile(bool bReadOnly)
 
                             pContract->SetName(AssetName);
 
+                            Identifier theContractID;
+                            pContract->GetIdentifier(theContractID);
                             server_->transactor_
-                                .contractsMap_[InstrumentDefinitionID.Get()] =
-                                pContract;
+                                .contractsMap_[OTID(theContractID)] = pContract;
                         }
                         else {
                             delete pContract;
@@ -43,6 +43,7 @@
 #include <opentxs/server/ClientConnection.hpp>
 #include <opentxs/core/Log.hpp>
 #include <opentxs/core/Message.hpp>
+#include <opentxs/core/OTWireFormat.hpp>
 #include <opentxs/core/String.hpp>
 #include <opentxs/core/OTSettings.hpp>
 #include <opentxs/core/util/OTDataFolder.hpp>
@@ -95,6 +96,7 @@ void MessageProcessor::run()
         int64_t timeout = server_->computeTimeout();
         if (timeout <= 0) {
             server_->ProcessCron();
+            server_->userCommandProcessor_.DumpStats();
             continue;
         }
 
@@ -121,53 +123,70 @@ void MessageProcessor::run()
 
 void MessageProcessor::processSocket()
 {
-    char* msg = zstr_recv(zmqSocket_);
-    if (msg == nullptr) {
+    // A frame rather than a string: binary requests may contain null bytes.
+    zframe_t* request = zframe_recv(zmqSocket_);
+    if (request == nullptr) {
         Log::Error("zeromq recv() failed\n");
         return;
     }
-    std::string requestString(msg);
-    zstr_free(&msg);
 
     std::string responseString;
 
-    bool error = processMessage(requestString, responseString);
+    bool error = processMessage(zframe_data(request), zframe_size(request),
+                                responseString);
 
     if (error) {
         responseString = "";
     }
 
-    int rc = zstr_send(zmqSocket_, responseString.c_str());
+    zframe_t* response =
+        zframe_new(responseString.data(), responseString.size());
+    int rc = zframe_send(&response, zmqSocket_, 0);
 
     if (rc != 0) {
-        Log::vError("MessageProcessor: failed to send response\n"
-                    "request:\n%s\n\n"
-                    "response:\n%s\n\n",
-                    requestString.c_str(), responseString.c_str());
+        Log::vError("MessageProcessor: failed to send response (%zu bytes) "
+                    "to a request of %zu bytes.\n",
+                    responseString.size(), zframe_size(request));
+        zframe_destroy(&response);
     }
+
+    zframe_destroy(&request);
 }
 
-bool MessageProcessor::processMessage(const std::string& messageString,
-                                      std::string& reply)
+bool MessageProcessor::processMessage(const void* requestData,
+                                      size_t requestSize, std::string& reply)
 {
-    if (messageString.size() < 1) return false;
+    if (requestSize < 1) return false;
 
-    // First we grab the client's message
-    OTASCIIArmor ascMessage;
-    ascMessage.MemSet(messageString.data(), messageString.size());
+    OTWireFormat::Framing framing = OTWireFormat::ARMORED;
+
+    if (OTWireFormat::IsBinary(requestData, requestSize) &&
+        !ServerSettings::GetBinaryFraming()) {
+        // Answer like a server that predates binary framing, so the client
+        // falls back to armored requests.
+        Log::Output(1, "Rejecting binary framed request (disabled in "
+                       "server.cfg).\n");
+        return true;
+    }
 
+    // First we grab the client's message
     String messageContents;
-    ascMessage.GetString(messageContents);
-    // All decrypted--now let's load the results into an OTMessage.
+    bool decoded = OTWireFormat::Decode(requestData, requestSize,
+                                        messageContents, framing);
+
+    // All decoded--now let's load the results into an OTMessage.
     // No need to call message.ParseRawFile() after, since
     // LoadContractFromString handles it.
     Message message;
-    if (!messageContents.Exists() ||
+    if (!decoded || !messageContents.Exists() ||
         !message.LoadContractFromString(messageContents)) {
         Log::vError("Error loading message from message "
                     "contents:\n\n%s\n\n",
                     messageContents.Get());
-        return true;
+
+        // Let a binary client know the server did understand the framing.
+        OTWireFormat::FailedReply(framing, reply);
+        return reply.empty();
     }
 
     Message replyMessage;
@@ -190,11 +209,15 @@ bool MessageProcessor::processMessage(const std::string& messageString,
     // for the reply, I'll  have the key and thus I'll be able to
     // encrypt reply to the recipient.)
     if (!processedUserCmd) {
-        String s1(message);
-
-        Log::vOutput(0, "Unable to process user command: %s\n ********** "
-                        "REQUEST:\n\n%s\n\n",
-                     message.m_strCommand.Get(), s1.Get());
+        // The full request and response only at level 2: serializing and
+        // writing them out for every failed command is too costly.
+        Log::vOutput(0, "Unable to process user command: %s (Nym: %s)\n",
+                     message.m_strCommand.Get(), message.m_strNymID.Get());
+
+        if (Log::IsEnabled(2)) {
+            String s1(message);
+            Log::vOutput(2, " ********** REQUEST:\n\n%s\n\n", s1.Get());
+        }
 
         // NOTE: normally you would even HAVE a true or false if
         // we're in this block. ProcessUserCommand()
@@ -219,9 +242,10 @@ bool MessageProcessor::processMessage(const std::string& messageString,
         replyMessage.SignContract(server_->GetServerNym());
         replyMessage.SaveContract();
 
-        String s2(replyMessage);
-
-        Log::vOutput(0, " ********** RESPONSE:\n\n%s\n\n", s2.Get());
+        if (Log::IsEnabled(2)) {
+            String s2(replyMessage);
+            Log::vOutput(2, " ********** RESPONSE:\n\n%s\n\n", s2.Get());
+        }
     }
     else {
         // At this point the reply is ready to go, and client
@@ -235,21 +259,19 @@ bool MessageProcessor::processMessage(const std::string& messageString,
     if (!replyString.Exists()) {
         Log::vOutput(0, "Failed trying to grab the reply "
                         "in OTString form. "
-                        "(No reply message will be sent.)\n");
-        return true;
+                        "(Sending an empty reply.)\n");
+        OTWireFormat::FailedReply(framing, reply);
+        return reply.empty();
     }
 
-    OTASCIIArmor ascReply(replyString);
-
-    if (!ascReply.Exists()) {
-        Log::vOutput(0, "Unable to WriteArmoredString from "
-                        "OTASCIIArmor object into OTString object. (No reply "
-                        "message will be sent.)\n");
-        return true;
+    if (!OTWireFormat::Encode(replyString, framing, reply)) {
+        Log::vOutput(0, "Unable to encode the reply for the wire (%s). "
+                        "(Sending an empty reply.)\n",
+                     OTWireFormat::FramingToString(framing));
+        OTWireFormat::FailedReply(framing, reply);
+        return reply.empty();
     }
 
-    reply.assign(ascReply.Get(), ascReply.GetLength());
-
     return false;
 }
 
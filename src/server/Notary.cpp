@@ -61,6 +61,7 @@
 #include <opentxs/core/Item.hpp>
 #include <opentxs/core/trade/OTTrade.hpp>
 #include <opentxs/core/util/OTFolders.hpp>
+#include <opentxs/core/util/Trace.hpp>
 #include <opentxs/core/Log.hpp>
 #include <deque>
 #include <memory>
@@ -81,6 +82,8 @@ void Notary::NotarizeTransfer(Nym& theNym, Account& theFromAccount,
                               OTTransaction& tranIn, OTTransaction& tranOut,
                               bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeTransfer");
+
     // The outgoing transaction is an "atTransfer", that is, "a reply to the
     // transfer request"
     tranOut.SetType(OTTransaction::atTransfer);
@@ -378,18 +381,20 @@ void Notary::NotarizeTransfer(Nym& theNym, Account& theFromAccount,
                 // Now we have created 2 new transactions from the server to the
                 // users' boxes
                 // Let's sign them and add to their inbox / outbox.
-                pOutboxTransaction->SignContract(server_->m_nymServer);
-                pInboxTransaction->SignContract(server_->m_nymServer);
-
-                pOutboxTransaction->SaveContract();
-                pInboxTransaction->SaveContract();
+                //
                 // Meanwhile a copy of the outbox transaction is also added to
                 // pOutbox. (It's just another copy of the outbox, but used
                 // purely for verifying the balance statement, while a different
                 // copy of the outbox is used for actually adding the receipt
                 // and saving to the outbox file.)
                 //
-                pTEMPOutboxTransaction->SignContract(server_->m_nymServer);
+                // All three are signed together, as one batch.
+                Contract::SignContracts({pOutboxTransaction, pInboxTransaction,
+                                         pTEMPOutboxTransaction},
+                                        server_->m_nymServer);
+
+                pOutboxTransaction->SaveContract();
+                pInboxTransaction->SaveContract();
                 pTEMPOutboxTransaction->SaveContract();
 
                 // No need to save a box receipt in this case, like we normally
@@ -471,8 +476,8 @@ void Notary::NotarizeTransfer(Nym& theNym, Account& theFromAccount,
                         theToInbox.ReleaseSignatures();
 
                         // Sign them.
-                        theFromOutbox.SignContract(server_->m_nymServer);
-                        theToInbox.SignContract(server_->m_nymServer);
+                        Contract::SignContracts({&theFromOutbox, &theToInbox},
+                                                server_->m_nymServer);
 
                         // Save them internally
                         theFromOutbox.SaveContract();
@@ -482,13 +487,18 @@ void Notary::NotarizeTransfer(Nym& theNym, Account& theFromAccount,
                         theFromAccount.SaveOutbox(theFromOutbox);
                         pDestinationAcct->SaveInbox(theToInbox);
 
+                        // The accounts can't go in the same batch as the
+                        // boxes: saving the boxes updates the box hashes
+                        // inside the accounts.
                         theFromAccount.ReleaseSignatures();
-                        theFromAccount.SignContract(server_->m_nymServer);
+                        pDestinationAcct->ReleaseSignatures();
+                        Contract::SignContracts(
+                            {&theFromAccount, pDestinationAcct.get()},
+                            server_->m_nymServer);
+
                         theFromAccount.SaveContract();
                         theFromAccount.SaveAccount();
 
-                        pDestinationAcct->ReleaseSignatures();
-                        pDestinationAcct->SignContract(server_->m_nymServer);
                         pDestinationAcct->SaveContract();
                         pDestinationAcct->SaveAccount();
 
@@ -546,11 +556,9 @@ void Notary::NotarizeTransfer(Nym& theNym, Account& theFromAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -570,6 +578,8 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
                                 OTTransaction& tranIn, OTTransaction& tranOut,
                                 bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeWithdrawal");
+
     // The outgoing transaction is an "atWithdrawal", that is, "a reply to the
     // withdrawal request"
     tranOut.SetType(OTTransaction::atWithdrawal);
@@ -1319,11 +1329,9 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
         // Now, whether it was rejection or acknowledgement, it is set properly
         // and it is signed, and it
         // is owned by the transaction, who will take it from here.
-        pResponseItem->SignContract(server_->m_nymServer);
-        pResponseItem->SaveContract(); // the signing was of no effect because I
-                                       // forgot to save.
-
-        pResponseBalanceItem->SignContract(server_->m_nymServer);
+        Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                                server_->m_nymServer);
+        pResponseItem->SaveContract();
         pResponseBalanceItem->SaveContract();
     }
     else {
@@ -1341,11 +1349,9 @@ void Notary::NotarizeWithdrawal(Nym& theNym, Account& theAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -1383,6 +1389,8 @@ void Notary::NotarizePayDividend(Nym& theNym, Account& theSourceAccount,
                                  OTTransaction& tranIn, OTTransaction& tranOut,
                                  bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizePayDividend");
+
     const char* szFunc = "Notary::NotarizePayDividend";
 
     // The outgoing transaction is an "atPayDividend", that is, "a reply to the
@@ -2180,11 +2188,9 @@ void Notary::NotarizePayDividend(Nym& theNym, Account& theSourceAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -2193,6 +2199,8 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                              OTTransaction& tranIn, OTTransaction& tranOut,
                              bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeDeposit");
+
     // The outgoing transaction is an "atDeposit", that is, "a reply to the
     // deposit request"
     tranOut.SetType(OTTransaction::atDeposit);
@@ -3558,8 +3566,9 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
                             pSourceAcct->ReleaseSignatures();
                             theAccount.ReleaseSignatures();
 
-                            pSourceAcct->SignContract(server_->m_nymServer);
-                            theAccount.SignContract(server_->m_nymServer);
+                            Contract::SignContracts(
+                                {pSourceAcct, &theAccount},
+                                server_->m_nymServer);
 
                             pSourceAcct->SaveContract();
                             theAccount.SaveContract();
@@ -3966,11 +3975,9 @@ void Notary::NotarizeDeposit(Nym& theNym, Account& theAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -3998,6 +4005,8 @@ void Notary::NotarizePaymentPlan(Nym& theNym, Account& theDepositorAccount,
                                  OTTransaction& tranIn, OTTransaction& tranOut,
                                  bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizePaymentPlan");
+
     // The outgoing transaction is an "atPaymentPlan", that is, "a reply to the
     // paymentPlan request"
     tranOut.SetType(OTTransaction::atPaymentPlan);
@@ -4732,11 +4741,9 @@ void Notary::NotarizePaymentPlan(Nym& theNym, Account& theDepositorAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -4744,6 +4751,8 @@ void Notary::NotarizeSmartContract(Nym& theNym, Account& theActivatingAccount,
                                    OTTransaction& tranIn,
                                    OTTransaction& tranOut, bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeSmartContract");
+
     // The outgoing transaction is an "atSmartContract", that is, "a reply to
     // the smartContract request"
     tranOut.SetType(OTTransaction::atSmartContract);
@@ -5443,11 +5452,9 @@ void Notary::NotarizeSmartContract(Nym& theNym, Account& theActivatingAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -5475,6 +5482,8 @@ void Notary::NotarizeCancelCronItem(Nym& theNym, Account& theAssetAccount,
                                     OTTransaction& tranIn,
                                     OTTransaction& tranOut, bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeCancelCronItem");
+
     // The outgoing transaction is an "atCancelCronItem", that is, "a reply to
     // the cancelCronItem request"
     tranOut.SetType(OTTransaction::atCancelCronItem);
@@ -5650,11 +5659,9 @@ void Notary::NotarizeCancelCronItem(Nym& theNym, Account& theAssetAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save.
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -5664,6 +5671,8 @@ void Notary::NotarizeExchangeBasket(Nym& theNym, Account& theAccount,
                                     OTTransaction& tranIn,
                                     OTTransaction& tranOut, bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeExchangeBasket");
+
     // The outgoing transaction is an "atExchangeBasket", that is, "a reply to
     // the exchange basket request"
     tranOut.SetType(OTTransaction::atExchangeBasket);
@@ -6542,10 +6551,9 @@ void Notary::NotarizeExchangeBasket(Nym& theNym, Account& theAccount,
 
     // I put this here so it's signed/saved whether the balance agreement itself
     // was successful OR NOT.
-    pResponseItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
     pResponseItem->SaveContract();
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
     pResponseBalanceItem->SaveContract();
 }
 
@@ -6556,6 +6564,8 @@ void Notary::NotarizeMarketOffer(Nym& theNym, Account& theAssetAccount,
                                  OTTransaction& tranIn, OTTransaction& tranOut,
                                  bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeMarketOffer");
+
     // The outgoing transaction is an "atMarketOffer", that is, "a reply to the
     // marketOffer request"
     tranOut.SetType(OTTransaction::atMarketOffer);
@@ -6948,11 +6958,9 @@ void Notary::NotarizeMarketOffer(Nym& theNym, Account& theAssetAccount,
     // Now, whether it was rejection or acknowledgement, it is set properly and
     // it is signed, and it
     // is owned by the transaction, who will take it from here.
-    pResponseItem->SignContract(server_->m_nymServer);
-    pResponseItem->SaveContract(); // the signing was of no effect because I
-                                   // forgot to save. (fixed.)
-
-    pResponseBalanceItem->SignContract(server_->m_nymServer);
+    Contract::SignContracts({pResponseItem, pResponseBalanceItem},
+                            server_->m_nymServer);
+    pResponseItem->SaveContract();
     pResponseBalanceItem->SaveContract();
 }
 
@@ -6965,7 +6973,14 @@ void Notary::NotarizeMarketOffer(Nym& theNym, Account& theAssetAccount,
 void Notary::NotarizeTransaction(Nym& theNym, OTTransaction& tranIn,
                                  OTTransaction& tranOut, bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeTransaction");
+
     const int64_t lTransactionNumber = tranIn.GetTransactionNum();
+
+    if (span.Active()) {
+        span.Arg("transactionNum", std::to_string(lTransactionNumber));
+        span.Arg("type", tranIn.GetTypeString());
+    }
     const Identifier NOTARY_ID(server_->m_strNotaryID);
     Identifier NYM_ID;
     theNym.GetIdentifier(NYM_ID);
@@ -7345,6 +7360,8 @@ void Notary::NotarizeTransaction(Nym& theNym, OTTransaction& tranIn,
 void Notary::NotarizeProcessNymbox(Nym& theNym, OTTransaction& tranIn,
                                    OTTransaction& tranOut, bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeProcessNymbox");
+
     // The outgoing transaction is an "atProcessNymbox", that is, "a reply to
     // the process nymbox request"
     tranOut.SetType(OTTransaction::atProcessNymbox);
@@ -8029,6 +8046,8 @@ void Notary::NotarizeProcessInbox(Nym& theNym, Account& theAccount,
                                   OTTransaction& tranIn, OTTransaction& tranOut,
                                   bool& bOutSuccess)
 {
+    Trace::Span span("Notary::NotarizeProcessInbox");
+
     // The outgoing transaction is an "atProcessInbox", that is, "a reply to the
     // process inbox request"
     tranOut.SetType(OTTransaction::atProcessInbox);
@@ -49,6 +49,12 @@ int64_t ServerSettings::__min_market_scale = 1;
 int32_t ServerSettings::__heartbeat_no_requests = 10;
 // number of ms between each heartbeat.
 int32_t ServerSettings::__heartbeat_ms_between_beats = 100;
+// Accept binary framed requests, as well as armored ones.
+bool ServerSettings::__binary_framing = true;
+// Write the per-command statistics to the stats folder once a minute.
+int32_t ServerSettings::__stats_dump_interval = 60;
+// Keep the last 100 sampled request traces.
+int32_t ServerSettings::__trace_max_files = 100;
 // The Nym who's allowed to do certain
 // commands even if they are turned off.
 std::string ServerSettings::__override_nym_id;
@@ -101,6 +107,8 @@ bool ServerSettings::__transact_payment_plan = true;
 bool ServerSettings::__transact_cancel_cron_item = true;
 bool ServerSettings::__transact_smart_contract = true;
 bool ServerSettings::__cmd_trigger_clause = true;
+bool ServerSettings::__cmd_get_server_stats =
+    false; // Only the override Nym, unless the operator turns it on.
 
 // Todo: Might set ALL of these to false (so you're FORCED to set them true
 // in the server.cfg file.) This way you're also assured that the right data
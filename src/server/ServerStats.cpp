@@ -0,0 +1,178 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include <opentxs/server/ServerStats.hpp>
+
+#include <opentxs/core/OTStorageCache.hpp>
+#include <opentxs/core/OTStorageStats.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/Common.hpp>
+#include <opentxs/core/util/Tag.hpp>
+
+namespace opentxs
+{
+
+ServerStats::CommandStats::CommandStats()
+    : count_(0)
+    , errors_(0)
+{
+}
+
+ServerStats::ServerStats()
+    : started_(std::chrono::steady_clock::now())
+{
+}
+
+void ServerStats::Record(const std::string& command, bool success,
+                         const PhaseTimer::Durations& durations)
+{
+    CommandStats& stats = commands_[command];
+    int64_t totalNanos = 0;
+
+    ++stats.count_;
+
+    if (!success) ++stats.errors_;
+
+    for (int32_t i = 0; i < PhaseTimer::PHASE_COUNT; ++i) {
+        stats.phases_[i].Add(durations[i] / 1000);
+        totalNanos += durations[i];
+    }
+
+    stats.total_.Add(totalNanos / 1000);
+}
+
+void ServerStats::Serialize(String& output) const
+{
+    const int64_t uptime =
+        std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - started_).count();
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+
+    Tag root("serverStats");
+
+    for (auto& it : commands_) {
+        const CommandStats& stats = it.second;
+        TagPtr pCommand(new Tag("command"));
+
+        pCommand->add_attribute("name", it.first);
+        pCommand->add_attribute("count", formatUlong(stats.count_));
+        pCommand->add_attribute("errors", formatUlong(stats.errors_));
+
+        for (int32_t i = -1; i < PhaseTimer::PHASE_COUNT; ++i) {
+            const LatencyHistogram& histogram =
+                (i < 0) ? stats.total_ : stats.phases_[i];
+            const char* szPhase =
+                (i < 0) ? "total"
+                        : PhaseTimer::Name(static_cast<PhaseTimer::Phase>(i));
+            TagPtr pLatency(new Tag("latency"));
+
+            pLatency->add_attribute("phase", szPhase);
+            pLatency->add_attribute("totalMicros",
+                                    formatLong(histogram.TotalMicros()));
+            pLatency->add_attribute("maxMicros",
+                                    formatLong(histogram.MaxMicros()));
+            pLatency->add_attribute("buckets", histogram.FormatBuckets());
+            pCommand->add_tag(pLatency);
+        }
+
+        root.add_tag(pCommand);
+        requests += stats.count_;
+        errors += stats.errors_;
+    }
+
+    // What the requests above cost in disk I/O, by folder.
+    TagPtr pStorage(new Tag("storage"));
+
+    for (auto& it : OTDB::StorageStats::Get()) {
+        TagPtr pFolder(new Tag("folder"));
+
+        pFolder->add_attribute("name", it.first);
+
+        for (int32_t i = 0; i < OTDB::StorageStats::OPERATION_COUNT; ++i) {
+            const OTDB::StorageStats::Counters& counters = it.second[i];
+
+            if (0 == counters.m_lCount) continue;
+
+            TagPtr pOperation(new Tag("operation"));
+
+            pOperation->add_attribute(
+                "name", OTDB::StorageStats::Name(
+                            static_cast<OTDB::StorageStats::Operation>(i)));
+            pOperation->add_attribute("count", formatUlong(counters.m_lCount));
+            pOperation->add_attribute("errors",
+                                      formatUlong(counters.m_lErrors));
+            pOperation->add_attribute("bytes", formatUlong(counters.m_lBytes));
+            pOperation->add_attribute("slow", formatUlong(counters.m_lSlow));
+            pOperation->add_attribute(
+                "totalMicros", formatLong(counters.m_latency.TotalMicros()));
+            pOperation->add_attribute(
+                "maxMicros", formatLong(counters.m_latency.MaxMicros()));
+            pOperation->add_attribute("buckets",
+                                      counters.m_latency.FormatBuckets());
+            pFolder->add_tag(pOperation);
+        }
+
+        pStorage->add_tag(pFolder);
+    }
+
+    const OTDB::StorageCache::Stats cache = OTDB::StorageCache::GetStats();
+    TagPtr pCache(new Tag("cache"));
+
+    pCache->add_attribute("hits", formatUlong(cache.m_lHits));
+    pCache->add_attribute("misses", formatUlong(cache.m_lMisses));
+    pCache->add_attribute("stale", formatUlong(cache.m_lStale));
+    pCache->add_attribute("evictions", formatUlong(cache.m_lEvictions));
+    pCache->add_attribute("entries", formatUlong(cache.m_lEntries));
+    pCache->add_attribute("bytes", formatUlong(cache.m_lBytes));
+    pCache->add_attribute("pinnedBytes", formatUlong(cache.m_lPinnedBytes));
+    pStorage->add_tag(pCache);
+
+    root.add_tag(pStorage);
+
+    root.add_attribute("uptimeSeconds", formatLong(uptime));
+    root.add_attribute("requests", formatUlong(requests));
+    root.add_attribute("errors", formatUlong(errors));
+
+    std::string str_result;
+    root.output(str_result);
+
+    output.Set(str_result.c_str());
+}
+
+} // namespace opentxs
@@ -278,39 +278,28 @@ bool Transactor::removeIssuedNumber(Nym& theNym,
 AssetContract* Transactor::getAssetContract(
     const Identifier& INSTRUMENT_DEFINITION_ID)
 {
-    for (auto& it : contractsMap_) {
-        AssetContract* pContract = it.second;
-        OT_ASSERT(nullptr != pContract);
+    auto it = contractsMap_.find(OTID(INSTRUMENT_DEFINITION_ID));
 
-        Identifier theContractID;
-        pContract->GetIdentifier(theContractID);
+    if (contractsMap_.end() == it) return nullptr;
 
-        if (theContractID == INSTRUMENT_DEFINITION_ID) return pContract;
-    }
+    OT_ASSERT(nullptr != it->second);
 
-    return nullptr;
+    return it->second;
 }
 
 /// OTServer will take ownership of theContract from this point on,
 /// and will be responsible for deleting it. MUST be allocated on the heap.
 bool Transactor::addAssetContract(AssetContract& theContract)
 {
-    AssetContract* pContract = nullptr;
-
-    String STR_CONTRACT_ID;
     Identifier CONTRACT_ID;
-    theContract.GetIdentifier(STR_CONTRACT_ID);
     theContract.GetIdentifier(CONTRACT_ID);
 
-    pContract = getAssetContract(CONTRACT_ID);
-
-    // already exists
-    if (nullptr != pContract) // if not null
-        return false;
+    const OTID theKey(CONTRACT_ID);
 
-    contractsMap_[STR_CONTRACT_ID.Get()] = &theContract;
+    if (theKey.empty()) return false;
 
-    return true;
+    // already exists
+    return contractsMap_.insert(std::make_pair(theKey, &theContract)).second;
 }
 
 // Server stores a map of BASKET_ID to BASKET_ACCOUNT_ID.
@@ -453,18 +442,15 @@ Mint* Transactor::getMint(const Identifier& INSTRUMENT_DEFINITION_ID,
                                            // Mint.
 {
     Mint* pMint = nullptr;
+    const OTID theKey(INSTRUMENT_DEFINITION_ID);
+    const auto range = mintsMap_.equal_range(theKey);
 
-    for (auto& it : mintsMap_) {
-        pMint = it.second;
+    for (auto it = range.first; it != range.second; ++it) {
+        pMint = it->second;
         OT_ASSERT_MSG(nullptr != pMint,
                       "nullptr mint pointer in Transactor::getMint\n");
 
-        Identifier theID;
-        pMint->GetIdentifier(theID);
-
-        if ((INSTRUMENT_DEFINITION_ID ==
-             theID) && // if the ID on the Mint matches the ID passed in
-            (nSeries == pMint->GetSeries())) // and the series also matches...
+        if (nSeries == pMint->GetSeries()) // if the series also matches...
             return pMint; // return the pointer right here, we're done.
     }
     // The mint isn't in memory for the series requested.
@@ -501,10 +487,9 @@ Mint* Transactor::getMint(const Identifier& INSTRUMENT_DEFINITION_ID,
             // but expiry dates are only enforced on the Mint itself during a
             // withdrawal.)
             // It's a multimap now...
-            // mintsMap_[INSTRUMENT_DEFINITION_ID_STR.Get()] = pMint;
+            // mintsMap_[theKey] = pMint;
 
-            mintsMap_.insert(std::pair<std::string, Mint*>(
-                INSTRUMENT_DEFINITION_ID_STR.Get(), pMint));
+            mintsMap_.insert(std::make_pair(theKey, pMint));
 
             return pMint;
         }
@@ -57,22 +57,180 @@
 #include <opentxs/core/Ledger.hpp>
 #include <opentxs/cash/Mint.hpp>
 #include <opentxs/core/trade/OTMarket.hpp>
+#include <opentxs/core/util/PhaseTimer.hpp>
+#include <opentxs/core/util/Trace.hpp>
 
 namespace opentxs
 {
 
 UserCommandProcessor::UserCommandProcessor(OTServer* server)
     : server_(server)
+    , lastStatsDump_(std::chrono::steady_clock::now())
+    , tracesSaved_(0)
 {
+    typedef UserCommandProcessor U;
+    typedef ServerSettings S;
+
+    // pingNotary and registerNym aren't here: they come before the Nym is
+    // authenticated, and are handled in ProcessCommand itself.
+    AddCommand("getRequestNumber", &U::UserCmdGetRequestNumber,
+               {&S::__cmd_get_requestnumber});
+    AddCommand("getTransactionNumbers", &U::UserCmdGetTransactionNumbers,
+               {&S::__cmd_get_trans_nums});
+    AddCommand("checkNym", &U::UserCmdCheckNym, {&S::__cmd_check_nym});
+    AddCommand("sendNymMessage", &U::UserCmdSendNymMessage,
+               {&S::__cmd_send_message});
+    AddCommand("sendNymInstrument", &U::UserCmdSendNymInstrument,
+               {&S::__cmd_send_message});
+    AddCommand("unregisterNym", &U::UserCmdDeleteUser,
+               {&S::__cmd_del_user_acct});
+    AddCommand("unregisterAccount", &U::UserCmdDeleteAssetAcct,
+               {&S::__cmd_del_asset_acct});
+    AddCommand("registerAccount", &U::UserCmdRegisterAccount,
+               {&S::__cmd_create_asset_acct});
+    AddCommand("registerInstrumentDefinition",
+               &U::UserCmdRegisterInstrumentDefinition,
+               {&S::__cmd_issue_asset});
+    AddCommand("issueBasket", &U::UserCmdIssueBasket,
+               {&S::__cmd_issue_basket});
+    AddCommand("notarizeTransaction", &U::UserCmdNotarizeTransaction,
+               {&S::__cmd_notarize_transaction});
+    AddCommand("getNymbox", &U::UserCmdGetNymbox, {&S::__cmd_get_nymbox});
+    // Depth 0 is the Nymbox, 1 the inbox and 2 the outbox.
+    AddCommand("getBoxReceipt", &U::UserCmdGetBoxReceipt,
+               {&S::__cmd_get_nymbox, &S::__cmd_get_inbox,
+                &S::__cmd_get_outbox},
+               true);
+    AddCommand("getAccountData", &U::UserCmdGetAccountData,
+               {&S::__cmd_get_inbox, &S::__cmd_get_outbox, &S::__cmd_get_acct});
+    AddCommand("processNymbox", &U::UserCmdProcessNymbox,
+               {&S::__cmd_process_nymbox});
+    AddCommand("processInbox", &U::UserCmdProcessInbox,
+               {&S::__cmd_process_inbox});
+    AddCommand("queryInstrumentDefinitions",
+               &U::UserCmdQueryInstrumentDefinitions, {&S::__cmd_get_contract});
+    AddCommand("getInstrumentDefinition", &U::UserCmdGetInstrumentDefinition,
+               {&S::__cmd_get_contract});
+    AddCommand("getMint", &U::UserCmdGetMint, {&S::__cmd_get_mint});
+    AddCommand("getMarketList", &U::UserCmdGetMarketList,
+               {&S::__cmd_get_market_list});
+    AddCommand("getMarketOffers", &U::UserCmdGetMarketOffers,
+               {&S::__cmd_get_market_offers});
+    AddCommand("getMarketRecentTrades", &U::UserCmdGetMarketRecentTrades,
+               {&S::__cmd_get_market_recent_trades});
+    AddCommand("getNymMarketOffers", &U::UserCmdGetNymMarketOffers,
+               {&S::__cmd_get_nym_market_offers});
+    AddCommand("triggerClause", &U::UserCmdTriggerClause,
+               {&S::__cmd_trigger_clause});
+    AddCommand("usageCredits", &U::UserCmdUsageCredits,
+               {&S::__cmd_usage_credits});
+    AddCommand("getServerStats", &U::UserCmdGetServerStats,
+               {&S::__cmd_get_server_stats});
+}
+
+void UserCommandProcessor::AddCommand(const std::string& name, Handler handler,
+                                      std::vector<const bool*> permissions,
+                                      bool byDepth)
+{
+    UserCommand& command = commands_[name];
+    command.handler = handler;
+    command.permissions.swap(permissions);
+    command.byDepth = byDepth;
 }
 
-// this function will create the Nym if it's not passed in. We pass it in so the
-// caller has the option to query things about the Nym (like if it actually
-// exists.)
 bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
                                               Message& msgOut,
                                               ClientConnection* pConnection,
                                               Nym* pNym)
+{
+    const std::string command(theMessage.m_strCommand.Get());
+    const bool bTraced = Trace::Begin();
+    bool bProcessed = false;
+
+    PhaseTimer::Begin();
+    {
+        Trace::Span span("UserCommandProcessor::ProcessUserCommand");
+
+        if (span.Active()) {
+            span.Arg("command", command);
+            span.Arg("nymID", theMessage.m_strNymID.Get());
+            span.Arg("requestNum", theMessage.m_strRequestNum.Get());
+        }
+
+        bProcessed = ProcessCommand(theMessage, msgOut, pConnection, pNym);
+    }
+    const PhaseTimer::Durations durations = PhaseTimer::End();
+
+    if (bTraced) SaveTrace();
+
+    RecordStats(command, bProcessed && msgOut.m_bSuccess, durations);
+
+    return bProcessed;
+}
+
+void UserCommandProcessor::RecordStats(const std::string& command,
+                                       bool success,
+                                       const PhaseTimer::Durations& durations)
+{
+    // Anything not in the table is counted together, so that junk commands
+    // can't grow the statistics without bound.
+    const bool bKnown = (commands_.end() != commands_.find(command)) ||
+                        ("pingNotary" == command) || ("registerNym" == command);
+
+    stats_.Record(bKnown ? command : "unknown", success, durations);
+}
+
+void UserCommandProcessor::DumpStats()
+{
+    const int32_t nInterval = ServerSettings::GetStatsDumpInterval();
+
+    if (nInterval <= 0) return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now - lastStatsDump_ < std::chrono::seconds(nInterval)) return;
+
+    lastStatsDump_ = now;
+
+    String strStats;
+    stats_.Serialize(strStats);
+
+    if (!OTDB::StorePlainString(strStats.Get(), OTFolders::Stats().Get(),
+                                "serverStats.xml")) {
+        Log::Error("UserCommandProcessor::DumpStats: Failed saving "
+                   "serverStats.xml\n");
+    }
+}
+
+void UserCommandProcessor::SaveTrace()
+{
+    std::string strTrace;
+
+    if (!Trace::End(strTrace)) return;
+
+    const int32_t nMaxFiles = ServerSettings::GetTraceMaxFiles();
+
+    if (nMaxFiles <= 0) return;
+
+    // The newest nMaxFiles traces are kept; after that they're overwritten
+    // oldest first.
+    String strFilename;
+    strFilename.Format("trace%d.json", tracesSaved_ % nMaxFiles);
+    ++tracesSaved_;
+
+    if (!OTDB::StorePlainString(strTrace, OTFolders::Stats().Get(), "traces",
+                                strFilename.Get())) {
+        Log::vError("UserCommandProcessor::SaveTrace: Failed saving %s\n",
+                    strFilename.Get());
+    }
+}
+
+// this function will create the Nym if it's not passed in. We pass it in so the
+// caller has the option to query things about the Nym (like if it actually
+// exists.)
+bool UserCommandProcessor::ProcessCommand(Message& theMessage, Message& msgOut,
+                                          ClientConnection* pConnection,
+                                          Nym* pNym)
 {
     msgOut.m_strRequestNum.Set(theMessage.m_strRequestNum);
 
@@ -983,292 +1141,21 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
                                       // msgOut.m_strNotaryID is already set.
                                       // (It uses it.)
 
-    if (theMessage.m_strCommand.Compare("getRequestNumber")) // This command is
-    // special because it's
-    // the only one that
-    // doesn't require a
-    // request number.
-    // All of the other commands, below, will fail above if the proper
-    // request number isn't included
-    // in the message.  They will already have failed by this point if they
-    // didn't verify.
-    {
-        Log::vOutput(0,
-                     "\n==> Received a getRequestNumber message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_requestnumber);
-
-        UserCmdGetRequestNumber(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getTransactionNumbers")) {
-        Log::vOutput(
-            0, "\n==> Received a getTransactionNumbers message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_trans_nums);
-
-        UserCmdGetTransactionNumbers(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("checkNym")) {
-        Log::vOutput(0, "\n==> Received a checkNym message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_check_nym);
-
-        UserCmdCheckNym(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("sendNymMessage")) {
-        Log::vOutput(0,
-                     "\n==> Received a sendNymMessage message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_send_message);
-
-        UserCmdSendNymMessage(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("sendNymInstrument")) {
-        Log::vOutput(
-            0, "\n==> Received a sendNymInstrument message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_send_message);
-
-        UserCmdSendNymInstrument(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("unregisterNym")) {
-        Log::vOutput(0, "\n==> Received a unregisterNym message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_del_user_acct);
-
-        UserCmdDeleteUser(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("unregisterAccount")) {
-        Log::vOutput(
-            0, "\n==> Received a unregisterAccount message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_del_asset_acct);
-
-        UserCmdDeleteAssetAcct(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("registerAccount")) {
-        Log::vOutput(0,
-                     "\n==> Received a registerAccount message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_create_asset_acct);
-
-        UserCmdRegisterAccount(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare(
-                   "registerInstrumentDefinition")) {
-        Log::vOutput(0, "\n==> Received an registerInstrumentDefinition "
-                        "message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_issue_asset);
-
-        UserCmdRegisterInstrumentDefinition(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("issueBasket")) {
-        Log::vOutput(0, "\n==> Received an issueBasket message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_issue_basket);
-
-        UserCmdIssueBasket(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("notarizeTransaction")) {
-        Log::vOutput(0, "\n==> Received a notarizeTransaction message.  "
-                        "Acct: %s Nym: %s  ...\n",
-                     theMessage.m_strAcctID.Get(), strMsgNymID.Get());
+    auto it = commands_.find(theMessage.m_strCommand.Get());
 
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_notarize_transaction);
+    if (commands_.end() != it) {
+        const UserCommand& command = it->second;
 
-        UserCmdNotarizeTransaction(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getNymbox")) {
-        Log::vOutput(0, "\n==> Received a getNymbox message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_nymbox);
-
-        UserCmdGetNymbox(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getBoxReceipt")) {
-        Log::vOutput(0, "\n==> Received a getBoxReceipt message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        bool bRunIt = true;
-        if (0 == theMessage.m_lDepth)
-            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_nymbox)
-        else if (1 == theMessage.m_lDepth)
-            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_inbox)
-        else if (2 == theMessage.m_lDepth)
-            OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_outbox)
+        if (theMessage.m_strAcctID.Exists())
+            Log::vOutput(0, "\n==> Received a %s message. Acct: %s Nym: %s "
+                            "...\n",
+                         theMessage.m_strCommand.Get(),
+                         theMessage.m_strAcctID.Get(), strMsgNymID.Get());
         else
-            bRunIt = false;
-
-        if (bRunIt) UserCmdGetBoxReceipt(theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getAccountData")) {
-        Log::vOutput(0, "\n==> Received a getAccountData message.  Acct: %s "
-                        "Nym: %s  ...\n",
-                     theMessage.m_strAcctID.Get(), strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_inbox);
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_outbox);
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_acct);
-
-        UserCmdGetAccountData(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("processNymbox")) {
-        Log::vOutput(0, "\n==> Received a processNymbox message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_process_nymbox);
-
-        UserCmdProcessNymbox(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("processInbox")) {
-        Log::vOutput(
-            0, "\n==> Received a processInbox message. Acct: %s Nym: %s  ...\n",
-            theMessage.m_strAcctID.Get(), strMsgNymID.Get());
+            Log::vOutput(0, "\n==> Received a %s message. Nym: %s ...\n",
+                         theMessage.m_strCommand.Get(), strMsgNymID.Get());
 
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_process_inbox);
-
-        UserCmdProcessInbox(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("queryInstrumentDefinitions")) {
-        Log::vOutput(0, "\n==> Received a queryInstrumentDefinitions "
-                        "message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_contract);
-
-        UserCmdQueryInstrumentDefinitions(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getInstrumentDefinition")) {
-        Log::vOutput(
-            0,
-            "\n==> Received a getInstrumentDefinition message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_contract);
-
-        UserCmdGetInstrumentDefinition(theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getMint")) {
-        Log::vOutput(0, "\n==> Received a getMint message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_mint);
-
-        UserCmdGetMint(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getMarketList")) {
-        Log::vOutput(0, "\n==> Received a getMarketList message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_market_list);
-
-        UserCmdGetMarketList(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getMarketOffers")) {
-        Log::vOutput(0,
-                     "\n==> Received a getMarketOffers message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_market_offers);
-
-        UserCmdGetMarketOffers(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getMarketRecentTrades")) {
-        Log::vOutput(
-            0, "\n==> Received a getMarketRecentTrades message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(
-            ServerSettings::__cmd_get_market_recent_trades);
-
-        UserCmdGetMarketRecentTrades(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("getNymMarketOffers")) {
-        Log::vOutput(
-            0, "\n==> Received a getNymMarketOffers message. Nym: %s ...\n",
-            strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_get_nym_market_offers);
-
-        UserCmdGetNymMarketOffers(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("triggerClause")) {
-        Log::vOutput(0, "\n==> Received a triggerClause message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_trigger_clause);
-
-        UserCmdTriggerClause(*pNym, theMessage, msgOut);
-
-        return true;
-    }
-    else if (theMessage.m_strCommand.Compare("usageCredits")) {
-        Log::vOutput(0, "\n==> Received a usageCredits message. Nym: %s ...\n",
-                     strMsgNymID.Get());
-
-        OT_ENFORCE_PERMISSION_MSG(ServerSettings::__cmd_usage_credits);
-
-        UserCmdUsageCredits(*pNym, theMessage, msgOut);
-
-        return true;
+        return RunCommand(command, *pNym, theMessage, msgOut);
     }
     else {
         Log::vError("Unknown command type in the XML, or missing payload, in "
@@ -1297,6 +1184,29 @@ bool UserCommandProcessor::ProcessUserCommand(Message& theMessage,
     }
 }
 
+bool UserCommandProcessor::RunCommand(const UserCommand& command, Nym& nym,
+                                      Message& theMessage, Message& msgOut)
+{
+    if (command.byDepth) {
+        // The depth picks the box, and so the permission.
+        if ((theMessage.m_lDepth < 0) ||
+            (theMessage.m_lDepth >=
+             static_cast<int64_t>(command.permissions.size())))
+            return true;
+
+        OT_ENFORCE_PERMISSION_MSG(*command.permissions[theMessage.m_lDepth]);
+    }
+    else {
+        for (const bool* permission : command.permissions) {
+            OT_ENFORCE_PERMISSION_MSG(*permission);
+        }
+    }
+
+    (this->*command.handler)(nym, theMessage, msgOut);
+
+    return true;
+}
+
 // Get the list of markets on this server.
 void UserCommandProcessor::UserCmdGetMarketList(Nym&, Message& MsgIn,
                                                 Message& msgOut)
@@ -1340,6 +1250,22 @@ void UserCommandProcessor::UserCmdGetMarketList(Nym&, Message& MsgIn,
     msgOut.SaveContract();
 }
 
+void UserCommandProcessor::UserCmdGetServerStats(Nym&, Message& MsgIn,
+                                                 Message& msgOut)
+{
+    msgOut.m_strCommand = "getServerStatsResponse";
+    msgOut.m_strNymID = MsgIn.m_strNymID;
+
+    String strStats;
+    stats_.Serialize(strStats);
+
+    msgOut.m_ascPayload.SetString(strStats);
+    msgOut.m_bSuccess = true;
+
+    msgOut.SignContract(server_->m_nymServer);
+    msgOut.SaveContract();
+}
+
 // Get the publicly-available list of offers on a specific market.
 void UserCommandProcessor::UserCmdGetMarketOffers(Nym&, Message& MsgIn,
                                                   Message& msgOut)
@@ -3247,7 +3173,8 @@ void UserCommandProcessor::UserCmdQueryInstrumentDefinitions(Nym&,
     msgOut.SaveContract();
 }
 
-void UserCommandProcessor::UserCmdGetInstrumentDefinition(Message& MsgIn,
+void UserCommandProcessor::UserCmdGetInstrumentDefinition(Nym&,
+                                                          Message& MsgIn,
                                                           Message& msgOut)
 {
     // (1) set up member variables
@@ -3664,7 +3591,8 @@ void UserCommandProcessor::UserCmdDeleteUser(Nym& theNym, Message& MsgIn,
 // the Nymbox. Otherwise it will contain an AcctID if retrieving a boxreceipt
 // for an Asset Acct.
 //
-void UserCommandProcessor::UserCmdGetBoxReceipt(Message& MsgIn, Message& msgOut)
+void UserCommandProcessor::UserCmdGetBoxReceipt(Nym&, Message& MsgIn,
+                                                Message& msgOut)
 {
     // (1) set up member variables
     msgOut.m_strCommand = "getBoxReceiptResponse"; // reply to getBoxReceipt
@@ -0,0 +1,232 @@
+// Times Contract::ParseRawFile against the line-by-line parser it replaced,
+// on signed messages of a few sizes. Both parsers must agree on the unsigned
+// XML, the hash type and every signature before anything is timed.
+//
+// Usage: bench-opentxs-contract [iterations]
+
+#include <opentxs/core/Contract.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+class BenchContract : public Contract
+{
+public:
+    void SetRawFile(const std::string& str_raw)
+    {
+        Release();
+        m_strRawFile.Set(str_raw.c_str());
+    }
+
+    // Everything ParseRawFile produces, for comparing the two parsers.
+    std::string Dump() const
+    {
+        std::string str_dump(m_xmlUnsigned.Get());
+        str_dump += "|";
+        str_dump += m_strSigHashType.Get();
+
+        for (const auto& it : m_listSignatures) {
+            str_dump += "|";
+            str_dump += it->Get();
+        }
+
+        return str_dump;
+    }
+
+    // The previous implementation of ParseRawFile (the metadata checks left
+    // out), kept as the reference.
+    bool LegacyParseRawFile()
+    {
+        char buffer1[2100];
+        OTSignature* pSig = nullptr;
+        std::string line;
+        bool bSignatureMode = false;
+        bool bContentMode = false;
+        bool bHaveEnteredContentMode = false;
+
+        std::string str_Trim(m_strRawFile.Get());
+        std::string str_Trim2 = String::trim(str_Trim);
+        m_strRawFile.Set(str_Trim2.c_str());
+
+        bool bIsEOF = false;
+        m_strRawFile.reset();
+
+        do {
+            memset(buffer1, 0, 2100);
+            bIsEOF = !(m_strRawFile.sgets(buffer1, 2048));
+            line = buffer1;
+            const char* pBuf = line.c_str();
+
+            if (line.length() < 2) {
+                if (bSignatureMode) continue;
+            }
+            else if (line.at(0) == '-') {
+                if (bSignatureMode) {
+                    pSig = nullptr;
+                    bSignatureMode = false;
+                    continue;
+                }
+                if (!bHaveEnteredContentMode) {
+                    if ((line.length() > 3) &&
+                        (line.find("BEGIN") != std::string::npos) &&
+                        line.at(1) == '-' && line.at(2) == '-' &&
+                        line.at(3) == '-') {
+                        bHaveEnteredContentMode = true;
+                        bContentMode = true;
+                    }
+                    continue;
+                }
+                else if (line.length() > 3 &&
+                         line.find("SIGNATURE") != std::string::npos &&
+                         line.at(1) == '-' && line.at(2) == '-' &&
+                         line.at(3) == '-') {
+                    bSignatureMode = true;
+                    bContentMode = false;
+                    pSig = new OTSignature();
+                    m_listSignatures.push_back(pSig);
+                    continue;
+                }
+                else if (line.length() < 3 || line.at(1) != ' ' ||
+                         line.at(2) != '-') {
+                    return false;
+                }
+            }
+            else if (bHaveEnteredContentMode) {
+                if (bSignatureMode) {
+                    if ((line.compare(0, 8, "Version:") == 0) ||
+                        (line.compare(0, 8, "Comment:") == 0) ||
+                        (line.compare(0, 5, "Meta:") == 0)) {
+                        if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048))
+                            return false;
+                        continue;
+                    }
+                }
+                if (bContentMode && (line.compare(0, 6, "Hash: ") == 0)) {
+                    std::string strTemp = line.substr(6);
+                    m_strSigHashType = strTemp.c_str();
+                    m_strSigHashType.ConvertToUpperCase();
+                    if (bIsEOF || !m_strRawFile.sgets(buffer1, 2048))
+                        return false;
+                    continue;
+                }
+            }
+
+            if (bSignatureMode)
+                pSig->Concatenate("%s\n", pBuf);
+            else if (bContentMode)
+                m_xmlUnsigned.Concatenate("%s\n", pBuf);
+        } while (!bIsEOF);
+
+        return bHaveEnteredContentMode && !bContentMode && !bSignatureMode &&
+               LoadContractXML();
+    }
+
+protected:
+    // The benchmark is about the parser, not about any particular contract.
+    virtual int32_t ProcessXMLNode(irr::io::IrrXMLReader*&)
+    {
+        return 1;
+    }
+};
+
+std::string signed_message(int32_t nRecords, int32_t nSignatures)
+{
+    std::string str_raw("-----BEGIN SIGNED MESSAGE-----\nHash: SHA256\n\n"
+                        "<?xml version=\"1.0\"?>\n<notaryMessage>\n");
+
+    for (int32_t i = 0; i < nRecords; ++i) {
+        str_raw += "<ackReplies requestNum=\"" + std::to_string(1000 + i) +
+                   "\"\n accountID=\"ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1\" />"
+                   "\n\n";
+    }
+
+    str_raw += "</notaryMessage>\n\n";
+
+    for (int32_t i = 0; i < nSignatures; ++i) {
+        str_raw += "-----BEGIN MESSAGE SIGNATURE-----\n"
+                   "Version: Open Transactions 0.93\n"
+                   "Comment: http://opentransactions.org\n"
+                   "Meta:    Sabc\n\n";
+
+        for (int32_t j = 0; j < 6; ++j) {
+            str_raw += "iQIcBAEBCAAGBQJVd2jWAAoJEE2fCcWeI/Wqv1MP/3JmZx8xAb"
+                       "CdEfGhIjKlMnOp\n";
+        }
+
+        str_raw += "-----END MESSAGE SIGNATURE-----\n\n";
+    }
+
+    return str_raw;
+}
+
+// Microseconds per parse.
+template <class F>
+double time_it(int32_t nIterations, BenchContract& theContract,
+               const std::string& str_raw, F parse)
+{
+    double dTotal = 0;
+
+    for (int32_t i = 0; i < nIterations; ++i) {
+        theContract.SetRawFile(str_raw);
+
+        const auto start = std::chrono::steady_clock::now();
+        parse();
+        const auto end = std::chrono::steady_clock::now();
+
+        dTotal +=
+            std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    return dTotal / nIterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int32_t nIterations = argc > 1 ? atoi(argv[1]) : 200;
+
+    // Keep the per-line debug logging out of the measurements.
+    Log::SetLogLevel(0);
+
+    printf("%10s %10s %12s %12s %8s\n", "bytes", "sigs", "legacy_us",
+           "parser_us", "speedup");
+
+    for (int32_t nRecords : {10, 100, 1000}) {
+        const std::string str_raw = signed_message(nRecords, 2);
+        BenchContract theContract;
+
+        theContract.SetRawFile(str_raw);
+        const bool bLegacy = theContract.LegacyParseRawFile();
+        const std::string str_legacy = theContract.Dump();
+
+        theContract.SetRawFile(str_raw);
+        const bool bParsed = theContract.ParseRawFile();
+
+        if (!bLegacy || !bParsed || (str_legacy != theContract.Dump())) {
+            fprintf(stderr, "%d records: parsers disagree\n", nRecords);
+            return 1;
+        }
+
+        const double dLegacy =
+            time_it(nIterations, theContract, str_raw,
+                    [&]() { theContract.LegacyParseRawFile(); });
+        const double dParser = time_it(nIterations, theContract, str_raw,
+                                       [&]() { theContract.ParseRawFile(); });
+
+        printf("%10zu %10d %12.1f %12.1f %7.1fx\n", str_raw.size(), 2,
+               dLegacy, dParser, dLegacy / dParser);
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Cost of a log statement whose level is suppressed, before and after the
+// level gates: the stream and vOutput paths as they used to be, the gated
+// otLog3 stream, OT_LOG and the gated vOutput. Each is timed with logging
+// off (-1) and at the default level 0, with a message of the shape the
+// Notary and the market code write per item.
+//
+// Usage: bench-opentxs-log [iterations]
+
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// OTLogStream as it was: every character goes through overflow() and the
+// level is only looked at once a whole line has been built.
+class LegacyLogStream : public std::ostream, std::streambuf
+{
+public:
+    explicit LegacyLogStream(int nLevel)
+        : std::ostream(this)
+        , nLevel_(nLevel)
+        , nNext_(0)
+    {
+    }
+
+    virtual int overflow(int c)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+
+        buffer_[nNext_++] = static_cast<char>(c);
+        if (c != '\n' && nNext_ < 1000) {
+            return 0;
+        }
+
+        buffer_[nNext_] = '\0';
+        nNext_ = 0;
+        Log::Output(nLevel_, buffer_);
+        return 0;
+    }
+
+private:
+    int nLevel_;
+    int nNext_;
+    char buffer_[1024];
+    std::mutex lock_;
+};
+
+// Log::vOutput as it was: formats unless the level is above a non-zero log
+// level, then lets Output() drop the result.
+void legacy_voutput(int32_t nVerbosity, const char* szOutput, ...)
+    ATTR_PRINTF(2, 3);
+
+void legacy_voutput(int32_t nVerbosity, const char* szOutput, ...)
+{
+    if ((0 != Log::LogLevel()) && (nVerbosity > Log::LogLevel())) return;
+
+    va_list args;
+    va_start(args, szOutput);
+    std::string strOutput;
+    String::vformat(szOutput, &args, strOutput);
+    va_end(args);
+
+    Log::Output(nVerbosity, strOutput.c_str());
+}
+
+// Nanoseconds per statement.
+double time_it(int32_t nIterations, const std::function<void(int64_t)>& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < nIterations; ++i) fn(i);
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           nIterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int32_t nIterations = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    // Init() may not find a data folder here; the logger it creates is all
+    // SetLogLevel() needs.
+    Log::Init();
+
+    const String strAccountID("ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1");
+    LegacyLogStream legacyLog3(3);
+
+    printf("%-22s %12s %12s\n", "statement", "off_ns", "level0_ns");
+
+    struct Case {
+        const char* szName;
+        std::function<void(int64_t)> fn;
+    };
+
+    const Case cases[] = {
+        {"legacy stream",
+         [&](int64_t lNum) {
+             legacyLog3 << "Processing item number: " << lNum
+                        << " for account " << strAccountID << "\n";
+         }},
+        {"otLog3 stream",
+         [&](int64_t lNum) {
+             otLog3 << "Processing item number: " << lNum << " for account "
+                    << strAccountID << "\n";
+         }},
+        {"OT_LOG(3)",
+         [&](int64_t lNum) {
+             OT_LOG(3) << "Processing item number: " << lNum
+                       << " for account " << String(strAccountID) << "\n";
+         }},
+        {"legacy vOutput",
+         [&](int64_t lNum) {
+             legacy_voutput(3, "Processing item number: %" PRId64
+                               " for account %s\n",
+                            lNum, strAccountID.Get());
+         }},
+        {"Log::vOutput",
+         [&](int64_t lNum) {
+             Log::vOutput(3, "Processing item number: %" PRId64
+                             " for account %s\n",
+                          lNum, strAccountID.Get());
+         }},
+    };
+
+    for (const Case& theCase : cases) {
+        Log::SetLogLevel(-1);
+        const double dOff = time_it(nIterations, theCase.fn);
+        Log::SetLogLevel(0);
+        const double dLevel0 = time_it(nIterations, theCase.fn);
+
+        printf("%-22s %12.1f %12.1f\n", theCase.szName, dOff, dLevel0);
+    }
+
+    Log::Cleanup();
+
+    return 0;
+}
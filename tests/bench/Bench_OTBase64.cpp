@@ -0,0 +1,145 @@
+// Compares OTBase64 against the OpenSSL BIO_f_base64 code it replaced, for
+// each kernel the CPU supports. Output is checked byte-for-byte against the
+// BIO reference before anything is timed.
+//
+// Usage: bench-opentxs-base64 [payload bytes] [iterations]
+
+#include <opentxs/core/crypto/OTBase64.hpp>
+#include <opentxs/core/OTData.hpp>
+
+#include <openssl/bio.h>
+#include <openssl/buffer.h>
+#include <openssl/evp.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+// The implementation OTCrypto_OpenSSL::Base64Encode used to have.
+std::string bio_encode(const std::vector<uint8_t>& input)
+{
+    BIO* b64 = BIO_new(BIO_f_base64());
+    BIO* mem = BIO_new(BIO_s_mem());
+    BIO* chain = BIO_push(b64, mem);
+    BIO_write(chain, input.data(), static_cast<int>(input.size()));
+    (void)BIO_flush(chain);
+
+    BUF_MEM* pMem = nullptr;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+    BIO_get_mem_ptr(chain, &pMem);
+#pragma GCC diagnostic pop
+    std::string str_output(pMem->data, pMem->length);
+    BIO_free_all(chain);
+
+    return str_output;
+}
+
+// The implementation OTCrypto_OpenSSL::Base64Decode used to have.
+std::vector<uint8_t> bio_decode(const std::string& str_input)
+{
+    std::vector<uint8_t> output((str_input.size() * 6 + 7) / 8);
+    BIO* b64 = BIO_new(BIO_f_base64());
+    BIO* mem =
+        BIO_new_mem_buf(str_input.data(), static_cast<int>(str_input.size()));
+    BIO* chain = BIO_push(b64, mem);
+    const int nRead =
+        BIO_read(chain, output.data(), static_cast<int>(output.size()));
+    BIO_free_all(chain);
+    output.resize(nRead < 0 ? 0 : static_cast<size_t>(nRead));
+
+    return output;
+}
+
+std::string native_encode(const std::vector<uint8_t>& input)
+{
+    std::string str_output(OTBase64::EncodedSize(input.size(), true), '\0');
+    OTBase64::Encode(input.data(), input.size(), &str_output[0], true);
+    return str_output;
+}
+
+// Microseconds per call.
+double time_it(int32_t nIterations, const std::function<void()>& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < nIterations; ++i) fn();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() /
+           nIterations;
+}
+
+void report(const char* szName, size_t lSize, double dEncode, double dDecode)
+{
+    printf("%-8s %10zu %12.2f %12.2f %10.1f %10.1f\n", szName, lSize, dEncode,
+           dDecode, lSize / dEncode, lSize / dDecode);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t lSize = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    const int32_t nIterations = argc > 2 ? atoi(argv[2]) : 1000;
+
+    std::vector<uint8_t> input(lSize);
+    for (size_t i = 0; i < lSize; ++i) {
+        input[i] = static_cast<uint8_t>(rand());
+    }
+
+    const std::string str_reference = bio_encode(input);
+
+    printf("%-8s %10s %12s %12s %10s %10s\n", "impl", "bytes", "encode_us",
+           "decode_us", "enc_MB/s", "dec_MB/s");
+
+    {
+        std::string str_encoded;
+        std::vector<uint8_t> decoded;
+        const double dEncode = time_it(
+            nIterations, [&]() { str_encoded = bio_encode(input); });
+        const double dDecode = time_it(
+            nIterations, [&]() { decoded = bio_decode(str_reference); });
+        report("openssl", lSize, dEncode, dDecode);
+    }
+
+    const std::string str_default = OTBase64::Implementation();
+
+    for (const char* szName : {"scalar", "ssse3", "avx2"}) {
+        if (!OTBase64::SetImplementation(szName)) continue;
+
+        OTData theData;
+
+        if (native_encode(input) != str_reference ||
+            !OTBase64::Decode(str_reference.data(), str_reference.size(),
+                              theData) ||
+            theData != OTData(input.data(), static_cast<uint32_t>(lSize))) {
+            fprintf(stderr, "%s: output differs from OpenSSL\n", szName);
+            return 1;
+        }
+
+        std::string str_encoded(OTBase64::EncodedSize(lSize, true), '\0');
+        const double dEncode = time_it(nIterations, [&]() {
+            OTBase64::Encode(input.data(), lSize, &str_encoded[0], true);
+        });
+        const double dDecode = time_it(nIterations, [&]() {
+            OTBase64::Decode(str_reference.data(), str_reference.size(),
+                             theData);
+        });
+        report(szName, lSize, dEncode, dDecode);
+    }
+
+    printf("default: %s\n", str_default.c_str());
+
+    return 0;
+}
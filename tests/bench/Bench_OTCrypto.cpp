@@ -0,0 +1,427 @@
+// Times the crypto primitives on the hot paths: signing and verifying at each
+// key size, sealing and opening envelopes for 1 to 32 recipients, symmetric
+// encrypt / decrypt, message digests (for each OTHash160 implementation),
+// armoring and key derivation. Every operation is checked once (the signature
+// verifies, the envelope opens to the same plaintext, ...) before it is
+// timed.
+//
+// Output is CSV on stdout, one row per measurement, so runs can be diffed
+// or loaded elsewhere to track regressions between releases:
+//
+//     op,param,iterations,us_per_op
+//     sign_rsa,2048,412,1213.57
+//
+// Each operation runs for at least the given number of seconds (and at least
+// three times.) The signature cache is turned off, so verify means verify.
+// Key generation is not timed. DeriveNewKey uses the configured iteration
+// count.
+//
+// Usage: bench-opentxs-crypto [seconds per operation]
+
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Log.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTData.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/crypto/OTASCIIArmor.hpp>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTEnvelope.hpp>
+#include <opentxs/core/crypto/OTHash160.hpp>
+#include <opentxs/core/crypto/OTKeypair.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+double s_dSeconds = 1.0;
+
+// Something shaped like the contracts we actually sign.
+String sample_contract(size_t lSize)
+{
+    String strContract("<?xml version=\"1.0\"?>\n<notaryMessage>\n");
+
+    while (strContract.GetLength() < lSize) {
+        strContract.Concatenate("<ackReplies requestNum=\"%d\"\n accountID="
+                                "\"ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1\" />\n",
+                                static_cast<int32_t>(strContract.GetLength()));
+    }
+
+    strContract.Concatenate("</notaryMessage>\n");
+
+    return strContract;
+}
+
+void report(const char* szOp, const std::string& str_param,
+            const std::function<void()>& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto end = start;
+    int32_t nIterations = 0;
+
+    do {
+        fn();
+        ++nIterations;
+        end = std::chrono::steady_clock::now();
+    } while ((nIterations < 3) ||
+             (std::chrono::duration<double>(end - start).count() <
+              s_dSeconds));
+
+    const double dMicros =
+        std::chrono::duration<double, std::micro>(end - start).count();
+
+    printf("%s,%s,%d,%.2f\n", szOp, str_param.c_str(), nIterations,
+           dMicros / nIterations);
+    fflush(stdout);
+}
+
+bool fail(const char* szOp, const std::string& str_param)
+{
+    fprintf(stderr, "%s,%s: self-check failed\n", szOp, str_param.c_str());
+    return false;
+}
+
+bool bench_signatures(const char* szSign, const char* szVerify,
+                      const std::string& str_param, OTKeypair& theKeypair)
+{
+    const String strContract(sample_contract(2048));
+    const OTAsymmetricKey& thePrivate = theKeypair.GetPrivateKey();
+    const OTAsymmetricKey& thePublic = theKeypair.GetPublicKey();
+    OTCrypto* pCrypto = OTCrypto::It();
+    OTSignature theSignature;
+
+    if (!pCrypto->SignContract(strContract, thePrivate, theSignature,
+                               Identifier::DefaultHashAlgorithm) ||
+        !pCrypto->VerifySignature(strContract, thePublic, theSignature,
+                                  Identifier::DefaultHashAlgorithm)) {
+        return fail(szSign, str_param);
+    }
+
+    report(szSign, str_param, [&]() {
+        OTSignature theOutput;
+        pCrypto->SignContract(strContract, thePrivate, theOutput,
+                              Identifier::DefaultHashAlgorithm);
+    });
+    report(szVerify, str_param, [&]() {
+        pCrypto->VerifySignature(strContract, thePublic, theSignature,
+                                 Identifier::DefaultHashAlgorithm);
+    });
+
+    return true;
+}
+
+bool bench_envelopes(std::vector<std::unique_ptr<Nym>>& theNyms)
+{
+    const String strPlaintext(sample_contract(4096));
+
+    for (size_t lRecipients : {1, 2, 4, 8, 16, 32}) {
+        const std::string str_param = std::to_string(lRecipients);
+        setOfNyms theRecipients;
+
+        for (size_t i = 0; i < lRecipients; ++i) {
+            theRecipients.insert(theNyms[i].get());
+        }
+
+        // Open as the recipient whose key comes last, so the recipient table
+        // has to be walked all the way through.
+        String strLastID;
+        theNyms[0]->GetIdentifier(strLastID);
+        Nym* pOpener = theNyms[0].get();
+
+        for (size_t i = 1; i < lRecipients; ++i) {
+            String strNymID;
+            theNyms[i]->GetIdentifier(strNymID);
+
+            if (strcmp(strNymID.Get(), strLastID.Get()) > 0) {
+                strLastID = strNymID;
+                pOpener = theNyms[i].get();
+            }
+        }
+
+        OTEnvelope theEnvelope;
+        String strOutput;
+
+        if (!theEnvelope.Seal(theRecipients, strPlaintext) ||
+            !theEnvelope.Open(*pOpener, strOutput) ||
+            !strOutput.Compare(strPlaintext)) {
+            return fail("seal", str_param);
+        }
+
+        report("seal", str_param, [&]() {
+            OTEnvelope theOutput;
+            theOutput.Seal(theRecipients, strPlaintext);
+        });
+        report("open", str_param, [&]() {
+            String strOpened;
+            theEnvelope.Open(*pOpener, strOpened);
+        });
+    }
+
+    return true;
+}
+
+bool bench_symmetric()
+{
+    OTCrypto* pCrypto = OTCrypto::It();
+    OTPassword theKey;
+    OTData theIV;
+
+    theKey.randomizeMemory(OTCryptoConfig::SymmetricKeySize());
+    theIV.Randomize(OTCryptoConfig::SymmetricIvSize());
+
+    for (size_t lSize : {1024, 65536}) {
+        const std::string str_param = std::to_string(lSize);
+        const String strPlaintext(sample_contract(lSize));
+        const uint32_t lLength = strPlaintext.GetLength();
+        OTData theCiphertext, theDecrypted;
+
+        if (!pCrypto->Encrypt(theKey, strPlaintext.Get(), lLength, theIV,
+                              theCiphertext) ||
+            !pCrypto->Decrypt(theKey, static_cast<const char*>(
+                                          theCiphertext.GetPointer()),
+                              theCiphertext.GetSize(), theIV,
+                              OTCrypto_Decrypt_Output(theDecrypted)) ||
+            theDecrypted != OTData(strPlaintext.Get(), lLength)) {
+            return fail("encrypt", str_param);
+        }
+
+        report("encrypt", str_param, [&]() {
+            OTData theOutput;
+            pCrypto->Encrypt(theKey, strPlaintext.Get(), lLength, theIV,
+                             theOutput);
+        });
+        report("decrypt", str_param, [&]() {
+            OTData theOutput;
+            pCrypto->Decrypt(
+                theKey, static_cast<const char*>(theCiphertext.GetPointer()),
+                theCiphertext.GetSize(), theIV,
+                OTCrypto_Decrypt_Output(theOutput));
+        });
+    }
+
+    return true;
+}
+
+bool bench_digest()
+{
+    for (size_t lSize : {64, 1024, 65536}) {
+        const std::string str_param = std::to_string(lSize);
+        const String strInput(sample_contract(lSize));
+        Identifier theID;
+
+        if (!theID.CalculateDigest(strInput)) {
+            return fail("digest", str_param);
+        }
+
+        report("digest", str_param, [&]() {
+            Identifier theOutput;
+            theOutput.CalculateDigest(strInput);
+        });
+    }
+
+    // The raw hash for each implementation, one input at a time and in
+    // batches of 64. Batch rows are per batch.
+    const std::string str_default = OTHash160::Implementation();
+    const std::vector<uint8_t> input(65536, 0x5a);
+    const std::vector<const uint8_t*> inputs(64, input.data());
+    std::vector<uint8_t> output(64 * OTHash160::DigestSize);
+
+    for (const char* szName : {"scalar", "avx2", "shani"}) {
+        if (!OTHash160::SetImplementation(szName)) continue;
+
+        for (size_t lSize : {64, 1024, 65536}) {
+            const std::string str_param =
+                std::string(szName) + "/" + std::to_string(lSize);
+            const std::vector<size_t> sizes(64, lSize);
+
+            report("hash160", str_param, [&]() {
+                OTHash160::Digest(input.data(), lSize, output.data());
+            });
+            report("hash160_batch64", str_param, [&]() {
+                OTHash160::Digest(inputs.data(), sizes.data(), 64,
+                                  output.data());
+            });
+        }
+    }
+
+    OTHash160::SetImplementation(str_default.c_str());
+
+    return true;
+}
+
+bool bench_armor()
+{
+    for (size_t lSize : {1024, 65536}) {
+        const std::string str_param = std::to_string(lSize);
+        const String strInput(sample_contract(lSize));
+        const std::string str_input(strInput.Get());
+        const OTData theData(strInput.Get(), strInput.GetLength());
+        std::string str_compressed, str_decompressed;
+        OTASCIIArmor ascData, ascString;
+        OTData theDearmored;
+        String strDearmored;
+
+        if (!OTArmorCodec::Encode(str_input, str_compressed) ||
+            !OTArmorCodec::Decode(str_compressed, str_decompressed) ||
+            (str_decompressed != str_input) || !ascData.SetData(theData) ||
+            !ascData.GetData(theDearmored) || (theDearmored != theData) ||
+            !ascString.SetString(strInput) ||
+            !ascString.GetString(strDearmored) ||
+            !strDearmored.Compare(strInput)) {
+            return fail("armor", str_param);
+        }
+
+        report("compress", str_param, [&]() {
+            std::string str_output;
+            OTArmorCodec::Encode(str_input, str_output);
+        });
+        report("decompress", str_param, [&]() {
+            std::string str_output;
+            OTArmorCodec::Decode(str_compressed, str_output);
+        });
+        // Base64 only.
+        report("armor", str_param, [&]() {
+            OTASCIIArmor ascOutput;
+            ascOutput.SetData(theData);
+        });
+        report("dearmor", str_param, [&]() {
+            OTData theOutput;
+            ascData.GetData(theOutput);
+        });
+        // Compress, pack and base64, as contracts are armored.
+        report("armor_string", str_param, [&]() {
+            OTASCIIArmor ascOutput;
+            ascOutput.SetString(strInput);
+        });
+        report("dearmor_string", str_param, [&]() {
+            String strOutput;
+            ascString.GetString(strOutput);
+        });
+    }
+
+    // Payloads below the stored threshold interleaved with ones that are
+    // compressed, as a server sees them.
+    const std::string str_small =
+        std::string(sample_contract(96).Get()).substr(0, 96);
+    const std::string str_large(sample_contract(1024).Get());
+    bool bSmall = false;
+
+    report("compress_mixed", "96+1024", [&]() {
+        std::string str_output;
+        bSmall = !bSmall;
+        OTArmorCodec::Encode(bSmall ? str_small : str_large, str_output);
+    });
+
+    return true;
+}
+
+bool bench_derive_key()
+{
+    const uint32_t uIterations = OTCryptoConfig::IterationCount();
+    const std::string str_param = std::to_string(uIterations);
+    OTPassword thePassphrase;
+    OTData theSalt;
+
+    thePassphrase.setPassword("benchmark passphrase", 20);
+    theSalt.Randomize(OTCryptoConfig::SymmetricSaltSize());
+
+    {
+        OTData theCheckHash;
+        std::unique_ptr<OTPassword> pKey(OTCrypto::It()->DeriveNewKey(
+            thePassphrase, theSalt, uIterations, theCheckHash, true));
+
+        if (!pKey) return fail("derive_key", str_param);
+    }
+
+    report("derive_key", str_param, [&]() {
+        OTData theCheckHash;
+        std::unique_ptr<OTPassword> pKey(OTCrypto::It()->DeriveNewKey(
+            thePassphrase, theSalt, uIterations, theCheckHash, true));
+    });
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1) s_dSeconds = atof(argv[1]);
+
+    Log::SetLogLevel(0);
+    OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+    OTCrypto::It()->Init();
+
+    // Keep the keys instantiated, so signing measures signing and not the
+    // private key being decrypted again when its timer runs out.
+    OTAsymmetricKey::SetKeyResidency(OTAsymmetricKey::RESIDENT);
+
+    const bool bCache = OTSignatureCache::IsEnabled();
+    OTSignatureCache::SetEnabled(false);
+
+    printf("op,param,iterations,us_per_op\n");
+
+    bool bSuccess = true;
+
+    for (int32_t nBits : {1024, 2048, 4096}) {
+        OTKeypair theKeypair;
+
+        bSuccess = theKeypair.MakeNewKeypair(nBits) &&
+                   bench_signatures("sign_rsa", "verify_rsa",
+                                    std::to_string(nBits), theKeypair) &&
+                   bSuccess;
+    }
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+    {
+        OTKeypair theKeypair;
+
+        bSuccess = theKeypair.MakeNewKeypair(0, OTAsymmetricKey::ED25519) &&
+                   bench_signatures("sign_ed25519", "verify_ed25519", "256",
+                                    theKeypair) &&
+                   bSuccess;
+    }
+#endif
+
+    {
+        // Temporary Nyms (no files), as OTPurse uses.
+        std::vector<std::unique_ptr<Nym>> theNyms;
+
+        for (int32_t i = 0; i < 32; ++i) {
+            theNyms.emplace_back(new Nym);
+
+            if (!theNyms.back()->GenerateNym(1024, false)) {
+                fprintf(stderr, "failed to generate a Nym\n");
+                return 1;
+            }
+        }
+
+        bSuccess = bench_envelopes(theNyms) && bSuccess;
+    }
+
+    bSuccess = bench_symmetric() && bSuccess;
+    bSuccess = bench_digest() && bSuccess;
+    bSuccess = bench_armor() && bSuccess;
+    bSuccess = bench_derive_key() && bSuccess;
+
+    OTSignatureCache::SetEnabled(bCache);
+    OTCrypto::It()->Cleanup();
+
+    return bSuccess ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// What it costs StorageFS to read a plain-string file again: the
+// ifstream + stringstream read it used to do, the sized read that replaced
+// it, and a StorageCache hit (a stat() and a copy). All three must return
+// the file's contents before anything is timed.
+//
+// Usage: bench-opentxs-storagecache [iterations]
+
+#include <opentxs/core/OTStorageCache.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string legacy_read(const std::string& strPath)
+{
+    std::ifstream fin(strPath.c_str(), std::ios::in | std::ios::binary);
+    std::stringstream buffer;
+    buffer << fin.rdbuf();
+
+    return buffer.str();
+}
+
+std::string sized_read(const std::string& strPath, size_t lSize)
+{
+    std::ifstream fin(strPath.c_str(), std::ios::in | std::ios::binary);
+    std::string strContents(lSize, '\0');
+    fin.read(&strContents[0], static_cast<std::streamsize>(lSize));
+    strContents.resize(static_cast<size_t>(fin.gcount()));
+
+    if (!fin.eof()) {
+        strContents.append(std::istreambuf_iterator<char>(fin),
+                           std::istreambuf_iterator<char>());
+    }
+
+    return strContents;
+}
+
+std::string cached_read(const std::string& strPath)
+{
+    std::string strContents;
+    OTDB::StorageCache::FileVersion theVersion;
+
+    if (!OTDB::StorageCache::Get(strPath, strContents, theVersion)) {
+        strContents = legacy_read(strPath);
+        OTDB::StorageCache::Put("bench", strPath, theVersion, strContents);
+    }
+
+    return strContents;
+}
+
+// Microseconds per read.
+double time_it(int32_t nIterations, const std::function<void()>& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < nIterations; ++i) fn();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() /
+           nIterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int32_t nIterations = argc > 1 ? atoi(argv[1]) : 10000;
+    const std::string strPath = "bench_storagecache.tmp";
+
+    printf("%10s %12s %12s %12s\n", "bytes", "legacy_us", "sized_us",
+           "cached_us");
+
+    for (size_t lSize : {1000, 10000, 100000, 1000000}) {
+        std::string strFile(lSize, 'x');
+        {
+            std::ofstream ofs(strPath.c_str(), std::ios::out |
+                                                   std::ios::binary |
+                                                   std::ios::trunc);
+            ofs << strFile;
+        }
+
+        OTDB::StorageCache::Clear();
+        OTDB::StorageCache::SetMaxBytes(static_cast<int64_t>(lSize) * 8);
+
+        if ((legacy_read(strPath) != strFile) ||
+            (sized_read(strPath, lSize) != strFile) ||
+            (cached_read(strPath) != strFile) ||
+            (cached_read(strPath) != strFile)) {
+            fprintf(stderr, "%zu bytes: reads disagree\n", lSize);
+            remove(strPath.c_str());
+            return 1;
+        }
+
+        std::string strContents;
+        const double dLegacy = time_it(
+            nIterations, [&]() { strContents = legacy_read(strPath); });
+        const double dSized = time_it(
+            nIterations, [&]() { strContents = sized_read(strPath, lSize); });
+        const double dCached = time_it(
+            nIterations, [&]() { strContents = cached_read(strPath); });
+
+        printf("%10zu %12.2f %12.2f %12.2f\n", lSize, dLegacy, dSized,
+               dCached);
+    }
+
+    remove(strPath.c_str());
+
+    return 0;
+}
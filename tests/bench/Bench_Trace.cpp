@@ -0,0 +1,84 @@
+// Cost of a Trace::Span: on a request that isn't sampled (tracing off, and
+// tracing on at a rate that skips this request), and on a traced one, with
+// and without an argument. A PhaseTimer::Scope is timed alongside for scale.
+//
+// Usage: bench-opentxs-trace [iterations]
+
+#include <opentxs/core/util/PhaseTimer.hpp>
+#include <opentxs/core/util/Trace.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Nanoseconds per span.
+double time_it(int32_t nIterations, const std::function<void()>& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < nIterations; ++i) fn();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           nIterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int32_t nIterations = argc > 1 ? atoi(argv[1]) : 1000000;
+    // Traced runs stay under Trace::MaxSpans, so nothing is dropped.
+    const int32_t nTraced = static_cast<int32_t>(Trace::MaxSpans) - 1;
+    const std::string strPath("nyms/ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1");
+
+    const auto span = []() { Trace::Span theSpan("OTDB::QueryPlainString"); };
+    const auto spanArg = [&]() {
+        Trace::Span theSpan("OTDB::QueryPlainString");
+        if (theSpan.Active()) theSpan.Arg("path", strPath);
+    };
+    const auto scope = []() { PhaseTimer::Scope theScope(PhaseTimer::LOAD); };
+
+    printf("%-28s %10s\n", "case", "ns");
+
+    Trace::SetSampleRate(0);
+    Trace::Begin();
+    printf("%-28s %10.1f\n", "span, tracing off", time_it(nIterations, span));
+    printf("%-28s %10.1f\n", "span+arg, tracing off",
+           time_it(nIterations, spanArg));
+    printf("%-28s %10.1f\n", "phase scope, no Begin",
+           time_it(nIterations, scope));
+
+    Trace::SetSampleRate(1000);
+    while (!Trace::Begin()) {
+    }
+    std::string strJson;
+    Trace::End(strJson);
+    Trace::Begin(); // the next 999 requests are not sampled
+    printf("%-28s %10.1f\n", "span, request not sampled",
+           time_it(nIterations, span));
+
+    Trace::SetSampleRate(1);
+    Trace::Begin();
+    printf("%-28s %10.1f\n", "span, traced", time_it(nTraced, span));
+    Trace::End(strJson);
+    Trace::Begin();
+    printf("%-28s %10.1f\n", "span+arg, traced", time_it(nTraced, spanArg));
+
+    const auto start = std::chrono::steady_clock::now();
+    Trace::End(strJson);
+    const auto end = std::chrono::steady_clock::now();
+    printf("export of %d spans: %.1f ms, %zu bytes\n", nTraced,
+           std::chrono::duration<double, std::milli>(end - start).count(),
+           strJson.size());
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "common/TestHelpers.hpp"
+
+#include <opentxs/core/crypto/OTKeypair.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/crypto/OTPasswordData.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <cstring>
+
+namespace opentxs
+{
+namespace test
+{
+
+const char PASSPHRASE[] = "test passphrase";
+
+const char NYM_ID[] = "ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1";
+const char ACCT_ID[] = "ot2C4ZXzFSHkXWVSvEJy5mtHHYg7T1ZtDn8";
+const char NOTARY_ID[] = "ot2A2hYrXjS9bZCBcFZnHQ1tmLzNkHqhYpK";
+
+std::unique_ptr<Nym> new_nym()
+{
+    OTKeypair theKeypair;
+    String strCert;
+    std::unique_ptr<Nym> pNym(new Nym);
+
+    if (!theKeypair.MakeNewKeypair(1024) ||
+        !theKeypair.SaveCertAndPrivateKeyToString(strCert) ||
+        !pNym->Loadx509CertAndPrivateKeyFromString(strCert) ||
+        !pNym->SetIdentifierByPubkey())
+        pNym.reset();
+
+    return pNym;
+}
+
+} // namespace test
+} // namespace opentxs
+
+extern "C" int32_t test_pass_cb(char* buf, int32_t size, int32_t,
+                                void* userdata)
+{
+    const int32_t nLength =
+        static_cast<int32_t>(strlen(opentxs::test::PASSPHRASE));
+    const opentxs::OTPasswordData* pPWData =
+        static_cast<const opentxs::OTPasswordData*>(userdata);
+
+    if ((nullptr != pPWData) && pPWData->isForCachedKey() &&
+        (nullptr != pPWData->GetMasterPW())) {
+        pPWData->GetMasterPW()->setPassword(opentxs::test::PASSPHRASE,
+                                            nLength);
+
+        return nLength;
+    }
+
+    if (nLength >= size) return 0;
+
+    strncpy(buf, opentxs::test::PASSPHRASE, size);
+
+    return nLength;
+}
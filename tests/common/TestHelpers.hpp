@@ -0,0 +1,39 @@
+#ifndef OPENTXS_TESTS_COMMON_TESTHELPERS_HPP
+#define OPENTXS_TESTS_COMMON_TESTHELPERS_HPP
+
+#include <cstdint>
+#include <memory>
+
+// Fixtures shared by the unit tests and the benchmarks.
+
+namespace opentxs
+{
+
+class Nym;
+
+namespace test
+{
+
+// What test_pass_cb answers with.
+extern const char PASSPHRASE[];
+
+// IDs for fixtures that only need well-formed ones.
+extern const char NYM_ID[];
+extern const char ACCT_ID[];
+extern const char NOTARY_ID[];
+
+// A Nym with just an RSA keypair, no credentials, and its ID hashed from
+// the public key. Null on failure. Needs test_pass_cb (or another password
+// callback) to be set.
+std::unique_ptr<Nym> new_nym();
+
+} // namespace test
+} // namespace opentxs
+
+// Password callback for OTAsymmetricKey::SetPasswordCallback. Copies
+// test::PASSPHRASE into buf, or into the master passphrase when OTCachedKey
+// is the one asking.
+extern "C" int32_t test_pass_cb(char* buf, int32_t size, int32_t rwflag,
+                                void* userdata);
+
+#endif // OPENTXS_TESTS_COMMON_TESTHELPERS_HPP
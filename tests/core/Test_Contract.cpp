@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+const std::string CONTENT =
+    "-----BEGIN SIGNED MESSAGE-----\n"
+    "Hash: SHA256\n\n"
+    "<?xml version=\"1.0\"?>\n"
+    "<notaryMessage version=\"2.0\" dateSigned=\"1\">\n\n"
+    "</notaryMessage>\n\n";
+
+const std::string SIGNATURE =
+    "-----BEGIN MESSAGE SIGNATURE-----\n\n"
+    "iQIcBAEBCAAGBQJVd2jWAAoJEE2fCcWeI/Wqv1MP/3JmZx8xAbCd\n"
+    "ZmF0aGVyIG9mIGFsbCBiYXNlNjQgbGluZXM=\n";
+
+const std::string END = "-----END MESSAGE SIGNATURE-----\n";
+
+class ParsedMessage : public Message
+{
+public:
+    size_t SignatureCount() const
+    {
+        return m_listSignatures.size();
+    }
+};
+
+} // namespace
+
+TEST(Contract, parses_signature_blocks)
+{
+    ParsedMessage theMessage;
+
+    ASSERT_TRUE(theMessage.LoadContractFromString(
+        String(CONTENT + SIGNATURE + END + SIGNATURE + END)));
+    EXPECT_EQ(2U, theMessage.SignatureCount());
+}
+
+TEST(Contract, unterminated_signature_is_an_error)
+{
+    ParsedMessage theOnly;
+    EXPECT_FALSE(theOnly.LoadContractFromString(String(CONTENT + SIGNATURE)));
+    EXPECT_EQ(0U, theOnly.SignatureCount());
+
+    // Just the opening line.
+    ParsedMessage theEmpty;
+    EXPECT_FALSE(theEmpty.LoadContractFromString(
+        String(CONTENT + "-----BEGIN MESSAGE SIGNATURE-----\n")));
+    EXPECT_EQ(0U, theEmpty.SignatureCount());
+
+    // After a complete one, which is kept.
+    ParsedMessage theSecond;
+    EXPECT_FALSE(theSecond.LoadContractFromString(
+        String(CONTENT + SIGNATURE + END + SIGNATURE)));
+    EXPECT_EQ(1U, theSecond.SignatureCount());
+}
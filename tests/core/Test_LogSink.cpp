@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/LogSink.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Collects what the sink writes. The writer can be held inside a write, to
+// fill the ring or to catch Flush() and Stop() returning early.
+class Output
+{
+public:
+    LogSink::Writer Writer()
+    {
+        return [this](const std::string& strBatch) { Write(strBatch); };
+    }
+
+    void Hold()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = false;
+        cv_.notify_all();
+    }
+
+    // Until the writer is stuck in Hold().
+    void WaitUntilHeld()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return waiting_; });
+    }
+
+    std::vector<std::string> Lines()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> lines;
+        std::istringstream stream(text_);
+
+        for (std::string line; std::getline(stream, line);)
+            lines.push_back(line);
+
+        return lines;
+    }
+
+private:
+    void Write(const std::string& strBatch)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        waiting_ = held_;
+        cv_.notify_all();
+        cv_.wait(lock, [this]() { return !held_; });
+        waiting_ = false;
+
+        text_ += strBatch;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool held_ = false;
+    bool waiting_ = false;
+    std::string text_;
+};
+
+std::string line(int nProducer, int nIndex)
+{
+    return std::to_string(nProducer) + " " + std::to_string(nIndex) + "\n";
+}
+
+} // namespace
+
+TEST(LogSink, push_fails_while_stopped)
+{
+    Output theOutput;
+    LogSink theSink(16, theOutput.Writer());
+
+    EXPECT_FALSE(theSink.Push("before\n", false));
+
+    theSink.Start();
+    EXPECT_TRUE(theSink.Push("during\n", false));
+    theSink.Stop();
+
+    EXPECT_FALSE(theSink.Push("after\n", false));
+    EXPECT_EQ(std::vector<std::string>{"during"}, theOutput.Lines());
+}
+
+TEST(LogSink, producers_lose_nothing_below_capacity)
+{
+    const int nProducers = 4;
+    const int nLines = 1000; // 4000 in all, below the 8192 slots.
+
+    Output theOutput;
+    LogSink theSink(LogSink::RingSize, theOutput.Writer());
+    theSink.Start();
+
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < nProducers; ++p) {
+        producers.emplace_back([&theSink, p]() {
+            for (int i = 0; i < nLines; ++i)
+                ASSERT_TRUE(theSink.Push(line(p, i).c_str(), false));
+        });
+    }
+
+    for (auto& producer : producers) producer.join();
+
+    theSink.Stop();
+
+    EXPECT_EQ(0U, theSink.Dropped());
+
+    const auto lines = theOutput.Lines();
+    ASSERT_EQ(static_cast<size_t>(nProducers * nLines), lines.size());
+
+    // Each producer's lines come out in the order it pushed them.
+    std::vector<int> next(nProducers, 0);
+
+    for (const auto& str : lines) {
+        int p = -1, i = -1;
+        ASSERT_EQ(2, std::sscanf(str.c_str(), "%d %d", &p, &i)) << str;
+        ASSERT_TRUE((0 <= p) && (p < nProducers)) << str;
+        EXPECT_EQ(next[p], i);
+        next[p] = i + 1;
+    }
+}
+
+TEST(LogSink, overflow_is_counted_and_reported)
+{
+    Output theOutput;
+    LogSink theSink(8, theOutput.Writer());
+    theSink.Start();
+
+    // Park the writer, with the ring empty behind it.
+    theOutput.Hold();
+    ASSERT_TRUE(theSink.Push("first\n", false));
+    theOutput.WaitUntilHeld();
+
+    for (int i = 0; i < 8 + 5; ++i)
+        ASSERT_TRUE(theSink.Push(line(0, i).c_str(), false));
+
+    EXPECT_EQ(5U, theSink.Dropped());
+
+    theOutput.Release();
+    theSink.Stop();
+
+    const auto lines = theOutput.Lines();
+    ASSERT_EQ(1U + 8U + 1U, lines.size());
+    EXPECT_EQ("first", lines.front());
+
+    for (int i = 0; i < 8; ++i)
+        EXPECT_EQ(line(0, i), lines[1 + i] + "\n");
+
+    EXPECT_EQ(std::to_string(theSink.Dropped()) +
+                  " log messages dropped: log ring full",
+              lines.back());
+}
+
+TEST(LogSink, flush_waits_for_queued_lines)
+{
+    Output theOutput;
+    LogSink theSink(64, theOutput.Writer());
+    theSink.Start();
+
+    theOutput.Hold();
+    ASSERT_TRUE(theSink.Push("first\n", false));
+    theOutput.WaitUntilHeld();
+
+    for (int i = 0; i < 10; ++i)
+        ASSERT_TRUE(theSink.Push(line(0, i).c_str(), false));
+
+    std::atomic<bool> bFlushed(false);
+    size_t lWrittenAtFlush = 0;
+
+    std::thread flusher([&]() {
+        theSink.Flush();
+        lWrittenAtFlush = theOutput.Lines().size();
+        bFlushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(bFlushed);
+
+    theOutput.Release();
+    flusher.join();
+
+    EXPECT_EQ(11U, lWrittenAtFlush);
+
+    theSink.Stop();
+}
+
+TEST(LogSink, stop_drains_the_ring)
+{
+    Output theOutput;
+    LogSink theSink(64, theOutput.Writer());
+    theSink.Start();
+
+    theOutput.Hold();
+    ASSERT_TRUE(theSink.Push("first\n", false));
+    theOutput.WaitUntilHeld();
+
+    for (int i = 0; i < 20; ++i)
+        ASSERT_TRUE(theSink.Push(line(0, i).c_str(), false));
+
+    std::thread stopper([&]() { theSink.Stop(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    theOutput.Release();
+    stopper.join();
+
+    EXPECT_EQ(21U, theOutput.Lines().size());
+    EXPECT_EQ(0U, theSink.Dropped());
+}
+
+// Stop() takes the writer thread out of the sink before it has drained the
+// ring. A Flush() in that window still has to wait for the lines.
+TEST(LogSink, flush_waits_while_stop_drains)
+{
+    Output theOutput;
+    LogSink theSink(64, theOutput.Writer());
+    theSink.Start();
+
+    theOutput.Hold();
+    ASSERT_TRUE(theSink.Push("first\n", false));
+    theOutput.WaitUntilHeld();
+
+    for (int i = 0; i < 3; ++i)
+        ASSERT_TRUE(theSink.Push(line(0, i).c_str(), false));
+
+    std::thread stopper([&]() { theSink.Stop(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::atomic<bool> bFlushed(false);
+    size_t lWrittenAtFlush = 0;
+
+    std::thread flusher([&]() {
+        theSink.Flush();
+        lWrittenAtFlush = theOutput.Lines().size();
+        bFlushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(bFlushed);
+
+    theOutput.Release();
+    flusher.join();
+    stopper.join();
+
+    EXPECT_EQ(4U, lWrittenAtFlush);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/NumList.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <set>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string output(const NumList& theList)
+{
+    String strOutput;
+    theList.Output(strOutput);
+    return strOutput.Get();
+}
+
+} // namespace
+
+TEST(NumList, runs_are_written_as_ranges)
+{
+    NumList theList;
+
+    for (int64_t i = 1001; i <= 1100; ++i) theList.Add(i);
+    theList.Add(1205);
+    theList.Add(7);
+    theList.Add(8);
+
+    ASSERT_EQ(103, theList.Count());
+    ASSERT_EQ("7,8,1001-1100,1205", output(theList));
+
+    NumList::SetRangeOutput(false);
+    const std::string str_plain = output(theList);
+    NumList::SetRangeOutput(true);
+
+    ASSERT_EQ(std::string::npos, str_plain.find('-'));
+    ASSERT_TRUE(theList.Verify(NumList(str_plain)));
+}
+
+TEST(NumList, parses_both_forms)
+{
+    const NumList theRanges(String("1001-1100, 1205"));
+    ASSERT_EQ(101, theRanges.Count());
+    ASSERT_TRUE(theRanges.Verify(1050));
+    ASSERT_FALSE(theRanges.Verify(1101));
+
+    std::set<int64_t> theNumbers;
+    for (int64_t i = 1001; i <= 1100; ++i) theNumbers.insert(i);
+    theNumbers.insert(1205);
+
+    ASSERT_TRUE(theRanges.Verify(NumList(theNumbers)));
+
+    NumList theList(String("0,3,4,5"));
+    ASSERT_EQ(4, theList.Count());
+    ASSERT_TRUE(theList.Verify(0));
+
+    // Overlapping a range that is already there reports the duplicates.
+    ASSERT_FALSE(theList.Add(String("5-9")));
+    ASSERT_EQ(8, theList.Count());
+    ASSERT_TRUE(theList.Add(String("10-12")));
+    ASSERT_EQ("0,3-12", output(theList));
+}
+
+TEST(NumList, rejects_bad_ranges)
+{
+    NumList theList;
+    ASSERT_FALSE(theList.Add(String("10-5")));
+    ASSERT_FALSE(theList.Add(String("-5")));
+    ASSERT_FALSE(theList.Add(String("1-2-3")));
+    ASSERT_FALSE(theList.Add(String("1-")));
+    ASSERT_FALSE(theList.Add(String("0-9000000000")));
+    ASSERT_EQ(0, theList.Count());
+}
+
+TEST(NumList, verify_any)
+{
+    const NumList theList(String("100-200,300"));
+
+    ASSERT_TRUE(theList.VerifyAny(NumList(String("50-100"))));
+    ASSERT_TRUE(theList.VerifyAny(NumList(String("300"))));
+    ASSERT_FALSE(theList.VerifyAny(NumList(String("201-299,301"))));
+
+    NumList theCopy;
+    int64_t lNumber = 0;
+    ASSERT_TRUE(theList.Peek(lNumber));
+    ASSERT_EQ(100, lNumber);
+    ASSERT_TRUE(theCopy.Add(theList));
+    ASSERT_TRUE(theCopy.Pop());
+    ASSERT_EQ(101, theCopy.Count());
+    ASSERT_FALSE(theCopy.Verify(theList));
+}
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/core/util/OTDataFolder.hpp>
+#include <opentxs/core/util/OTFolders.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+using test::NYM_ID;
+
+// Exposes what SaveSignedNymfile and LoadSignedNymfile do around the
+// signature.
+class MailNym : public Nym
+{
+public:
+    MailNym()
+        : Nym(String(NYM_ID))
+    {
+    }
+
+    bool SaveNymfile(String& strNym)
+    {
+        StoreMail(String(NYM_ID));
+        return SavePseudonym(strNym, true);
+    }
+
+    bool LoadNymfile(const String& strNym)
+    {
+        return LoadFromString(strNym, nullptr, nullptr, nullptr, true);
+    }
+
+    void SavedNymfile()
+    {
+        EraseRemovedMail(String(NYM_ID));
+    }
+};
+
+Message* new_message(int32_t nNumber)
+{
+    String strMessage;
+    strMessage.Format("-----BEGIN SIGNED MESSAGE-----\nHash: SHA256\n\n"
+                      "<?xml version=\"1.0\"?>\n"
+                      "<notaryMessage version=\"2.0\" dateSigned=\"%d\">\n\n"
+                      "</notaryMessage>\n\n"
+                      "-----BEGIN MESSAGE SIGNATURE-----\n\n"
+                      "iQIcBAEBCAAGBQJVd2jWAAoJEE2fCcWeI/Wqv1MP/3JmZx8xAbCd\n"
+                      "-----END MESSAGE SIGNATURE-----\n",
+                      nNumber);
+
+    Message* pMessage = new Message;
+
+    if (!pMessage->LoadContractFromString(strMessage)) {
+        delete pMessage;
+        return nullptr;
+    }
+
+    return pMessage;
+}
+
+std::string mail_id(const Message& theMessage)
+{
+    Identifier theID;
+    theID.CalculateDigest(String(theMessage));
+
+    return String(theID).Get();
+}
+
+bool mail_exists(const char* szBox, const std::string& str_id)
+{
+    return OTDB::Exists(OTFolders::Mail().Get(), NYM_ID, szBox, str_id);
+}
+
+class Test_NymMail : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        OTDataFolder::Init("unittests");
+        OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+    }
+
+    void SetUp()
+    {
+        Message* pMail = new_message(1);
+        Message* pOutmail = new_message(2);
+        Message* pOutpayment = new_message(3);
+        ASSERT_TRUE(nullptr != pMail);
+        ASSERT_TRUE(nullptr != pOutmail);
+        ASSERT_TRUE(nullptr != pOutpayment);
+
+        strMail_ = String(*pMail).Get();
+        strMailID_ = mail_id(*pMail);
+        strOutmailID_ = mail_id(*pOutmail);
+        strOutpaymentID_ = mail_id(*pOutpayment);
+
+        // The Nym owns them from here on.
+        theNym_.AddMail(*pMail);
+        theNym_.AddOutmail(*pOutmail);
+        theNym_.AddOutpayments(*pOutpayment);
+        ASSERT_TRUE(theNym_.SaveNymfile(strNymfile_));
+    }
+
+    void TearDown()
+    {
+        const std::string strFolder(OTFolders::Mail().Get());
+
+        OTDB::EraseValueByKey(strFolder, NYM_ID, "mail", strMailID_);
+        OTDB::EraseValueByKey(strFolder, NYM_ID, "outmail", strOutmailID_);
+        OTDB::EraseValueByKey(strFolder, NYM_ID, "outpayments",
+                              strOutpaymentID_);
+    }
+
+    MailNym theNym_;
+    std::string strMail_;
+    std::string strMailID_;
+    std::string strOutmailID_;
+    std::string strOutpaymentID_;
+    String strNymfile_;
+};
+
+} // namespace
+
+TEST_F(Test_NymMail, stored_by_reference)
+{
+    ASSERT_TRUE(mail_exists("mail", strMailID_));
+    ASSERT_TRUE(mail_exists("outmail", strOutmailID_));
+    ASSERT_TRUE(mail_exists("outpayments", strOutpaymentID_));
+
+    const std::string str_nymfile(strNymfile_.Get());
+    ASSERT_NE(std::string::npos,
+              str_nymfile.find("<mailMessageRef ID=\"" + strMailID_));
+    ASSERT_EQ(std::string::npos, str_nymfile.find("<mailMessage>"));
+}
+
+TEST_F(Test_NymMail, load_round_trip)
+{
+    MailNym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadNymfile(strNymfile_));
+
+    ASSERT_EQ(1, theLoaded.GetMailCount());
+    ASSERT_EQ(1, theLoaded.GetOutmailCount());
+    ASSERT_EQ(1, theLoaded.GetOutpaymentsCount());
+    ASSERT_EQ(strMail_, String(*theLoaded.GetMailByIndex(0)).Get());
+    ASSERT_EQ(strOutmailID_, mail_id(*theLoaded.GetOutmailByIndex(0)));
+    ASSERT_EQ(strOutpaymentID_, mail_id(*theLoaded.GetOutpaymentsByIndex(0)));
+
+    // Saving it again writes the same nymfile.
+    String strSaved;
+    ASSERT_TRUE(theLoaded.SaveNymfile(strSaved));
+    ASSERT_STREQ(strNymfile_.Get(), strSaved.Get());
+}
+
+TEST_F(Test_NymMail, portable_copy_inlines_mail)
+{
+    String strExport;
+    ASSERT_TRUE(theNym_.SavePseudonym(strExport));
+
+    const std::string str_export(strExport.Get());
+    ASSERT_EQ(std::string::npos, str_export.find("MessageRef"));
+
+    MailNym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadFromString(strExport));
+    ASSERT_EQ(1, theLoaded.GetMailCount());
+}
+
+TEST_F(Test_NymMail, references_only_from_signed_nymfile)
+{
+    // A Nym that came from a peer mustn't make us read files.
+    MailNym theLoaded;
+    ASSERT_FALSE(theLoaded.LoadFromString(strNymfile_));
+}
+
+TEST_F(Test_NymMail, rejects_malformed_id)
+{
+    for (const char* szID : {"../../nyms/x", "", "ot2xuVPJ/DdweZ"}) {
+        std::string str_nymfile(strNymfile_.Get());
+        str_nymfile.replace(str_nymfile.find(strMailID_), strMailID_.size(),
+                            szID);
+
+        MailNym theLoaded;
+        ASSERT_FALSE(theLoaded.LoadNymfile(String(str_nymfile)));
+    }
+}
+
+TEST_F(Test_NymMail, erase_removed_mail)
+{
+    ASSERT_TRUE(theNym_.RemoveMailByIndex(0));
+
+    // Still listed by the last saved nymfile.
+    ASSERT_TRUE(mail_exists("mail", strMailID_));
+
+    String strSaved;
+    ASSERT_TRUE(theNym_.SaveNymfile(strSaved));
+    theNym_.SavedNymfile();
+
+    ASSERT_FALSE(mail_exists("mail", strMailID_));
+    ASSERT_TRUE(mail_exists("outmail", strOutmailID_));
+
+    MailNym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadNymfile(strSaved));
+    ASSERT_EQ(0, theLoaded.GetMailCount());
+    ASSERT_EQ(1, theLoaded.GetOutmailCount());
+}
+
+TEST_F(Test_NymMail, missing_file_keeps_reference)
+{
+    ASSERT_TRUE(OTDB::EraseValueByKey(OTFolders::Mail().Get(), NYM_ID, "mail",
+                                      strMailID_));
+
+    MailNym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadNymfile(strNymfile_));
+    ASSERT_EQ(0, theLoaded.GetMailCount());
+    ASSERT_EQ(1, theLoaded.GetOutmailCount());
+
+    String strSaved;
+    ASSERT_TRUE(theLoaded.SaveNymfile(strSaved));
+    theLoaded.SavedNymfile();
+    ASSERT_STREQ(strNymfile_.Get(), strSaved.Get());
+}
+
+TEST_F(Test_NymMail, tampered_file_keeps_reference)
+{
+    ASSERT_TRUE(OTDB::StorePlainString(strMail_ + "tampered",
+                                       OTFolders::Mail().Get(), NYM_ID, "mail",
+                                       strMailID_));
+
+    MailNym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadNymfile(strNymfile_));
+    ASSERT_EQ(0, theLoaded.GetMailCount());
+
+    String strSaved;
+    ASSERT_TRUE(theLoaded.SaveNymfile(strSaved));
+    theLoaded.SavedNymfile();
+    ASSERT_STREQ(strNymfile_.Get(), strSaved.Get());
+
+    // Removing the rest of the mail leaves it listed.
+    theLoaded.ClearOutmail();
+    ASSERT_TRUE(theLoaded.SaveNymfile(strSaved));
+
+    const std::string str_saved(strSaved.Get());
+    ASSERT_NE(std::string::npos, str_saved.find(strMailID_));
+}
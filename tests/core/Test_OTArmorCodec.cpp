@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTArmorCodec.hpp>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string sample_xml()
+{
+    std::string str_xml;
+
+    for (int i = 0; i < 50; ++i) {
+        str_xml += "<inboxRecord type=\"transferReceipt\"\n"
+                   " adjustment=\"100\"\n"
+                   " transactionNum=\"" + std::to_string(1000 + i) + "\" />\n";
+    }
+
+    return str_xml;
+}
+
+void round_trip(const std::string& str_input, OTArmorCodec::Codec codec,
+                int32_t level)
+{
+    std::string str_encoded, str_decoded;
+
+    ASSERT_TRUE(OTArmorCodec::Encode(str_input, str_encoded, codec, level));
+    ASSERT_TRUE(OTArmorCodec::Decode(str_encoded, str_decoded));
+    ASSERT_EQ(str_input, str_decoded);
+}
+
+} // namespace
+
+TEST(OTArmorCodec, round_trip_all_codecs)
+{
+    const std::string str_xml = sample_xml();
+
+    for (int32_t level = 0; level <= 9; ++level) {
+        round_trip(str_xml, OTArmorCodec::ZLIB, level);
+        round_trip(str_xml, OTArmorCodec::STORED, level);
+        round_trip(str_xml, OTArmorCodec::ZLIB_DICTIONARY, level);
+    }
+}
+
+TEST(OTArmorCodec, zlib_codec_has_no_header)
+{
+    std::string str_encoded;
+
+    ASSERT_TRUE(OTArmorCodec::Encode(sample_xml(), str_encoded,
+                                     OTArmorCodec::ZLIB, 1));
+    // A bare zlib stream, exactly what older versions produced and expect.
+    ASSERT_EQ(0x78, static_cast<uint8_t>(str_encoded[0]));
+}
+
+TEST(OTArmorCodec, dictionary_codec_has_header)
+{
+    std::string str_encoded;
+
+    ASSERT_TRUE(OTArmorCodec::Encode(sample_xml(), str_encoded,
+                                     OTArmorCodec::ZLIB_DICTIONARY, 1));
+    ASSERT_EQ(OTArmorCodec::HeaderMagic, static_cast<uint8_t>(str_encoded[0]));
+    ASSERT_EQ(OTArmorCodec::HeaderVersion,
+              static_cast<uint8_t>(str_encoded[1]));
+    ASSERT_EQ(OTArmorCodec::ZLIB_DICTIONARY,
+              static_cast<uint8_t>(str_encoded[2]));
+    ASSERT_EQ(OTArmorCodec::DictionaryVersion,
+              static_cast<uint8_t>(str_encoded[3]));
+}
+
+TEST(OTArmorCodec, small_payload_is_stored)
+{
+    const OTArmorCodec::Codec old_codec = OTArmorCodec::GetCodec();
+    const std::string str_input("<note />");
+    std::string str_encoded, str_decoded;
+
+    OTArmorCodec::SetCodec(OTArmorCodec::ZLIB_DICTIONARY);
+    ASSERT_TRUE(OTArmorCodec::Encode(str_input, str_encoded));
+    OTArmorCodec::SetCodec(old_codec);
+
+    ASSERT_EQ(OTArmorCodec::HeaderSize + str_input.size(), str_encoded.size());
+    ASSERT_EQ(OTArmorCodec::STORED, static_cast<uint8_t>(str_encoded[2]));
+    ASSERT_TRUE(OTArmorCodec::Decode(str_encoded, str_decoded));
+    ASSERT_EQ(str_input, str_decoded);
+}
+
+// With the zlib codec, small payloads are zlib streams at level 0 and the
+// rest are compressed. Alternating between them must keep both working.
+TEST(OTArmorCodec, small_and_large_payloads_interleave)
+{
+    const OTArmorCodec::Codec old_codec = OTArmorCodec::GetCodec();
+    const std::string str_small("<note />"), str_large = sample_xml();
+    std::string str_small_encoded, str_large_encoded, str_encoded,
+        str_decoded;
+
+    OTArmorCodec::SetCodec(OTArmorCodec::ZLIB);
+    ASSERT_TRUE(OTArmorCodec::Encode(str_small, str_small_encoded));
+    ASSERT_TRUE(OTArmorCodec::Encode(str_large, str_large_encoded));
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(OTArmorCodec::Encode(str_small, str_encoded));
+        ASSERT_EQ(str_small_encoded, str_encoded);
+        ASSERT_TRUE(OTArmorCodec::Decode(str_encoded, str_decoded));
+        ASSERT_EQ(str_small, str_decoded);
+
+        ASSERT_TRUE(OTArmorCodec::Encode(str_large, str_encoded));
+        ASSERT_EQ(str_large_encoded, str_encoded);
+        ASSERT_LT(str_encoded.size(), str_large.size());
+        ASSERT_TRUE(OTArmorCodec::Decode(str_encoded, str_decoded));
+        ASSERT_EQ(str_large, str_decoded);
+    }
+
+    OTArmorCodec::SetCodec(old_codec);
+}
+
+TEST(OTArmorCodec, rejects_unknown_header_version)
+{
+    std::string str_encoded, str_decoded;
+
+    ASSERT_TRUE(OTArmorCodec::Encode(sample_xml(), str_encoded,
+                                     OTArmorCodec::STORED, 0));
+    str_encoded[1] = static_cast<char>(OTArmorCodec::HeaderVersion + 1);
+    ASSERT_FALSE(OTArmorCodec::Decode(str_encoded, str_decoded));
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+
+#include <opentxs/core/crypto/OTAsymmetricKeyEd25519.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <memory>
+
+using namespace opentxs;
+
+namespace
+{
+
+typedef std::unique_ptr<OTAsymmetricKey_Ed25519> KeyPtr;
+
+KeyPtr new_key()
+{
+    return KeyPtr(dynamic_cast<OTAsymmetricKey_Ed25519*>(
+        OTAsymmetricKey::KeyFactory(OTAsymmetricKey::ED25519)));
+}
+
+class Test_OTAsymmetricKeyEd25519 : public ::testing::Test
+{
+public:
+    KeyPtr m_pPublic;
+    KeyPtr m_pPrivate;
+
+    Test_OTAsymmetricKeyEd25519()
+        : m_pPublic(new_key())
+        , m_pPrivate(new_key())
+    {
+    }
+
+    void SetUp()
+    {
+        OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+        ASSERT_TRUE(m_pPublic && m_pPrivate);
+        ASSERT_TRUE(
+            OTAsymmetricKey_Ed25519::MakeNewKeypair(*m_pPublic, *m_pPrivate));
+    }
+
+    String cert() const
+    {
+        String strPrivate, strPublic, strCert;
+        m_pPrivate->GetPrivateKey(strPrivate, false);
+        m_pPublic->GetPublicKey(strPublic, false);
+        strCert.Format("%s%s", strPrivate.Get(), strPublic.Get());
+        return strCert;
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTAsymmetricKeyEd25519, sign_and_verify)
+{
+    const String strContents("<contract>some contents</contract>\n");
+    OTSignature theSignature;
+
+    ASSERT_TRUE(m_pPrivate->Sign(strContents, theSignature));
+    ASSERT_TRUE(m_pPublic->Verify(strContents, theSignature));
+    ASSERT_FALSE(m_pPublic->Verify(String("<contract>other</contract>\n"),
+                                   theSignature));
+}
+
+TEST_F(Test_OTAsymmetricKeyEd25519, reload_from_cert_string)
+{
+    const String strCert = cert();
+    ASSERT_TRUE(strCert.Contains("-----BEGIN ED25519 PUBLIC KEY-----"));
+    ASSERT_TRUE(
+        strCert.Contains("-----BEGIN ENCRYPTED ED25519 PRIVATE KEY-----"));
+
+    KeyPtr pPublic(new_key()), pPrivate(new_key());
+    ASSERT_TRUE(pPublic->LoadPublicKeyFromCertString(strCert, false));
+    ASSERT_TRUE(pPrivate->LoadPrivateKeyFromCertString(strCert, false));
+
+    const String strContents("reloaded");
+    OTSignature theSignature;
+    ASSERT_TRUE(pPrivate->Sign(strContents, theSignature));
+    ASSERT_TRUE(m_pPublic->Verify(strContents, theSignature));
+}
+
+TEST_F(Test_OTAsymmetricKeyEd25519, export_passphrase)
+{
+    const OTPassword theExportPassword("export passphrase", 17);
+    ASSERT_TRUE(m_pPrivate->ReEncryptPrivateKey(theExportPassword, false));
+
+    const String strCert = cert();
+    KeyPtr pWrong(new_key()), pRight(new_key());
+
+    ASSERT_FALSE(pWrong->LoadPrivateKeyFromCertString(strCert, false));
+    ASSERT_TRUE(pRight->LoadPrivateKeyFromCertString(strCert, false, nullptr,
+                                                     &theExportPassword));
+}
+
+#endif // OT_CRYPTO_SUPPORTED_KEY_ED25519
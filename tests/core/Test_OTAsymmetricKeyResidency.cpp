@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTKeypair.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace opentxs
+{
+
+TEST(OTAsymmetricKey, key_residency_strings)
+{
+    for (auto eResidency :
+         {OTAsymmetricKey::TIMED, OTAsymmetricKey::RESIDENT,
+          OTAsymmetricKey::REFRESH}) {
+        OTAsymmetricKey::KeyResidency eParsed = OTAsymmetricKey::TIMED;
+        ASSERT_TRUE(OTAsymmetricKey::KeyResidencyFromString(
+            OTAsymmetricKey::KeyResidencyToString(eResidency), eParsed));
+        ASSERT_EQ(eResidency, eParsed);
+    }
+
+    OTAsymmetricKey::KeyResidency eParsed = OTAsymmetricKey::TIMED;
+    ASSERT_FALSE(OTAsymmetricKey::KeyResidencyFromString("forever", eParsed));
+}
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+
+// Signs with a private key that starts out armored only, as it does after a
+// Nym is loaded, and can make its OT_KEY_TIMER run out on demand. Restores
+// the key residency afterwards, even if an ASSERT fails.
+class Test_OTAsymmetricKeyResidency : public ::testing::Test
+{
+protected:
+    Test_OTAsymmetricKeyResidency()
+        : eOldResidency_(OTAsymmetricKey::GetKeyResidency())
+        , contents_("<contract>residency</contract>\n")
+    {
+    }
+
+    ~Test_OTAsymmetricKeyResidency()
+    {
+        OTAsymmetricKey::SetKeyResidency(eOldResidency_);
+    }
+
+    bool load_key(OTAsymmetricKey::KeyType eKeyType,
+                  OTAsymmetricKey::KeyResidency eResidency)
+    {
+        OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+        OTAsymmetricKey::SetKeyResidency(eResidency);
+
+        OTKeypair theNew;
+        String strCert;
+
+        return theNew.MakeNewKeypair(1024, eKeyType) &&
+               theNew.SaveCertAndPrivateKeyToString(strCert) &&
+               keypair_.LoadCertAndPrivateKeyFromString(strCert);
+    }
+
+    bool sign()
+    {
+        OTSignature theSignature;
+
+        return OTCrypto::It()->SignContract(contents_,
+                                            keypair_.GetPrivateKey(),
+                                            theSignature,
+                                            Identifier::DefaultHashAlgorithm) &&
+               OTCrypto::It()->VerifySignature(
+                   contents_, keypair_.GetPublicKey(), theSignature,
+                   Identifier::DefaultHashAlgorithm);
+    }
+
+    // As if OT_KEY_TIMER had run out since the key was last decrypted.
+    void expire_key_timer()
+    {
+        const_cast<OTAsymmetricKey&>(keypair_.GetPrivateKey()).m_timer.clear();
+    }
+
+    const OTAsymmetricKey::KeyResidency eOldResidency_;
+    const String contents_;
+    OTKeypair keypair_;
+};
+
+TEST_F(Test_OTAsymmetricKeyResidency, timed_rsa_key_is_decrypted_again)
+{
+    ASSERT_TRUE(load_key(OTAsymmetricKey::RSA, OTAsymmetricKey::TIMED));
+    ASSERT_TRUE(sign());
+
+    const int64_t lInstantiations = OTAsymmetricKey::GetKeyInstantiations();
+
+    ASSERT_TRUE(sign());
+    ASSERT_EQ(lInstantiations, OTAsymmetricKey::GetKeyInstantiations());
+
+    expire_key_timer();
+    ASSERT_TRUE(sign());
+    ASSERT_EQ(lInstantiations + 1, OTAsymmetricKey::GetKeyInstantiations());
+}
+
+TEST_F(Test_OTAsymmetricKeyResidency, resident_rsa_key_outlives_the_timer)
+{
+    ASSERT_TRUE(load_key(OTAsymmetricKey::RSA, OTAsymmetricKey::RESIDENT));
+    ASSERT_TRUE(sign());
+
+    const int64_t lInstantiations = OTAsymmetricKey::GetKeyInstantiations();
+
+    for (int32_t i = 0; i < 3; ++i) {
+        expire_key_timer();
+        ASSERT_TRUE(sign());
+    }
+
+    ASSERT_EQ(lInstantiations, OTAsymmetricKey::GetKeyInstantiations());
+}
+
+// Once the timer runs out the key is decrypted again in the background,
+// while the old instance keeps signing. The new one is swapped in on a
+// later use, once it is ready.
+TEST_F(Test_OTAsymmetricKeyResidency, refresh_rsa_key_in_the_background)
+{
+    ASSERT_TRUE(load_key(OTAsymmetricKey::RSA, OTAsymmetricKey::REFRESH));
+    ASSERT_TRUE(sign());
+
+    const int64_t lInstantiations = OTAsymmetricKey::GetKeyInstantiations();
+    const int64_t lRefreshes = OTAsymmetricKey::GetKeyRefreshes();
+
+    expire_key_timer();
+    ASSERT_TRUE(sign());
+
+    for (int32_t i = 0;
+         (i < 1000) && (lRefreshes == OTAsymmetricKey::GetKeyRefreshes());
+         ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ASSERT_TRUE(sign());
+    }
+
+    ASSERT_EQ(lRefreshes + 1, OTAsymmetricKey::GetKeyRefreshes());
+    ASSERT_EQ(lInstantiations + 1, OTAsymmetricKey::GetKeyInstantiations());
+
+    // The refreshed key restarted the timer.
+    ASSERT_TRUE(sign());
+    ASSERT_EQ(lRefreshes + 1, OTAsymmetricKey::GetKeyRefreshes());
+}
+
+#if defined(OT_CRYPTO_SUPPORTED_KEY_ED25519)
+
+TEST_F(Test_OTAsymmetricKeyResidency, resident_ed25519_key_outlives_the_timer)
+{
+    ASSERT_TRUE(
+        load_key(OTAsymmetricKey::ED25519, OTAsymmetricKey::RESIDENT));
+    ASSERT_TRUE(sign());
+
+    const int64_t lInstantiations = OTAsymmetricKey::GetKeyInstantiations();
+
+    for (int32_t i = 0; i < 3; ++i) {
+        expire_key_timer();
+        ASSERT_TRUE(sign());
+    }
+
+    ASSERT_EQ(lInstantiations, OTAsymmetricKey::GetKeyInstantiations());
+
+    // Whereas a timed one is unsealed again.
+    OTAsymmetricKey::SetKeyResidency(OTAsymmetricKey::TIMED);
+    expire_key_timer();
+    ASSERT_TRUE(sign());
+    ASSERT_EQ(lInstantiations + 1, OTAsymmetricKey::GetKeyInstantiations());
+}
+
+#endif // OT_CRYPTO_SUPPORTED_KEY_ED25519
+
+#endif // OT_CRYPTO_USING_OPENSSL
+
+} // namespace opentxs
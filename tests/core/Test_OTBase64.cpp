@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTBase64.hpp>
+#include <opentxs/core/OTData.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string encode(const std::vector<uint8_t>& input, bool bLineBreaks)
+{
+    std::string str_output(OTBase64::EncodedSize(input.size(), bLineBreaks),
+                           '\0');
+    const size_t lWritten = OTBase64::Encode(input.data(), input.size(),
+                                             &str_output[0], bLineBreaks);
+    EXPECT_EQ(str_output.size(), lWritten);
+    return str_output;
+}
+
+std::vector<uint8_t> pattern(size_t lSize)
+{
+    std::vector<uint8_t> output(lSize);
+
+    for (size_t i = 0; i < lSize; ++i) {
+        output[i] = static_cast<uint8_t>((i * 131 + 7) & 0xff);
+    }
+
+    return output;
+}
+
+// Runs the checks against every implementation this CPU supports.
+void for_each_implementation(void (*check)())
+{
+    const std::string str_old = OTBase64::Implementation();
+
+    for (const char* szName : {"scalar", "ssse3", "avx2"}) {
+        if (!OTBase64::SetImplementation(szName)) continue;
+        SCOPED_TRACE(szName);
+        check();
+    }
+
+    OTBase64::SetImplementation(str_old.c_str());
+}
+
+} // namespace
+
+TEST(OTBase64, known_vectors)
+{
+    for_each_implementation([]() {
+        const std::string str_input("foobar");
+        const std::vector<uint8_t> input(str_input.begin(), str_input.end());
+        const char* expected[] = {"",     "Zg==",     "Zm8=",    "Zm9v",
+                                  "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+
+        for (size_t i = 0; i <= input.size(); ++i) {
+            const std::vector<uint8_t> prefix(input.begin(),
+                                              input.begin() + i);
+            ASSERT_EQ(expected[i], encode(prefix, false));
+        }
+    });
+}
+
+TEST(OTBase64, line_layout_matches_openssl)
+{
+    for_each_implementation([]() {
+        // 48 input bytes fill exactly one 64 character line.
+        ASSERT_EQ(65u, encode(pattern(48), true).size());
+        ASSERT_EQ('\n', encode(pattern(48), true)[64]);
+        ASSERT_EQ(std::string::npos, encode(pattern(48), false).find('\n'));
+        // A partial last line is terminated too.
+        ASSERT_EQ(65u + 5u, encode(pattern(49), true).size());
+        ASSERT_EQ('\n', encode(pattern(49), true).back());
+    });
+}
+
+TEST(OTBase64, round_trip)
+{
+    for_each_implementation([]() {
+        for (size_t lSize = 0; lSize < 600; ++lSize) {
+            const std::vector<uint8_t> input = pattern(lSize);
+
+            for (bool bLineBreaks : {true, false}) {
+                const std::string str_encoded = encode(input, bLineBreaks);
+                OTData theData;
+
+                ASSERT_TRUE(OTBase64::Decode(str_encoded.data(),
+                                             str_encoded.size(), theData,
+                                             bLineBreaks));
+                ASSERT_EQ(OTData(input.data(), input.size()), theData);
+            }
+        }
+    });
+}
+
+TEST(OTBase64, decode_skips_whitespace)
+{
+    for_each_implementation([]() {
+        const std::vector<uint8_t> input = pattern(300);
+        std::string str_crlf;
+
+        for (char c : encode(input, true)) {
+            if ('\n' == c) str_crlf += "\r\n";
+            else str_crlf += c;
+        }
+
+        OTData theData;
+        ASSERT_TRUE(
+            OTBase64::Decode(str_crlf.data(), str_crlf.size(), theData));
+        ASSERT_EQ(OTData(input.data(), input.size()), theData);
+    });
+}
+
+TEST(OTBase64, decode_rejects_garbage)
+{
+    for_each_implementation([]() {
+        std::string str_encoded = encode(pattern(300), true);
+        str_encoded[100] = '*';
+
+        OTData theData;
+        ASSERT_FALSE(OTBase64::Decode(str_encoded.data(), str_encoded.size(),
+                                      theData));
+
+        // Truncated input.
+        ASSERT_FALSE(OTBase64::Decode("Zm9vY", 5, theData));
+    });
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_OTCryptoPool : public ::testing::Test
+{
+public:
+    int32_t m_nOldThreads;
+
+    Test_OTCryptoPool()
+        : m_nOldThreads(OTCryptoPool::GetThreads())
+    {
+    }
+
+    void TearDown()
+    {
+        OTCryptoPool::SetThreads(m_nOldThreads);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTCryptoPool, results_come_back_in_order)
+{
+    OTCryptoPool::SetThreads(4);
+
+    listOfCryptoFutures theFutures;
+
+    for (int32_t i = 0; i < 100; ++i) {
+        theFutures.push_back(
+            OTCryptoPool::Submit([i]() { return 0 == (i % 3); }));
+    }
+
+    for (int32_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(0 == (i % 3), theFutures[i].get());
+    }
+}
+
+TEST_F(Test_OTCryptoPool, wait_all)
+{
+    OTCryptoPool::SetThreads(2);
+
+    std::atomic<int32_t> nRun(0);
+    listOfCryptoFutures theFutures;
+
+    for (int32_t i = 0; i < 10; ++i) {
+        theFutures.push_back(OTCryptoPool::Submit([&nRun]() {
+            ++nRun;
+            return true;
+        }));
+    }
+
+    ASSERT_TRUE(OTCryptoPool::WaitAll(theFutures));
+    ASSERT_EQ(10, nRun.load());
+
+    theFutures.clear();
+    theFutures.push_back(OTCryptoPool::Ready(true));
+    theFutures.push_back(OTCryptoPool::Submit([]() { return false; }));
+    ASSERT_FALSE(OTCryptoPool::WaitAll(theFutures));
+}
+
+TEST_F(Test_OTCryptoPool, no_threads_runs_inline)
+{
+    OTCryptoPool::SetThreads(0);
+
+    const std::thread::id theCaller = std::this_thread::get_id();
+    std::thread::id theRunner;
+
+    std::future<bool> theFuture = OTCryptoPool::Submit([&theRunner]() {
+        theRunner = std::this_thread::get_id();
+        return true;
+    });
+
+    ASSERT_TRUE(theFuture.get());
+    ASSERT_EQ(theCaller, theRunner);
+}
+
+TEST_F(Test_OTCryptoPool, shutdown_finishes_queued_jobs)
+{
+    OTCryptoPool::SetThreads(1);
+
+    std::atomic<int32_t> nRun(0);
+    listOfCryptoFutures theFutures;
+
+    for (int32_t i = 0; i < 20; ++i) {
+        theFutures.push_back(OTCryptoPool::Submit([&nRun]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++nRun;
+            return true;
+        }));
+    }
+
+    OTCryptoPool::Shutdown();
+    ASSERT_EQ(20, nRun.load());
+    ASSERT_TRUE(OTCryptoPool::WaitAll(theFutures));
+}
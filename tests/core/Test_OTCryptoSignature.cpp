@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace opentxs;
+
+namespace
+{
+
+// Signatures made the way SignContract did before it kept its digest and key
+// contexts per thread: the default hash is RSA-PSS (SHA-256, maximum salt
+// length) over the double SHA-256 of the contents, and SHA256 is what
+// EVP_SignFinal makes (PKCS #1 v1.5.) They must keep verifying.
+const char CERT[] =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIICAjCCAWugAwIBAgIUUpo9+gE8YFid2T0FOIJOOmk1COYwDQYJKoZIhvcNAQEL\n"
+    "BQAwEjEQMA4GA1UEAwwHZml4dHVyZTAgFw0yNjEwMTkwNTI2MTVaGA8yMTI2MDky\n"
+    "NTA1MjYxNVowEjEQMA4GA1UEAwwHZml4dHVyZTCBnzANBgkqhkiG9w0BAQEFAAOB\n"
+    "jQAwgYkCgYEA2kAoN04V5IkrGIad02K8cS5XbPGd5TalQoyykJ7yEEdVJwehT2ON\n"
+    "FEw31Fb8A4MsAGHTo7V6PbIJj3C3xjaTa5eYBEW7jfgIHovrIiqzBMinaZv8LeIi\n"
+    "LbO9a3G4IgmAHmuz6Da72GwoCXPK9w2idQUmP6WMd0JLPW7VrCvTcTUCAwEAAaNT\n"
+    "MFEwHQYDVR0OBBYEFJWQWwjIYEQSo+2BkZvjJaeUyA/1MB8GA1UdIwQYMBaAFJWQ\n"
+    "WwjIYEQSo+2BkZvjJaeUyA/1MA8GA1UdEwEB/wQFMAMBAf8wDQYJKoZIhvcNAQEL\n"
+    "BQADgYEASJZXFAOrmWWABcbeREAhsghtD6btrOhgOs1KRpCN9O4O4aBq2qefNHnp\n"
+    "OyujjhWUeizM6ihBlwdbB5lQe7gKOP2hAdBF1udVryvvVy5qpfys4phBz56mU13Q\n"
+    "ObrXt/g6Hce5SExkieOKpWsEQFdo3LYbpmJjOdw9WbNCNo03Oys=\n"
+    "-----END CERTIFICATE-----\n";
+
+const char CONTENTS[] = "<contract>\n"
+                        "Signed before the signing contexts were cached.\n"
+                        "</contract>\n";
+
+const char DEFAULT_HASH_SIGNATURE[] =
+    "dnxmt7zAG81+XhRkPP15ZiksZtg+oKxs7LRYLt0UprYYGDr4JXHdvm64EUrZnPxJ\n"
+    "Zx4q08GmhQNzOS0vJIC3LuXPFrIjlyyrSvPeLjj8qF82mZ3iU3fn7s4v2MmZdUqK\n"
+    "uSENYDWfyYARcKGK2LDwm5EuoFbrKUcc3Dq7sJQEk1g=\n";
+
+const char SHA256_SIGNATURE[] =
+    "P+CKySk7kMki2txqh9EaQEMO7tnwyZbeOfRaUqVZFstnPKNXUnf24q8rQac64E1J\n"
+    "Ng3Ups13S8Eu4IKW2cK2EC1pmKM6dmk24Y3dEm2MHNaK2i6Mi9VDud6TJwTucBkd\n"
+    "07SSPepWhmNlaqju4bMV560ECCUTq8LY0EYO80BWQHw=\n";
+
+class Test_OTCryptoSignature : public ::testing::Test
+{
+protected:
+    Test_OTCryptoSignature()
+        : bOldCache_(OTSignatureCache::IsEnabled())
+        , pFixtureKey_(OTAsymmetricKey::KeyFactory(OTAsymmetricKey::RSA))
+    {
+    }
+
+    void SetUp()
+    {
+        OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+        OTSignatureCache::SetEnabled(false);
+
+        ASSERT_TRUE(pFixtureKey_);
+        ASSERT_TRUE(pFixtureKey_->LoadPublicKeyFromCertString(CERT, false));
+    }
+
+    void TearDown()
+    {
+        OTSignatureCache::SetEnabled(bOldCache_);
+    }
+
+    bool verify_fixture(const String& strContents, const char* szSignature,
+                        const String& strHashType) const
+    {
+        return OTCrypto::It()->VerifySignature(strContents, *pFixtureKey_,
+                                               OTSignature(szSignature),
+                                               strHashType);
+    }
+
+    const bool bOldCache_;
+    std::unique_ptr<OTAsymmetricKey> pFixtureKey_;
+};
+
+} // namespace
+
+TEST_F(Test_OTCryptoSignature, verifies_old_default_hash_signature)
+{
+    ASSERT_TRUE(verify_fixture(CONTENTS, DEFAULT_HASH_SIGNATURE,
+                               Identifier::DefaultHashAlgorithm));
+    ASSERT_FALSE(verify_fixture("<contract>\nSomething else.\n</contract>\n",
+                                DEFAULT_HASH_SIGNATURE,
+                                Identifier::DefaultHashAlgorithm));
+    ASSERT_FALSE(verify_fixture(CONTENTS, SHA256_SIGNATURE,
+                                Identifier::DefaultHashAlgorithm));
+}
+
+TEST_F(Test_OTCryptoSignature, verifies_old_sha256_signature)
+{
+    ASSERT_TRUE(verify_fixture(CONTENTS, SHA256_SIGNATURE, "SHA256"));
+    ASSERT_FALSE(verify_fixture("<contract>\nSomething else.\n</contract>\n",
+                                SHA256_SIGNATURE, "SHA256"));
+    ASSERT_FALSE(verify_fixture(CONTENTS, DEFAULT_HASH_SIGNATURE, "SHA256"));
+}
+
+// Two threads, each with its own cached contexts, signing with the same key
+// and verifying the old signatures while they're at it.
+TEST_F(Test_OTCryptoSignature, sign_and_verify_on_two_threads)
+{
+    std::unique_ptr<Nym> pNym(test::new_nym());
+    ASSERT_TRUE(pNym);
+
+    std::atomic<int32_t> nFailures(0);
+
+    auto work = [&](int32_t nThread) {
+        for (int32_t i = 0; i < 50; ++i) {
+            String strContents;
+            strContents.Format("<contract>thread %d, job %d</contract>\n",
+                               nThread, i);
+
+            const String strHashType =
+                (0 == i % 2) ? Identifier::DefaultHashAlgorithm
+                             : String("SHA256");
+            OTSignature theSignature;
+
+            const bool bGood =
+                OTCrypto::It()->SignContract(strContents,
+                                             pNym->GetPrivateSignKey(),
+                                             theSignature, strHashType) &&
+                OTCrypto::It()->VerifySignature(strContents,
+                                                pNym->GetPublicSignKey(),
+                                                theSignature, strHashType) &&
+                verify_fixture(CONTENTS, DEFAULT_HASH_SIGNATURE,
+                               Identifier::DefaultHashAlgorithm) &&
+                verify_fixture(CONTENTS, SHA256_SIGNATURE, "SHA256");
+
+            if (!bGood) ++nFailures;
+        }
+    };
+
+    std::thread first(work, 1);
+    std::thread second(work, 2);
+    first.join();
+    second.join();
+
+    ASSERT_EQ(0, nFailures.load());
+}
+
+#endif // OT_CRYPTO_USING_OPENSSL
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <opentxs/core/OTData.hpp>
 
+#include <cstring>
+
 using namespace opentxs;
 
 namespace
@@ -58,3 +60,14 @@ TEST(OTData, compare_not_equal_to_other_different)
     OTData other("zzzz", 4);
     ASSERT_TRUE(one != other);
 }
+
+TEST(OTData, fread_in_place)
+{
+    OTData data("abcdef", 6);
+    const void* first = data.OTfreadInPlace(4);
+    ASSERT_EQ(data.GetPointer(), first);
+    ASSERT_EQ(nullptr, data.OTfreadInPlace(3));
+    const void* second = data.OTfreadInPlace(2);
+    ASSERT_EQ(0, memcmp("ef", second, 2));
+    ASSERT_EQ(nullptr, data.OTfreadInPlace(1));
+}
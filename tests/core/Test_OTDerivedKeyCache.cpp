@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCachedKey.hpp>
+#include <opentxs/core/crypto/OTDerivedKeyCache.hpp>
+#include <opentxs/core/crypto/OTPassword.hpp>
+#include <opentxs/core/crypto/OTSymmetricKey.hpp>
+#include <opentxs/core/OTData.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_OTDerivedKeyCache : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        nOldTimeout_ = OTDerivedKeyCache::GetTimeoutSeconds();
+        OTDerivedKeyCache::SetTimeoutSeconds(300);
+
+        derivedKey_.setMemory("0123456789abcdef0123456789abcdef", 32);
+        checkHash_.Assign("check hash", 10);
+    }
+
+    void TearDown()
+    {
+        OTDerivedKeyCache::Shutdown();
+        OTDerivedKeyCache::SetTimeoutSeconds(nOldTimeout_);
+    }
+
+    int32_t nOldTimeout_;
+    OTPassword derivedKey_;
+    OTData checkHash_;
+};
+
+} // namespace
+
+TEST_F(Test_OTDerivedKeyCache, returns_what_was_inserted)
+{
+    const uint64_t lHits = OTDerivedKeyCache::Hits();
+    const uint64_t lMisses = OTDerivedKeyCache::Misses();
+    OTPassword theKey;
+    OTData theCheckHash;
+
+    ASSERT_FALSE(OTDerivedKeyCache::Lookup("a", theKey, theCheckHash));
+    OTDerivedKeyCache::Insert("a", derivedKey_, checkHash_);
+    ASSERT_EQ(1, OTDerivedKeyCache::Size());
+    ASSERT_TRUE(OTDerivedKeyCache::Lookup("a", theKey, theCheckHash));
+    ASSERT_TRUE(theKey.Compare(derivedKey_));
+    ASSERT_TRUE(theCheckHash == checkHash_);
+    ASSERT_FALSE(OTDerivedKeyCache::Lookup("b", theKey, theCheckHash));
+
+    ASSERT_EQ(lHits + 1, OTDerivedKeyCache::Hits());
+    ASSERT_EQ(lMisses + 2, OTDerivedKeyCache::Misses());
+}
+
+TEST_F(Test_OTDerivedKeyCache, zero_timeout_disables)
+{
+    OTDerivedKeyCache::SetTimeoutSeconds(0);
+    OTDerivedKeyCache::Insert("a", derivedKey_, checkHash_);
+
+    OTPassword theKey;
+    OTData theCheckHash;
+    ASSERT_EQ(0, OTDerivedKeyCache::Size());
+    ASSERT_FALSE(OTDerivedKeyCache::Lookup("a", theKey, theCheckHash));
+}
+
+TEST_F(Test_OTDerivedKeyCache, changing_timeout_wipes)
+{
+    OTDerivedKeyCache::Insert("a", derivedKey_, checkHash_);
+    OTDerivedKeyCache::SetTimeoutSeconds(-1);
+    ASSERT_EQ(0, OTDerivedKeyCache::Size());
+
+    OTDerivedKeyCache::Insert("a", derivedKey_, checkHash_);
+    ASSERT_EQ(1, OTDerivedKeyCache::Size());
+}
+
+TEST_F(Test_OTDerivedKeyCache, entries_expire)
+{
+    OTDerivedKeyCache::SetTimeoutSeconds(1);
+    OTDerivedKeyCache::Insert("a", derivedKey_, checkHash_);
+    ASSERT_EQ(1, OTDerivedKeyCache::Size());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    // Wiped by the timer thread, not by the lookup.
+    ASSERT_EQ(0, OTDerivedKeyCache::Size());
+
+    OTPassword theKey;
+    OTData theCheckHash;
+    ASSERT_FALSE(OTDerivedKeyCache::Lookup("a", theKey, theCheckHash));
+}
+
+TEST_F(Test_OTDerivedKeyCache, symmetric_key_is_cached)
+{
+    OTPassword thePassphrase;
+    thePassphrase.setPassword(test::PASSPHRASE,
+                              static_cast<int32_t>(strlen(test::PASSPHRASE)));
+
+    OTSymmetricKey theKey(thePassphrase);
+    ASSERT_TRUE(theKey.IsGenerated());
+    ASSERT_EQ(1, OTDerivedKeyCache::Size());
+
+    const uint64_t lHits = OTDerivedKeyCache::Hits();
+    OTPassword theRawKey;
+    ASSERT_TRUE(theKey.GetRawKeyFromPassphrase(thePassphrase, theRawKey));
+    ASSERT_EQ(lHits + 1, OTDerivedKeyCache::Hits());
+}
+
+// With a master key timeout of 0 the user forbids keeping anything that
+// unlocks the master key. Its derived key stays out of the cache, while the
+// cache itself is on.
+TEST_F(Test_OTDerivedKeyCache, master_key_is_never_cached)
+{
+    OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+
+    OTPassword theMasterPassword;
+    std::shared_ptr<OTCachedKey> pMaster(OTCachedKey::CreateMasterPassword(
+        theMasterPassword, "master_key_is_never_cached", 0));
+    ASSERT_TRUE(pMaster);
+    ASSERT_EQ(0, OTDerivedKeyCache::Size());
+
+    // The timeout already dropped the master password, so this derives the
+    // key again to decrypt it.
+    OTPassword theAgain;
+    ASSERT_TRUE(pMaster->GetMasterPassword(pMaster, theAgain,
+                                           "master_key_is_never_cached"));
+    ASSERT_TRUE(theAgain.Compare(theMasterPassword));
+    ASSERT_EQ(0, OTDerivedKeyCache::Size());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTEnvelope.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_OTEnvelope : public ::testing::Test
+{
+public:
+    std::vector<std::unique_ptr<Nym>> m_recipients;
+    std::unique_ptr<Nym> m_pOutsider;
+
+    void SetUp()
+    {
+        OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+
+        for (int32_t i = 0; i < 3; ++i) {
+            m_recipients.push_back(test::new_nym());
+            ASSERT_TRUE(m_recipients.back() != nullptr);
+        }
+
+        m_pOutsider = test::new_nym();
+        ASSERT_TRUE(m_pOutsider != nullptr);
+    }
+};
+
+} // namespace
+
+TEST_F(Test_OTEnvelope, every_recipient_opens_the_envelope)
+{
+    const String strPlaintext("Several recipients, one session key.\n");
+    setOfNyms theRecipients;
+
+    for (auto& pNym : m_recipients) theRecipients.insert(pNym.get());
+
+    OTEnvelope theEnvelope;
+    ASSERT_TRUE(theEnvelope.Seal(theRecipients, strPlaintext));
+
+    for (auto& pNym : m_recipients) {
+        String strOutput;
+        ASSERT_TRUE(theEnvelope.Open(*pNym, strOutput));
+        EXPECT_STREQ(strPlaintext.Get(), strOutput.Get());
+    }
+
+    String strOutput;
+    EXPECT_FALSE(theEnvelope.Open(*m_pOutsider, strOutput));
+    EXPECT_FALSE(strOutput.Exists());
+}
+
+// One recipient still goes through EVP_SealInit.
+TEST_F(Test_OTEnvelope, single_recipient)
+{
+    const String strPlaintext("Just the one.\n");
+
+    OTEnvelope theEnvelope;
+    ASSERT_TRUE(theEnvelope.Seal(*m_recipients[0], strPlaintext));
+
+    String strOutput;
+    ASSERT_TRUE(theEnvelope.Open(*m_recipients[0], strOutput));
+    EXPECT_STREQ(strPlaintext.Get(), strOutput.Get());
+
+    strOutput.Release();
+    EXPECT_FALSE(theEnvelope.Open(*m_recipients[1], strOutput));
+}
+
+#endif // OT_CRYPTO_USING_OPENSSL
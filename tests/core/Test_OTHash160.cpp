@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTHash160.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+std::string hex(const uint8_t* pDigest)
+{
+    std::string str_hex;
+    char buffer[3];
+
+    for (size_t i = 0; i < OTHash160::DigestSize; ++i) {
+        snprintf(buffer, sizeof(buffer), "%02x", pDigest[i]);
+        str_hex += buffer;
+    }
+
+    return str_hex;
+}
+
+std::string digest(const std::string& str_input)
+{
+    uint8_t output[OTHash160::DigestSize];
+    OTHash160::Digest(reinterpret_cast<const uint8_t*>(str_input.data()),
+                      str_input.size(), output);
+    return hex(output);
+}
+
+std::vector<uint8_t> pattern(size_t lSize)
+{
+    std::vector<uint8_t> output(lSize);
+
+    for (size_t i = 0; i < lSize; ++i) {
+        output[i] = static_cast<uint8_t>((i * 131 + 7) & 0xff);
+    }
+
+    return output;
+}
+
+// Runs the checks against every implementation this CPU supports.
+void for_each_implementation(void (*check)())
+{
+    const std::string str_old = OTHash160::Implementation();
+
+    for (const char* szName : {"scalar", "avx2", "shani"}) {
+        if (!OTHash160::SetImplementation(szName)) continue;
+        SCOPED_TRACE(szName);
+        check();
+    }
+
+    OTHash160::SetImplementation(str_old.c_str());
+}
+
+} // namespace
+
+TEST(OTHash160, known_vectors)
+{
+    for_each_implementation([]() {
+        ASSERT_EQ("b472a266d0bd89c13706a4132ccfb16f7c3b9fcb", digest(""));
+        ASSERT_EQ("bb1be98c142444d7a56aa3981c3942a978e4dc33", digest("abc"));
+        ASSERT_EQ("7c2b902bbfae7c54f2498f50bc78fa46c0693802",
+                  digest(std::string(1000, 'a')));
+    });
+}
+
+TEST(OTHash160, implementations_agree)
+{
+    const std::string str_old = OTHash160::Implementation();
+    const std::vector<uint8_t> input = pattern(300);
+    std::vector<std::string> reference;
+
+    ASSERT_TRUE(OTHash160::SetImplementation("scalar"));
+
+    for (size_t lSize = 0; lSize <= input.size(); ++lSize) {
+        uint8_t output[OTHash160::DigestSize];
+        OTHash160::Digest(input.data(), lSize, output);
+        reference.push_back(hex(output));
+    }
+
+    for (const char* szName : {"avx2", "shani"}) {
+        if (!OTHash160::SetImplementation(szName)) continue;
+        SCOPED_TRACE(szName);
+
+        for (size_t lSize = 0; lSize <= input.size(); ++lSize) {
+            uint8_t output[OTHash160::DigestSize];
+            OTHash160::Digest(input.data(), lSize, output);
+            EXPECT_EQ(reference[lSize], hex(output)) << lSize;
+        }
+    }
+
+    OTHash160::SetImplementation(str_old.c_str());
+}
+
+TEST(OTHash160, batch_matches_single)
+{
+    for_each_implementation([]() {
+        // Mixed lengths (so lanes finish at different blocks) and a count
+        // that isn't a multiple of the batch width.
+        const std::vector<uint8_t> input = pattern(1000);
+        std::vector<const uint8_t*> inputs;
+        std::vector<size_t> sizes;
+
+        for (size_t i = 0; i < 37; ++i) {
+            inputs.push_back(input.data() + i);
+            sizes.push_back((i * 97) % 900);
+        }
+
+        std::vector<uint8_t> output(inputs.size() * OTHash160::DigestSize);
+        OTHash160::Digest(inputs.data(), sizes.data(), inputs.size(),
+                          output.data());
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            uint8_t single[OTHash160::DigestSize];
+            OTHash160::Digest(inputs[i], sizes[i], single);
+            ASSERT_EQ(hex(single), hex(&output[i * OTHash160::DigestSize]))
+                << i;
+        }
+    });
+}
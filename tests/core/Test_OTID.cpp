@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/OTID.hpp>
+#include <opentxs/core/String.hpp>
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace opentxs;
+
+namespace
+{
+
+Identifier digest(const char* szInput)
+{
+    Identifier theID;
+    theID.CalculateDigest(String(szInput));
+    return theID;
+}
+
+} // namespace
+
+TEST(OTID, trivially_copyable)
+{
+    ASSERT_TRUE(std::is_trivially_copyable<OTID>::value);
+    ASSERT_EQ(OTID::Size, sizeof(OTID));
+}
+
+TEST(OTID, round_trip)
+{
+    const Identifier theID = digest("contract");
+    const OTID theKey(theID);
+    ASSERT_FALSE(theKey.empty());
+
+    Identifier theCopy;
+    theKey.GetIdentifier(theCopy);
+    ASSERT_EQ(theID.GetSize(), theCopy.GetSize());
+    ASSERT_EQ(0, memcmp(theID.GetPointer(), theCopy.GetPointer(),
+                        theID.GetSize()));
+}
+
+TEST(OTID, rejects_other_sizes)
+{
+    OTID theKey(digest("contract"));
+    const Identifier theEmpty;
+    Identifier theLong;
+    theLong.Assign("0123456789012345678901234567890123456789", 32);
+
+    ASSERT_FALSE(theKey.Set(theLong));
+    ASSERT_TRUE(theKey.empty());
+    ASSERT_FALSE(OTID(theEmpty) != OTID());
+
+    Identifier theCopy = digest("contract");
+    theKey.GetIdentifier(theCopy);
+    ASSERT_TRUE(theCopy.empty());
+}
+
+TEST(OTID, unordered_map_key)
+{
+    std::unordered_map<OTID, int> mapIDs;
+
+    for (int i = 0; i < 100; ++i) {
+        mapIDs[OTID(digest(std::to_string(i).c_str()))] = i;
+    }
+
+    ASSERT_EQ(100u, mapIDs.size());
+
+    for (int i = 0; i < 100; ++i) {
+        const auto it = mapIDs.find(OTID(digest(std::to_string(i).c_str())));
+        ASSERT_NE(mapIDs.end(), it);
+        ASSERT_EQ(i, it->second);
+    }
+
+    ASSERT_EQ(mapIDs.end(), mapIDs.find(OTID(digest("100"))));
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTNumberSet.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+void expect_same(const std::set<int64_t>& expected, const OTNumberSet& theSet)
+{
+    ASSERT_EQ(expected.size(), theSet.Count());
+
+    std::vector<int64_t> actual;
+    theSet.ForEach([&](int64_t lNumber) { actual.push_back(lNumber); });
+    ASSERT_EQ(std::vector<int64_t>(expected.begin(), expected.end()), actual);
+
+    // Ranges are disjoint and never adjacent.
+    int64_t lPrevious = 0;
+    bool bFirst = true;
+
+    for (const auto& it : theSet.GetRanges()) {
+        ASSERT_LE(it.first, it.second);
+        if (!bFirst) {
+            ASSERT_LT(lPrevious + 1, it.first);
+        }
+        lPrevious = it.second;
+        bFirst = false;
+    }
+}
+
+} // namespace
+
+TEST(OTNumberSet, runs_are_merged)
+{
+    OTNumberSet theSet;
+
+    for (int64_t i = 1001; i <= 1100; ++i) ASSERT_TRUE(theSet.Insert(i));
+    ASSERT_TRUE(theSet.Insert(1205));
+    ASSERT_FALSE(theSet.Insert(1050));
+
+    ASSERT_EQ(101u, theSet.Count());
+    ASSERT_EQ(2u, theSet.GetRanges().size());
+    ASSERT_EQ(1001, theSet.Lowest());
+    ASSERT_EQ(1205, theSet.Highest());
+
+    // Splitting a range and joining it again.
+    ASSERT_TRUE(theSet.Remove(1050));
+    ASSERT_FALSE(theSet.Contains(1050));
+    ASSERT_EQ(3u, theSet.GetRanges().size());
+    ASSERT_TRUE(theSet.Insert(1050));
+    ASSERT_EQ(2u, theSet.GetRanges().size());
+    ASSERT_FALSE(theSet.Remove(1101));
+}
+
+TEST(OTNumberSet, index)
+{
+    OTNumberSet theSet;
+    theSet.Insert(5);
+    theSet.Insert(6);
+    theSet.Insert(10);
+
+    int64_t lNumber = 0;
+    ASSERT_TRUE(theSet.At(0, lNumber));
+    ASSERT_EQ(5, lNumber);
+    ASSERT_TRUE(theSet.At(1, lNumber));
+    ASSERT_EQ(6, lNumber);
+    ASSERT_TRUE(theSet.At(2, lNumber));
+    ASSERT_EQ(10, lNumber);
+    ASSERT_FALSE(theSet.At(3, lNumber));
+}
+
+TEST(OTNumberSet, ranges_at_the_limits)
+{
+    OTNumberSet theSet;
+
+    // Overlapping a range that starts at INT64_MIN.
+    ASSERT_EQ(2u, theSet.InsertRange(INT64_MIN, INT64_MIN + 1));
+    ASSERT_EQ(2u, theSet.InsertRange(INT64_MIN, INT64_MIN + 3));
+    ASSERT_EQ(0u, theSet.InsertRange(INT64_MIN, INT64_MIN));
+
+    // Touching it from above.
+    ASSERT_EQ(2u, theSet.InsertRange(INT64_MIN + 4, INT64_MIN + 5));
+    ASSERT_EQ(1u, theSet.GetRanges().size());
+    ASSERT_EQ(6u, theSet.Count());
+    ASSERT_EQ(INT64_MIN, theSet.Lowest());
+
+    // And the same at the top.
+    ASSERT_EQ(2u, theSet.InsertRange(INT64_MAX - 1, INT64_MAX));
+    ASSERT_EQ(1u, theSet.InsertRange(INT64_MAX - 2, INT64_MAX));
+    ASSERT_EQ(0u, theSet.InsertRange(INT64_MAX, INT64_MAX));
+    ASSERT_FALSE(theSet.Insert(INT64_MAX));
+    ASSERT_TRUE(theSet.Insert(INT64_MAX - 3));
+    ASSERT_EQ(2u, theSet.GetRanges().size());
+    ASSERT_EQ(INT64_MAX, theSet.Highest());
+
+    std::set<int64_t> expected;
+    for (int64_t i = 0; i < 6; ++i) expected.insert(INT64_MIN + i);
+    for (int64_t i = 0; i < 4; ++i) expected.insert(INT64_MAX - i);
+    expect_same(expected, theSet);
+}
+
+TEST(OTNumberSet, matches_std_set)
+{
+    OTNumberSet theSet;
+    std::set<int64_t> expected;
+    srand(42);
+
+    for (int i = 0; i < 20000; ++i) {
+        const int64_t lNumber = rand() % 300;
+
+        if (0 == rand() % 10) {
+            const int64_t lLast = lNumber + rand() % 8;
+            size_t lAdded = 0;
+            bool bAny = false, bAll = true;
+
+            for (int64_t j = lNumber; j <= lLast; ++j) {
+                bAny = bAny || (expected.count(j) > 0);
+                bAll = bAll && (expected.count(j) > 0);
+                if (expected.insert(j).second) ++lAdded;
+            }
+
+            ASSERT_EQ(bAny, theSet.ContainsAny(lNumber, lLast));
+            ASSERT_EQ(bAll, theSet.ContainsAll(lNumber, lLast));
+            ASSERT_EQ(lAdded, theSet.InsertRange(lNumber, lLast));
+        }
+        else if (rand() % 3) {
+            ASSERT_EQ(expected.insert(lNumber).second, theSet.Insert(lNumber));
+        }
+        else {
+            ASSERT_EQ(expected.erase(lNumber) > 0, theSet.Remove(lNumber));
+        }
+
+        ASSERT_EQ(expected.count(lNumber) > 0, theSet.Contains(lNumber));
+    }
+
+    expect_same(expected, theSet);
+
+    theSet.Clear();
+    ASSERT_TRUE(theSet.empty());
+    ASSERT_TRUE(theSet.GetRanges().empty());
+}
+
+TEST(OTNumberSet, keep_highest)
+{
+    OTNumberSet theSet;
+    theSet.InsertRange(1, 10);
+    theSet.InsertRange(20, 29);
+    theSet.Insert(40);
+
+    theSet.KeepHighest(25);
+    ASSERT_EQ(21u, theSet.Count());
+
+    // Drops all of one range and part of the next.
+    theSet.KeepHighest(5);
+    std::set<int64_t> expected{26, 27, 28, 29, 40};
+    expect_same(expected, theSet);
+
+    theSet.KeepHighest(0);
+    ASSERT_TRUE(theSet.empty());
+}
+
+// A Nym's number lists load a range at a time, however many numbers a peer
+// claims, and the ack numbers stay capped.
+TEST(OTNumberSet, nym_loads_whole_ranges)
+{
+    const String strNotaryID(test::NOTARY_ID);
+
+    Nym theNym;
+    theNym.GetMapIssuedNum()[strNotaryID.Get()].InsertRange(1, 999999);
+    theNym.GetMapTransNum()[strNotaryID.Get()].InsertRange(500, 599);
+    theNym.GetMapAcknowledgedNum()[strNotaryID.Get()].InsertRange(1, 1000);
+
+    String strNym;
+    ASSERT_TRUE(theNym.SavePseudonym(strNym));
+
+    Nym theLoaded;
+    ASSERT_TRUE(theLoaded.LoadFromString(strNym));
+
+    const OTNumberSet& theIssued =
+        theLoaded.GetMapIssuedNum()[strNotaryID.Get()];
+    ASSERT_EQ(999999u, theIssued.Count());
+    ASSERT_EQ(1u, theIssued.GetRanges().size());
+
+    ASSERT_EQ(100, theLoaded.GetTransactionNumCount(Identifier(strNotaryID)));
+    ASSERT_TRUE(theLoaded.VerifyTransactionNum(strNotaryID, 599));
+
+    const OTNumberSet& theAcks =
+        theLoaded.GetMapAcknowledgedNum()[strNotaryID.Get()];
+    ASSERT_GE(100u, theAcks.Count());
+    ASSERT_EQ(1000, theAcks.Highest());
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_OTSignatureCache : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        lOldCapacity_ = OTSignatureCache::GetCapacity();
+        bOldEnabled_ = OTSignatureCache::IsEnabled();
+        OTSignatureCache::SetEnabled(true);
+        OTSignatureCache::Clear();
+    }
+
+    void TearDown()
+    {
+        OTSignatureCache::Clear();
+        OTSignatureCache::SetCapacity(lOldCapacity_);
+        OTSignatureCache::SetEnabled(bOldEnabled_);
+    }
+
+    int64_t lOldCapacity_;
+    bool bOldEnabled_;
+};
+
+} // namespace
+
+TEST_F(Test_OTSignatureCache, counts_hits_and_misses)
+{
+    const uint64_t lHits = OTSignatureCache::Hits();
+    const uint64_t lMisses = OTSignatureCache::Misses();
+
+    ASSERT_FALSE(OTSignatureCache::Lookup("a"));
+    OTSignatureCache::Insert("a");
+    ASSERT_TRUE(OTSignatureCache::Lookup("a"));
+    ASSERT_TRUE(OTSignatureCache::Lookup("a"));
+
+    ASSERT_EQ(lHits + 2, OTSignatureCache::Hits());
+    ASSERT_EQ(lMisses + 1, OTSignatureCache::Misses());
+}
+
+TEST_F(Test_OTSignatureCache, evicts_least_recently_used)
+{
+    OTSignatureCache::SetCapacity(2);
+    OTSignatureCache::Insert("a");
+    OTSignatureCache::Insert("b");
+    ASSERT_TRUE(OTSignatureCache::Lookup("a")); // b is now the oldest
+    OTSignatureCache::Insert("c");
+
+    ASSERT_EQ(2, OTSignatureCache::Size());
+    ASSERT_TRUE(OTSignatureCache::Lookup("a"));
+    ASSERT_FALSE(OTSignatureCache::Lookup("b"));
+    ASSERT_TRUE(OTSignatureCache::Lookup("c"));
+
+    OTSignatureCache::SetCapacity(1);
+    ASSERT_EQ(1, OTSignatureCache::Size());
+    ASSERT_TRUE(OTSignatureCache::Lookup("c"));
+}
+
+TEST_F(Test_OTSignatureCache, disabled_cache_never_hits)
+{
+    OTSignatureCache::Insert("a");
+    OTSignatureCache::SetEnabled(false);
+
+    ASSERT_EQ(0, OTSignatureCache::Size());
+    OTSignatureCache::Insert("a");
+    ASSERT_FALSE(OTSignatureCache::Lookup("a"));
+
+    OTSignatureCache::SetEnabled(true);
+    ASSERT_FALSE(OTSignatureCache::Lookup("a"));
+}
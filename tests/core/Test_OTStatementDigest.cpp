@@ -0,0 +1,337 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Account.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Item.hpp>
+#include <opentxs/core/Ledger.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTNumberSet.hpp>
+#include <opentxs/core/OTStatementDigest.hpp>
+#include <opentxs/core/OTTransaction.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <memory>
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+using test::NYM_ID;
+using test::ACCT_ID;
+using test::NOTARY_ID;
+
+OTNumberSet numbers(int64_t lFirst, int64_t lLast)
+{
+    OTNumberSet theNumbers;
+    theNumbers.InsertRange(lFirst, lLast);
+    return theNumbers;
+}
+
+class Test_OTStatementDigest : public ::testing::Test
+{
+protected:
+    Test_OTStatementDigest()
+        : nymID_(NYM_ID)
+        , transaction_(nymID_, Identifier(ACCT_ID), Identifier(NOTARY_ID),
+                       100)
+    {
+    }
+
+    // A statement item for transaction_, with no report yet.
+    Item* new_statement(Item::itemType theType)
+    {
+        return new Item(nymID_, transaction_, theType);
+    }
+
+    // Adds a report sub-item, the way ProduceInboxReportItem does.
+    void add_receipt(Item& theReport, Item::itemType theType,
+                     int64_t lTransNum, int64_t lAmount,
+                     int64_t lClosingNum = 0)
+    {
+        Item* pSubItem = new Item(nymID_, transaction_, theType);
+        pSubItem->SetTransactionNum(lTransNum);
+        pSubItem->SetReferenceToNum(40);
+        pSubItem->SetNumberOfOrigin(40);
+        pSubItem->SetAmount(lAmount);
+        pSubItem->SetClosingNum(lClosingNum);
+        theReport.AddItem(*pSubItem);
+    }
+
+    // An abbreviated box receipt, the way the server loads them.
+    OTTransaction* new_receipt(OTTransaction::transactionType theType,
+                               int64_t lTransNum, int64_t lAmount,
+                               int64_t lClosingNum = 0)
+    {
+        return new OTTransaction(nymID_, Identifier(ACCT_ID),
+                                 Identifier(NOTARY_ID), 40, lTransNum, 40, 40,
+                                 OT_TIME_ZERO, theType, String(), lAmount,
+                                 lAmount, lClosingNum, 0, false);
+    }
+
+    std::unique_ptr<Ledger> new_box(Ledger::ledgerType theType)
+    {
+        std::unique_ptr<Ledger> pBox(
+            new Ledger(nymID_, Identifier(ACCT_ID), Identifier(NOTARY_ID)));
+        pBox->m_Type = theType;
+        return pBox;
+    }
+
+    // The digest a client with these boxes attaches to a balance statement
+    // for a deposit (which closes #100.)
+    String balance_digest(Ledger& theInbox, Ledger& theOutbox)
+    {
+        std::unique_ptr<Item> pReport(new_statement(Item::balanceStatement));
+
+        for (auto& it : theInbox.GetTransactionMap())
+            it.second->ProduceInboxReportItem(*pReport);
+
+        theOutbox.ProduceOutboxReport(*pReport);
+
+        OTStatementDigest theDigest;
+        theDigest.SetIssued(numbers(101, 109));
+        theDigest.GetRemoved().Add(int64_t(100));
+        theDigest.SetBox(*pReport);
+
+        String strDigest;
+        theDigest.Save(strDigest);
+        return strDigest;
+    }
+
+    Identifier nymID_;
+    OTTransaction transaction_;
+};
+
+} // namespace
+
+TEST_F(Test_OTStatementDigest, save_load_round_trip)
+{
+    OTStatementDigest theDigest;
+    theDigest.SetIssued(numbers(100, 199));
+    theDigest.GetRemoved().Add(int64_t(100));
+
+    std::unique_ptr<Item> pReport(new_statement(Item::balanceStatement));
+    add_receipt(*pReport, Item::chequeReceipt, 50, 10);
+    add_receipt(*pReport, Item::transfer, 1, -20);
+    theDigest.SetBox(*pReport);
+
+    String strDigest;
+    theDigest.Save(strDigest);
+    ASSERT_TRUE(OTStatementDigest::IsDigest(strDigest));
+
+    OTStatementDigest theLoaded;
+    ASSERT_TRUE(theLoaded.Load(strDigest));
+    EXPECT_TRUE(theLoaded.SameIssued(theDigest));
+    EXPECT_TRUE(theLoaded.SameBox(theDigest));
+    EXPECT_EQ(100, theLoaded.GetIssuedCount());
+    EXPECT_TRUE(theLoaded.GetRemoved().Verify(theDigest.GetRemoved()));
+
+    // A transaction statement has no box.
+    OTStatementDigest theNoBox;
+    theNoBox.SetIssued(numbers(100, 199));
+    EXPECT_TRUE(theNoBox.SameIssued(theDigest));
+    EXPECT_FALSE(theNoBox.SameBox(theDigest));
+}
+
+TEST_F(Test_OTStatementDigest, rejects_other_versions)
+{
+    OTStatementDigest theDigest;
+    theDigest.SetIssued(numbers(1, 5));
+
+    String strDigest;
+    theDigest.Save(strDigest);
+
+    std::string str(strDigest.Get());
+    const auto pos = str.find("version=\"2\"");
+    ASSERT_NE(std::string::npos, pos);
+    str.replace(pos, 11, "version=\"3\"");
+
+    OTStatementDigest theLoaded;
+    EXPECT_FALSE(theLoaded.Load(String(str)));
+
+    // A message Nym isn't a digest.
+    Nym theMessageNym;
+    String strNym;
+    ASSERT_TRUE(theMessageNym.SavePseudonym(strNym));
+    EXPECT_FALSE(OTStatementDigest::IsDigest(strNym));
+    EXPECT_FALSE(theLoaded.Load(strNym));
+}
+
+TEST_F(Test_OTStatementDigest, issued_hash_covers_the_numbers)
+{
+    OTStatementDigest theFirst, theSame, theOther;
+    theFirst.SetIssued(numbers(100, 199));
+    theSame.SetIssued(numbers(100, 199));
+
+    // Same count, different numbers.
+    OTNumberSet theNumbers = numbers(100, 198);
+    theNumbers.Insert(300);
+    theOther.SetIssued(theNumbers);
+
+    EXPECT_TRUE(theFirst.SameIssued(theSame));
+    EXPECT_EQ(theFirst.GetIssuedCount(), theOther.GetIssuedCount());
+    EXPECT_FALSE(theFirst.SameIssued(theOther));
+}
+
+// What the client hashes from its message Nym, the server hashes from its own
+// copy of the list.
+TEST_F(Test_OTStatementDigest, message_nym_matches_number_set)
+{
+    Nym theMessageNym;
+
+    for (int64_t lNumber = 100; lNumber < 150; ++lNumber)
+        theMessageNym.AddIssuedNum(String(NOTARY_ID), lNumber);
+
+    String strNym;
+    ASSERT_TRUE(theMessageNym.SavePseudonym(strNym));
+
+    std::unique_ptr<Item> pStatement(new_statement(Item::transactionStatement));
+    pStatement->SetAttachment(strNym);
+
+    OTStatementDigest theClient, theServer;
+    ASSERT_TRUE(theClient.SetIssued(*pStatement));
+    theServer.SetIssued(numbers(100, 149));
+
+    EXPECT_TRUE(theClient.SameIssued(theServer));
+}
+
+TEST_F(Test_OTStatementDigest, box_hash_ignores_order)
+{
+    std::unique_ptr<Item> pFirst(new_statement(Item::balanceStatement));
+    add_receipt(*pFirst, Item::chequeReceipt, 50, 10);
+    add_receipt(*pFirst, Item::finalReceipt, 60, 0, 7);
+    add_receipt(*pFirst, Item::transfer, 70, -20);
+
+    std::unique_ptr<Item> pSecond(new_statement(Item::balanceStatement));
+    add_receipt(*pSecond, Item::transfer, 70, -20);
+    add_receipt(*pSecond, Item::chequeReceipt, 50, 10);
+    add_receipt(*pSecond, Item::finalReceipt, 60, 0, 7);
+
+    std::unique_ptr<Item> pOther(new_statement(Item::balanceStatement));
+    add_receipt(*pOther, Item::chequeReceipt, 50, 10);
+    add_receipt(*pOther, Item::finalReceipt, 60, 0, 8);
+    add_receipt(*pOther, Item::transfer, 70, -20);
+
+    OTStatementDigest theFirst, theSecond, theOther;
+    theFirst.SetBox(*pFirst);
+    theSecond.SetBox(*pSecond);
+    theOther.SetBox(*pOther);
+
+    EXPECT_TRUE(theFirst.SameBox(theSecond));
+    EXPECT_FALSE(theFirst.SameBox(theOther));
+}
+
+// The client reports a new outbox transfer as #1; the server has the real
+// number by the time it checks.
+TEST_F(Test_OTStatementDigest, new_outbox_transfer_is_hashed_as_one)
+{
+    std::unique_ptr<Item> pClient(new_statement(Item::balanceStatement));
+    add_receipt(*pClient, Item::transfer, 1, -20);
+
+    std::unique_ptr<Item> pServer(new_statement(Item::balanceStatement));
+    add_receipt(*pServer, Item::transfer, 18736, -20);
+
+    OTStatementDigest theClient, theServer, theUnmapped;
+    theClient.SetBox(*pClient);
+    theServer.SetBox(*pServer, 18736);
+    theUnmapped.SetBox(*pServer);
+
+    EXPECT_TRUE(theServer.SameBox(theClient));
+    EXPECT_FALSE(theUnmapped.SameBox(theClient));
+}
+
+// Server side: a compact transaction statement checks out against the
+// server's list, minus what the transaction closes, and leaves it alone.
+TEST_F(Test_OTStatementDigest, verify_compact_transaction_statement)
+{
+    Nym theServerNym;
+    for (int64_t lNumber = 100; lNumber < 110; ++lNumber)
+        theServerNym.AddIssuedNum(String(NOTARY_ID), lNumber);
+
+    transaction_.SetType(OTTransaction::cancelCronItem);
+
+    OTStatementDigest theDigest;
+    theDigest.SetIssued(numbers(101, 109));
+    theDigest.GetRemoved().Add(int64_t(100));
+
+    String strDigest;
+    theDigest.Save(strDigest);
+
+    std::unique_ptr<Item> pStatement(new_statement(Item::transactionStatement));
+    pStatement->SetAttachment(strDigest);
+
+    EXPECT_TRUE(pStatement->VerifyTransactionStatement(theServerNym,
+                                                       transaction_));
+    EXPECT_EQ(10, theServerNym.GetIssuedNumCount(Identifier(NOTARY_ID)));
+
+    // Not without a transaction number: processNymbox needs the list.
+    EXPECT_FALSE(pStatement->VerifyTransactionStatement(theServerNym,
+                                                        transaction_, false));
+
+    // The delta has to be exactly what the transaction closes.
+    OTStatementDigest theWrongDelta;
+    theWrongDelta.SetIssued(numbers(101, 109));
+    theWrongDelta.GetRemoved().Add(int64_t(105));
+    theWrongDelta.Save(strDigest);
+    pStatement->SetAttachment(strDigest);
+    EXPECT_FALSE(pStatement->VerifyTransactionStatement(theServerNym,
+                                                        transaction_));
+
+    // And the list has to match the server's.
+    OTStatementDigest theWrongList;
+    theWrongList.SetIssued(numbers(101, 108));
+    theWrongList.GetRemoved().Add(int64_t(100));
+    theWrongList.Save(strDigest);
+    pStatement->SetAttachment(strDigest);
+    EXPECT_FALSE(pStatement->VerifyTransactionStatement(theServerNym,
+                                                        transaction_));
+    EXPECT_EQ(10, theServerNym.GetIssuedNumCount(Identifier(NOTARY_ID)));
+}
+
+// Server side: a compact balance statement checks out against the server's
+// inbox and outbox, not just its list.
+TEST_F(Test_OTStatementDigest, verify_compact_balance_statement)
+{
+    Nym theServerNym;
+    for (int64_t lNumber = 100; lNumber < 110; ++lNumber)
+        theServerNym.AddIssuedNum(String(NOTARY_ID), lNumber);
+
+    transaction_.SetType(OTTransaction::deposit);
+
+    Account theAccount(nymID_, Identifier(ACCT_ID), Identifier(NOTARY_ID));
+    ASSERT_TRUE(theAccount.Credit(500));
+
+    std::unique_ptr<Ledger> pInbox(new_box(Ledger::inbox));
+    pInbox->AddTransaction(*new_receipt(OTTransaction::chequeReceipt, 50, -10));
+    pInbox->AddTransaction(*new_receipt(OTTransaction::finalReceipt, 60, 0, 7));
+
+    std::unique_ptr<Ledger> pOutbox(new_box(Ledger::outbox));
+    pOutbox->AddTransaction(*new_receipt(OTTransaction::pending, 70, 20));
+
+    std::unique_ptr<Item> pStatement(new_statement(Item::balanceStatement));
+    pStatement->SetAmount(500);
+    pStatement->SetAttachment(balance_digest(*pInbox, *pOutbox));
+
+    EXPECT_TRUE(pStatement->VerifyBalanceStatement(
+        0, theServerNym, *pInbox, *pOutbox, theAccount, transaction_));
+    EXPECT_EQ(10, theServerNym.GetIssuedNumCount(Identifier(NOTARY_ID)));
+
+    // The client saw a receipt that isn't in the server's inbox.
+    std::unique_ptr<Ledger> pShortInbox(new_box(Ledger::inbox));
+    pShortInbox->AddTransaction(
+        *new_receipt(OTTransaction::finalReceipt, 60, 0, 7));
+
+    EXPECT_FALSE(pStatement->VerifyBalanceStatement(
+        0, theServerNym, *pShortInbox, *pOutbox, theAccount, transaction_));
+
+    // The client's outbox says 25 where the server's says 20.
+    std::unique_ptr<Ledger> pOtherOutbox(new_box(Ledger::outbox));
+    pOtherOutbox->AddTransaction(*new_receipt(OTTransaction::pending, 70, 25));
+    pStatement->SetAttachment(balance_digest(*pInbox, *pOtherOutbox));
+
+    EXPECT_FALSE(pStatement->VerifyBalanceStatement(
+        0, theServerNym, *pInbox, *pOutbox, theAccount, transaction_));
+    EXPECT_EQ(10, theServerNym.GetIssuedNumCount(Identifier(NOTARY_ID)));
+}
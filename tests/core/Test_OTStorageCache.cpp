@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/OTStorageCache.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_OTStorageCache : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        lOldMaxBytes_ = OTDB::StorageCache::GetMaxBytes();
+        strOldPinned_ = OTDB::StorageCache::GetPinnedFolders();
+        OTDB::StorageCache::SetPinnedFolders("");
+        OTDB::StorageCache::SetMaxBytes(1024 * 1024);
+        OTDB::StorageCache::Clear();
+    }
+
+    void TearDown()
+    {
+        for (const std::string& strPath : paths_) remove(strPath.c_str());
+
+        OTDB::StorageCache::SetPinnedFolders(strOldPinned_);
+        OTDB::StorageCache::SetMaxBytes(lOldMaxBytes_);
+    }
+
+    std::string Write(const std::string& strName,
+                      const std::string& strContents)
+    {
+        const std::string strPath = "ot_storagecache_test_" + strName;
+        std::ofstream ofs(strPath.c_str(), std::ios::out | std::ios::binary |
+                                               std::ios::trunc);
+        ofs << strContents;
+        paths_.push_back(strPath);
+
+        return strPath;
+    }
+
+    // What StorageFS does on a miss.
+    void Load(const std::string& strFolder, const std::string& strPath,
+              const std::string& strContents)
+    {
+        std::string strCached;
+        OTDB::StorageCache::FileVersion theVersion;
+
+        ASSERT_FALSE(OTDB::StorageCache::Get(strPath, strCached, theVersion));
+        OTDB::StorageCache::Put(strFolder, strPath, theVersion, strContents);
+    }
+
+    bool Cached(const std::string& strPath, std::string& strContents)
+    {
+        OTDB::StorageCache::FileVersion theVersion;
+
+        return OTDB::StorageCache::Get(strPath, strContents, theVersion);
+    }
+
+    int64_t lOldMaxBytes_;
+    std::string strOldPinned_;
+    std::vector<std::string> paths_;
+};
+
+} // namespace
+
+TEST_F(Test_OTStorageCache, hit_after_put)
+{
+    const std::string strPath = Write("hit", "contents");
+    std::string strContents;
+
+    Load("nyms", strPath, "contents");
+    ASSERT_TRUE(Cached(strPath, strContents));
+    ASSERT_EQ("contents", strContents);
+
+    const OTDB::StorageCache::Stats theStats =
+        OTDB::StorageCache::GetStats();
+    ASSERT_EQ(1u, theStats.m_lEntries);
+    ASSERT_EQ(8u, theStats.m_lBytes);
+}
+
+TEST_F(Test_OTStorageCache, size_mismatch_is_not_cached)
+{
+    const std::string strPath = Write("mismatch", "contents");
+    std::string strContents;
+
+    Load("nyms", strPath, "content");
+    ASSERT_FALSE(Cached(strPath, strContents));
+}
+
+TEST_F(Test_OTStorageCache, external_change_is_stale)
+{
+    const std::string strPath = Write("stale", "contents");
+    std::string strContents;
+
+    Load("nyms", strPath, "contents");
+
+    const uint64_t lStale = OTDB::StorageCache::GetStats().m_lStale;
+    Write("stale", "changed contents");
+    ASSERT_FALSE(Cached(strPath, strContents));
+    ASSERT_EQ(lStale + 1, OTDB::StorageCache::GetStats().m_lStale);
+}
+
+TEST_F(Test_OTStorageCache, invalidate)
+{
+    const std::string strPath = Write("invalidate", "contents");
+    std::string strContents;
+
+    Load("nyms", strPath, "contents");
+    OTDB::StorageCache::Invalidate(strPath);
+    ASSERT_FALSE(Cached(strPath, strContents));
+}
+
+TEST_F(Test_OTStorageCache, evicts_least_recently_used)
+{
+    const std::string strContents(100, 'x');
+    OTDB::StorageCache::SetMaxBytes(8 * 100 + 50);
+
+    std::vector<std::string> paths;
+
+    for (int32_t i = 0; i < 8; ++i) {
+        paths.push_back(Write("lru" + std::to_string(i), strContents));
+        Load("accounts", paths.back(), strContents);
+    }
+
+    std::string strCached;
+
+    // Touching the first makes the second the oldest.
+    ASSERT_TRUE(Cached(paths[0], strCached));
+    paths.push_back(Write("lru8", strContents));
+    Load("accounts", paths.back(), strContents);
+
+    ASSERT_TRUE(Cached(paths[0], strCached));
+    ASSERT_FALSE(Cached(paths[1], strCached));
+    ASSERT_TRUE(Cached(paths[8], strCached));
+    ASSERT_LE(OTDB::StorageCache::GetStats().m_lBytes, 850u);
+}
+
+TEST_F(Test_OTStorageCache, pinned_folders_are_not_evicted)
+{
+    OTDB::StorageCache::SetPinnedFolders("contracts, mints");
+    OTDB::StorageCache::SetMaxBytes(0);
+
+    const std::string strContract(4096, 'c');
+    const std::string strPinned = Write("pinned", strContract);
+    const std::string strOther = Write("unpinned", "contents");
+    std::string strCached;
+
+    Load("contracts", strPinned, strContract);
+    Load("nyms", strOther, "contents");
+
+    ASSERT_TRUE(Cached(strPinned, strCached));
+    ASSERT_EQ(strContract, strCached);
+    ASSERT_FALSE(Cached(strOther, strCached));
+    ASSERT_EQ(4096u, OTDB::StorageCache::GetStats().m_lPinnedBytes);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/OTStorage.hpp>
+#include <opentxs/core/OTStorageCache.hpp>
+#include <opentxs/core/util/OTDataFolder.hpp>
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace opentxs;
+
+namespace
+{
+
+const char FOLDER[] = "storagefs_test";
+const char FILENAME[] = "file.txt";
+
+class Test_OTStorageFS : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        OTDataFolder::Init("unittests");
+        OTDB::InitDefaultStorage(OTDB_DEFAULT_STORAGE, OTDB_DEFAULT_PACKER);
+
+        lOldMaxBytes_ = OTDB::StorageCache::GetMaxBytes();
+        strOldPinned_ = OTDB::StorageCache::GetPinnedFolders();
+        OTDB::StorageCache::SetPinnedFolders("");
+        OTDB::StorageCache::SetMaxBytes(1024 * 1024);
+        OTDB::StorageCache::Clear();
+
+        // Creates the folder, so the path can be formed.
+        ASSERT_TRUE(OTDB::StorePlainString("placeholder", FOLDER, FILENAME));
+        ASSERT_LT(0, OTDB::FormPathString(strPath_, FOLDER, FILENAME));
+    }
+
+    void TearDown()
+    {
+        OTDB::EraseValueByKey(FOLDER, FILENAME);
+        OTDB::StorageCache::Clear();
+        OTDB::StorageCache::SetPinnedFolders(strOldPinned_);
+        OTDB::StorageCache::SetMaxBytes(lOldMaxBytes_);
+    }
+
+    // Behind OTDB's back, in place.
+    void Rewrite(const std::string& strContents)
+    {
+        std::ofstream ofs(strPath_.c_str(), std::ios::out | std::ios::binary |
+                                                std::ios::trunc);
+        ofs << strContents;
+    }
+
+    std::string Query()
+    {
+        return OTDB::QueryPlainString(FOLDER, FILENAME);
+    }
+
+    uint64_t Hits()
+    {
+        return OTDB::StorageCache::GetStats().m_lHits;
+    }
+
+    int64_t lOldMaxBytes_;
+    std::string strOldPinned_;
+    std::string strPath_;
+};
+
+} // namespace
+
+TEST_F(Test_OTStorageFS, read_follows_size_changes_after_stat)
+{
+    const std::string strContents = "0123456789abcdefghij";
+    ASSERT_TRUE(OTDB::StorePlainString(strContents, FOLDER, FILENAME));
+
+    std::string strRead;
+
+    ASSERT_TRUE(OTDB::StorageFS::ReadFile(strPath_, 20, strRead));
+    EXPECT_EQ(strContents, strRead);
+
+    // Grown since the stat() that said 12 bytes.
+    ASSERT_TRUE(OTDB::StorageFS::ReadFile(strPath_, 12, strRead));
+    EXPECT_EQ(strContents, strRead);
+
+    // Shrunk since the stat() that said 64 bytes.
+    ASSERT_TRUE(OTDB::StorageFS::ReadFile(strPath_, 64, strRead));
+    EXPECT_EQ(strContents, strRead);
+
+    ASSERT_FALSE(
+        OTDB::StorageFS::ReadFile(strPath_ + ".missing", 20, strRead));
+}
+
+TEST_F(Test_OTStorageFS, second_read_is_a_cache_hit)
+{
+    ASSERT_TRUE(OTDB::StorePlainString("contents", FOLDER, FILENAME));
+
+    const uint64_t lHits = Hits();
+    EXPECT_EQ("contents", Query());
+    EXPECT_EQ(lHits, Hits());
+    EXPECT_EQ("contents", Query());
+    EXPECT_EQ(lHits + 1, Hits());
+}
+
+TEST_F(Test_OTStorageFS, store_plain_string_invalidates)
+{
+    ASSERT_TRUE(OTDB::StorePlainString("first", FOLDER, FILENAME));
+    ASSERT_EQ("first", Query());
+
+    ASSERT_TRUE(OTDB::StorePlainString("other", FOLDER, FILENAME));
+    EXPECT_EQ("other", Query());
+}
+
+TEST_F(Test_OTStorageFS, store_packed_buffer_invalidates)
+{
+    ASSERT_TRUE(OTDB::StorePlainString("first", FOLDER, FILENAME));
+    ASSERT_EQ("first", Query());
+
+    std::unique_ptr<OTDB::OTDBString> pString(dynamic_cast<OTDB::OTDBString*>(
+        OTDB::CreateObject(OTDB::STORED_OBJ_STRING)));
+    ASSERT_TRUE(pString);
+    pString->m_string = "packed";
+    ASSERT_TRUE(OTDB::StoreObject(*pString, FOLDER, FILENAME));
+
+    // Whatever the packer made of it, it's what is on disk now.
+    std::string strOnDisk;
+    ASSERT_TRUE(OTDB::StorageFS::ReadFile(strPath_, 0, strOnDisk));
+    EXPECT_NE("first", strOnDisk);
+    EXPECT_EQ(strOnDisk, Query());
+}
+
+TEST_F(Test_OTStorageFS, erase_invalidates)
+{
+    ASSERT_TRUE(OTDB::StorePlainString("first", FOLDER, FILENAME));
+    ASSERT_EQ("first", Query());
+
+    ASSERT_TRUE(OTDB::EraseValueByKey(FOLDER, FILENAME));
+    EXPECT_FALSE(OTDB::Exists(FOLDER, FILENAME));
+    EXPECT_EQ("", Query());
+
+    // A file put back in its place is read fresh.
+    Rewrite("again");
+    EXPECT_EQ("again", Query());
+}
+
+// Same size, same second: only the sub-second timestamps tell the two
+// versions apart.
+TEST_F(Test_OTStorageFS, same_size_same_second_rewrite_is_seen)
+{
+    auto millisecond = []() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count() %
+               1000;
+    };
+
+    // Start early in a second, so both writes can land inside it.
+    while (500 < millisecond())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    ASSERT_TRUE(OTDB::StorePlainString("aaaa", FOLDER, FILENAME));
+    ASSERT_EQ("aaaa", Query());
+
+    struct stat before;
+    ASSERT_EQ(0, stat(strPath_.c_str(), &before));
+
+    // Past the kernel's timestamp granularity, well short of a second.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Rewrite("bbbb");
+
+    struct stat after;
+    ASSERT_EQ(0, stat(strPath_.c_str(), &after));
+    ASSERT_EQ(before.st_size, after.st_size);
+    ASSERT_EQ(before.st_ino, after.st_ino);
+    ASSERT_EQ(before.st_mtime, after.st_mtime);
+
+    EXPECT_EQ("bbbb", Query());
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/OTStorageStats.hpp>
+#include <opentxs/core/util/LatencyHistogram.hpp>
+
+using namespace opentxs;
+using namespace opentxs::OTDB;
+
+TEST(LatencyHistogram, buckets)
+{
+    LatencyHistogram theHistogram;
+    ASSERT_EQ("", theHistogram.FormatBuckets());
+
+    theHistogram.Add(0);
+    theHistogram.Add(1);
+    theHistogram.Add(3);
+    theHistogram.Add(1000);
+
+    ASSERT_EQ("2,1,0,0,0,0,0,0,0,1", theHistogram.FormatBuckets());
+    ASSERT_EQ(1004, theHistogram.TotalMicros());
+    ASSERT_EQ(1000, theHistogram.MaxMicros());
+
+    // Anything past the last bucket lands in it.
+    LatencyHistogram theSlow;
+    theSlow.Add(INT64_C(1) << 40);
+    ASSERT_EQ(static_cast<size_t>(2 * LatencyHistogram::Buckets - 1),
+              theSlow.FormatBuckets().size());
+}
+
+TEST(StorageStats, record)
+{
+    const int64_t lOldThreshold = StorageStats::GetSlowThreshold();
+    StorageStats::SetSlowThreshold(10);
+
+    ASSERT_FALSE(StorageStats::Record("test-folder", StorageStats::READ, true,
+                                      100, 50));
+    ASSERT_TRUE(StorageStats::Record("test-folder", StorageStats::READ, false,
+                                     0, 20000));
+    ASSERT_FALSE(StorageStats::Record("test-folder", StorageStats::WRITE, true,
+                                      7, 5));
+
+    const StorageStats::Snapshot theSnapshot = StorageStats::Get();
+    const auto it = theSnapshot.find("test-folder");
+    ASSERT_TRUE(theSnapshot.end() != it);
+
+    const StorageStats::Counters& theReads = it->second[StorageStats::READ];
+    ASSERT_EQ(2U, theReads.m_lCount);
+    ASSERT_EQ(1U, theReads.m_lErrors);
+    ASSERT_EQ(100U, theReads.m_lBytes);
+    ASSERT_EQ(1U, theReads.m_lSlow);
+    ASSERT_EQ(20050, theReads.m_latency.TotalMicros());
+
+    const StorageStats::Counters& theWrites = it->second[StorageStats::WRITE];
+    ASSERT_EQ(1U, theWrites.m_lCount);
+    ASSERT_EQ(7U, theWrites.m_lBytes);
+
+    ASSERT_EQ(0U, it->second[StorageStats::ERASE].m_lCount);
+
+    StorageStats::SetSlowThreshold(0);
+    ASSERT_FALSE(StorageStats::Record("test-folder", StorageStats::READ, true,
+                                      0, 20000));
+
+    StorageStats::SetSlowThreshold(lOldThreshold);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/OTWireFormat.hpp>
+#include <opentxs/core/String.hpp>
+
+using namespace opentxs;
+
+namespace
+{
+
+String sample_message(int32_t nRecords)
+{
+    String strMessage("-----BEGIN SIGNED MESSAGE-----\n");
+
+    for (int32_t i = 0; i < nRecords; ++i) {
+        strMessage.Concatenate("<ackReplies>%d</ackReplies>\n", i);
+    }
+
+    strMessage.Concatenate("-----END SIGNED MESSAGE-----\n");
+
+    return strMessage;
+}
+
+void round_trip(const String& strMessage)
+{
+    std::string strFrame;
+    ASSERT_TRUE(
+        OTWireFormat::Encode(strMessage, OTWireFormat::BINARY, strFrame));
+    ASSERT_TRUE(OTWireFormat::IsBinary(strFrame.data(), strFrame.size()));
+
+    String strDecoded;
+    OTWireFormat::Framing theFraming = OTWireFormat::ARMORED;
+    ASSERT_TRUE(OTWireFormat::Decode(strFrame.data(), strFrame.size(),
+                                     strDecoded, theFraming));
+    ASSERT_EQ(OTWireFormat::BINARY, theFraming);
+    ASSERT_STREQ(strMessage.Get(), strDecoded.Get());
+}
+
+} // namespace
+
+TEST(OTWireFormat, binary_round_trip)
+{
+    const bool bOldCompress = OTWireFormat::GetCompress();
+
+    OTWireFormat::SetCompress(true);
+    round_trip(sample_message(1));
+    round_trip(sample_message(500));
+
+    OTWireFormat::SetCompress(false);
+    round_trip(sample_message(1));
+    round_trip(sample_message(500));
+
+    OTWireFormat::SetCompress(bOldCompress);
+}
+
+TEST(OTWireFormat, armored_text_is_not_binary)
+{
+    const std::string strArmored("eJzT0dXVBQAC8ADk\n");
+    ASSERT_FALSE(OTWireFormat::IsBinary(strArmored.data(), strArmored.size()));
+}
+
+TEST(OTWireFormat, empty_binary_reply)
+{
+    std::string strFrame;
+    OTWireFormat::EmptyBinary(strFrame);
+    ASSERT_EQ(OTWireFormat::HeaderSize, strFrame.size());
+    ASSERT_EQ(0, strFrame[0]);
+
+    String strDecoded;
+    OTWireFormat::Framing theFraming = OTWireFormat::ARMORED;
+    ASSERT_TRUE(OTWireFormat::Decode(strFrame.data(), strFrame.size(),
+                                     strDecoded, theFraming));
+    ASSERT_EQ(OTWireFormat::BINARY, theFraming);
+    ASSERT_FALSE(strDecoded.Exists());
+}
+
+TEST(OTWireFormat, rejects_unknown_version)
+{
+    std::string strFrame;
+    OTWireFormat::EmptyBinary(strFrame);
+    strFrame[3] = 99;
+    strFrame += "payload";
+
+    String strDecoded;
+    OTWireFormat::Framing theFraming = OTWireFormat::ARMORED;
+    ASSERT_FALSE(OTWireFormat::Decode(strFrame.data(), strFrame.size(),
+                                      strDecoded, theFraming));
+}
+
+TEST(OTWireFormat, failed_reply_keeps_framing)
+{
+    std::string strReply("stale");
+    OTWireFormat::FailedReply(OTWireFormat::ARMORED, strReply);
+    ASSERT_TRUE(strReply.empty());
+
+    // An empty frame would tell a binary client to downgrade and resend.
+    OTWireFormat::FailedReply(OTWireFormat::BINARY, strReply);
+    ASSERT_FALSE(strReply.empty());
+    ASSERT_TRUE(OTWireFormat::IsBinary(strReply.data(), strReply.size()));
+
+    String strDecoded;
+    OTWireFormat::Framing theFraming = OTWireFormat::ARMORED;
+    ASSERT_TRUE(OTWireFormat::Decode(strReply.data(), strReply.size(),
+                                     strDecoded, theFraming));
+    ASSERT_EQ(OTWireFormat::BINARY, theFraming);
+    ASSERT_FALSE(strDecoded.Exists());
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/PhaseTimer.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace opentxs;
+
+namespace
+{
+
+void sleep_ms(int32_t nMilliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(nMilliseconds));
+}
+
+int64_t ms(int64_t lNanoseconds)
+{
+    return lNanoseconds / 1000000;
+}
+
+} // namespace
+
+TEST(PhaseTimer, innermost_scope_is_charged)
+{
+    PhaseTimer::Begin();
+
+    sleep_ms(10);
+    {
+        PhaseTimer::Scope load(PhaseTimer::LOAD);
+        sleep_ms(10);
+        {
+            PhaseTimer::Scope verify(PhaseTimer::VERIFY);
+            sleep_ms(20);
+        }
+        sleep_ms(10);
+    }
+
+    const PhaseTimer::Durations durations = PhaseTimer::End();
+
+    ASSERT_GE(ms(durations[PhaseTimer::PROCESS]), 10);
+    ASSERT_GE(ms(durations[PhaseTimer::LOAD]), 20);
+    ASSERT_GE(ms(durations[PhaseTimer::VERIFY]), 20);
+    ASSERT_LT(ms(durations[PhaseTimer::VERIFY]), 40);
+    ASSERT_EQ(0, durations[PhaseTimer::SIGN]);
+    ASSERT_EQ(0, durations[PhaseTimer::SAVE]);
+}
+
+TEST(PhaseTimer, scope_outside_begin_records_nothing)
+{
+    {
+        PhaseTimer::Scope sign(PhaseTimer::SIGN);
+        sleep_ms(5);
+    }
+
+    PhaseTimer::Begin();
+    const PhaseTimer::Durations durations = PhaseTimer::End();
+
+    ASSERT_EQ(0, durations[PhaseTimer::SIGN]);
+}
+
+TEST(PhaseTimer, names)
+{
+    ASSERT_STREQ("process", PhaseTimer::Name(PhaseTimer::PROCESS));
+    ASSERT_STREQ("save", PhaseTimer::Name(PhaseTimer::SAVE));
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#if defined(OT_CRYPTO_USING_OPENSSL)
+
+#include <opentxs/core/crypto/OTAsymmetricKey.hpp>
+#include <opentxs/core/crypto/OTCrypto.hpp>
+#include <opentxs/core/crypto/OTCryptoPool.hpp>
+#include <opentxs/core/crypto/OTSignature.hpp>
+#include <opentxs/core/crypto/OTSignatureCache.hpp>
+#include <opentxs/core/Contract.hpp>
+#include <opentxs/core/Identifier.hpp>
+#include <opentxs/core/Item.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/OTTransaction.hpp>
+#include <opentxs/core/String.hpp>
+
+#include "common/TestHelpers.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace opentxs;
+
+namespace
+{
+
+using test::ACCT_ID;
+using test::NOTARY_ID;
+
+// Batches of signing jobs spread over four threads, with the signature
+// cache off so that every verify really verifies.
+class Test_SignatureBatch : public ::testing::Test
+{
+protected:
+    Test_SignatureBatch()
+        : nOldThreads_(OTCryptoPool::GetThreads())
+        , bOldCache_(OTSignatureCache::IsEnabled())
+    {
+    }
+
+    void SetUp()
+    {
+        OTAsymmetricKey::SetPasswordCallback(&test_pass_cb);
+        OTCryptoPool::SetThreads(4);
+        OTSignatureCache::SetEnabled(false);
+
+        pAlice_ = test::new_nym();
+        pBob_ = test::new_nym();
+        ASSERT_TRUE(pAlice_ && pBob_);
+
+        for (int32_t i = 0; i < 8; ++i) {
+            String strContents;
+            strContents.Format("<contract>job %d</contract>\n", i);
+            contents_.push_back(strContents);
+        }
+
+        signatures_.resize(contents_.size());
+    }
+
+    void TearDown()
+    {
+        OTSignatureCache::SetEnabled(bOldCache_);
+        OTCryptoPool::SetThreads(nOldThreads_);
+    }
+
+    // Even jobs are Alice's, odd ones Bob's, so each key is shared by
+    // several jobs in the batch.
+    const Nym& signer(size_t i) const
+    {
+        return (0 == i % 2) ? *pAlice_ : *pBob_;
+    }
+
+    bool verify_one(size_t i, const Nym& theNym) const
+    {
+        return OTCrypto::It()->VerifySignature(
+            contents_[i], theNym.GetPublicSignKey(), signatures_[i],
+            Identifier::DefaultHashAlgorithm);
+    }
+
+    // A transaction of Alice's with some items, each signed on its own.
+    std::unique_ptr<OTTransaction> new_transaction(listOfContracts& theItems)
+    {
+        const Identifier theNymID(*pAlice_);
+        std::unique_ptr<OTTransaction> pTransaction(new OTTransaction(
+            theNymID, Identifier(ACCT_ID), Identifier(NOTARY_ID), 100));
+
+        for (int32_t i = 0; i < 6; ++i) {
+            Item* pItem = new Item(theNymID, *pTransaction, Item::transfer);
+            pItem->SetAmount(10 * (i + 1));
+            pTransaction->AddItem(*pItem);
+            theItems.push_back(pItem);
+        }
+
+        return pTransaction;
+    }
+
+    const int32_t nOldThreads_;
+    const bool bOldCache_;
+    std::unique_ptr<Nym> pAlice_;
+    std::unique_ptr<Nym> pBob_;
+    std::vector<String> contents_;
+    std::vector<OTSignature> signatures_;
+};
+
+} // namespace
+
+TEST_F(Test_SignatureBatch, sign_contracts_matches_one_at_a_time)
+{
+    listOfSignatureJobs theJobs;
+
+    for (size_t i = 0; i < contents_.size(); ++i) {
+        theJobs.push_back({&contents_[i], &signer(i).GetPrivateSignKey(),
+                           &signatures_[i], Identifier::DefaultHashAlgorithm});
+    }
+
+    listOfCryptoFutures theFutures = OTCrypto::It()->SignContracts(theJobs);
+    ASSERT_EQ(contents_.size(), theFutures.size());
+
+    for (size_t i = 0; i < theFutures.size(); ++i) {
+        ASSERT_TRUE(theFutures[i].get()) << i;
+        ASSERT_TRUE(verify_one(i, signer(i))) << i;
+        ASSERT_FALSE(verify_one(i, signer(i + 1))) << i;
+    }
+}
+
+// Each future answers for its own job: one bad job doesn't spoil the
+// batch, and the batch doesn't cover for a bad job.
+TEST_F(Test_SignatureBatch, verify_signatures_flags_each_bad_job)
+{
+    for (size_t i = 0; i < contents_.size(); ++i) {
+        ASSERT_TRUE(OTCrypto::It()->SignContract(
+            contents_[i], signer(i).GetPrivateSignKey(), signatures_[i],
+            Identifier::DefaultHashAlgorithm));
+    }
+
+    const String strTampered("<contract>job 2, tampered</contract>\n");
+    listOfSignatureJobs theJobs;
+
+    for (size_t i = 0; i < contents_.size(); ++i) {
+        theJobs.push_back({&contents_[i], &signer(i).GetPublicSignKey(),
+                           &signatures_[i], Identifier::DefaultHashAlgorithm});
+    }
+
+    theJobs[2].m_pContents = &strTampered;
+    theJobs[5].m_pKey = &signer(6).GetPublicSignKey(); // Alice's, not Bob's.
+
+    listOfCryptoFutures theFutures =
+        OTCrypto::It()->VerifySignatures(theJobs);
+    ASSERT_EQ(theJobs.size(), theFutures.size());
+
+    for (size_t i = 0; i < theFutures.size(); ++i) {
+        ASSERT_EQ((2 != i) && (5 != i), theFutures[i].get()) << i;
+    }
+}
+
+TEST_F(Test_SignatureBatch, contract_batch_round_trip)
+{
+    listOfContracts theItems;
+    std::unique_ptr<OTTransaction> pTransaction(new_transaction(theItems));
+
+    ASSERT_TRUE(Contract::SignContracts(theItems, *pAlice_));
+
+    const listOfConstContracts theConstItems(theItems.begin(),
+                                             theItems.end());
+    ASSERT_TRUE(Contract::VerifySignatures(theConstItems, *pAlice_));
+    ASSERT_FALSE(Contract::VerifySignatures(theConstItems, *pBob_));
+
+    for (auto& it : theItems) ASSERT_TRUE(it->VerifySignature(*pAlice_));
+}
+
+TEST_F(Test_SignatureBatch, verify_items_rejects_one_tampered_item)
+{
+    listOfContracts theItems;
+    std::unique_ptr<OTTransaction> pTransaction(new_transaction(theItems));
+
+    ASSERT_TRUE(Contract::SignContracts(theItems, *pAlice_));
+    ASSERT_TRUE(pTransaction->VerifyItems(*pAlice_));
+
+    // Change what item 3 says, keeping the signature it had.
+    Item& theItem = dynamic_cast<Item&>(*theItems[3]);
+    theItem.SetAmount(1000000);
+    static_cast<Contract&>(theItem).UpdateContents();
+
+    ASSERT_FALSE(pTransaction->VerifyItems(*pAlice_));
+}
+
+#endif // OT_CRYPTO_USING_OPENSSL
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/Trace.hpp>
+
+#include <string>
+
+using namespace opentxs;
+
+namespace
+{
+
+class TraceTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        oldRate_ = Trace::GetSampleRate();
+    }
+
+    virtual void TearDown()
+    {
+        std::string strJson;
+        Trace::End(strJson);
+        Trace::SetSampleRate(oldRate_);
+    }
+
+    int32_t oldRate_;
+};
+
+bool contains(const std::string& strJson, const std::string& strPart)
+{
+    return std::string::npos != strJson.find(strPart);
+}
+
+} // namespace
+
+TEST_F(TraceTest, off_by_default)
+{
+    Trace::SetSampleRate(0);
+    ASSERT_FALSE(Trace::Begin());
+
+    Trace::Span span("not traced");
+    ASSERT_FALSE(span.Active());
+
+    std::string strJson;
+    ASSERT_FALSE(Trace::End(strJson));
+}
+
+TEST_F(TraceTest, nested_spans)
+{
+    Trace::SetSampleRate(1);
+    ASSERT_TRUE(Trace::Begin());
+    {
+        Trace::Span outer("outer");
+        ASSERT_TRUE(outer.Active());
+        outer.Arg("path", "nymbox/\"quoted\"");
+        {
+            Trace::Span inner("inner");
+        }
+    }
+
+    std::string strJson;
+    ASSERT_TRUE(Trace::End(strJson));
+    ASSERT_TRUE(contains(strJson, "{\"traceEvents\":["));
+    ASSERT_TRUE(contains(strJson, "\"name\":\"outer\""));
+    ASSERT_TRUE(contains(strJson, "\"name\":\"inner\""));
+    ASSERT_TRUE(contains(strJson, "\"ph\":\"X\""));
+    ASSERT_TRUE(contains(strJson, "\"path\":\"nymbox/\\\"quoted\\\"\""));
+    ASSERT_TRUE(contains(strJson, "\"droppedSpans\":0"));
+    ASSERT_LT(strJson.find("outer"), strJson.find("inner"));
+}
+
+TEST_F(TraceTest, open_span_closed_by_end)
+{
+    Trace::SetSampleRate(1);
+    ASSERT_TRUE(Trace::Begin());
+
+    Trace::Span span("still open");
+
+    std::string strJson;
+    ASSERT_TRUE(Trace::End(strJson));
+    ASSERT_TRUE(contains(strJson, "\"name\":\"still open\""));
+    ASSERT_FALSE(contains(strJson, "\"dur\":-"));
+}
+
+TEST_F(TraceTest, sampling)
+{
+    Trace::SetSampleRate(4);
+
+    int32_t nTraced = 0;
+
+    for (int32_t i = 0; i < 40; ++i) {
+        if (Trace::Begin()) {
+            ++nTraced;
+            std::string strJson;
+            Trace::End(strJson);
+        }
+    }
+
+    ASSERT_EQ(10, nTraced);
+}
+
+TEST_F(TraceTest, too_many_spans_are_dropped)
+{
+    Trace::SetSampleRate(1);
+    ASSERT_TRUE(Trace::Begin());
+
+    for (size_t i = 0; i < Trace::MaxSpans + 5; ++i) {
+        Trace::Span span("span");
+    }
+
+    std::string strJson;
+    ASSERT_TRUE(Trace::End(strJson));
+    ASSERT_TRUE(contains(strJson, "\"droppedSpans\":5"));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/util/Tag.hpp>
+#include <opentxs/core/util/XmlWriter.hpp>
+
+using namespace opentxs;
+
+TEST(XmlWriter, empty_element)
+{
+    std::string str_tag, str_writer;
+    Tag("nymData").output(str_tag);
+
+    XmlWriter writer(str_writer);
+    writer.open_element("nymData");
+    writer.close_element();
+
+    ASSERT_EQ(str_tag, str_writer);
+}
+
+TEST(XmlWriter, attributes_sorted_first_value_wins)
+{
+    std::string str_tag, str_writer;
+
+    Tag tag("transaction");
+    tag.add_attribute("type", "blank");
+    tag.add_attribute("dateSigned", "1420000000");
+    tag.add_attribute("accountID", "ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1");
+    tag.add_attribute("type", "ignored");
+    tag.add_attribute("nymID", "");
+    tag.output(str_tag);
+
+    XmlWriter writer(str_writer);
+    writer.open_element("transaction");
+    writer.add_attribute("type", "blank");
+    writer.add_attribute("dateSigned", "1420000000");
+    writer.add_attribute("accountID", "ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1");
+    writer.add_attribute("type", "ignored");
+    writer.add_attribute("nymID", "");
+    writer.close_element();
+
+    ASSERT_EQ(str_tag, str_writer);
+}
+
+TEST(XmlWriter, nested_elements_and_text)
+{
+    std::string str_tag, str_writer;
+
+    Tag tag("accountLedger");
+    tag.add_attribute("version", "2.0");
+    tag.add_attribute("type", "inbox");
+    for (int i = 0; i < 3; ++i) {
+        TagPtr pRecord(new Tag("inboxRecord"));
+        pRecord->add_attribute("transactionNum", std::to_string(i));
+        pRecord->add_attribute("adjustment", "-10");
+        tag.add_tag(pRecord);
+    }
+    TagPtr pParent(new Tag("transaction"));
+    pParent->add_attribute("value", "5");
+    pParent->add_tag("item", "eJwzNDI1MTAwNbWwtAQADSkCdg==");
+    pParent->add_tag("empty", "");
+    tag.add_tag(pParent);
+    tag.output(str_tag);
+
+    XmlWriter writer(str_writer);
+    writer.open_element("accountLedger");
+    writer.add_attribute("version", "2.0");
+    writer.add_attribute("type", "inbox");
+    for (int i = 0; i < 3; ++i) {
+        writer.open_element("inboxRecord");
+        writer.add_attribute("transactionNum", std::to_string(i));
+        writer.add_attribute("adjustment", "-10");
+        writer.close_element();
+    }
+    writer.open_element("transaction");
+    writer.add_attribute("value", "5");
+    writer.add_element("item", "eJwzNDI1MTAwNbWwtAQADSkCdg==");
+    writer.add_element("empty", "");
+    writer.close_element();
+    writer.close_element();
+
+    ASSERT_EQ(0u, writer.depth());
+    ASSERT_EQ(str_tag, str_writer);
+}
+
+TEST(XmlWriter, element_with_attributes_and_text)
+{
+    std::string str_tag, str_writer;
+
+    Tag tag("mailMessage", "eJwzNDI1MTAwNbWwtAQADSkCdg==");
+    tag.add_attribute("index", "0");
+    tag.output(str_tag);
+
+    XmlWriter writer(str_writer);
+    writer.open_element("mailMessage");
+    writer.add_attribute("index", "0");
+    writer.set_text("eJwzNDI1MTAwNbWwtAQADSkCdg==");
+    writer.close_element();
+
+    ASSERT_EQ(str_tag, str_writer);
+}
+
+TEST(XmlWriter, quote_in_attribute_is_escaped)
+{
+    std::string str_writer;
+
+    XmlWriter writer(str_writer);
+    writer.open_element("nym");
+    writer.add_attribute("name", "a \"b\" & <c>");
+    writer.close_element();
+
+    ASSERT_EQ("<nym\n name=\"a &quot;b&quot; & <c>\" />\n", str_writer);
+}
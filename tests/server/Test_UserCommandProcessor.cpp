@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+#include <opentxs/core/Message.hpp>
+#include <opentxs/core/Nym.hpp>
+#include <opentxs/core/String.hpp>
+#include <opentxs/server/ServerSettings.hpp>
+#include <opentxs/server/ServerStats.hpp>
+#include <opentxs/server/UserCommandProcessor.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+class Test_UserCommandProcessor : public ::testing::Test
+{
+protected:
+    typedef UserCommandProcessor U;
+    typedef ServerSettings S;
+
+    struct Expected
+    {
+        U::Handler handler;
+        std::vector<const bool*> permissions;
+        bool byDepth;
+    };
+
+    Test_UserCommandProcessor()
+        : processor_(nullptr)
+        , overrideNymID_(S::GetOverrideNymID())
+    {
+        for (const bool* permission : all_permissions())
+            saved_.push_back(*permission);
+
+        S::SetOverrideNymID("");
+    }
+
+    ~Test_UserCommandProcessor()
+    {
+        const auto permissions = all_permissions();
+
+        for (size_t i = 0; i < permissions.size(); ++i)
+            *const_cast<bool*>(permissions[i]) = saved_[i];
+
+        S::SetOverrideNymID(overrideNymID_);
+    }
+
+    // What the if/else chain in ProcessCommand did before the table.
+    static std::map<std::string, Expected> old_commands()
+    {
+        return {
+            {"getRequestNumber",
+             {&U::UserCmdGetRequestNumber, {&S::__cmd_get_requestnumber},
+              false}},
+            {"getTransactionNumbers",
+             {&U::UserCmdGetTransactionNumbers, {&S::__cmd_get_trans_nums},
+              false}},
+            {"checkNym", {&U::UserCmdCheckNym, {&S::__cmd_check_nym}, false}},
+            {"sendNymMessage",
+             {&U::UserCmdSendNymMessage, {&S::__cmd_send_message}, false}},
+            {"sendNymInstrument",
+             {&U::UserCmdSendNymInstrument, {&S::__cmd_send_message}, false}},
+            {"unregisterNym",
+             {&U::UserCmdDeleteUser, {&S::__cmd_del_user_acct}, false}},
+            {"unregisterAccount",
+             {&U::UserCmdDeleteAssetAcct, {&S::__cmd_del_asset_acct}, false}},
+            {"registerAccount",
+             {&U::UserCmdRegisterAccount, {&S::__cmd_create_asset_acct},
+              false}},
+            {"registerInstrumentDefinition",
+             {&U::UserCmdRegisterInstrumentDefinition, {&S::__cmd_issue_asset},
+              false}},
+            {"issueBasket",
+             {&U::UserCmdIssueBasket, {&S::__cmd_issue_basket}, false}},
+            {"notarizeTransaction",
+             {&U::UserCmdNotarizeTransaction, {&S::__cmd_notarize_transaction},
+              false}},
+            {"getNymbox",
+             {&U::UserCmdGetNymbox, {&S::__cmd_get_nymbox}, false}},
+            {"getBoxReceipt",
+             {&U::UserCmdGetBoxReceipt,
+              {&S::__cmd_get_nymbox, &S::__cmd_get_inbox,
+               &S::__cmd_get_outbox},
+              true}},
+            {"getAccountData",
+             {&U::UserCmdGetAccountData,
+              {&S::__cmd_get_inbox, &S::__cmd_get_outbox, &S::__cmd_get_acct},
+              false}},
+            {"processNymbox",
+             {&U::UserCmdProcessNymbox, {&S::__cmd_process_nymbox}, false}},
+            {"processInbox",
+             {&U::UserCmdProcessInbox, {&S::__cmd_process_inbox}, false}},
+            {"queryInstrumentDefinitions",
+             {&U::UserCmdQueryInstrumentDefinitions, {&S::__cmd_get_contract},
+              false}},
+            {"getInstrumentDefinition",
+             {&U::UserCmdGetInstrumentDefinition, {&S::__cmd_get_contract},
+              false}},
+            {"getMint", {&U::UserCmdGetMint, {&S::__cmd_get_mint}, false}},
+            {"getMarketList",
+             {&U::UserCmdGetMarketList, {&S::__cmd_get_market_list}, false}},
+            {"getMarketOffers",
+             {&U::UserCmdGetMarketOffers, {&S::__cmd_get_market_offers},
+              false}},
+            {"getMarketRecentTrades",
+             {&U::UserCmdGetMarketRecentTrades,
+              {&S::__cmd_get_market_recent_trades}, false}},
+            {"getNymMarketOffers",
+             {&U::UserCmdGetNymMarketOffers,
+              {&S::__cmd_get_nym_market_offers}, false}},
+            {"triggerClause",
+             {&U::UserCmdTriggerClause, {&S::__cmd_trigger_clause}, false}},
+            {"usageCredits",
+             {&U::UserCmdUsageCredits, {&S::__cmd_usage_credits}, false}},
+        };
+    }
+
+    // Added along with the table.
+    static Expected server_stats_command()
+    {
+        return {&U::UserCmdGetServerStats, {&S::__cmd_get_server_stats},
+                false};
+    }
+
+    // Every permission the table refers to, so a test can change them.
+    static std::vector<const bool*> all_permissions()
+    {
+        std::vector<const bool*> permissions{&S::__cmd_get_server_stats};
+
+        for (auto& it : old_commands())
+            for (const bool* permission : it.second.permissions)
+                permissions.push_back(permission);
+
+        return permissions;
+    }
+
+    void expect_table_entry(const std::string& name, const Expected& expected)
+    {
+        auto it = processor_.commands_.find(name);
+        ASSERT_NE(processor_.commands_.end(), it) << name;
+
+        EXPECT_TRUE(expected.handler == it->second.handler) << name;
+        EXPECT_EQ(expected.permissions, it->second.permissions) << name;
+        EXPECT_EQ(expected.byDepth, it->second.byDepth) << name;
+    }
+
+    size_t table_size() const
+    {
+        return processor_.commands_.size();
+    }
+
+    // Only for commands whose permission check fails: with server_ null, a
+    // handler that gets to run would crash.
+    bool run(const std::string& name, int64_t lDepth, Message& msgOut)
+    {
+        Message theMessage;
+        theMessage.m_strCommand = name.c_str();
+        theMessage.m_strNymID = "ot2xuVPJDdweZvKLQD42UMCzhCmT3okn3W1";
+        theMessage.m_lDepth = lDepth;
+
+        Nym theNym;
+
+        return processor_.RunCommand(processor_.commands_.at(name), theNym,
+                                     theMessage, msgOut);
+    }
+
+    void record(const std::string& name, bool bSuccess)
+    {
+        processor_.RecordStats(name, bSuccess, PhaseTimer::Durations{});
+    }
+
+    std::string stats() const
+    {
+        String strStats;
+        processor_.stats_.Serialize(strStats);
+        return strStats.Get();
+    }
+
+    static void allow(const bool& permission, bool bAllowed)
+    {
+        const_cast<bool&>(permission) = bAllowed;
+    }
+
+    UserCommandProcessor processor_;
+    std::string overrideNymID_;
+    std::vector<bool> saved_;
+};
+
+TEST_F(Test_UserCommandProcessor, table_matches_the_old_dispatch)
+{
+    const auto expected = old_commands();
+
+    for (auto& it : expected) expect_table_entry(it.first, it.second);
+
+    expect_table_entry("getServerStats", server_stats_command());
+
+    EXPECT_EQ(expected.size() + 1, table_size());
+}
+
+TEST_F(Test_UserCommandProcessor, denied_command_returns_false)
+{
+    allow(S::__cmd_check_nym, false);
+
+    Message msgOut;
+    EXPECT_FALSE(run("checkNym", 0, msgOut));
+    EXPECT_FALSE(msgOut.m_strCommand.Exists());
+}
+
+TEST_F(Test_UserCommandProcessor, account_data_needs_all_three_permissions)
+{
+    const bool* permissions[] = {&S::__cmd_get_inbox, &S::__cmd_get_outbox,
+                                 &S::__cmd_get_acct};
+
+    for (const bool* denied : permissions) {
+        for (const bool* permission : permissions)
+            allow(*permission, permission != denied);
+
+        Message msgOut;
+        EXPECT_FALSE(run("getAccountData", 0, msgOut));
+        EXPECT_FALSE(msgOut.m_strCommand.Exists());
+    }
+}
+
+TEST_F(Test_UserCommandProcessor, box_receipt_permission_follows_depth)
+{
+    const bool* permissions[] = {&S::__cmd_get_nymbox, &S::__cmd_get_inbox,
+                                 &S::__cmd_get_outbox};
+
+    for (int64_t lDepth = 0; lDepth < 3; ++lDepth) {
+        // Only the box at this depth is off limits.
+        for (int64_t i = 0; i < 3; ++i) allow(*permissions[i], i != lDepth);
+
+        Message msgOut;
+        EXPECT_FALSE(run("getBoxReceipt", lDepth, msgOut)) << lDepth;
+    }
+
+    // No box at this depth: nothing runs, but the request counts as handled.
+    for (const bool* permission : permissions) allow(*permission, false);
+
+    for (int64_t lDepth : {int64_t(-1), int64_t(3)}) {
+        Message msgOut;
+        EXPECT_TRUE(run("getBoxReceipt", lDepth, msgOut)) << lDepth;
+        EXPECT_FALSE(msgOut.m_strCommand.Exists());
+    }
+}
+
+TEST_F(Test_UserCommandProcessor, unknown_commands_are_counted_together)
+{
+    record("checkNym", true);
+    record("pingNotary", true);
+    record("registerNym", false);
+    record("noSuchCommand", false);
+    record("anotherBogusCommand", true);
+
+    const std::string strStats = stats();
+
+    EXPECT_NE(std::string::npos, strStats.find("name=\"checkNym\""));
+    EXPECT_NE(std::string::npos, strStats.find("name=\"pingNotary\""));
+    EXPECT_NE(std::string::npos, strStats.find("name=\"registerNym\""));
+    EXPECT_EQ(std::string::npos, strStats.find("noSuchCommand"));
+    EXPECT_EQ(std::string::npos, strStats.find("anotherBogusCommand"));
+
+    const auto pos = strStats.find("name=\"unknown\"");
+    ASSERT_NE(std::string::npos, pos);
+
+    // Attributes come out sorted, so count and errors precede the name.
+    const auto start = strStats.rfind("<command", pos);
+    const std::string strCommand = strStats.substr(start, pos - start);
+    EXPECT_NE(std::string::npos, strCommand.find("count=\"2\""));
+    EXPECT_NE(std::string::npos, strCommand.find("errors=\"1\""));
+}
+
+} // namespace opentxs
+
+using namespace opentxs;
+
+// Nothing in this binary touches storage, so those counters are all zero.
+TEST(ServerStats, serialize)
+{
+    ServerStats theStats;
+    PhaseTimer::Durations durations{};
+    durations[PhaseTimer::PROCESS] = 3000; // nanoseconds
+    durations[PhaseTimer::LOAD] = 5000;
+
+    theStats.Record("checkNym", false, durations);
+
+    String strStats;
+    theStats.Serialize(strStats);
+
+    EXPECT_STREQ("<serverStats\n"
+                 " errors=\"1\"\n"
+                 " requests=\"1\"\n"
+                 " uptimeSeconds=\"0\">\n"
+                 "<command\n"
+                 " count=\"1\"\n"
+                 " errors=\"1\"\n"
+                 " name=\"checkNym\">\n"
+                 "<latency\n"
+                 " buckets=\"0,0,0,1\"\n"
+                 " maxMicros=\"8\"\n"
+                 " phase=\"total\"\n"
+                 " totalMicros=\"8\" />\n"
+                 "<latency\n"
+                 " buckets=\"0,1\"\n"
+                 " maxMicros=\"3\"\n"
+                 " phase=\"process\"\n"
+                 " totalMicros=\"3\" />\n"
+                 "<latency\n"
+                 " buckets=\"1\"\n"
+                 " maxMicros=\"0\"\n"
+                 " phase=\"verify\"\n"
+                 " totalMicros=\"0\" />\n"
+                 "<latency\n"
+                 " buckets=\"0,0,1\"\n"
+                 " maxMicros=\"5\"\n"
+                 " phase=\"load\"\n"
+                 " totalMicros=\"5\" />\n"
+                 "<latency\n"
+                 " buckets=\"1\"\n"
+                 " maxMicros=\"0\"\n"
+                 " phase=\"sign\"\n"
+                 " totalMicros=\"0\" />\n"
+                 "<latency\n"
+                 " buckets=\"1\"\n"
+                 " maxMicros=\"0\"\n"
+                 " phase=\"save\"\n"
+                 " totalMicros=\"0\" />\n"
+                 "\n"
+                 "</command>\n"
+                 "<storage>\n"
+                 "<cache\n"
+                 " bytes=\"0\"\n"
+                 " entries=\"0\"\n"
+                 " evictions=\"0\"\n"
+                 " hits=\"0\"\n"
+                 " misses=\"0\"\n"
+                 " pinnedBytes=\"0\"\n"
+                 " stale=\"0\" />\n"
+                 "\n"
+                 "</storage>\n"
+                 "\n"
+                 "</serverStats>\n",
+                 strStats.Get());
+}